@@ -3,9 +3,22 @@
 
 #include "esp_err.h"
 #include <time.h>
+#include <stdint.h>
 
-// SNTP 초기화 및 시간 동기화
-esp_err_t sntp_init_and_sync(void);
+// 현재 시계의 출처
+typedef enum {
+    SNTP_TIME_NONE = 0,         // 시간 정보 없음 (1970년부터 흐름)
+    SNTP_TIME_NVS_ESTIMATE,     // 전원 재인가 후 NVS의 마지막 동기화 시각으로 설정 (하한값)
+    SNTP_TIME_RTC_RESTORED,     // 소프트 리셋 후 RTC에서 유지된 시간
+    SNTP_TIME_SYNCED,           // 이번 부팅에서 SNTP 동기화 완료
+} sntp_time_state_t;
+
+// 저장된 마지막 동기화 시각으로 시계 복원 (NVS 초기화 직후 호출)
+void sntp_restore_time(void);
+
+// 서버 RTT 측정 후 SNTP 시작 (백그라운드 태스크, 호출자를 막지 않음)
+// 동기화 완료 시 APP_INIT_TIME_SYNCED 세트
+esp_err_t sntp_service_start(void);
 
 // 현재 세계 시간 가져오기 (Unix timestamp)
 time_t get_current_world_time(void);
@@ -16,7 +29,10 @@ int64_t get_combined_timestamp(void);
 // 시간 포맷팅 (디버깅용)
 void print_current_time(void);
 
-// SNTP 동기화 상태 확인
+// 시계 출처 조회
+sntp_time_state_t sntp_get_time_state(void);
+
+// 유닉스 시간을 신뢰할 수 있는지 (SNTP 동기화 또는 RTC 유지)
 int is_sntp_synced(void);
 
 #endif // SNTP_HELPER_H
@@ -7,6 +7,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "sntp_helper.h"
+#include "task_placement.h"
 #include <string.h>
 
 static const char *TAG = "BLE_ANCHOR";
@@ -139,7 +140,7 @@ void ble_anchor_init(void)
 
     ble_initialized = true;
 
-    xTaskCreate(anchor_status_task, "anchor_status", 3072, NULL, 5, NULL);
+    task_placement_create(TASK_ID_ANCHOR_STATUS, anchor_status_task, NULL, NULL);
     ESP_LOGI(TAG, "BLE Anchor initialized");
 }
 
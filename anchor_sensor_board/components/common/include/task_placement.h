@@ -0,0 +1,56 @@
+// task_placement.h
+// 애플리케이션 태스크 배치 테이블 (코어 / 우선순위 / 스택)
+//
+// 모든 애플리케이션 태스크는 task_placement_create()로 생성한다. 코어와 스택 크기는
+// menuconfig "Task placement"에서 바꿀 수 있고, 기본 정책은 무선/네트워크(Wi-Fi, lwIP, Bluedroid,
+// MQTT, 광고 상태 점검)를 core 0에, 센서 획득(DHT 비트뱅잉 포함)과 발행 준비를 core 1에 고정한다.
+// 시스템 태스크(lwIP tcpip, esp-mqtt, Bluedroid, esp_timer)의 코어는 sdkconfig에서 같은 정책으로 맞춘다.
+//
+// 스택 크기는 task_placement_check_stacks()가 출력하는 실측 최고 사용량(high-water mark)을 기준으로 정한다.
+// dlog는 common에 의존하지 않는 하위 컴포넌트라 테이블에 넣지 않았다 (저우선순위, 비고정).
+
+#ifndef TASK_PLACEMENT_H
+#define TASK_PLACEMENT_H
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+typedef enum {
+    TASK_ID_SENSOR_PUBLISH = 0,     // 센서 획득 + 발행 메시지 작성 (core 1)
+    TASK_ID_MQTT_OUTBOX,            // 발행 대기열 (core 0)
+    TASK_ID_ANCHOR_STATUS,          // iBeacon 광고 상태 점검 (core 0)
+    TASK_ID_WIFI_MGR,               // Wi-Fi 재연결 관리 (core 0)
+    TASK_ID_SNTP,                   // SNTP 서버 선택/동기화 (core 0)
+    TASK_ID_COUNT
+} task_id_t;
+
+/**
+ * @brief 배치 테이블에 따라 태스크 생성 (코어 고정 / 비고정은 정책에 따름)
+ * @param id 태스크 식별자 (이름, 스택, 우선순위, 코어는 테이블에서 결정)
+ * @param fn 태스크 함수
+ * @param arg 태스크 인자
+ * @param out_handle 생성된 핸들 (NULL 가능)
+ * @return pdPASS 성공
+ */
+BaseType_t task_placement_create(task_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *out_handle);
+
+/**
+ * @brief 외부에서 삭제한 태스크를 스택 점검 대상에서 제외
+ */
+void task_placement_forget(task_id_t id);
+
+/**
+ * @brief 테이블의 태스크 이름
+ */
+const char *task_placement_name(task_id_t id);
+
+/**
+ * @brief 실행 중인 태스크별 스택 최고 사용량과 권장 크기를 로그로 출력
+ *
+ * 여유가 CONFIG_TASK_STACK_MARGIN보다 적은 태스크는 경고로 표시한다.
+ * @return 실행 중인 태스크 중 가장 작은 스택 여유 (bytes), 점검 대상이 없으면 UINT32_MAX
+ */
+uint32_t task_placement_check_stacks(void);
+
+#endif // TASK_PLACEMENT_H
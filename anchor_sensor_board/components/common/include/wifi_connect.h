@@ -1,8 +0,0 @@
-// wifi_connect.h
-
-#ifndef WIFI_CONNECT_H
-#define WIFI_CONNECT_H
-
-void wifi_connect(void);
-
-#endif // WIFI_CONNECT_H
@@ -0,0 +1,159 @@
+// app_init.c
+
+#include "app_init.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "APP_INIT";
+
+// 단계별 실행 기록
+typedef struct {
+    const app_init_stage_t *stage;
+    int64_t ready_us;       // requires 충족 시각
+    int64_t done_us;        // fn 반환 시각
+    esp_err_t result;
+    bool finished;
+} stage_record_t;
+
+static EventGroupHandle_t s_init_group = NULL;
+static int64_t s_boot_us = 0;
+static int64_t s_bit_time_us[APP_INIT_BIT_COUNT];
+static stage_record_t s_records[APP_INIT_MAX_STAGES];
+static size_t s_record_count = 0;
+static portMUX_TYPE s_time_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const s_bit_names[APP_INIT_BIT_COUNT] = {
+    "nvs", "i2c", "sensor_data", "sensors", "net_up",
+    "time_synced", "mqtt_up", "ble", "first_publish",
+};
+
+void app_init_begin(void) {
+    if (s_init_group != NULL) {
+        return;
+    }
+    s_boot_us = esp_timer_get_time();
+    s_init_group = xEventGroupCreate();
+    if (s_init_group == NULL) {
+        ESP_LOGE(TAG, "이벤트 그룹 생성 실패");
+    }
+}
+
+void app_init_signal(EventBits_t bits) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_SAFE(&s_time_lock);
+    for (int i = 0; i < APP_INIT_BIT_COUNT; i++) {
+        if ((bits & (1u << i)) && s_bit_time_us[i] == 0) {
+            s_bit_time_us[i] = now;
+        }
+    }
+    portEXIT_CRITICAL_SAFE(&s_time_lock);
+
+    if (s_init_group != NULL) {
+        xEventGroupSetBits(s_init_group, bits);
+    }
+}
+
+void app_init_clear(EventBits_t bits) {
+    if (s_init_group != NULL) {
+        xEventGroupClearBits(s_init_group, bits);
+    }
+}
+
+EventBits_t app_init_wait(EventBits_t bits, TickType_t timeout) {
+    if (s_init_group == NULL) {
+        return 0;
+    }
+    return xEventGroupWaitBits(s_init_group, bits, pdFALSE, pdTRUE, timeout);
+}
+
+bool app_init_is_set(EventBits_t bits) {
+    if (s_init_group == NULL) {
+        return false;
+    }
+    return (xEventGroupGetBits(s_init_group) & bits) == bits;
+}
+
+static void stage_task(void *pvParameters) {
+    stage_record_t *rec = (stage_record_t *)pvParameters;
+    const app_init_stage_t *stage = rec->stage;
+
+    if (stage->requires != 0) {
+        app_init_wait(stage->requires, portMAX_DELAY);
+    }
+    rec->ready_us = esp_timer_get_time();
+
+    rec->result = stage->fn();
+    rec->done_us = esp_timer_get_time();
+    rec->finished = true;
+
+    if (rec->result == ESP_OK) {
+        ESP_LOGI(TAG, "[%s] 완료 (%lld ms)", stage->name, (rec->done_us - rec->ready_us) / 1000);
+        if (stage->provides != 0) {
+            app_init_signal(stage->provides);
+        }
+    } else {
+        ESP_LOGE(TAG, "[%s] 실패: %s", stage->name, esp_err_to_name(rec->result));
+    }
+
+    vTaskDelete(NULL);
+}
+
+esp_err_t app_init_start(const app_init_stage_t *stages, size_t count) {
+    app_init_begin();
+
+    if (s_record_count + count > APP_INIT_MAX_STAGES) {
+        ESP_LOGE(TAG, "단계 수 초과 (%d > %d)", (int)(s_record_count + count), APP_INIT_MAX_STAGES);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        stage_record_t *rec = &s_records[s_record_count++];
+        rec->stage = &stages[i];
+
+        uint32_t stack = stages[i].stack_size ? stages[i].stack_size : 4096;
+        if (xTaskCreate(stage_task, stages[i].name, stack, rec, 5, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "[%s] 태스크 생성 실패", stages[i].name);
+            rec->result = ESP_ERR_NO_MEM;
+            rec->finished = true;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+void app_init_mark_first_publish(void) {
+    if (app_init_is_set(APP_INIT_FIRST_PUBLISH)) {
+        return;
+    }
+    app_init_signal(APP_INIT_FIRST_PUBLISH);
+    app_init_print_report();
+}
+
+void app_init_print_report(void) {
+    ESP_LOGI(TAG, "===== 부팅 리포트 (app_main 기준, ms) =====");
+    for (size_t i = 0; i < s_record_count; i++) {
+        const stage_record_t *rec = &s_records[i];
+        if (!rec->finished) {
+            ESP_LOGI(TAG, "  %-12s 대기/실행 중", rec->stage->name);
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-12s 시작 %6lld  종료 %6lld  (%5lld ms) %s",
+                 rec->stage->name,
+                 (rec->ready_us - s_boot_us) / 1000,
+                 (rec->done_us - s_boot_us) / 1000,
+                 (rec->done_us - rec->ready_us) / 1000,
+                 rec->result == ESP_OK ? "OK" : esp_err_to_name(rec->result));
+    }
+    for (int i = 0; i < APP_INIT_BIT_COUNT; i++) {
+        if (s_bit_time_us[i] != 0) {
+            ESP_LOGI(TAG, "  bit %-13s %6lld", s_bit_names[i], (s_bit_time_us[i] - s_boot_us) / 1000);
+        }
+    }
+    int64_t first_publish_us = s_bit_time_us[__builtin_ctz(APP_INIT_FIRST_PUBLISH)];
+    if (first_publish_us != 0) {
+        ESP_LOGI(TAG, "  부팅 → 첫 publish: %lld ms (리셋 기준 %lld ms)",
+                 (first_publish_us - s_boot_us) / 1000, first_publish_us / 1000);
+    }
+}
@@ -0,0 +1,110 @@
+// metrics.c
+
+#include "metrics.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "METRICS";
+
+static metric_timer_stat_t s_timers[METRIC_TIMER_COUNT];
+static uint32_t s_counters[METRIC_COUNTER_COUNT];
+static int64_t s_marks_us[METRIC_MARK_COUNT];
+static portMUX_TYPE s_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const s_timer_names[METRIC_TIMER_COUNT] = {
+    [METRIC_WIFI_ASSOC_MS]         = "wifi_assoc",
+    [METRIC_WIFI_DHCP_MS]          = "wifi_dhcp",
+    [METRIC_WIFI_ASSOC_TO_MQTT_MS] = "assoc_to_mqtt",
+    [METRIC_WIFI_OUTAGE_MS]        = "wifi_outage",
+    [METRIC_MQTT_ACK_MS]           = "mqtt_ack",
+};
+
+static const char *const s_counter_names[METRIC_COUNTER_COUNT] = {
+    [METRIC_WIFI_DISCONNECTS]    = "wifi_disconnects",
+    [METRIC_WIFI_CACHE_HITS]     = "wifi_cache_hits",
+    [METRIC_WIFI_CACHE_MISSES]   = "wifi_cache_misses",
+    [METRIC_MQTT_DISCONNECTS]    = "mqtt_disconnects",
+    [METRIC_OUTBOX_DROPS_ALERT]  = "outbox_drop_alert",
+    [METRIC_OUTBOX_DROPS_VITALS] = "outbox_drop_vitals",
+    [METRIC_OUTBOX_DROPS_ENV]    = "outbox_drop_env",
+    [METRIC_OUTBOX_DROPS_DIAG]   = "outbox_drop_diag",
+    [METRIC_OUTBOX_COALESCED]    = "outbox_coalesced",
+    [METRIC_OUTBOX_EXPIRED]      = "outbox_expired",
+};
+
+void metrics_mark(metric_mark_t mark) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&s_metrics_lock);
+    s_marks_us[mark] = now;
+    portEXIT_CRITICAL_SAFE(&s_metrics_lock);
+}
+
+void metrics_record_ms(metric_timer_t timer, uint32_t ms) {
+    portENTER_CRITICAL_SAFE(&s_metrics_lock);
+    metric_timer_stat_t *t = &s_timers[timer];
+    if (t->count == 0 || ms < t->min) {
+        t->min = ms;
+    }
+    if (ms > t->max) {
+        t->max = ms;
+    }
+    t->last = ms;
+    t->sum += ms;
+    t->count++;
+    portEXIT_CRITICAL_SAFE(&s_metrics_lock);
+}
+
+int32_t metrics_record_since(metric_timer_t timer, metric_mark_t mark) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&s_metrics_lock);
+    int64_t start = s_marks_us[mark];
+    portEXIT_CRITICAL_SAFE(&s_metrics_lock);
+
+    if (start == 0) {
+        return -1;
+    }
+    uint32_t ms = (uint32_t)((now - start) / 1000);
+    metrics_record_ms(timer, ms);
+    return (int32_t)ms;
+}
+
+void metrics_inc(metric_counter_t counter) {
+    metrics_add(counter, 1);
+}
+
+void metrics_add(metric_counter_t counter, uint32_t n) {
+    portENTER_CRITICAL_SAFE(&s_metrics_lock);
+    s_counters[counter] += n;
+    portEXIT_CRITICAL_SAFE(&s_metrics_lock);
+}
+
+metric_timer_stat_t metrics_get_timer(metric_timer_t timer) {
+    portENTER_CRITICAL_SAFE(&s_metrics_lock);
+    metric_timer_stat_t copy = s_timers[timer];
+    portEXIT_CRITICAL_SAFE(&s_metrics_lock);
+    return copy;
+}
+
+uint32_t metrics_get_counter(metric_counter_t counter) {
+    portENTER_CRITICAL_SAFE(&s_metrics_lock);
+    uint32_t value = s_counters[counter];
+    portEXIT_CRITICAL_SAFE(&s_metrics_lock);
+    return value;
+}
+
+void metrics_log_summary(void) {
+    ESP_LOGI(TAG, "===== metrics =====");
+    for (int i = 0; i < METRIC_TIMER_COUNT; i++) {
+        metric_timer_stat_t t = metrics_get_timer((metric_timer_t)i);
+        if (t.count == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-16s n=%lu last=%lums min=%lums max=%lums avg=%lums",
+                 s_timer_names[i], (unsigned long)t.count, (unsigned long)t.last,
+                 (unsigned long)t.min, (unsigned long)t.max, (unsigned long)(t.sum / t.count));
+    }
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        ESP_LOGI(TAG, "  %-16s %lu", s_counter_names[i], (unsigned long)metrics_get_counter((metric_counter_t)i));
+    }
+}
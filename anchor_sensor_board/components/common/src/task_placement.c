@@ -0,0 +1,82 @@
+// task_placement.c
+
+#include "task_placement.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+
+static const char *TAG = "TASK_PLACE";
+
+#if CONFIG_TASK_PLACEMENT_PINNED
+#define CORE(n) (n)
+#else
+#define CORE(n) tskNO_AFFINITY
+#endif
+
+typedef struct {
+    const char *name;
+    uint32_t stack;             // bytes
+    UBaseType_t priority;
+    BaseType_t core;
+} task_placement_t;
+
+static const task_placement_t s_table[TASK_ID_COUNT] = {
+    [TASK_ID_SENSOR_PUBLISH] = { "sensor_publish_task", CONFIG_TASK_STACK_SENSOR_PUBLISH, 5, CORE(CONFIG_TASK_CORE_SENSOR_PUBLISH) },
+    [TASK_ID_MQTT_OUTBOX]    = { "mqtt_outbox",         CONFIG_TASK_STACK_MQTT_OUTBOX,    5, CORE(CONFIG_TASK_CORE_MQTT_OUTBOX) },
+    [TASK_ID_ANCHOR_STATUS]  = { "anchor_status",       CONFIG_TASK_STACK_ANCHOR_STATUS,  5, CORE(CONFIG_TASK_CORE_ANCHOR_STATUS) },
+    [TASK_ID_WIFI_MGR]       = { "wifi_mgr",            CONFIG_TASK_STACK_WIFI_MGR,       6, CORE(CONFIG_TASK_CORE_WIFI_MGR) },
+    [TASK_ID_SNTP]           = { "sntp",                CONFIG_TASK_STACK_SNTP,           4, CORE(CONFIG_TASK_CORE_SNTP) },
+};
+
+static TaskHandle_t s_handles[TASK_ID_COUNT];
+
+BaseType_t task_placement_create(task_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *out_handle) {
+    const task_placement_t *p = &s_table[id];
+    TaskHandle_t handle = NULL;
+    BaseType_t ret = xTaskCreatePinnedToCore(fn, p->name, p->stack, arg, p->priority, &handle, p->core);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "%s 생성 실패 (stack %lu)", p->name, (unsigned long)p->stack);
+        return ret;
+    }
+    s_handles[id] = handle;
+    if (out_handle != NULL) {
+        *out_handle = handle;
+    }
+    ESP_LOGD(TAG, "%s: core %d, prio %u, stack %lu", p->name, (int)(p->core == tskNO_AFFINITY ? -1 : p->core),
+             (unsigned)p->priority, (unsigned long)p->stack);
+    return ret;
+}
+
+void task_placement_forget(task_id_t id) {
+    s_handles[id] = NULL;
+}
+
+const char *task_placement_name(task_id_t id) {
+    return s_table[id].name;
+}
+
+uint32_t task_placement_check_stacks(void) {
+    uint32_t min_free = UINT32_MAX;
+
+    for (int i = 0; i < TASK_ID_COUNT; i++) {
+        TaskHandle_t handle = s_handles[i];
+        if (handle == NULL) {
+            continue;
+        }
+        // ESP-IDF에서 StackType_t는 1바이트이므로 high-water mark는 bytes 단위
+        uint32_t free_bytes = (uint32_t)uxTaskGetStackHighWaterMark(handle);
+        uint32_t used = s_table[i].stack > free_bytes ? s_table[i].stack - free_bytes : 0;
+        uint32_t suggest = (used + CONFIG_TASK_STACK_MARGIN + 255) & ~255u;
+        if (free_bytes < min_free) {
+            min_free = free_bytes;
+        }
+
+        if (free_bytes < CONFIG_TASK_STACK_MARGIN) {
+            ESP_LOGW(TAG, "  %-20s stack %5lu used %5lu free %5lu → 권장 %lu (여유 부족)", s_table[i].name,
+                     (unsigned long)s_table[i].stack, (unsigned long)used, (unsigned long)free_bytes, (unsigned long)suggest);
+        } else {
+            ESP_LOGI(TAG, "  %-20s stack %5lu used %5lu free %5lu → 권장 %lu", s_table[i].name,
+                     (unsigned long)s_table[i].stack, (unsigned long)used, (unsigned long)free_bytes, (unsigned long)suggest);
+        }
+    }
+    return min_free;
+}
@@ -0,0 +1,406 @@
+// wifi_manager.c
+
+#include "wifi_manager.h"
+#include "app_init.h"
+#include "metrics.h"
+#include "task_placement.h"
+
+#include <string.h>
+#include "esp_wifi.h"
+#include "esp_log.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+static const char *TAG = "WIFI_MGR";
+
+#define WIFI_MGR_NVS_NAMESPACE "wifi_mgr"
+#define WIFI_MGR_NVS_KEY_AP    "ap"
+#define WIFI_MGR_CACHE_RETRIES 2        // 캐시된 AP로 연속 실패 허용 횟수
+
+// 이벤트 핸들러 → 관리 태스크 메시지
+typedef enum {
+    WM_MSG_STA_START,
+    WM_MSG_CONNECTED,
+    WM_MSG_DISCONNECTED,
+    WM_MSG_GOT_IP,
+    WM_MSG_LOST_IP,
+} wm_msg_type_t;
+
+typedef struct {
+    wm_msg_type_t type;
+    union {
+        struct {
+            uint8_t bssid[6];
+            uint8_t channel;
+        } connected;
+        uint8_t reason;
+        esp_netif_ip_info_t ip_info;
+    };
+} wm_msg_t;
+
+// NVS에 저장되는 AP 캐시
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t valid;
+} wm_ap_cache_t;
+
+typedef enum {
+    WM_STATE_IDLE,
+    WM_STATE_CONNECTING,
+    WM_STATE_ASSOCIATED,    // L2 연결, IP 대기
+    WM_STATE_ONLINE,
+    WM_STATE_BACKOFF,
+} wm_state_t;
+
+static QueueHandle_t s_msg_queue = NULL;
+static esp_netif_t *s_sta_netif = NULL;
+static wm_ap_cache_t s_ap_cache;
+static bool s_use_cache = false;
+static wm_state_t s_state = WM_STATE_IDLE;
+static uint32_t s_attempts = 0;             // 연속 실패 횟수
+static int64_t s_retry_at_us = 0;
+static volatile bool s_online = false;
+static bool s_outage_pending = false;      // 끊김 후 아직 IP를 다시 받지 못함
+
+// ---- NVS 캐시 ----
+
+static void ap_cache_load(void) {
+    memset(&s_ap_cache, 0, sizeof(s_ap_cache));
+#if CONFIG_WIFI_MGR_CACHE_AP
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_MGR_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    size_t len = sizeof(s_ap_cache);
+    if (nvs_get_blob(nvs, WIFI_MGR_NVS_KEY_AP, &s_ap_cache, &len) != ESP_OK || len != sizeof(s_ap_cache)) {
+        memset(&s_ap_cache, 0, sizeof(s_ap_cache));
+    }
+    nvs_close(nvs);
+#endif
+}
+
+static void ap_cache_save(const uint8_t bssid[6], uint8_t channel) {
+#if CONFIG_WIFI_MGR_CACHE_AP
+    if (s_ap_cache.valid && s_ap_cache.channel == channel && memcmp(s_ap_cache.bssid, bssid, 6) == 0) {
+        return;     // 변경 없음 - 플래시 쓰기 생략
+    }
+    memcpy(s_ap_cache.bssid, bssid, 6);
+    s_ap_cache.channel = channel;
+    s_ap_cache.valid = 1;
+
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_MGR_NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        nvs_set_blob(nvs, WIFI_MGR_NVS_KEY_AP, &s_ap_cache, sizeof(s_ap_cache));
+        nvs_commit(nvs);
+        nvs_close(nvs);
+        ESP_LOGI(TAG, "AP 캐시 저장: " MACSTR " ch%d", MAC2STR(bssid), channel);
+    }
+#endif
+}
+
+static void ap_cache_invalidate(void) {
+    s_ap_cache.valid = 0;
+    s_use_cache = false;
+#if CONFIG_WIFI_MGR_CACHE_AP
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_MGR_NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        nvs_erase_key(nvs, WIFI_MGR_NVS_KEY_AP);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+#endif
+}
+
+// ---- DNS ----
+
+// DHCP가 DNS를 주지 않은 경우 게이트웨이 / 8.8.8.8 / 1.1.1.1 주입
+static void ensure_dns_servers(const esp_netif_ip_info_t *ip_info) {
+    esp_netif_dns_info_t curr = {0};
+    if (esp_netif_get_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &curr) == ESP_OK) {
+        bool need_inject = (curr.ip.type != ESP_IPADDR_TYPE_V4) || (curr.ip.u_addr.ip4.addr == 0);
+
+        if (need_inject) {
+            // 1) 메인 DNS = 게이트웨이
+            esp_netif_dns_info_t d1 = {0};
+            d1.ip.type = ESP_IPADDR_TYPE_V4;
+            d1.ip.u_addr.ip4.addr = ip_info->gw.addr;
+
+            // 2) 백업 DNS = 8.8.8.8
+            esp_netif_dns_info_t d2 = {0};
+            d2.ip.type = ESP_IPADDR_TYPE_V4;
+            IP4_ADDR(&d2.ip.u_addr.ip4, 8, 8, 8, 8);
+
+            // 3) 폴백 DNS = 1.1.1.1
+            esp_netif_dns_info_t d3 = {0};
+            d3.ip.type = ESP_IPADDR_TYPE_V4;
+            IP4_ADDR(&d3.ip.u_addr.ip4, 1, 1, 1, 1);
+
+            esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &d1);
+            esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_BACKUP, &d2);
+            esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_FALLBACK, &d3);
+            ESP_LOGI(TAG, "DNS 주입 완료");
+        }
+    }
+
+    esp_netif_dns_info_t main_dns = {0};
+    if (esp_netif_get_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &main_dns) == ESP_OK) {
+        ESP_LOGI(TAG, "Main DNS: " IPSTR, IP2STR(&main_dns.ip.u_addr.ip4));
+    }
+}
+
+#if CONFIG_WIFI_MGR_STATIC_IP
+static void apply_static_ip(void) {
+    esp_netif_ip_info_t ip_info = {0};
+    ip_info.ip.addr = esp_ip4addr_aton(CONFIG_WIFI_MGR_STATIC_IP_ADDR);
+    ip_info.netmask.addr = esp_ip4addr_aton(CONFIG_WIFI_MGR_STATIC_NETMASK);
+    ip_info.gw.addr = esp_ip4addr_aton(CONFIG_WIFI_MGR_STATIC_GW);
+
+    esp_netif_dhcpc_stop(s_sta_netif);
+    ESP_ERROR_CHECK(esp_netif_set_ip_info(s_sta_netif, &ip_info));
+
+    esp_netif_dns_info_t dns = {0};
+    dns.ip.type = ESP_IPADDR_TYPE_V4;
+    dns.ip.u_addr.ip4.addr = esp_ip4addr_aton(CONFIG_WIFI_MGR_STATIC_DNS);
+    esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+
+    ESP_LOGI(TAG, "고정 IP 사용: %s", CONFIG_WIFI_MGR_STATIC_IP_ADDR);
+}
+#endif
+
+// ---- 연결 제어 (관리 태스크 전용) ----
+
+static uint32_t backoff_delay_ms(uint32_t attempts) {
+    uint32_t delay = CONFIG_WIFI_MGR_BACKOFF_MIN_MS;
+    for (uint32_t i = 1; i < attempts && delay < CONFIG_WIFI_MGR_BACKOFF_MAX_MS; i++) {
+        delay *= 2;
+    }
+    if (delay > CONFIG_WIFI_MGR_BACKOFF_MAX_MS) {
+        delay = CONFIG_WIFI_MGR_BACKOFF_MAX_MS;
+    }
+    // 여러 기기가 동시에 재접속하지 않도록 최대 25% 지터
+    return delay + esp_random() % (delay / 4 + 1);
+}
+
+// 실패 1회를 세고 백오프 상태로 (캐시 AP로 여러 번 실패하면 전체 스캔으로 전환)
+// @return 다음 시도까지 대기 시간 (ms)
+static uint32_t enter_backoff(void) {
+    s_attempts++;
+    if (s_use_cache && s_attempts >= WIFI_MGR_CACHE_RETRIES) {
+        ESP_LOGW(TAG, "캐시된 AP로 연결 실패 %lu회 - 전체 스캔으로 전환", (unsigned long)s_attempts);
+        metrics_inc(METRIC_WIFI_CACHE_MISSES);
+        ap_cache_invalidate();
+    }
+
+    uint32_t delay = backoff_delay_ms(s_attempts);
+    s_retry_at_us = esp_timer_get_time() + (int64_t)delay * 1000;
+    s_state = WM_STATE_BACKOFF;
+    return delay;
+}
+
+static void start_connect(void) {
+    wifi_config_t cfg = {0};
+    esp_wifi_get_config(WIFI_IF_STA, &cfg);
+
+    if (s_use_cache && s_ap_cache.valid) {
+        // 캐시된 AP로 바로 접속 (해당 채널만 스캔)
+        cfg.sta.bssid_set = true;
+        memcpy(cfg.sta.bssid, s_ap_cache.bssid, 6);
+        cfg.sta.channel = s_ap_cache.channel;
+        cfg.sta.scan_method = WIFI_FAST_SCAN;
+        ESP_LOGI(TAG, "연결 시도 (캐시: " MACSTR " ch%d)", MAC2STR(s_ap_cache.bssid), s_ap_cache.channel);
+    } else {
+        cfg.sta.bssid_set = false;
+        cfg.sta.channel = 0;
+        cfg.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+        cfg.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
+        ESP_LOGI(TAG, "연결 시도 (전체 스캔, SSID: %s)", CONFIG_WIFI_MGR_SSID);
+    }
+    esp_wifi_set_config(WIFI_IF_STA, &cfg);
+
+    metrics_mark(METRIC_MARK_WIFI_CONNECT_REQ);
+    s_state = WM_STATE_CONNECTING;
+    esp_err_t err = esp_wifi_connect();
+    if (err != ESP_OK) {
+        // 연결 요청 자체가 실패하면 끊김 이벤트가 오지 않으므로 여기서 재시도를 건다
+        uint32_t delay = enter_backoff();
+        ESP_LOGW(TAG, "esp_wifi_connect 실패: %s → %lums 후 재시도 (%lu회째)",
+                 esp_err_to_name(err), (unsigned long)delay, (unsigned long)s_attempts);
+    }
+}
+
+static void handle_msg(const wm_msg_t *msg) {
+    switch (msg->type) {
+        case WM_MSG_STA_START:
+            start_connect();
+            break;
+
+        case WM_MSG_CONNECTED:
+            s_state = WM_STATE_ASSOCIATED;
+            metrics_mark(METRIC_MARK_WIFI_ASSOC);
+            ESP_LOGI(TAG, "AP 연결 성공 (" MACSTR " ch%d, %ldms)", MAC2STR(msg->connected.bssid),
+                     msg->connected.channel, (long)metrics_record_since(METRIC_WIFI_ASSOC_MS, METRIC_MARK_WIFI_CONNECT_REQ));
+            if (s_use_cache) {
+                metrics_inc(METRIC_WIFI_CACHE_HITS);
+            }
+            ap_cache_save(msg->connected.bssid, msg->connected.channel);
+            break;
+
+        case WM_MSG_DISCONNECTED:
+            if (s_online) {
+                metrics_mark(METRIC_MARK_WIFI_LOST);
+                s_outage_pending = true;
+                metrics_inc(METRIC_WIFI_DISCONNECTS);
+            }
+            s_online = false;
+            app_init_clear(APP_INIT_NET_UP);
+
+            uint32_t delay = enter_backoff();
+            ESP_LOGW(TAG, "연결 끊김 reason=%d → %lums 후 재시도 (%lu회째)",
+                     msg->reason, (unsigned long)delay, (unsigned long)s_attempts);
+            break;
+
+        case WM_MSG_GOT_IP:
+            ESP_LOGI(TAG, "IP 할당 완료: " IPSTR ", GW: " IPSTR " (DHCP %ldms)",
+                     IP2STR(&msg->ip_info.ip), IP2STR(&msg->ip_info.gw),
+                     (long)metrics_record_since(METRIC_WIFI_DHCP_MS, METRIC_MARK_WIFI_ASSOC));
+            if (s_outage_pending) {
+                ESP_LOGI(TAG, "재연결 완료 (중단 %ldms)", (long)metrics_record_since(METRIC_WIFI_OUTAGE_MS, METRIC_MARK_WIFI_LOST));
+                s_outage_pending = false;
+            }
+            ensure_dns_servers(&msg->ip_info);
+
+            s_attempts = 0;
+            s_state = WM_STATE_ONLINE;
+            s_online = true;
+#if CONFIG_WIFI_MGR_CACHE_AP
+            s_use_cache = true;     // 다음 재연결부터 캐시 사용
+#endif
+            app_init_signal(APP_INIT_NET_UP);
+            break;
+
+        case WM_MSG_LOST_IP:
+            ESP_LOGW(TAG, "IP 분실");
+            s_online = false;
+            app_init_clear(APP_INIT_NET_UP);
+            break;
+    }
+}
+
+static void wifi_manager_task(void *pvParameters) {
+    wm_msg_t msg;
+
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+        if (s_state == WM_STATE_BACKOFF) {
+            int64_t remain_us = s_retry_at_us - esp_timer_get_time();
+            wait = remain_us > 0 ? pdMS_TO_TICKS(remain_us / 1000) + 1 : 0;
+        }
+
+        if (xQueueReceive(s_msg_queue, &msg, wait) == pdTRUE) {
+            handle_msg(&msg);
+        } else if (s_state == WM_STATE_BACKOFF) {
+            start_connect();
+        }
+    }
+}
+
+// ---- 이벤트 핸들러: 큐에 넣기만 한다 ----
+
+static void wifi_event_handler(void *arg, esp_event_base_t event_base,
+                               int32_t event_id, void *event_data) {
+    wm_msg_t msg = {0};
+
+    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        msg.type = WM_MSG_STA_START;
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        wifi_event_sta_connected_t *ev = (wifi_event_sta_connected_t *)event_data;
+        msg.type = WM_MSG_CONNECTED;
+        memcpy(msg.connected.bssid, ev->bssid, 6);
+        msg.connected.channel = ev->channel;
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        wifi_event_sta_disconnected_t *ev = (wifi_event_sta_disconnected_t *)event_data;
+        msg.type = WM_MSG_DISCONNECTED;
+        msg.reason = ev->reason;
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        ip_event_got_ip_t *ev = (ip_event_got_ip_t *)event_data;
+        msg.type = WM_MSG_GOT_IP;
+        msg.ip_info = ev->ip_info;
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_LOST_IP) {
+        msg.type = WM_MSG_LOST_IP;
+    } else {
+        return;
+    }
+
+    if (xQueueSend(s_msg_queue, &msg, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "이벤트 큐 가득 참 (type=%d)", msg.type);
+    }
+}
+
+esp_err_t wifi_manager_start(void) {
+    if (s_msg_queue != NULL) {
+        return ESP_OK;
+    }
+
+    s_msg_queue = xQueueCreate(8, sizeof(wm_msg_t));
+    if (s_msg_queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ap_cache_load();
+    s_use_cache = s_ap_cache.valid;
+
+    // 네트워크 인터페이스 초기화
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+    s_sta_netif = esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+
+    // 이벤트 핸들러 등록
+    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_STA_LOST_IP, &wifi_event_handler, NULL));
+
+#if CONFIG_WIFI_MGR_STATIC_IP
+    apply_static_ip();
+#endif
+
+    // Wi-Fi 설정
+    wifi_config_t wifi_config = {
+        .sta = {
+            .threshold.authmode = WIFI_AUTH_WPA2_PSK, // WPA2 이상만 연결
+            .failure_retry_cnt = 0,                   // 재시도는 관리 태스크의 백오프로 처리
+        },
+    };
+    strncpy((char *)wifi_config.sta.ssid, CONFIG_WIFI_MGR_SSID, sizeof(wifi_config.sta.ssid));
+    strncpy((char *)wifi_config.sta.password, CONFIG_WIFI_MGR_PASSWORD, sizeof(wifi_config.sta.password));
+
+    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+
+    if (task_placement_create(TASK_ID_WIFI_MGR, wifi_manager_task, NULL, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "wifi_mgr 태스크 생성 실패");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Wi-Fi 시작 (STA_START 이벤트에서 첫 연결)
+    ESP_ERROR_CHECK(esp_wifi_start());
+    ESP_LOGI(TAG, "Wi-Fi 관리자 시작 (AP 캐시: %s)", s_use_cache ? "있음" : "없음");
+    return ESP_OK;
+}
+
+bool wifi_manager_is_connected(void) {
+    return s_online;
+}
+
+void wifi_manager_forget_ap(void) {
+    ap_cache_invalidate();
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+// 지연(deferred) 바이너리 로그
+//
+// DLOGx()는 호출 지점에서 문자열 포맷팅을 하지 않는다. 로그 위치(site) 디스크립터의
+// 주소를 ID로 사용하고, 인자는 32비트 워드로 그대로 링 버퍼에 복사한다.
+// 링 버퍼는 낮은 우선순위의 dlog 태스크가 "#DL:" 헥스 라인으로 콘솔에 내보내며,
+// 호스트의 tools/dlog_decode.py가 ELF에서 태그/포맷 문자열을 찾아 메시지를 복원한다.
+//
+// 사용 규칙
+//  - tag는 `static const char *TAG = "...";` 처럼 주소를 취할 수 있는 변수여야 한다.
+//  - %s 인자는 상수 문자열(플래시의 .rodata)만 허용한다. 스택 버퍼는 디코더가 읽을 수 없다.
+//  - 인자는 최대 DLOG_MAX_ARGS개, 64비트 값은 워드 2개를 차지한다.
+//  - 파일별 컴파일 타임 레벨은 include 전에 DLOG_LOCAL_LEVEL을 정의해서 지정한다.
+//    레벨보다 상세한 호출은 코드에서 완전히 제거된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DLOG_LEVEL_NONE    0
+#define DLOG_LEVEL_ERROR   1
+#define DLOG_LEVEL_WARN    2
+#define DLOG_LEVEL_INFO    3
+#define DLOG_LEVEL_DEBUG   4
+#define DLOG_LEVEL_VERBOSE 5
+
+#ifndef DLOG_LOCAL_LEVEL
+#define DLOG_LOCAL_LEVEL CONFIG_DLOG_DEFAULT_LEVEL
+#endif
+
+#define DLOG_MAX_ARGS  8
+#define DLOG_MAX_WORDS 8
+
+// 인자 타입 태그 (인자당 2비트, 디코더가 워드 수를 알기 위해 사용)
+#define DLOG_ARG_U32 0
+#define DLOG_ARG_F32 1
+#define DLOG_ARG_U64 2
+#define DLOG_ARG_STR 3
+
+/**
+ * @brief 로그 위치 디스크립터 (플래시 .rodata에 위치, 주소가 곧 로그 ID)
+ *
+ * 디코더가 ELF에서 그대로 읽으므로 레이아웃을 바꾸면 tools/dlog_decode.py도 함께 수정해야 한다.
+ */
+typedef struct {
+    uint8_t level;
+    uint8_t reserved;
+    uint16_t line;
+    const char *const *tag;   // TAG 변수의 주소
+    const char *fmt;
+} dlog_site_t;
+
+/**
+ * @brief 호출 지점 스택에서 조립되는 레코드
+ */
+typedef struct {
+    const dlog_site_t *site;
+    uint16_t types;
+    uint8_t nargs;
+    uint8_t nwords;
+    uint32_t words[DLOG_MAX_WORDS];
+} dlog_record_t;
+
+/**
+ * @brief dlog 드레인 태스크 시작 (app_main 초반에 1회 호출)
+ *
+ * 링 버퍼 자체는 정적 초기화로 동작하므로 이 함수 호출 이전의 로그도 보존된다.
+ */
+void dlog_init(void);
+
+/**
+ * @brief 레코드를 링 버퍼에 넣는다 (lock-free, ISR/멀티코어 안전)
+ * @return 버퍼가 가득 차서 버려진 경우 false
+ */
+bool dlog_write(const dlog_record_t *rec);
+
+/**
+ * @brief 버퍼 포화로 버려진 레코드 수
+ */
+uint32_t dlog_get_dropped(void);
+
+// ---- 인자 패킹 (내부용) ----
+
+static inline void dlog_put(dlog_record_t *r, uint32_t type, const uint32_t *w, unsigned n) {
+    if (r->nargs >= DLOG_MAX_ARGS || r->nwords + n > DLOG_MAX_WORDS) {
+        return;
+    }
+    r->types |= (uint16_t)(type << (2 * r->nargs));
+    r->nargs++;
+    for (unsigned i = 0; i < n; i++) {
+        r->words[r->nwords++] = w[i];
+    }
+}
+
+static inline void dlog_arg_u32(dlog_record_t *r, uint32_t v) {
+    dlog_put(r, DLOG_ARG_U32, &v, 1);
+}
+
+static inline void dlog_arg_f32(dlog_record_t *r, double v) {
+    float f = (float)v;
+    uint32_t w;
+    memcpy(&w, &f, sizeof(w));
+    dlog_put(r, DLOG_ARG_F32, &w, 1);
+}
+
+static inline void dlog_arg_u64(dlog_record_t *r, uint64_t v) {
+    uint32_t w[2] = { (uint32_t)v, (uint32_t)(v >> 32) };
+    dlog_put(r, DLOG_ARG_U64, w, 2);
+}
+
+static inline void dlog_arg_str(dlog_record_t *r, const char *s) {
+    uint32_t w = (uint32_t)(uintptr_t)s;
+    dlog_put(r, DLOG_ARG_STR, &w, 1);
+}
+
+static inline void dlog_arg_ptr(dlog_record_t *r, const void *p) {
+    dlog_arg_u32(r, (uint32_t)(uintptr_t)p);
+}
+
+#define DLOG_ARG(r, x) _Generic((x),                        \
+    float: dlog_arg_f32, double: dlog_arg_f32,              \
+    int64_t: dlog_arg_u64, uint64_t: dlog_arg_u64,          \
+    char *: dlog_arg_str, const char *: dlog_arg_str,       \
+    void *: dlog_arg_ptr, const void *: dlog_arg_ptr,       \
+    default: dlog_arg_u32)((r), (x))
+
+#define DLOG_NARG(...)  DLOG_NARG_(_0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARG_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define DLOG_CAT(a, b)  DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b) a##b
+
+#define DLOG_PUSH_ALL(r, ...) DLOG_CAT(DLOG_PUSH_, DLOG_NARG(__VA_ARGS__))(r, ##__VA_ARGS__)
+#define DLOG_PUSH_0(r)
+#define DLOG_PUSH_1(r, a)      DLOG_ARG(r, a);
+#define DLOG_PUSH_2(r, a, ...) DLOG_ARG(r, a); DLOG_PUSH_1(r, __VA_ARGS__)
+#define DLOG_PUSH_3(r, a, ...) DLOG_ARG(r, a); DLOG_PUSH_2(r, __VA_ARGS__)
+#define DLOG_PUSH_4(r, a, ...) DLOG_ARG(r, a); DLOG_PUSH_3(r, __VA_ARGS__)
+#define DLOG_PUSH_5(r, a, ...) DLOG_ARG(r, a); DLOG_PUSH_4(r, __VA_ARGS__)
+#define DLOG_PUSH_6(r, a, ...) DLOG_ARG(r, a); DLOG_PUSH_5(r, __VA_ARGS__)
+#define DLOG_PUSH_7(r, a, ...) DLOG_ARG(r, a); DLOG_PUSH_6(r, __VA_ARGS__)
+#define DLOG_PUSH_8(r, a, ...) DLOG_ARG(r, a); DLOG_PUSH_7(r, __VA_ARGS__)
+
+// printf 포맷 검사용 (호출되지 않음)
+static inline void __attribute__((format(printf, 1, 2))) dlog_format_check(const char *fmt, ...) {
+    (void)fmt;
+}
+
+#define DLOG_DISABLED(tag, fmt, ...) do {                   \
+    if (0) {                                                \
+        (void)(tag);                                        \
+        dlog_format_check(fmt, ##__VA_ARGS__);              \
+    }                                                       \
+} while (0)
+
+#if CONFIG_DLOG_ENABLE
+#define DLOG_AT(lvl, tag, fmt, ...) do {                                        \
+    static const dlog_site_t _dlog_site = { (lvl), 0, __LINE__, &(tag), (fmt) }; \
+    dlog_record_t _dlog_rec = { .site = &_dlog_site };                          \
+    if (0) {                                                                    \
+        dlog_format_check(fmt, ##__VA_ARGS__);                                  \
+    }                                                                           \
+    DLOG_PUSH_ALL(&_dlog_rec, ##__VA_ARGS__)                                    \
+    dlog_write(&_dlog_rec);                                                     \
+} while (0)
+#else
+#define DLOG_AT(lvl, tag, fmt, ...) \
+    ESP_LOG_LEVEL((esp_log_level_t)(lvl), tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if DLOG_LOCAL_LEVEL >= DLOG_LEVEL_ERROR
+#define DLOGE(tag, fmt, ...) DLOG_AT(DLOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__)
+#else
+#define DLOGE(tag, fmt, ...) DLOG_DISABLED(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if DLOG_LOCAL_LEVEL >= DLOG_LEVEL_WARN
+#define DLOGW(tag, fmt, ...) DLOG_AT(DLOG_LEVEL_WARN, tag, fmt, ##__VA_ARGS__)
+#else
+#define DLOGW(tag, fmt, ...) DLOG_DISABLED(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if DLOG_LOCAL_LEVEL >= DLOG_LEVEL_INFO
+#define DLOGI(tag, fmt, ...) DLOG_AT(DLOG_LEVEL_INFO, tag, fmt, ##__VA_ARGS__)
+#else
+#define DLOGI(tag, fmt, ...) DLOG_DISABLED(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if DLOG_LOCAL_LEVEL >= DLOG_LEVEL_DEBUG
+#define DLOGD(tag, fmt, ...) DLOG_AT(DLOG_LEVEL_DEBUG, tag, fmt, ##__VA_ARGS__)
+#else
+#define DLOGD(tag, fmt, ...) DLOG_DISABLED(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if DLOG_LOCAL_LEVEL >= DLOG_LEVEL_VERBOSE
+#define DLOGV(tag, fmt, ...) DLOG_AT(DLOG_LEVEL_VERBOSE, tag, fmt, ##__VA_ARGS__)
+#else
+#define DLOGV(tag, fmt, ...) DLOG_DISABLED(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
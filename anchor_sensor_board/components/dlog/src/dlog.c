@@ -0,0 +1,151 @@
+#include "dlog.h"
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+
+#if CONFIG_DLOG_ENABLE
+
+static const char *TAG = "DLOG";
+
+#define DLOG_SLOTS     CONFIG_DLOG_RING_SLOTS
+#define DLOG_SLOT_MASK (DLOG_SLOTS - 1)
+
+_Static_assert((DLOG_SLOTS & DLOG_SLOT_MASK) == 0, "CONFIG_DLOG_RING_SLOTS must be a power of two");
+
+// 링 버퍼 슬롯 (48 bytes)
+// seq는 "기대 시퀀스 - 슬롯 인덱스"로 저장한다. 덕분에 0으로 초기화된 .bss 상태가 곧
+// 빈 버퍼이며 dlog_init() 이전의 로그도 안전하게 기록된다.
+typedef struct {
+    atomic_uint seq;
+    uint32_t timestamp_ms;
+    const dlog_site_t *site;
+    uint16_t types;
+    uint8_t nargs;
+    uint8_t nwords;
+    uint32_t words[DLOG_MAX_WORDS];
+} dlog_slot_t;
+
+static dlog_slot_t s_slots[DLOG_SLOTS];
+static atomic_uint s_enqueue_pos;
+static unsigned s_dequeue_pos;      // 드레인 태스크 전용
+static atomic_uint s_dropped;
+static TaskHandle_t s_drain_task = NULL;
+
+bool dlog_write(const dlog_record_t *rec) {
+    unsigned pos = atomic_load_explicit(&s_enqueue_pos, memory_order_relaxed);
+    dlog_slot_t *slot;
+
+    // 다중 생산자 / 단일 소비자 bounded queue (Vyukov)
+    for (;;) {
+        slot = &s_slots[pos & DLOG_SLOT_MASK];
+        unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire) + (pos & DLOG_SLOT_MASK);
+        int diff = (int)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&s_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 버퍼 포화: 호출 지점을 막지 않고 버린다
+            atomic_fetch_add_explicit(&s_dropped, 1, memory_order_relaxed);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&s_enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->timestamp_ms = esp_log_timestamp();
+    slot->site = rec->site;
+    slot->types = rec->types;
+    slot->nargs = rec->nargs;
+    slot->nwords = rec->nwords;
+    memcpy(slot->words, rec->words, rec->nwords * sizeof(uint32_t));
+
+    atomic_store_explicit(&slot->seq, (pos + 1) - (pos & DLOG_SLOT_MASK), memory_order_release);
+    return true;
+}
+
+uint32_t dlog_get_dropped(void) {
+    return atomic_load_explicit(&s_dropped, memory_order_relaxed);
+}
+
+// 슬롯 하나를 꺼내 "#DL:" 헥스 라인으로 출력
+static bool drain_one(void) {
+    unsigned pos = s_dequeue_pos;
+    dlog_slot_t *slot = &s_slots[pos & DLOG_SLOT_MASK];
+    unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire) + (pos & DLOG_SLOT_MASK);
+    if ((int)(seq - (pos + 1)) < 0) {
+        return false;   // 비어 있음
+    }
+
+    // 라인: ts(8) site(8) types(4) nargs(2) nwords(2) words(8 * n)
+    char line[8 + 4 + 8 + 4 + 2 + 2 + 8 * DLOG_MAX_WORDS + 2];
+    int len = snprintf(line, sizeof(line), "#DL:%08lx%08lx%04x%02x%02x",
+                       (unsigned long)slot->timestamp_ms,
+                       (unsigned long)(uintptr_t)slot->site,
+                       slot->types, slot->nargs, slot->nwords);
+    for (int i = 0; i < slot->nwords && len < (int)sizeof(line); i++) {
+        len += snprintf(line + len, sizeof(line) - len, "%08lx", (unsigned long)slot->words[i]);
+    }
+
+    // 슬롯 반납
+    atomic_store_explicit(&slot->seq, (pos + DLOG_SLOTS) - (pos & DLOG_SLOT_MASK), memory_order_release);
+    s_dequeue_pos = pos + 1;
+
+    puts(line);
+    return true;
+}
+
+static void dlog_drain_task(void *pvParameters) {
+    uint32_t reported_dropped = 0;
+
+    printf("#DL-BOOT\n");
+
+    while (1) {
+        while (drain_one()) {
+            // 연속으로 비움
+        }
+
+        uint32_t dropped = dlog_get_dropped();
+        if (dropped != reported_dropped) {
+            printf("#DL-DROP:%lu\n", (unsigned long)dropped);
+            reported_dropped = dropped;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_DLOG_DRAIN_PERIOD_MS));
+    }
+}
+
+void dlog_init(void) {
+    if (s_drain_task != NULL) {
+        return;
+    }
+
+    BaseType_t ret = xTaskCreate(dlog_drain_task, "dlog", 3072, NULL,
+                                 CONFIG_DLOG_DRAIN_TASK_PRIORITY, &s_drain_task);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "dlog 태스크 생성 실패");
+        s_drain_task = NULL;
+        return;
+    }
+    ESP_LOGI(TAG, "지연 로그 시작 (슬롯: %d, 드레인 주기: %dms)", DLOG_SLOTS, CONFIG_DLOG_DRAIN_PERIOD_MS);
+}
+
+#else  // !CONFIG_DLOG_ENABLE
+
+void dlog_init(void) {
+}
+
+bool dlog_write(const dlog_record_t *rec) {
+    (void)rec;
+    return false;
+}
+
+uint32_t dlog_get_dropped(void) {
+    return 0;
+}
+
+#endif
@@ -8,4 +8,25 @@ esp_mqtt_client_handle_t mqtt_get_handle(void);  // 전역 핸들 제공
 
 bool mqtt_is_connected(void);
 
+// 전송 토픽 (이름은 Kconfig에 따라 sensor/<suffix> 또는 sensor/<device id>/<suffix>)
+typedef enum {
+    MQTT_TOPIC_SENSOR_DATA = 0,
+    MQTT_TOPIC_ALERT,       // 낙상/경보 이벤트
+    MQTT_TOPIC_DIAG,        // 진단 카운터
+    MQTT_TOPIC_COUNT
+} mqtt_topic_id_t;
+
+/**
+ * @brief 토픽 ID로 발행 (MQTT 5 모드에서는 토픽 별칭/메시지 만료/user property 적용)
+ * @note 발행 속성이 클라이언트 단위라 mqtt_outbox 전송 태스크에서만 호출한다
+ * @return msg_id, 실패 시 음수
+ */
+int mqtt_wrapper_publish(mqtt_topic_id_t topic, const char *payload, int len, int qos);
+
+// Kconfig 기기 ID (JSON 본문의 deviceId)
+const char *mqtt_wrapper_device_id(void);
+
+// 실제 토픽 문자열
+const char *mqtt_wrapper_topic_name(mqtt_topic_id_t topic);
+
 #endif
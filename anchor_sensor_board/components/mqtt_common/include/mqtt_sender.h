@@ -5,4 +5,7 @@
 
 void mqtt_send_influx_sensor_data(const influx_sensor_data_t* data);
 
+// metrics 카운터와 발행 대기열 상태를 진단 클래스로 전송
+void mqtt_send_diagnostics(void);
+
 #endif
@@ -1,8 +1,21 @@
 // mqtt_client_wrapper.c
 
 #include "mqtt_client_wrapper.h"
+#include "mqtt_outbox.h"
 #include "esp_log.h"
 #include "sntp_helper.h"
+#include "app_init.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#if CONFIG_APP_MQTT_PROTOCOL_5
+#include "mqtt5_client.h"
+#define MQTT_PROTOCOL_NAME "v5"
+#else
+#define MQTT_PROTOCOL_NAME "v3.1.1"
+#endif
+
+#define MQTT_BOARD_TYPE "anchor"
 
 // mqtt_client 전역 변수로 관리
 esp_mqtt_client_handle_t mqtt_client = NULL;
@@ -11,35 +24,152 @@ static const char *TAG = "MQTT";
 
 static bool mqtt_connected = false;
 
+// 토픽별 접미사, MQTT 5 토픽 별칭 번호 (1부터, 브로커 topic alias maximum 이내)와 메시지 만료 여부
+// (경보는 오프라인 구독자에게도 끝까지 전달되어야 하므로 만료시키지 않는다)
+typedef struct {
+    const char *suffix;
+    uint16_t alias;
+    bool expires;
+} mqtt_topic_def_t;
+
+static const mqtt_topic_def_t s_topic_defs[MQTT_TOPIC_COUNT] = {
+    [MQTT_TOPIC_SENSOR_DATA] = { "data", 1, true },
+    [MQTT_TOPIC_ALERT]       = { "alert", 2, false },
+    [MQTT_TOPIC_DIAG]        = { "diag", 3, true },
+};
+
+static char s_topic_names[MQTT_TOPIC_COUNT][64];
+static char s_client_id[48];
+
+#if CONFIG_APP_MQTT_PROTOCOL_5
+// 연결 세대: CONNECTED/DISCONNECTED마다 증가. 이벤트 핸들러는 publish 도중 같은 태스크에서
+// (쓰기 실패 → DISCONNECTED) 불릴 수 있으므로 락을 잡지 않고 이 값만 올린다.
+static atomic_uint s_conn_gen = 1;
+// 토픽별로 QoS 0 발행이 토픽-별칭 매핑을 보낸 연결 세대 (0이면 없음, 발행 태스크만 접근)
+static unsigned s_alias_gen[MQTT_TOPIC_COUNT];
+static mqtt5_user_property_handle_t s_user_props = NULL;
+#endif
+
 bool mqtt_is_connected(void) {
     return mqtt_connected;
 }
 
+const char *mqtt_wrapper_device_id(void) {
+    return CONFIG_APP_MQTT_DEVICE_ID;
+}
+
+const char *mqtt_wrapper_topic_name(mqtt_topic_id_t topic) {
+    return s_topic_names[topic];
+}
+
 // MQTT 이벤트 핸들러
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data) {
-    esp_mqtt_event_handle_t event = event_data;
-
     if (event_id == MQTT_EVENT_CONNECTED) {
+#if CONFIG_APP_MQTT_PROTOCOL_5
+        // 토픽 별칭은 연결 단위로만 유효하므로 세대를 올려 등록을 무효화
+        atomic_fetch_add(&s_conn_gen, 1);
+#endif
         mqtt_connected = true;
-        ESP_LOGI(TAG, "MQTT connected");
+        app_init_signal(APP_INIT_MQTT_UP);
+        ESP_LOGI(TAG, "MQTT connected (Wi-Fi 연결 후 %ldms)",
+                 (long)metrics_record_since(METRIC_WIFI_ASSOC_TO_MQTT_MS, METRIC_MARK_WIFI_ASSOC));
     } else if (event_id == MQTT_EVENT_DISCONNECTED) {
+#if CONFIG_APP_MQTT_PROTOCOL_5
+        atomic_fetch_add(&s_conn_gen, 1);
+#endif
         mqtt_connected = false;
+        app_init_clear(APP_INIT_MQTT_UP);
+        metrics_inc(METRIC_MQTT_DISCONNECTS);
         ESP_LOGW(TAG, "MQTT disconnected");
     }
+
+    esp_mqtt_event_handle_t event = event_data;
+    mqtt_outbox_handle_event((esp_mqtt_event_id_t)event_id, event->msg_id);
+}
+
+// 발행 속성 설정과 publish가 한 쌍이라 발행 태스크(mqtt_outbox) 하나에서만 호출한다.
+// esp-mqtt가 publish 안에서 이벤트를 동기로 보낼 수 있으므로 래퍼 락은 잡지 않는다.
+int mqtt_wrapper_publish(mqtt_topic_id_t topic, const char *payload, int len, int qos) {
+    if (mqtt_client == NULL || topic >= MQTT_TOPIC_COUNT) {
+        return -1;
+    }
+
+#if CONFIG_APP_MQTT_PROTOCOL_5
+    esp_mqtt5_publish_property_config_t property = {
+        .payload_format_indicator = true,   // UTF-8 (JSON)
+        .message_expiry_interval = s_topic_defs[topic].expires ? CONFIG_APP_MQTT_MESSAGE_EXPIRY_S : 0,
+        .topic_alias = s_topic_defs[topic].alias,
+        .content_type = "application/json",
+        .user_property = s_user_props,
+    };
+    esp_mqtt5_client_set_publish_property(mqtt_client, &property);
+
+    // 별칭 등록 후에는 빈 토픽 + 별칭만 보내 헤더 크기를 줄인다. QoS 1 이상은 esp-mqtt outbox에
+    // 직렬화된 채 남아 재연결 후(별칭이 등록되지 않은 새 연결에서) 재전송될 수 있으므로 항상 전체
+    // 토픽 이름을 별칭과 함께 보낸다 (브로커는 매핑을 다시 등록할 뿐이다).
+    // 발행 중에 연결이 바뀌면 세대가 달라져 다음 발행은 다시 전체 토픽 이름을 보낸다.
+    unsigned gen = atomic_load(&s_conn_gen);
+    const char *topic_name = (qos == 0 && s_alias_gen[topic] == gen) ? "" : s_topic_names[topic];
+    int msg_id = esp_mqtt_client_publish(mqtt_client, topic_name, payload, len, qos, 0);
+    if (qos == 0 && msg_id >= 0) {
+        s_alias_gen[topic] = gen;
+    }
+#else
+    int msg_id = esp_mqtt_client_publish(mqtt_client, s_topic_names[topic], payload, len, qos, 0);
+#endif
+    return msg_id;
+}
+
+static void build_topic_names(void) {
+    for (int i = 0; i < MQTT_TOPIC_COUNT; i++) {
+#if CONFIG_APP_MQTT_PER_DEVICE_TOPIC
+        snprintf(s_topic_names[i], sizeof(s_topic_names[i]), "sensor/%s/%s", CONFIG_APP_MQTT_DEVICE_ID, s_topic_defs[i].suffix);
+#else
+        snprintf(s_topic_names[i], sizeof(s_topic_names[i]), "sensor/%s", s_topic_defs[i].suffix);
+#endif
+    }
 }
 
 // MQTT 설정, 초기화 및 시작 함수
 void mqtt_start(void) {
+    build_topic_names();
+    mqtt_outbox_init();
+    // 세션 재개를 위해 기기별로 고정된 client id 사용
+    snprintf(s_client_id, sizeof(s_client_id), "%s-%s", MQTT_BOARD_TYPE, CONFIG_APP_MQTT_DEVICE_ID);
+
     esp_mqtt_client_config_t mqtt_cfg = {
-        .broker.address.uri = "mqtt://i13a107.p.ssafy.io:8883",
-        .credentials.username = "a107",
-        .credentials.authentication.password = "123456789",
+        .broker.address.uri = CONFIG_APP_MQTT_BROKER_URI,
+        .credentials.username = CONFIG_APP_MQTT_USERNAME,
+        .credentials.client_id = s_client_id,
+        .credentials.authentication.password = CONFIG_APP_MQTT_PASSWORD,
+#if CONFIG_APP_MQTT_PROTOCOL_5
+        .session.protocol_ver = MQTT_PROTOCOL_V_5,
+        .session.disable_clean_session = true,
+#endif
     };
     mqtt_client = esp_mqtt_client_init(&mqtt_cfg);  // 전역으로 관리되는 mqtt_client 변수 초기화
+
+#if CONFIG_APP_MQTT_PROTOCOL_5
+    esp_mqtt5_connection_property_config_t connect_property = {
+        .session_expiry_interval = CONFIG_APP_MQTT_SESSION_EXPIRY_S,
+        .request_problem_info = true,
+    };
+    esp_mqtt5_client_set_connect_property(mqtt_client, &connect_property);
+
+    // 페이로드를 파싱하지 않고도 라우팅할 수 있도록 모든 발행에 붙는 user property
+    esp_mqtt5_user_property_item_t user_props[] = {
+        { "deviceId", CONFIG_APP_MQTT_DEVICE_ID },
+        { "board", MQTT_BOARD_TYPE },
+    };
+    esp_mqtt5_client_set_user_property(&s_user_props, user_props, sizeof(user_props) / sizeof(user_props[0]));
+#endif
+
     esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
     esp_mqtt_client_start(mqtt_client);     // mqtt_client 시작
+    ESP_LOGI(TAG, "MQTT 시작: %s (%s, topic %s)", CONFIG_APP_MQTT_BROKER_URI,
+             MQTT_PROTOCOL_NAME, s_topic_names[MQTT_TOPIC_SENSOR_DATA]);
 }
 
 esp_mqtt_client_handle_t mqtt_get_handle(void) {
     return mqtt_client;
-}
\ No newline at end of file
+}
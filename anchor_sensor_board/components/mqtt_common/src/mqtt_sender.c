@@ -1,26 +1,31 @@
 #include "mqtt_sender.h"                 // 이 파일의 헤더 (함수 선언 등 포함)
+#include <inttypes.h>                    // PRId64
 #include "esp_log.h"                     // 로그 출력을 위한 ESP-IDF 헤더
 #include "mqtt_client.h"                 // 기본 MQTT 클라이언트 정의
 #include "mqtt_client_wrapper.h"         // 커스텀 MQTT 래퍼 함수들 포함 (예: 연결 상태 확인)
+#include "mqtt_outbox.h"                 // 우선순위별 발행 대기열
+#include "metrics.h"                     // 진단 카운터
+#include "clock_service.h"               // 진단 전송 시각
 #include "esp_timer.h"                   // 타임스탬프(ms) 사용을 위한 타이머 API
 #include "esp_ibeacon_api.h"             // vendor_config 구조체 접근을 위한 헤더
 #include "sntp_helper.h"
+#define DLOG_LOCAL_LEVEL CONFIG_DLOG_LEVEL_MQTT_SEND
+#include "dlog.h"                          // 지연 바이너리 로그
+
+static const char *TAG = "MQTT_SEND";
 
-extern esp_mqtt_client_handle_t mqtt_client;  // 외부에서 선언된 MQTT 클라이언트 핸들 사용
-extern bool mqtt_is_connected(void);          // MQTT 연결 여부 확인 함수 (래퍼에서 정의)
 extern esp_ble_ibeacon_vendor_t vendor_config; // vendor_config 구조체 접근
 
 // 새로운 InfluxDB 형식으로 센서 데이터 전송
 void mqtt_send_influx_sensor_data(const influx_sensor_data_t* data) {
-    // MQTT 연결이 안 되어 있으면 전송 생략
-    if (!mqtt_is_connected() || data == NULL) return;
+    if (data == NULL) return;
 
     // vendor_config에서 major, minor 값 가져오기
     uint16_t major = ENDIAN_CHANGE_U16(vendor_config.major);
     uint16_t minor = ENDIAN_CHANGE_U16(vendor_config.minor);
 
     char payload[512];
-    snprintf(payload, sizeof(payload),
+    int len = snprintf(payload, sizeof(payload),
         "{"
         "\"measurement\": \"environment\", "
         "\"tags\": {\"deviceId\": \"%s\"}, "
@@ -53,9 +58,55 @@ void mqtt_send_influx_sensor_data(const influx_sensor_data_t* data) {
         data->timestamp_ms
     );
 
-    // MQTT publish 수행
-    esp_mqtt_client_publish(mqtt_client, "sensor/data", payload, 0, 1, 0);
+    if (len < 0 || (size_t)len >= sizeof(payload)) {
+        ESP_LOGE(TAG, "payload 버퍼 부족 (len=%d)", len);
+        return;
+    }
+
+    // 환경 클래스 대기열에 등록 (대기열/예산이 넘치면 더 새 값이 있는 항목부터 버려짐)
+    esp_err_t err = mqtt_outbox_publish(MQTT_CLASS_ENV, MQTT_TOPIC_SENSOR_DATA, payload, len, true);
+
+    // 로그 출력: payload 대신 timestamp / 결과 / 길이만 지연 로그로 기록
+    DLOGI(TAG, "Queued InfluxDB format: err=%d, len=%d, time=%" PRId64,
+          err, len, data->timestamp_ms);
+}
+
+// metrics 카운터와 발행 대기열 상태를 진단 클래스로 전송
+void mqtt_send_diagnostics(void) {
+    mqtt_outbox_stats_t stats;
+    mqtt_outbox_get_stats(&stats);
+
+    // 연결 단계 시간: 마지막 연결 기준 (재연결 소요는 최댓값)
+    metric_timer_stat_t assoc = metrics_get_timer(METRIC_WIFI_ASSOC_MS);
+    metric_timer_stat_t dhcp = metrics_get_timer(METRIC_WIFI_DHCP_MS);
+    metric_timer_stat_t to_mqtt = metrics_get_timer(METRIC_WIFI_ASSOC_TO_MQTT_MS);
+    metric_timer_stat_t outage = metrics_get_timer(METRIC_WIFI_OUTAGE_MS);
+
+    char payload[512];
+    int len = snprintf(payload, sizeof(payload),
+        "{\"measurement\": \"diag\", \"tags\": {\"deviceId\": \"%s\"}, \"fields\": {"
+        "\"wifiDisconnects\": %lu, \"mqttDisconnects\": %lu, "
+        "\"dropEnv\": %lu, \"dropDiag\": %lu, "
+        "\"coalesced\": %lu, \"expired\": %lu, "
+        "\"inflight\": %u, \"pendingBytes\": %lu, \"outboxBytes\": %ld, "
+        "\"assocMs\": %lu, \"dhcpMs\": %lu, \"assocToMqttMs\": %lu, \"assocToMqttAvgMs\": %lu, "
+        "\"outageMaxMs\": %lu}, "
+        "\"time\": %" PRId64 "}",
+        mqtt_wrapper_device_id(),
+        (unsigned long)metrics_get_counter(METRIC_WIFI_DISCONNECTS),
+        (unsigned long)metrics_get_counter(METRIC_MQTT_DISCONNECTS),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_DROPS_ENV),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_DROPS_DIAG),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_COALESCED),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_EXPIRED),
+        stats.inflight, (unsigned long)stats.pending_bytes, (long)stats.outbox_bytes,
+        (unsigned long)assoc.last, (unsigned long)dhcp.last, (unsigned long)to_mqtt.last,
+        (unsigned long)(to_mqtt.count ? to_mqtt.sum / to_mqtt.count : 0), (unsigned long)outage.max,
+        clock_to_utc_ms(clock_now_us()));
+    if (len < 0 || (size_t)len >= sizeof(payload)) {
+        return;
+    }
 
-    // 로그 출력: 전송한 payload 내용 표시
-    ESP_LOGI("MQTT_SEND", "Published InfluxDB format: %s", payload);
-}
\ No newline at end of file
+    // 진단은 최신 값만 의미 있으므로 덮어쓰기 (QoS 0, 가장 먼저 버려짐)
+    mqtt_outbox_publish(MQTT_CLASS_DIAG, MQTT_TOPIC_DIAG, payload, len, true);
+}
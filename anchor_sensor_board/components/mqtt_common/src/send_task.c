@@ -4,35 +4,32 @@
 #include "tvoc_sensor.h"
 #include "temp_humid_sensor.h"
 #include "light_sensor.h"
-#include "sntp_helper.h"
+#include "clock_service.h"
+#include "mqtt_client_wrapper.h"
+#include "task_placement.h"
+#include "metrics.h"
 
-#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#define DLOG_LOCAL_LEVEL CONFIG_DLOG_LEVEL_MQTT_SEND
+#include "dlog.h"
 
 static const char *TAG = "SEND_TASK";
 
 // 실제로 주기적으로 실행되는 태스크 함수
+#define DIAG_EVERY_N_PUBLISH  12     // 5초 x 12 = 1분마다 진단 전송
+
 void sensor_publish_task(void *pvParameters)
 {
-    while (1) {
-        // SNTP 동기화 상태에 따라 타임스탬프 설정
-        int64_t timestamp;
-        const char* timestamp_type;
+    int publish_count = 0;
 
-        if (is_sntp_synced()) {
-            // SNTP 동기화된 경우: 유닉스 타임스탬프 사용
-            time_t world_time = get_current_world_time();
-            timestamp = (int64_t)world_time * 1000;  // 초를 밀리초로 변환
-            timestamp_type = "unix_timestamp_ms";
-        } else {
-            // SNTP 동기화되지 않은 경우: ESP 타이머 사용
-            timestamp = esp_timer_get_time() / 1000;  // 마이크로초를 밀리초로 변환
-            timestamp_type = "esp_time_ms";
-        }
+    while (1) {
+        // 측정 시각 (ms 해상도 UTC, SNTP 기준점이 없으면 부팅 후 경과 ms)
+        int64_t timestamp = clock_to_utc_ms(clock_now_us());
+        const char* timestamp_type = clock_is_utc_valid() ? "unix_timestamp_ms" : "esp_time_ms";
         sensor_data_set_timestamp(timestamp);
-        ESP_LOGD(TAG, "timestamp set (%s): %lld", timestamp_type, (long long)timestamp);
+        DLOGD(TAG, "timestamp set (%s): %lld", timestamp_type, timestamp);
 
         // 온습도 데이터 저장 (getters 사용)
         float temperature = get_temperature();
@@ -70,9 +67,16 @@ void sensor_publish_task(void *pvParameters)
 
         // 새로운 InfluxDB 형식으로만 전송
         influx_sensor_data_t influx_data;
-        sensor_data_convert_to_influx(&snapshot, &influx_data, "dev01");
+        sensor_data_convert_to_influx(&snapshot, &influx_data, mqtt_wrapper_device_id());
         mqtt_send_influx_sensor_data(&influx_data);
 
+        if (++publish_count >= DIAG_EVERY_N_PUBLISH) {
+            publish_count = 0;
+            mqtt_send_diagnostics();
+            metrics_log_summary();
+            task_placement_check_stacks();
+        }
+
         // 다음 전송까지 대기 (5초)
         vTaskDelay(pdMS_TO_TICKS(5000));
     }
@@ -81,5 +85,5 @@ void sensor_publish_task(void *pvParameters)
 // app_main에서 호출할 시작 함수
 void start_send_task(void)
 {
-    xTaskCreate(sensor_publish_task, "sensor_publish_task", 4096, NULL, 5, NULL);
+    task_placement_create(TASK_ID_SENSOR_PUBLISH, sensor_publish_task, NULL, NULL);
 }
@@ -3,7 +3,7 @@
 #include "nvs_flash.h"
 #include "mqtt_client.h"
 
-#include "wifi_connect.h"
+#include "wifi_manager.h"
 #include "mqtt_client_wrapper.h"
 #include "sensor_data.h"
 #include "i2c_helper.h"
@@ -19,72 +19,98 @@
 #include "esp_log.h"
 #include "esp_wifi.h"
 #include "esp_ibeacon_api.h"
+#include "dlog.h"
+#include "app_init.h"
+#include "clock_service.h"
 
 
 static const char *TAG = "MAIN";
 extern esp_ble_ibeacon_vendor_t vendor_config;
 
 
-void app_main(void) {
-    ESP_ERROR_CHECK(nvs_flash_init());
-
-    vendor_config.major = ENDIAN_CHANGE_U16(2);   // 원하는 major 값
-    vendor_config.minor = ENDIAN_CHANGE_U16(1);   // 원하는 minor 값
+// ---- 부팅 단계 함수 (app_init 단계 태스크에서 실행) ----
 
+// BLE 광고는 성공할 때까지 백그라운드에서 재시도 (네트워크/센서 초기화를 막지 않음)
+static esp_err_t stage_ble(void) {
     ESP_LOGI(TAG, "BLE iBeacon advertising 시작 시도...");
     ble_anchor_init();
-    vTaskDelay(pdMS_TO_TICKS(1000));
 
-
-    while (!ble_anchor_is_advertising()) {
-        ESP_LOGW(TAG, "⚠ BLE iBeacon advertising 실패 - 재시도 중...");
-        ble_anchor_restart_advertising();
-        vTaskDelay(pdMS_TO_TICKS(2000));
+    for (int i = 0; !ble_anchor_is_advertising(); i++) {
+        vTaskDelay(pdMS_TO_TICKS(500));
+        if (i % 4 == 3) {
+            ESP_LOGW(TAG, "⚠ BLE iBeacon advertising 실패 - 재시도 중...");
+            ble_anchor_restart_advertising();
+        }
     }
 
-    ESP_LOGI(TAG, "✓ BLE iBeacon advertising 성공 - 시스템 초기화 진행");
-
-    
-    // Wi-Fi 연결
-    wifi_connect();
-    
-    // Wi-Fi 연결 완료까지 대기
-    vTaskDelay(pdMS_TO_TICKS(3000));
-
-    // SNTP 초기화 및 시간 동기화 추가
-    ESP_LOGI(TAG, "SNTP 시간 동기화 시작...");
-    esp_err_t sntp_result = sntp_init_and_sync();
-    if (sntp_result == ESP_OK) {
-        ESP_LOGI(TAG, "✓ SNTP 시간 동기화 성공");
-    } else {
-        ESP_LOGW(TAG, "⚠ SNTP 시간 동기화 실패, ESP 타이머 사용");
-    }
-    
-    // MQTT 시작
+    ESP_LOGI(TAG, "✓ BLE iBeacon advertising 성공");
+    return ESP_OK;
+}
+
+static esp_err_t stage_wifi(void) {
+    // 완료(IP 획득)는 wifi_mgr 태스크에서 APP_INIT_NET_UP으로 통지
+    return wifi_manager_start();
+}
+
+// SNTP는 전송을 막지 않는다 - 서버 선택/동기화는 sntp 태스크에서 진행 (완료 시 APP_INIT_TIME_SYNCED)
+static esp_err_t stage_sntp(void) {
+    return sntp_service_start();
+}
+
+static esp_err_t stage_mqtt(void) {
+    // 완료(브로커 연결)는 mqtt_client_wrapper.c에서 APP_INIT_MQTT_UP으로 통지
     mqtt_start();
-    
-    // MQTT 연결 완료까지 대기
-    vTaskDelay(pdMS_TO_TICKS(2000));
-    
+    return ESP_OK;
+}
+
+static esp_err_t stage_sensors(void) {
     // I2C 드라이버 초기화
     i2c_master_init();
-    
-    // 센서 데이터 구조체 초기화
-    sensor_data_init();
+    app_init_signal(APP_INIT_I2C);
 
     // 센서 초기화
     tvoc_sensor_init();  // 공기질 센서 초기화 및 태스크 시작
     temp_humid_sensor_init();  // 온습도 센서 초기화 및 태스크 시작
     //  GL5549(조도) 초기화 (GPIO32 = ADC1_CH4)
-    ESP_ERROR_CHECK(light_sensor_init(ADC1_CHANNEL_4));
+    return light_sensor_init(ADC1_CHANNEL_4);
+}
+
+static esp_err_t stage_send(void) {
+    start_send_task();
+    return ESP_OK;
+}
 
+static const app_init_stage_t s_boot_stages[] = {
+    { "ble",     APP_INIT_NVS,                        APP_INIT_BLE,         stage_ble,     0 },
+    { "wifi",    APP_INIT_NVS,                        0,                    stage_wifi,    0 },
+    { "sntp",    APP_INIT_NET_UP,                     0,                    stage_sntp,    0 },
+    { "mqtt",    APP_INIT_NET_UP,                     0,                    stage_mqtt,    0 },
+    { "sensors", APP_INIT_SENSOR_DATA,                APP_INIT_SENSORS,     stage_sensors, 0 },
+    { "send",    APP_INIT_SENSORS | APP_INIT_MQTT_UP, 0,                    stage_send,    0 },
+};
 
+void app_main(void) {
+    app_init_begin();
 
-    // 센서 초기화 완료까지 대기
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    // 지연 로그 드레인 태스크 시작
+    dlog_init();
 
-    // MQTT 전송 태스크 시작
-    start_send_task();
-    
-    ESP_LOGI(TAG, "모든 초기화 완료");
+    ESP_ERROR_CHECK(nvs_flash_init());
+    app_init_signal(APP_INIT_NVS);
+
+    // 마지막으로 알던 시각 복원 (SNTP 동기화 전에도 타임스탬프 사용 가능)
+    sntp_restore_time();
+    clock_service_init(is_sntp_synced());
+
+    vendor_config.major = ENDIAN_CHANGE_U16(2);   // 원하는 major 값
+    vendor_config.minor = ENDIAN_CHANGE_U16(1);   // 원하는 minor 값
+
+    // 센서 데이터 구조체 초기화
+    sensor_data_init();
+    app_init_signal(APP_INIT_SENSOR_DATA);
+
+    // 나머지는 의존성이 충족되는 대로 병렬 실행 (BLE 광고, SNTP는 백그라운드)
+    ESP_ERROR_CHECK(app_init_start(s_boot_stages, sizeof(s_boot_stages) / sizeof(s_boot_stages[0])));
+
+    ESP_LOGI(TAG, "부팅 단계 시작 완료");
 }
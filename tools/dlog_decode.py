@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""dlog 바이너리 로그 디코더.
+
+펌웨어의 dlog 태스크가 콘솔로 내보내는 "#DL:" 라인을 ELF 정보로 복원한다.
+나머지 라인(일반 ESP_LOGx 출력)은 그대로 통과시킨다.
+
+사용 예:
+    idf.py monitor | python tools/dlog_decode.py --elf build/user_sensor_board.elf
+    python tools/dlog_decode.py --elf build/user_sensor_board.elf capture.log
+
+필요 패키지: pyelftools (ESP-IDF python 환경에 포함)
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+
+# dlog.h 의 DLOG_ARG_* 와 동일해야 함
+ARG_U32, ARG_F32, ARG_U64, ARG_STR = 0, 1, 2, 3
+
+LEVEL_CHARS = {1: 'E', 2: 'W', 3: 'I', 4: 'D', 5: 'V'}
+
+# printf 변환 명세: %[flags][width][.precision][length]conversion
+SPEC_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|L|q|j|z|t)?([diouxXeEfFgGcspn%])')
+
+
+class ElfMemory:
+    """ELF의 로드 가능한 섹션에서 주소로 바이트를 읽는다."""
+
+    def __init__(self, path):
+        self._file = open(path, 'rb')
+        self._elf = ELFFile(self._file)
+        self._sections = []
+        for sec in self._elf.iter_sections():
+            if not sec['sh_flags'] & SH_FLAGS.SHF_ALLOC:
+                continue
+            if sec['sh_type'] == 'SHT_NOBITS' or sec['sh_size'] == 0:
+                continue
+            self._sections.append((sec['sh_addr'], sec['sh_addr'] + sec['sh_size'], sec.data()))
+        self._str_cache = {}
+
+    def read(self, addr, size):
+        for start, end, data in self._sections:
+            if start <= addr and addr + size <= end:
+                off = addr - start
+                return data[off:off + size]
+        return None
+
+    def read_u32(self, addr):
+        raw = self.read(addr, 4)
+        return struct.unpack('<I', raw)[0] if raw else None
+
+    def read_cstr(self, addr):
+        if addr in self._str_cache:
+            return self._str_cache[addr]
+        for start, end, data in self._sections:
+            if start <= addr < end:
+                off = addr - start
+                nul = data.find(b'\0', off)
+                if nul < 0:
+                    nul = len(data)
+                text = data[off:nul].decode('utf-8', errors='replace')
+                self._str_cache[addr] = text
+                return text
+        return None
+
+
+class SiteTable:
+    """로그 위치 디스크립터(dlog_site_t) 캐시."""
+
+    def __init__(self, mem):
+        self._mem = mem
+        self._cache = {}
+
+    def lookup(self, addr):
+        if addr in self._cache:
+            return self._cache[addr]
+        raw = self._mem.read(addr, 12)
+        site = None
+        if raw:
+            level, _reserved, line, tag_pp, fmt_p = struct.unpack('<BBHII', raw)
+            tag_p = self._mem.read_u32(tag_pp)
+            tag = self._mem.read_cstr(tag_p) if tag_p is not None else None
+            fmt = self._mem.read_cstr(fmt_p)
+            if fmt is not None:
+                site = (level, line, tag or '?', fmt)
+        self._cache[addr] = site
+        return site
+
+
+def split_args(types, nargs, words):
+    """타입 태그에 따라 워드 배열을 인자 목록으로 분리."""
+    args = []
+    idx = 0
+    for i in range(nargs):
+        kind = (types >> (2 * i)) & 0x3
+        if kind == ARG_U64:
+            if idx + 2 > len(words):
+                break
+            args.append((kind, words[idx] | (words[idx + 1] << 32)))
+            idx += 2
+        else:
+            if idx + 1 > len(words):
+                break
+            args.append((kind, words[idx]))
+            idx += 1
+    return args
+
+
+def to_signed(value, bits):
+    if value & (1 << (bits - 1)):
+        return value - (1 << bits)
+    return value
+
+
+def render(fmt, args, mem):
+    out = []
+    pos = 0
+    it = iter(args)
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, _length, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        arg = next(it, None)
+        if arg is None:
+            out.append('<?>')
+            continue
+        kind, raw = arg
+        bits = 64 if kind == ARG_U64 else 32
+        spec = '%' + (flags or '') + (width or '') + ('.' + prec if prec is not None else '')
+        if conv in 'eEfFgG':
+            value = struct.unpack('<f', struct.pack('<I', raw & 0xFFFFFFFF))[0] if kind == ARG_F32 else raw
+            out.append((spec + conv) % value)
+        elif conv in 'di':
+            out.append((spec + 'd') % to_signed(raw, bits))
+        elif conv in 'uoxX':
+            out.append((spec + ('d' if conv == 'u' else conv)) % raw)
+        elif conv == 'c':
+            out.append(chr(raw & 0xFF))
+        elif conv == 's':
+            text = mem.read_cstr(raw) if kind == ARG_STR else None
+            out.append((spec + 's') % (text if text is not None else '<0x%08x>' % raw))
+        elif conv == 'p':
+            out.append('0x%08x' % raw)
+        else:
+            out.append(m.group(0))
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def decode_line(hexdata, sites, mem):
+    ts = int(hexdata[0:8], 16)
+    site_addr = int(hexdata[8:16], 16)
+    types = int(hexdata[16:20], 16)
+    nargs = int(hexdata[20:22], 16)
+    nwords = int(hexdata[22:24], 16)
+    words = [int(hexdata[24 + 8 * i:32 + 8 * i], 16) for i in range(nwords)]
+
+    site = sites.lookup(site_addr)
+    if site is None:
+        return '? (%d) dlog: unknown site 0x%08x (ELF mismatch?)' % (ts, site_addr)
+    level, line, tag, fmt = site
+    msg = render(fmt, split_args(types, nargs, words), mem)
+    return '%s (%d) %s: %s' % (LEVEL_CHARS.get(level, '?'), ts, tag, msg)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='dlog binary log decoder')
+    parser.add_argument('--elf', required=True, help='firmware ELF built from the same source')
+    parser.add_argument('input', nargs='?', help='captured console log (default: stdin)')
+    args = parser.parse_args()
+
+    mem = ElfMemory(args.elf)
+    sites = SiteTable(mem)
+    stream = open(args.input, 'r', errors='replace') if args.input else sys.stdin
+
+    for raw_line in stream:
+        line = raw_line.rstrip('\r\n')
+        idx = line.find('#DL:')
+        if idx >= 0:
+            try:
+                print(line[:idx] + decode_line(line[idx + 4:].strip(), sites, mem), flush=True)
+            except ValueError:
+                print(line, flush=True)
+        elif '#DL-DROP:' in line:
+            print('W dlog: %s records dropped (ring full)' % line.split('#DL-DROP:')[1], flush=True)
+        else:
+            print(line, flush=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,61 @@
+// bench.h
+// dsp_bench 공용 도구 (트레이스 로드, 난수, 시간 측정)
+
+#ifndef DSP_BENCH_H
+#define DSP_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// synth_sensor_trace.py / sensor_backend 트레이스 CSV의 한 샘플
+typedef struct {
+    uint32_t t_ms;
+    float v[6];         // imu: ax ay az (g) gx gy gz (dps), ppg: red ir
+} trace_sample_t;
+
+typedef struct {
+    trace_sample_t *imu;
+    size_t imu_count;
+    trace_sample_t *ppg;
+    size_t ppg_count;
+} trace_t;
+
+/**
+ * @brief 트레이스 CSV 로드 (imu/ppg 행만 사용, 나머지 종류는 무시)
+ * @return false면 파일 오류
+ */
+bool trace_load(const char *path, trace_t *trace);
+void trace_free(trace_t *trace);
+
+/**
+ * @brief PPG 샘플 주기에 맞춘 가속도 (직전 PPG 시각 < t <= 이번 PPG 시각 구간의 IMU 평균)
+ *
+ * 펌웨어 ppg_dsp 태스크와 같은 정렬 방식. 구간에 IMU가 없으면 acc_g를 그대로 둔다.
+ * @param cursor 다음에 볼 IMU 인덱스 (호출 간 유지)
+ */
+void trace_align_accel(const trace_t *trace, size_t *cursor, uint32_t t_ms, float acc_g[3]);
+
+// 재현 가능한 난수 (xorshift32)
+void bench_seed(uint32_t seed);
+float bench_uniform(void);
+float bench_gauss(void);
+
+// 단조 시계 (ns)
+uint64_t bench_now_ns(void);
+
+// 사이클 카운터 (x86은 TSC, 그 밖에는 ns) - 단위 문자열은 bench_cycles_unit()
+uint64_t bench_cycles(void);
+const char *bench_cycles_unit(void);
+
+// 전력 누적 (SNR 계산용)
+typedef struct {
+    double signal;
+    double noise;
+    size_t n;
+} snr_acc_t;
+
+void snr_add(snr_acc_t *acc, float signal, float noise);
+double snr_db(const snr_acc_t *acc);
+
+#endif // DSP_BENCH_H
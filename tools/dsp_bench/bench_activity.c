@@ -0,0 +1,162 @@
+// bench_activity.c
+// activity.c (창 특징량 + 양자화 결정 트리) 벤치마크
+//
+// 합성 구간(정지/걷기/달리기/팔 동작/긴 정지)을 100Hz로 이어 붙여 창마다 분류하고, 구간별 정답률과
+// 혼동 행렬, 창 하나(hop 동안의 샘플 누적 + 분류)의 비용을 보고한다. 구간 경계에 걸친 처음 두 창은
+// 전환 구간이므로 정답률에서 뺀다.
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "activity.h"
+
+#define FS_HZ   100.0f
+
+typedef enum { SEG_STILL, SEG_WALK, SEG_RUN, SEG_GESTURE } seg_kind_t;
+
+typedef struct {
+    seg_kind_t kind;
+    float seconds;
+    activity_class_t expect;
+    const char *name;
+} segment_t;
+
+// 긴 정지 구간 끝부분은 수면으로 넘어가야 함 (5분 뒤)
+static const segment_t s_segments[] = {
+    { SEG_STILL,   30.0f,  ACTIVITY_STILL,      "정지" },
+    { SEG_WALK,    60.0f,  ACTIVITY_WALK,       "걷기" },
+    { SEG_RUN,     60.0f,  ACTIVITY_RUN,        "달리기" },
+    { SEG_WALK,    30.0f,  ACTIVITY_WALK,       "걷기" },
+    { SEG_GESTURE, 10.0f,  ACTIVITY_TRANSITION, "팔 동작" },
+    { SEG_STILL,   420.0f, ACTIVITY_SLEEP,      "긴 정지" },
+};
+
+// 몸 좌표계 중력 방향을 따라 크기가 변하는 손목 가속도 + 팔 흔들림 자이로
+static void synth_sample(seg_kind_t kind, float t, float *theta, float acc[3], float gyro[3]) {
+    float mag = 1.0f;
+    float swing_dps = 0.0f;
+    float rot_dps = 0.0f;
+
+    switch (kind) {
+        case SEG_STILL:
+            break;
+        case SEG_WALK: {
+            float w = 2.0f * (float)M_PI * 1.8f * t;
+            mag += 0.25f * sinf(w) + 0.08f * sinf(2.0f * w + 0.5f);
+            swing_dps = 45.0f * sinf(0.5f * w);
+            break;
+        }
+        case SEG_RUN: {
+            float w = 2.0f * (float)M_PI * 2.8f * t;
+            mag += 0.9f * sinf(w) + 0.3f * sinf(2.0f * w + 0.8f);
+            swing_dps = 160.0f * sinf(0.5f * w);
+            break;
+        }
+        case SEG_GESTURE:
+            rot_dps = 60.0f * sinf(2.0f * (float)M_PI * 0.3f * t);
+            break;
+    }
+    *theta += rot_dps / FS_HZ * (float)M_PI / 180.0f;
+    float th = 0.3f + *theta;
+    acc[0] = mag * 0.2f + 0.01f * bench_gauss();
+    acc[1] = mag * 0.98f * sinf(th) + 0.01f * bench_gauss();
+    acc[2] = mag * 0.98f * cosf(th) + 0.01f * bench_gauss();
+    gyro[0] = rot_dps + 0.5f * bench_gauss();
+    gyro[1] = swing_dps + 0.5f * bench_gauss();
+    gyro[2] = 0.3f * swing_dps + 0.5f * bench_gauss();
+}
+
+int bench_activity(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "seed", required_argument, NULL, 's' },
+        { "verbose", no_argument, NULL, 'v' },
+        { NULL, 0, NULL, 0 },
+    };
+    bool verbose = false;
+    int c;
+    while ((c = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (c) {
+            case 's': bench_seed((uint32_t)strtoul(optarg, NULL, 10)); break;
+            case 'v': verbose = true; break;
+            default:
+                printf("usage: dsp_bench activity [--seed N] [--verbose]\n");
+                return 2;
+        }
+    }
+
+    static activity_ctx_t ctx;
+    activity_init(&ctx, FS_HZ);
+
+    int confusion[ACTIVITY_COUNT][ACTIVITY_COUNT] = {{0}};
+    uint64_t window_cycles = 0, max_window_cycles = 0, hop_cycles = 0;
+    int windows = 0;
+    float theta = 0.0f;
+    float t = 0.0f;
+
+    printf("activity 합성 시퀀스 (%.0fHz, 창 2초 / hop 1초, 컨텍스트 %zu바이트)\n", FS_HZ, sizeof(ctx));
+    printf("%-8s %6s %10s  %s\n", "구간", "창", "정답률", "기대");
+    for (size_t si = 0; si < sizeof(s_segments) / sizeof(s_segments[0]); si++) {
+        const segment_t *seg = &s_segments[si];
+        int n = (int)(seg->seconds * FS_HZ);
+        int seg_windows = 0, hits = 0, scored = 0;
+
+        for (int i = 0; i < n; i++, t += 1.0f / FS_HZ) {
+            float acc[3], gyro[3];
+            synth_sample(seg->kind, t, &theta, acc, gyro);
+
+            uint64_t c0 = bench_cycles();
+            bool done = activity_update(&ctx, acc, gyro);
+            hop_cycles += bench_cycles() - c0;
+            if (!done) {
+                continue;
+            }
+
+            window_cycles += hop_cycles;
+            if (hop_cycles > max_window_cycles) {
+                max_window_cycles = hop_cycles;
+            }
+            hop_cycles = 0;
+            windows++;
+
+            if (verbose) {
+                printf("  t=%6.1fs %-10s tree=%-10s std=%4umg f=%u zc=%2u gyro=%3udps\n", t,
+                       activity_name(ctx.activity), activity_name(ctx.tree_class),
+                       ctx.features[ACTIVITY_FEAT_MAG_STD_MG], ctx.features[ACTIVITY_FEAT_DOM_FREQ],
+                       ctx.features[ACTIVITY_FEAT_ZERO_CROSS], ctx.features[ACTIVITY_FEAT_GYRO_RMS_DPS]);
+            }
+            // 경계에 걸친 창 제외, 긴 정지는 수면 진입 이후만 채점
+            if (seg_windows++ < 2) {
+                continue;
+            }
+            if (seg->expect == ACTIVITY_SLEEP && seg_windows <= (int)ctx.sleep_onset_windows) {
+                continue;
+            }
+            confusion[seg->expect][ctx.activity]++;
+            scored++;
+            hits += ctx.activity == seg->expect;
+        }
+        printf("%-8s %6d %9.1f%%  %s\n", seg->name, seg_windows,
+               scored > 0 ? 100.0 * hits / scored : 0.0, activity_name(seg->expect));
+    }
+
+    printf("\n혼동 행렬 (행: 기대, 열: 결과)\n%-11s", "");
+    for (int j = 1; j < ACTIVITY_COUNT; j++) {
+        printf("%11s", activity_name((activity_class_t)j));
+    }
+    printf("\n");
+    for (int i = 1; i < ACTIVITY_COUNT; i++) {
+        printf("%-11s", activity_name((activity_class_t)i));
+        for (int j = 1; j < ACTIVITY_COUNT; j++) {
+            printf("%11d", confusion[i][j]);
+        }
+        printf("\n");
+    }
+
+    printf("\n창 1개 비용 (hop %u샘플 누적 + 분류): 평균 %.0f, 최대 %llu %s (샘플당 %.1f)\n",
+           ctx.hop_samples, (double)window_cycles / windows, (unsigned long long)max_window_cycles,
+           bench_cycles_unit(), (double)window_cycles / windows / ctx.hop_samples);
+    return 0;
+}
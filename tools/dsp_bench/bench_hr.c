@@ -0,0 +1,306 @@
+// bench_hr.c
+// 심박 엔진 비교 (heart_rate_calculator.c를 CONFIG_HR_ENGINE_TIME / SPECTRAL / FUSED로 각각 컴파일)
+//
+// 합성 모드: 정답 심박/SpO2가 있는 구간(정지, 낮은 관류, 심박 상승, 보행 아티팩트, 빠른 심박, 저산소)을
+// 50Hz로 만들고 구간마다 계산기를 새로 초기화해 세 엔진에 같은 샘플/가속도를 넣는다. 초기 수렴(WARMUP_S) 뒤
+// 심박/SpO2를 낸 비율, 정답과의 평균 절대 오차, 샘플당 평균 처리 사이클을 보고하고, 스펙트럼 추정 1회
+// (창 → FFT → 피크)의 비용을 따로 잰다.
+// 트레이스 모드: synth_sensor_trace.py / sensor_backend 트레이스 CSV를 펌웨어 ppg_dsp와 같은 방식으로
+// 정렬해 1초마다 엔진별 심박과 신뢰도를 출력한다 (정답이 없으므로 오차 없음).
+// LED AGC 요청은 반영하지 않는다 (전류 고정). 엔진별 정적 RAM은 오브젝트 크기로 확인한다:
+//   size tools/dsp_bench/build/CMakeFiles/hr_engine_*.dir/*/heart_sensor/src/*.o
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "heart_rate_calculator.h"
+#include "hr_spectral.h"
+
+#define FS_HZ           50.0f
+#define WARMUP_S        15.0f       // 스펙트럼 창(10초) + 여유
+#define DC_IR           120000.0f
+#define DC_RED          90000.0f
+#define NOISE_COUNTS    30.0f
+#define ARTIFACT_K      2500.0f     // 동적 가속도 1g당 PPG 흔들림 (bench_motion과 같음)
+#define GRAVITY_X       0.05f
+#define GRAVITY_Y      -0.10f
+#define GRAVITY_Z       0.99f
+
+// 엔진별로 이름을 바꿔 컴파일한 계산기 (CMakeLists.txt의 hr_engine_* 오브젝트)
+#define DECLARE_ENGINE(p)                                                               \
+    void p##heart_rate_calculator_init(void);                                           \
+    heart_rate_data_t p##calculate_heart_rate_and_spo2(uint32_t red, uint32_t ir, int64_t t_us); \
+    void p##hr_set_motion_reference(float ax_g, float ay_g, float az_g);
+
+DECLARE_ENGINE(time_)
+DECLARE_ENGINE(spectral_)
+DECLARE_ENGINE(fused_)
+
+typedef struct {
+    const char *name;
+    void (*init)(void);
+    heart_rate_data_t (*calc)(uint32_t red, uint32_t ir, int64_t t_us);
+    void (*motion)(float ax_g, float ay_g, float az_g);
+} engine_t;
+
+static const engine_t s_engines[] = {
+    { "time", time_heart_rate_calculator_init, time_calculate_heart_rate_and_spo2, time_hr_set_motion_reference },
+    { "spectral", spectral_heart_rate_calculator_init, spectral_calculate_heart_rate_and_spo2,
+      spectral_hr_set_motion_reference },
+    { "fused", fused_heart_rate_calculator_init, fused_calculate_heart_rate_and_spo2, fused_hr_set_motion_reference },
+};
+#define ENGINE_COUNT (int)(sizeof(s_engines) / sizeof(s_engines[0]))
+
+typedef struct {
+    const char *name;
+    float seconds;
+    float bpm_start;
+    float bpm_end;
+    float perfusion;        // IR AC/DC
+    float spo2;             // 참값 - RED 관류 = IR 관류 × R, R = (110 - SpO2) / 25 (기본 교정 곡선)
+    float walk_from_s;      // 이 시각부터 보행 (음수면 정지만) - 움직임 필터가 정지 맥파 기준을 먼저 잡게 한다
+} scenario_t;
+
+static const scenario_t s_scenarios[] = {
+    { "정지 72",        60.0f,  72.0f,  72.0f, 0.020f, 98.0f, -1.0f },
+    { "낮은 관류 65",   60.0f,  65.0f,  65.0f, 0.003f, 97.0f, -1.0f },
+    { "상승 70→130",    90.0f,  70.0f, 130.0f, 0.015f, 96.0f, -1.0f },
+    { "보행 100",       80.0f, 100.0f, 100.0f, 0.015f, 97.0f, 20.0f },
+    { "빠른 심박 150",  60.0f, 150.0f, 150.0f, 0.010f, 95.0f, -1.0f },
+    { "저산소 88",      60.0f,  85.0f,  85.0f, 0.015f, 88.0f, -1.0f },
+    { "심한 저산소 72", 60.0f,  90.0f,  90.0f, 0.015f, 72.0f, -1.0f },
+};
+
+typedef struct {
+    int counted;
+    int reported;
+    double abs_err;
+    int spo2_reported;
+    double spo2_abs_err;
+    uint64_t cycles;
+} engine_stats_t;
+
+static float pulse_shape(float ph) {
+    float a = (ph - 0.15f) / 0.07f;
+    float b = (ph - 0.42f) / 0.09f;
+    return expf(-a * a) + 0.35f * expf(-b * b);
+}
+
+static void run_engine_sample(const engine_t *e, engine_stats_t *st, const float acc[3], float red, float ir,
+                              int64_t t_us, heart_rate_data_t *out) {
+    uint64_t c0 = bench_cycles();
+    e->motion(acc[0], acc[1], acc[2]);
+    *out = e->calc((uint32_t)lroundf(red), (uint32_t)lroundf(ir), t_us);
+    st->cycles += bench_cycles() - c0;
+}
+
+// 스펙트럼 추정 1회 비용 (최솟값 - 호스트 선점/캐시 미스 영향 제외)
+static void spectral_estimate_cost(void) {
+    static hr_spectral_ctx_t ctx;
+    hr_spectral_init(&ctx, FS_HZ, 1000);
+    uint64_t best = UINT64_MAX, sum = 0;
+    int estimates = 0;
+    hr_estimate_t est = {0};
+    for (int i = 0; i < (int)(120 * FS_HZ); i++) {
+        float x = 1000.0f * sinf(2.0f * (float)M_PI * 1.2f * i / FS_HZ) + NOISE_COUNTS * bench_gauss();
+        uint64_t c0 = bench_cycles();
+        bool done = hr_spectral_process(&ctx, x, &est);
+        uint64_t dc = bench_cycles() - c0;
+        if (done) {
+            sum += dc;
+            estimates++;
+            if (dc < best) {
+                best = dc;
+            }
+        }
+    }
+    printf("스펙트럼 추정 1회: 최소 %llu / 평균 %.0f %s (%d회, 마지막 %.1fbpm 신뢰도 %.2f), 컨텍스트 %zu바이트\n",
+           (unsigned long long)best, estimates ? (double)sum / estimates : 0.0, bench_cycles_unit(), estimates,
+           est.bpm, est.confidence, sizeof(ctx));
+}
+
+static void print_stats(const char *scenario, const char *engine, const engine_stats_t *st, long samples) {
+    int counted = st->counted ? st->counted : 1;
+    printf("%-16s %-9s %7.1f%% %10.1f %8.1f%% %10.1f %14.0f\n", scenario, engine,
+           100.0 * st->reported / counted, st->reported ? st->abs_err / st->reported : 0.0,
+           100.0 * st->spo2_reported / counted, st->spo2_reported ? st->spo2_abs_err / st->spo2_reported : 0.0,
+           (double)st->cycles / samples);
+}
+
+static int run_synthetic(void) {
+    printf("심박 엔진 비교 (합성, %.0fHz, 구간별 %.0f초 이후 집계)\n", FS_HZ, WARMUP_S);
+    printf("%-16s %-9s %8s %10s %9s %10s %14s\n", "구간", "엔진", "출력%", "MAE(bpm)", "SpO2 출력%", "SpO2 MAE",
+           "샘플당 사이클");
+
+    engine_stats_t total[ENGINE_COUNT] = {0};
+    long total_samples = 0;
+    for (size_t si = 0; si < sizeof(s_scenarios) / sizeof(s_scenarios[0]); si++) {
+        const scenario_t *sc = &s_scenarios[si];
+        int n = (int)(sc->seconds * FS_HZ);
+        engine_stats_t st[ENGINE_COUNT] = {0};
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            s_engines[e].init();
+        }
+
+        float phase = 0.0f;
+        float hist[8][3] = {{0}};    // 가속도 지연선 (접촉 변화 지연)
+        for (int i = 0; i < n; i++) {
+            float t = i / FS_HZ;
+            float bpm = sc->bpm_start + (sc->bpm_end - sc->bpm_start) * t / sc->seconds;
+            phase = fmodf(phase + bpm / 60.0f / FS_HZ, 1.0f);
+            float g = pulse_shape(phase);
+
+            float acc[3] = { GRAVITY_X, GRAVITY_Y, GRAVITY_Z };
+            if (sc->walk_from_s >= 0.0f && t >= sc->walk_from_s) {
+                float w = 2.0f * (float)M_PI * 1.8f * t;
+                acc[0] += 0.30f * sinf(w) + 0.08f * sinf(2.0f * w);
+                acc[1] += 0.18f * sinf(w + 1.2f);
+                acc[2] += 0.15f * sinf(2.0f * w);
+            }
+            for (int a = 0; a < 3; a++) {
+                acc[a] += 0.004f * bench_gauss();
+            }
+            for (int k = 7; k > 0; k--) {
+                for (int a = 0; a < 3; a++) {
+                    hist[k][a] = hist[k - 1][a];
+                }
+            }
+            for (int a = 0; a < 3; a++) {
+                hist[0][a] = acc[a];
+            }
+            float art = (sc->walk_from_s >= 0.0f && t >= sc->walk_from_s) ? ARTIFACT_K * (0.7f * (hist[2][0] - GRAVITY_X) + 0.4f * (hist[4][2] - GRAVITY_Z))
+                                    : 0.0f;
+
+            float resp = 0.01f * sinf(2.0f * (float)M_PI * 0.25f * t);
+            float ir = DC_IR * (1.0f + resp - sc->perfusion * g) + art + NOISE_COUNTS * bench_gauss();
+            float red = DC_RED * (1.0f + resp - sc->perfusion * (110.0f - sc->spo2) / 25.0f * g) + 0.75f * art +
+                        NOISE_COUNTS * bench_gauss();
+            // 시각은 구간을 넘어 계속 흐른다 (검출기 내부의 직전 피크 시각은 init으로 지워지지 않음)
+            int64_t t_us = (int64_t)(total_samples + i) * 20000;
+
+            for (int e = 0; e < ENGINE_COUNT; e++) {
+                heart_rate_data_t hr;
+                run_engine_sample(&s_engines[e], &st[e], acc, red, ir, t_us, &hr);
+                if (t < WARMUP_S) {
+                    continue;
+                }
+                st[e].counted++;
+                if (hr.heart_rate > 0.0f) {
+                    st[e].reported++;
+                    st[e].abs_err += fabsf(hr.heart_rate - bpm);
+                }
+                if (hr.spo2 > 0) {
+                    st[e].spo2_reported++;
+                    st[e].spo2_abs_err += fabsf(hr.spo2 - sc->spo2);
+                }
+            }
+        }
+
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            print_stats(e == 0 ? sc->name : "", s_engines[e].name, &st[e], n);
+            total[e].counted += st[e].counted;
+            total[e].reported += st[e].reported;
+            total[e].abs_err += st[e].abs_err;
+            total[e].spo2_reported += st[e].spo2_reported;
+            total[e].spo2_abs_err += st[e].spo2_abs_err;
+            total[e].cycles += st[e].cycles;
+        }
+        total_samples += n;
+    }
+
+    printf("\n%-16s %-9s %8s %10s %9s %10s %14s\n", "전체", "엔진", "출력%", "MAE(bpm)", "SpO2 출력%", "SpO2 MAE",
+           "샘플당 사이클");
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        print_stats("", s_engines[e].name, &total[e], total_samples);
+    }
+    printf("사이클 단위: %s (FFT %d점, 창 %.2f초)\n", bench_cycles_unit(), HR_SPECTRAL_FFT_SIZE,
+           HR_SPECTRAL_FFT_SIZE * HR_SPECTRAL_DECIM / FS_HZ);
+    spectral_estimate_cost();
+    return 0;
+}
+
+static int run_trace(const char *path) {
+    trace_t tr;
+    if (!trace_load(path, &tr)) {
+        return 1;
+    }
+    if (tr.ppg_count < 2) {
+        fprintf(stderr, "%s: PPG 샘플 부족\n", path);
+        trace_free(&tr);
+        return 1;
+    }
+
+    engine_stats_t st[ENGINE_COUNT] = {0};
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        s_engines[e].init();
+    }
+    float acc[3] = { GRAVITY_X, GRAVITY_Y, GRAVITY_Z };
+    size_t cursor = 0;
+    uint32_t bucket = tr.ppg[0].t_ms / 1000;
+    heart_rate_data_t last[ENGINE_COUNT] = {0};
+
+    printf("심박 엔진 비교 트레이스 %s\n", path);
+    printf("%6s", "t(s)");
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        printf(" %9s(bpm/conf)", s_engines[e].name);
+    }
+    printf("\n");
+    // 계산기는 50Hz 고정이므로 더 빠른 트레이스는 정수배 묶음 평균으로 맞춘다
+    int ratio = (int)lroundf(1000.0f / (float)(tr.ppg[1].t_ms - tr.ppg[0].t_ms) / FS_HZ);
+    if (ratio < 1) {
+        ratio = 1;
+    }
+    int samples = 0;
+    for (size_t i = 0; i + ratio <= tr.ppg_count; i += ratio) {
+        float red = 0.0f, ir = 0.0f;
+        for (int k = 0; k < ratio; k++) {
+            red += tr.ppg[i + k].v[0] / ratio;
+            ir += tr.ppg[i + k].v[1] / ratio;
+        }
+        const trace_sample_t *p = &tr.ppg[i + ratio - 1];
+        trace_align_accel(&tr, &cursor, p->t_ms, acc);
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            run_engine_sample(&s_engines[e], &st[e], acc, red, ir, (int64_t)p->t_ms * 1000, &last[e]);
+        }
+        samples++;
+        if (p->t_ms / 1000 != bucket || i + 2 * ratio > tr.ppg_count) {
+            printf("%6u", bucket);
+            for (int e = 0; e < ENGINE_COUNT; e++) {
+                printf(" %14.1f/%4.2f", last[e].heart_rate, last[e].hr_confidence);
+            }
+            printf("\n");
+            bucket = p->t_ms / 1000;
+        }
+    }
+
+    printf("\n샘플당 평균 사이클 (%s):", bench_cycles_unit());
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        printf(" %s %.0f", s_engines[e].name, (double)st[e].cycles / (samples ? samples : 1));
+    }
+    printf("\n");
+    trace_free(&tr);
+    return 0;
+}
+
+int bench_hr(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "trace", required_argument, NULL, 't' },
+        { "seed", required_argument, NULL, 's' },
+        { NULL, 0, NULL, 0 },
+    };
+    const char *trace = NULL;
+    int c;
+    while ((c = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (c) {
+            case 't': trace = optarg; break;
+            case 's': bench_seed((uint32_t)strtoul(optarg, NULL, 10)); break;
+            default:
+                printf("usage: dsp_bench hr [--trace FILE] [--seed N]\n");
+                return 2;
+        }
+    }
+    return trace ? run_trace(trace) : run_synthetic();
+}
@@ -0,0 +1,143 @@
+// bench_led_agc.c
+// led_agc.c (MAX30102 LED 전류 AGC) 벤치마크
+//
+// 채널별 결합 계수(LSB당 ADC 카운트)로 피부색/접촉 압력을 흉내 낸 구간을 50Hz로 이어 붙이고,
+// 고정 전류(기본 12mA)와 AGC를 비교한다. DC 추정은 heart_rate_calculator와 같은 EMA(0.95)를 쓰고,
+// 요청은 다음 샘플부터 반영(획득 태스크가 다음 FIFO 읽기 직전에 쓰는 것과 같은 지연)한다.
+// 구간별로 DC가 대역(MIN_DC_VALUE~18비트 포화 사이) 안에 있는 비율과 평균 LED 전류를 보고한다.
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "led_agc.h"
+
+#define FS_HZ           50.0f
+#define DEFAULT_PA      60          // max30102 기본 설정 (12mA)
+#define ALPHA_DC        0.95f
+#define VALID_DC_MIN    5000.0f     // heart_rate_calculator MIN_DC_VALUE
+#define VALID_DC_MAX    (0.97f * LED_AGC_FULL_SCALE)
+
+typedef struct {
+    float seconds;
+    float coupling[LED_AGC_CHANNELS];   // 전류 1 LSB당 DC 카운트 (IR, RED)
+    float perfusion;                    // AC/DC
+    const char *name;
+} segment_t;
+
+static const segment_t s_segments[] = {
+    { 30.0f, { 2500.0f, 1800.0f }, 0.020f, "밝은 피부" },
+    { 30.0f, {  350.0f,  150.0f }, 0.010f, "어두운 피부" },
+    { 30.0f, { 5000.0f, 4000.0f }, 0.015f, "세게 누름" },
+    { 30.0f, {   10.0f,   10.0f }, 0.000f, "미착용" },
+    { 30.0f, { 1200.0f,  900.0f }, 0.005f, "약한 관류" },
+};
+
+typedef struct {
+    uint8_t current[LED_AGC_CHANNELS];
+    float dc[LED_AGC_CHANNELS];
+} channel_sim_t;
+
+static void sample(const segment_t *seg, const channel_sim_t *sim, float t, float raw[LED_AGC_CHANNELS]) {
+    float pulse = sinf(2.0f * (float)M_PI * 1.2f * t);
+    for (int c = 0; c < LED_AGC_CHANNELS; c++) {
+        float dc = seg->coupling[c] * sim->current[c];
+        float v = dc * (1.0f + seg->perfusion * pulse) + 20.0f * bench_gauss();
+        raw[c] = v < 0.0f ? 0.0f : (v > LED_AGC_FULL_SCALE ? LED_AGC_FULL_SCALE : v);
+    }
+}
+
+static void update_dc(channel_sim_t *sim, const float raw[LED_AGC_CHANNELS]) {
+    for (int c = 0; c < LED_AGC_CHANNELS; c++) {
+        sim->dc[c] = (sim->dc[c] == 0.0f) ? raw[c] : ALPHA_DC * sim->dc[c] + (1.0f - ALPHA_DC) * raw[c];
+    }
+}
+
+int bench_led_agc(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "seed", required_argument, NULL, 's' },
+        { "verbose", no_argument, NULL, 'v' },
+        { NULL, 0, NULL, 0 },
+    };
+    bool verbose = false;
+    int c;
+    while ((c = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (c) {
+            case 's': bench_seed((uint32_t)strtoul(optarg, NULL, 10)); break;
+            case 'v': verbose = true; break;
+            default:
+                printf("usage: dsp_bench led_agc [--seed N] [--verbose]\n");
+                return 2;
+        }
+    }
+
+    led_agc_ctx_t ctx;
+    led_agc_init(&ctx, FS_HZ, DEFAULT_PA, DEFAULT_PA);
+    channel_sim_t fixed = { .current = { DEFAULT_PA, DEFAULT_PA } };
+    channel_sim_t agc = { .current = { DEFAULT_PA, DEFAULT_PA } };
+    uint8_t request[LED_AGC_CHANNELS];
+    bool pending = false;
+    uint64_t cycles = 0;
+    long total = 0;
+    float t = 0.0f;
+
+    printf("LED AGC 합성 시퀀스 (%.0fHz, 블랭킹 %u / 판정 간격 %u샘플)\n", FS_HZ, ctx.blank_samples, ctx.hold_samples);
+    printf("%-12s %14s %14s %10s %10s %8s %8s\n", "구간", "대역 안(고정)", "대역 안(AGC)",
+           "mA(고정)", "mA(AGC)", "변경", "블랭킹");
+    for (size_t si = 0; si < sizeof(s_segments) / sizeof(s_segments[0]); si++) {
+        const segment_t *seg = &s_segments[si];
+        int n = (int)(seg->seconds * FS_HZ);
+        int in_fixed = 0, in_agc = 0, blanked = 0;
+        double ma_fixed = 0.0, ma_agc = 0.0;
+        uint32_t changes0 = ctx.changes;
+
+        for (int i = 0; i < n; i++, t += 1.0f / FS_HZ) {
+            // 직전 샘플에서 나온 요청은 이번 샘플 획득 전에 반영
+            if (pending) {
+                float gain[LED_AGC_CHANNELS];
+                led_agc_applied(&ctx, request, gain);
+                for (int ch = 0; ch < LED_AGC_CHANNELS; ch++) {
+                    agc.current[ch] = request[ch];
+                    agc.dc[ch] *= gain[ch];
+                }
+                pending = false;
+            }
+
+            float raw[LED_AGC_CHANNELS];
+            sample(seg, &fixed, t, raw);
+            update_dc(&fixed, raw);
+            sample(seg, &agc, t, raw);
+            update_dc(&agc, raw);
+
+            uint64_t c0 = bench_cycles();
+            pending = led_agc_update(&ctx, raw, agc.dc, request);
+            cycles += bench_cycles() - c0;
+            total++;
+
+            if (verbose && pending) {
+                printf("  t=%6.2fs DC IR %6.0f RED %6.0f → IR %3u RED %3u\n", t, agc.dc[LED_AGC_IR],
+                       agc.dc[LED_AGC_RED], request[LED_AGC_IR], request[LED_AGC_RED]);
+            }
+
+            bool ok_fixed = true, ok_agc = true;
+            for (int ch = 0; ch < LED_AGC_CHANNELS; ch++) {
+                ok_fixed &= fixed.dc[ch] > VALID_DC_MIN && fixed.dc[ch] < VALID_DC_MAX;
+                ok_agc &= agc.dc[ch] > VALID_DC_MIN && agc.dc[ch] < VALID_DC_MAX;
+                ma_fixed += fixed.current[ch] * LED_AGC_MA_PER_LSB;
+                ma_agc += agc.current[ch] * LED_AGC_MA_PER_LSB;
+            }
+            in_fixed += ok_fixed;
+            in_agc += ok_agc;
+            blanked += led_agc_is_blanking(&ctx);
+        }
+        printf("%-12s %13.1f%% %13.1f%% %10.1f %10.1f %8lu %7.1f%%\n", seg->name,
+               100.0 * in_fixed / n, 100.0 * in_agc / n, ma_fixed / n, ma_agc / n,
+               (unsigned long)(ctx.changes - changes0), 100.0 * blanked / n);
+    }
+
+    printf("\n판정 비용: 샘플당 평균 %.1f %s (컨텍스트 %zu바이트)\n", (double)cycles / total, bench_cycles_unit(),
+           sizeof(ctx));
+    return 0;
+}
@@ -0,0 +1,244 @@
+// bench_motion.c
+// motion_artifact.c (가속도 기준 NLMS) 벤치마크
+//
+// 합성 모드: 정지 → 보행 → 격한 움직임 구간을 만들고, 맥파(정답)와 가속도를 지연/혼합한
+// 움직임 잡음을 더해 구간별 입력/출력 SNR, 오염 플래그 비율을 계산한다.
+// 트레이스 모드: synth_sensor_trace.py 형식 CSV를 펌웨어와 같은 방식(PPG 주기별 IMU 평균)으로
+// 정렬해 1초 단위로 움직임 RMS, 입력/출력 AC RMS, 플래그를 출력한다 (정답이 없으므로 SNR 없음).
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "motion_artifact.h"
+
+#define GRAVITY_X       0.05f
+#define GRAVITY_Y      -0.10f
+#define GRAVITY_Z       0.99f
+#define PULSE_COUNTS    1200.0f     // IR DC 120000의 1% 관류
+#define ARTIFACT_K      2500.0f     // 동적 가속도 1g당 PPG 흔들림 (counts)
+#define NOISE_COUNTS    20.0f
+#define SETTLE_S        3.0f        // 구간 시작 후 수렴 시간 (SNR 집계에서 제외)
+
+typedef struct {
+    const char *name;
+    float start_s;
+    float end_s;
+} segment_t;
+
+static const segment_t s_segments[] = {
+    { "rest",  0.0f, 20.0f },
+    { "walk", 20.0f, 40.0f },
+    { "heavy", 40.0f, 60.0f },
+};
+#define SEGMENT_COUNT (int)(sizeof(s_segments) / sizeof(s_segments[0]))
+
+typedef struct {
+    float *acc;         // [n][3]
+    float *clean;       // 정답 맥파 AC
+    float *input;       // 맥파 + 움직임 잡음 + 센서 잡음
+    int n;
+    float fs;
+} synth_t;
+
+static float pulse_shape(float phase) {
+    float a = (phase - 0.15f) / 0.07f;
+    float b = (phase - 0.42f) / 0.09f;
+    return expf(-a * a) + 0.35f * expf(-b * b);
+}
+
+static bool synth_generate(synth_t *sy, float fs, float seconds) {
+    sy->fs = fs;
+    sy->n = (int)(fs * seconds);
+    sy->acc = calloc((size_t)sy->n * 3, sizeof(float));
+    sy->clean = calloc((size_t)sy->n, sizeof(float));
+    sy->input = calloc((size_t)sy->n, sizeof(float));
+    if (sy->acc == NULL || sy->clean == NULL || sy->input == NULL) {
+        return false;
+    }
+
+    int d1 = (int)lroundf(0.04f * fs);   // 손목 흔들림 → 접촉 변화 지연
+    int d2 = (int)lroundf(0.08f * fs);
+    float phase = 0.0f;
+    double mean = 0.0;
+
+    for (int i = 0; i < sy->n; i++) {
+        float t = i / fs;
+        float dx = 0.0f, dy = 0.0f, dz = 0.0f;
+        if (t >= s_segments[1].start_s && t < s_segments[1].end_s) {
+            float w = 2.0f * (float)M_PI * 1.8f * t;
+            dx = 0.30f * sinf(w) + 0.08f * sinf(2.0f * w);
+            dy = 0.18f * sinf(w + 1.2f);
+            dz = 0.15f * sinf(2.0f * w);
+        } else if (t >= s_segments[2].start_s) {
+            float w = 2.0f * (float)M_PI * 2.6f * t;
+            dx = 0.9f * sinf(w) + 0.3f * sinf(3.0f * w) + 0.1f * bench_gauss();
+            dy = 0.6f * sinf(w + 0.8f) + 0.1f * bench_gauss();
+            dz = 0.5f * sinf(2.0f * w) + 0.1f * bench_gauss();
+        }
+        sy->acc[i * 3 + 0] = GRAVITY_X + dx + 0.004f * bench_gauss();
+        sy->acc[i * 3 + 1] = GRAVITY_Y + dy + 0.004f * bench_gauss();
+        sy->acc[i * 3 + 2] = GRAVITY_Z + dz + 0.004f * bench_gauss();
+
+        float hr_hz = 75.0f / 60.0f;
+        phase = fmodf(phase + hr_hz / fs, 1.0f);
+        sy->clean[i] = -PULSE_COUNTS * pulse_shape(phase);   // 맥파는 IR 흡수 증가 → 값 감소
+        mean += sy->clean[i];
+    }
+    mean /= sy->n;
+
+    for (int i = 0; i < sy->n; i++) {
+        sy->clean[i] -= (float)mean;
+        float art = 0.0f;
+        if (i >= d2) {
+            art = ARTIFACT_K * (0.7f * (sy->acc[(i - d1) * 3 + 0] - GRAVITY_X) +
+                                0.4f * (sy->acc[(i - d2) * 3 + 2] - GRAVITY_Z));
+        }
+        sy->input[i] = sy->clean[i] + art + NOISE_COUNTS * bench_gauss();
+    }
+    return true;
+}
+
+static void synth_free(synth_t *sy) {
+    free(sy->acc);
+    free(sy->clean);
+    free(sy->input);
+}
+
+static int run_synthetic(float fs, int repeat) {
+    synth_t sy;
+    float seconds = s_segments[SEGMENT_COUNT - 1].end_s;
+    if (!synth_generate(&sy, fs, seconds)) {
+        fprintf(stderr, "메모리 부족\n");
+        synth_free(&sy);
+        return 1;
+    }
+
+    static motion_artifact_ctx_t ctx;
+    motion_artifact_init(&ctx, fs);
+    snr_acc_t in[SEGMENT_COUNT] = {0}, out[SEGMENT_COUNT] = {0};
+    int flagged[SEGMENT_COUNT] = {0}, total[SEGMENT_COUNT] = {0};
+
+    for (int i = 0; i < sy.n; i++) {
+        float t = i / fs;
+        float e = motion_artifact_process(&ctx, &sy.acc[i * 3], sy.input[i]);
+        for (int s = 0; s < SEGMENT_COUNT; s++) {
+            if (t < s_segments[s].start_s || t >= s_segments[s].end_s) {
+                continue;
+            }
+            total[s]++;
+            flagged[s] += motion_artifact_is_corrupted(&ctx);
+            if (t >= s_segments[s].start_s + SETTLE_S) {
+                snr_add(&in[s], sy.clean[i], sy.input[i] - sy.clean[i]);
+                snr_add(&out[s], sy.clean[i], e - sy.clean[i]);
+            }
+        }
+    }
+
+    printf("motion_artifact 합성 신호 (fs %.0fHz, 축 %d x 탭 %d)\n", fs, MA_REF_AXES, MA_TAPS);
+    printf("%-6s %10s %10s %10s %8s\n", "구간", "입력SNR", "출력SNR", "개선", "오염%");
+    for (int s = 0; s < SEGMENT_COUNT; s++) {
+        double a = snr_db(&in[s]), b = snr_db(&out[s]);
+        printf("%-6s %8.1fdB %8.1fdB %8.1fdB %7.1f%%\n", s_segments[s].name, a, b, b - a,
+               100.0 * flagged[s] / (total[s] ? total[s] : 1));
+    }
+
+    // 처리 시간 (같은 신호를 repeat회 반복)
+    uint64_t t0 = bench_now_ns();
+    float sink = 0.0f;
+    for (int r = 0; r < repeat; r++) {
+        motion_artifact_init(&ctx, fs);
+        for (int i = 0; i < sy.n; i++) {
+            sink += motion_artifact_process(&ctx, &sy.acc[i * 3], sy.input[i]);
+        }
+    }
+    double ns = (double)(bench_now_ns() - t0) / ((double)repeat * sy.n);
+    printf("처리 시간: %.1f ns/샘플 (호스트), 샘플 주기 %.0f us 대비 %.4f%% (sink %.1f)\n",
+           ns, 1e6 / fs, ns / (1e9 / fs) * 100.0, sink);
+
+    synth_free(&sy);
+    return 0;
+}
+
+static int run_trace(const char *path) {
+    trace_t tr;
+    if (!trace_load(path, &tr)) {
+        return 1;
+    }
+    if (tr.ppg_count < 2) {
+        fprintf(stderr, "%s: PPG 샘플 부족\n", path);
+        trace_free(&tr);
+        return 1;
+    }
+
+    float fs = 1000.0f / (float)(tr.ppg[1].t_ms - tr.ppg[0].t_ms);
+    static motion_artifact_ctx_t ctx;
+    motion_artifact_init(&ctx, fs);
+
+    float acc[3] = { GRAVITY_X, GRAVITY_Y, GRAVITY_Z };
+    size_t cursor = 0;
+    float dc = tr.ppg[0].v[1];
+    double in_sq = 0.0, out_sq = 0.0;
+    int n = 0, flagged = 0, flagged_total = 0;
+    uint32_t bucket = tr.ppg[0].t_ms / 1000;
+
+    printf("motion_artifact 트레이스 %s (PPG %.0fHz)\n", path, fs);
+    printf("%6s %10s %10s %10s %6s %6s\n", "t(s)", "motion(g)", "입력AC", "출력AC", "오염", "가중치");
+    for (size_t i = 0; i < tr.ppg_count; i++) {
+        const trace_sample_t *p = &tr.ppg[i];
+        trace_align_accel(&tr, &cursor, p->t_ms, acc);
+        dc = 0.95f * dc + 0.05f * p->v[1];      // heart_rate_calculator.c ALPHA_DC와 같은 DC 추정
+        float ac = p->v[1] - dc;
+        float e = motion_artifact_process(&ctx, acc, ac);
+
+        in_sq += (double)ac * ac;
+        out_sq += (double)e * e;
+        n++;
+        flagged += motion_artifact_is_corrupted(&ctx);
+
+        bool last = (i + 1 == tr.ppg_count);
+        if (last || tr.ppg[i + 1].t_ms / 1000 != bucket) {
+            printf("%6u %10.3f %10.1f %10.1f %5.0f%% %6.2f\n", bucket, motion_artifact_motion_rms(&ctx),
+                   sqrt(in_sq / n), sqrt(out_sq / n), 100.0 * flagged / n, motion_artifact_weight(&ctx));
+            flagged_total += flagged;
+            in_sq = out_sq = 0.0;
+            n = flagged = 0;
+            if (!last) {
+                bucket = tr.ppg[i + 1].t_ms / 1000;
+            }
+        }
+    }
+    printf("오염 샘플: %d / %zu\n", flagged_total, tr.ppg_count);
+    trace_free(&tr);
+    return 0;
+}
+
+int bench_motion(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "trace", required_argument, NULL, 't' },
+        { "fs", required_argument, NULL, 'f' },
+        { "repeat", required_argument, NULL, 'r' },
+        { "seed", required_argument, NULL, 's' },
+        { NULL, 0, NULL, 0 },
+    };
+    const char *trace = NULL;
+    float fs = 50.0f;       // sensor_manager의 MAX30102 읽기 주기
+    int repeat = 200;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (c) {
+            case 't': trace = optarg; break;
+            case 'f': fs = (float)atof(optarg); break;
+            case 'r': repeat = atoi(optarg); break;
+            case 's': bench_seed((uint32_t)strtoul(optarg, NULL, 10)); break;
+            default:
+                printf("usage: dsp_bench motion [--trace CSV] [--fs HZ] [--repeat N] [--seed N]\n");
+                return 2;
+        }
+    }
+    return trace ? run_trace(trace) : run_synthetic(fs, repeat);
+}
@@ -0,0 +1,170 @@
+// bench_orientation.c
+// orientation.c (Mahony 자세 추정) 벤치마크
+//
+// 합성 낙상: 선 자세 3초 → 0.6초 동안 X축으로 90° 회전하며 자유낙하(가속도 0.3g) → 충격(5g, 50ms)
+// → 누운 자세 3초. 기준 자세 대비 기울기의 정답과 비교해 Mahony와 기존 방식(샘플마다 가속도로
+// Roll/Pitch를 구하는 atan2f/sqrtf 2쌍)의 오차를 구간별로 보고하고, 갱신 1회당 사이클을 측정한다.
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "orientation.h"
+
+#define FS_HZ           100.0f      // sensor_manager의 MPU6050 읽기 주기
+#define STAND_S         3.0f
+#define FALL_S          0.6f
+#define IMPACT_S        0.05f
+#define LIE_S           3.0f
+#define FALL_DEG        90.0f
+#define GYRO_BIAS_DPS   0.3f
+
+typedef enum { PHASE_STAND, PHASE_FALL, PHASE_IMPACT, PHASE_LIE, PHASE_COUNT } phase_t;
+static const char *const s_phase_names[PHASE_COUNT] = { "stand", "fall", "impact", "lie" };
+
+typedef struct {
+    float acc[3];
+    float gyro[3];
+    float tilt_deg;     // 정답: 선 자세 대비 기울기
+    phase_t phase;
+} imu_truth_t;
+
+static int synth_fall(imu_truth_t **out) {
+    int n = (int)((STAND_S + FALL_S + IMPACT_S + LIE_S) * FS_HZ);
+    imu_truth_t *s = calloc((size_t)n, sizeof(*s));
+    if (s == NULL) {
+        return 0;
+    }
+    float rate_dps = FALL_DEG / FALL_S;
+    float theta = 0.0f;
+
+    for (int i = 0; i < n; i++) {
+        float t = i / FS_HZ;
+        float specific = 1.0f;      // 측정되는 비력 크기 (g)
+        float impact = 0.0f;
+        float gx = 0.0f;
+
+        if (t < STAND_S) {
+            s[i].phase = PHASE_STAND;
+        } else if (t < STAND_S + FALL_S) {
+            s[i].phase = PHASE_FALL;
+            gx = rate_dps;
+            theta += rate_dps / FS_HZ;
+            specific = 0.3f;
+        } else if (t < STAND_S + FALL_S + IMPACT_S) {
+            s[i].phase = PHASE_IMPACT;
+            theta = FALL_DEG;
+            impact = 5.0f;
+        } else {
+            s[i].phase = PHASE_LIE;
+        }
+
+        float th = theta * (float)M_PI / 180.0f;
+        s[i].acc[0] = 0.01f * bench_gauss() + 0.3f * impact * bench_gauss();
+        s[i].acc[1] = specific * sinf(th) + 0.01f * bench_gauss();
+        s[i].acc[2] = specific * cosf(th) - impact + 0.01f * bench_gauss();
+        s[i].gyro[0] = gx + GYRO_BIAS_DPS + 0.5f * bench_gauss() + 40.0f * impact / 5.0f * bench_gauss();
+        s[i].gyro[1] = GYRO_BIAS_DPS + 0.5f * bench_gauss();
+        s[i].gyro[2] = -GYRO_BIAS_DPS + 0.5f * bench_gauss();
+        s[i].tilt_deg = theta;
+    }
+    *out = s;
+    return n;
+}
+
+// 기존 mpu6050_step_fall.c 방식: 샘플마다 가속도만으로 Roll/Pitch → 총 각도
+static float accel_only_tilt_deg(const float a[3]) {
+    float roll = atan2f(a[1], sqrtf(a[0] * a[0] + a[2] * a[2])) * 180.0f / (float)M_PI;
+    float pitch = atan2f(-a[0], sqrtf(a[1] * a[1] + a[2] * a[2])) * 180.0f / (float)M_PI;
+    return sqrtf(roll * roll + pitch * pitch);
+}
+
+// 정답과 같은 기준(처음 선 자세의 Z축)으로 비교한다. tilt_cos는 기준 자세가 누운 뒤 천천히
+// 따라가므로 여기서는 쓰지 않는다.
+static float mahony_tilt_deg(const orientation_ctx_t *ctx) {
+    float c = ctx->gravity[2];
+    c = c > 1.0f ? 1.0f : (c < -1.0f ? -1.0f : c);
+    return acosf(c) * 180.0f / (float)M_PI;
+}
+
+int bench_orientation(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "repeat", required_argument, NULL, 'r' },
+        { "seed", required_argument, NULL, 's' },
+        { NULL, 0, NULL, 0 },
+    };
+    int repeat = 200;
+    int c;
+    while ((c = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (c) {
+            case 'r': repeat = atoi(optarg); break;
+            case 's': bench_seed((uint32_t)strtoul(optarg, NULL, 10)); break;
+            default:
+                printf("usage: dsp_bench orientation [--repeat N] [--seed N]\n");
+                return 2;
+        }
+    }
+
+    imu_truth_t *s = NULL;
+    int n = synth_fall(&s);
+    if (n == 0) {
+        fprintf(stderr, "메모리 부족\n");
+        return 1;
+    }
+
+    static orientation_ctx_t ctx;
+    orientation_init(&ctx, FS_HZ);
+    double err_m[PHASE_COUNT] = {0}, err_a[PHASE_COUNT] = {0};
+    int cnt[PHASE_COUNT] = {0};
+    float impact_m = 0.0f, impact_a = 0.0f, impact_lin = 0.0f;
+
+    for (int i = 0; i < n; i++) {
+        orientation_update(&ctx, s[i].acc, s[i].gyro);
+        float em = mahony_tilt_deg(&ctx) - s[i].tilt_deg;
+        float ea = accel_only_tilt_deg(s[i].acc) - s[i].tilt_deg;
+        err_m[s[i].phase] += em * em;
+        err_a[s[i].phase] += ea * ea;
+        cnt[s[i].phase]++;
+        if (s[i].phase == PHASE_IMPACT) {
+            impact_m = mahony_tilt_deg(&ctx);
+            impact_a = accel_only_tilt_deg(s[i].acc);
+            impact_lin = sqrtf(orientation_linear_sq(&ctx));
+        }
+    }
+
+    printf("orientation 합성 낙상 (%.0fHz, %.0f° 회전, 자이로 바이어스 %.1fdps)\n", FS_HZ, FALL_DEG, GYRO_BIAS_DPS);
+    printf("%-7s %14s %14s\n", "구간", "Mahony RMS", "가속도만 RMS");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        printf("%-7s %13.1f° %13.1f°\n", s_phase_names[p],
+               sqrt(err_m[p] / cnt[p]), sqrt(err_a[p] / cnt[p]));
+    }
+    printf("충격 마지막 샘플: 정답 %.0f°, Mahony %.1f°, 가속도만 %.1f° (선형 가속도 %.2fg)\n",
+           FALL_DEG, impact_m, impact_a, impact_lin);
+
+    // 갱신 1회 비용 (같은 시퀀스를 repeat회)
+    uint64_t t0 = bench_cycles();
+    float sink = 0.0f;
+    for (int r = 0; r < repeat; r++) {
+        orientation_init(&ctx, FS_HZ);
+        for (int i = 0; i < n; i++) {
+            orientation_update(&ctx, s[i].acc, s[i].gyro);
+            sink += ctx.tilt_cos;
+        }
+    }
+    uint64_t t1 = bench_cycles();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < n; i++) {
+            sink += accel_only_tilt_deg(s[i].acc);
+        }
+    }
+    uint64_t t2 = bench_cycles();
+    double per = (double)repeat * n;
+    const char *unit = bench_cycles_unit();
+    printf("갱신 1회: Mahony %.1f %s, 기존 가속도 각도 %.1f %s (호스트, sink %.1f)\n",
+           (t1 - t0) / per, unit, (t2 - t1) / per, unit, sink);
+
+    free(s);
+    return 0;
+}
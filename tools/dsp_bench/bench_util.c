@@ -0,0 +1,141 @@
+// bench_util.c
+
+#define _GNU_SOURCE
+#include "bench.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+static bool push_sample(trace_sample_t **arr, size_t *count, size_t *cap, const trace_sample_t *s) {
+    if (*count == *cap) {
+        size_t ncap = *cap ? *cap * 2 : 1024;
+        trace_sample_t *n = realloc(*arr, ncap * sizeof(**arr));
+        if (n == NULL) {
+            return false;
+        }
+        *arr = n;
+        *cap = ncap;
+    }
+    (*arr)[(*count)++] = *s;
+    return true;
+}
+
+bool trace_load(const char *path, trace_t *trace) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    memset(trace, 0, sizeof(*trace));
+    size_t imu_cap = 0, ppg_cap = 0;
+    char line[256];
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        trace_sample_t s = {0};
+        char kind[16];
+        int n = sscanf(line, "%u,%15[^,],%f,%f,%f,%f,%f,%f", &s.t_ms, kind,
+                       &s.v[0], &s.v[1], &s.v[2], &s.v[3], &s.v[4], &s.v[5]);
+        if (n == 8 && strcmp(kind, "imu") == 0) {
+            ok = push_sample(&trace->imu, &trace->imu_count, &imu_cap, &s);
+        } else if (n == 4 && strcmp(kind, "ppg") == 0) {
+            ok = push_sample(&trace->ppg, &trace->ppg_count, &ppg_cap, &s);
+        }
+    }
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "메모리 부족\n");
+        trace_free(trace);
+    }
+    return ok;
+}
+
+void trace_free(trace_t *trace) {
+    free(trace->imu);
+    free(trace->ppg);
+    memset(trace, 0, sizeof(*trace));
+}
+
+void trace_align_accel(const trace_t *trace, size_t *cursor, uint32_t t_ms, float acc_g[3]) {
+    float sum[3] = {0};
+    int n = 0;
+    while (*cursor < trace->imu_count && trace->imu[*cursor].t_ms <= t_ms) {
+        const trace_sample_t *s = &trace->imu[(*cursor)++];
+        sum[0] += s->v[0];
+        sum[1] += s->v[1];
+        sum[2] += s->v[2];
+        n++;
+    }
+    if (n > 0) {
+        for (int a = 0; a < 3; a++) {
+            acc_g[a] = sum[a] / n;
+        }
+    }
+}
+
+static uint32_t s_rng = 2463534242u;
+
+void bench_seed(uint32_t seed) {
+    s_rng = seed ? seed : 2463534242u;
+}
+
+float bench_uniform(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return (s_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+float bench_gauss(void) {
+    float u1 = bench_uniform();
+    float u2 = bench_uniform();
+    if (u1 < 1e-7f) {
+        u1 = 1e-7f;
+    }
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float)M_PI * u2);
+}
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t bench_cycles(void) {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return bench_now_ns();
+#endif
+}
+
+const char *bench_cycles_unit(void) {
+#ifdef HAVE_TSC
+    return "TSC 사이클";
+#else
+    return "ns";
+#endif
+}
+
+void snr_add(snr_acc_t *acc, float signal, float noise) {
+    acc->signal += (double)signal * signal;
+    acc->noise += (double)noise * noise;
+    acc->n++;
+}
+
+double snr_db(const snr_acc_t *acc) {
+    if (acc->noise <= 0.0) {
+        return INFINITY;
+    }
+    return 10.0 * log10(acc->signal / acc->noise);
+}
@@ -0,0 +1,60 @@
+// dsp_bench.c
+// 펌웨어 신호 처리 모듈 호스트 벤치마크
+//
+// 빌드:
+//   cmake -S tools/dsp_bench -B tools/dsp_bench/build && cmake --build tools/dsp_bench/build
+// 사용 예:
+//   tools/dsp_bench/build/dsp_bench motion
+//   tools/dsp_bench/build/dsp_bench orientation
+//   tools/dsp_bench/build/dsp_bench activity --verbose
+//   tools/dsp_bench/build/dsp_bench led_agc
+//   tools/dsp_bench/build/dsp_bench hr
+//   tools/dsp_bench/build/dsp_bench resp
+//   tools/dsp_bench/build/dsp_bench motion --trace user_sensor_board_ver2/components/sensor_backend/traces/walk_fall_10s.csv
+
+#include <stdio.h>
+#include <string.h>
+
+int bench_motion(int argc, char **argv);
+int bench_orientation(int argc, char **argv);
+int bench_activity(int argc, char **argv);
+int bench_led_agc(int argc, char **argv);
+int bench_hr(int argc, char **argv);
+int bench_resp(int argc, char **argv);
+
+typedef struct {
+    const char *name;
+    int (*run)(int argc, char **argv);
+    const char *help;
+} bench_t;
+
+static const bench_t s_benches[] = {
+    { "motion", bench_motion, "PPG 움직임 잡음 제거 (NLMS)" },
+    { "orientation", bench_orientation, "자세 추정 (Mahony) 정확도와 갱신 비용" },
+    { "activity", bench_activity, "활동 분류 (창 특징량 + 결정 트리) 정답률과 창당 비용" },
+    { "led_agc", bench_led_agc, "MAX30102 LED 전류 AGC: DC 대역 유지율과 평균 LED 전류" },
+    { "hr", bench_hr, "심박 엔진 비교 (시간 영역 / 스펙트럼 / 선택): 출력 비율, 오차, 처리 사이클" },
+    { "resp", bench_resp, "PPG 호흡수 추정 (기저선/진폭/간격 자기상관): 출력 비율, 오차, 품질 지표" },
+};
+
+static void usage(const char *prog) {
+    printf("usage: %s <bench> [options]\n", prog);
+    for (size_t i = 0; i < sizeof(s_benches) / sizeof(s_benches[0]); i++) {
+        printf("  %-10s %s\n", s_benches[i].name, s_benches[i].help);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    for (size_t i = 0; i < sizeof(s_benches) / sizeof(s_benches[0]); i++) {
+        if (strcmp(argv[1], s_benches[i].name) == 0) {
+            // getopt가 벤치 이름 다음부터 보도록 인자를 한 칸 민다
+            return s_benches[i].run(argc - 1, argv + 1);
+        }
+    }
+    usage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,11 @@
+// dlog.h (dsp_bench 호스트 빌드용) - 지연 로그는 호스트에서 컴파일하지 않는다
+
+#pragma once
+
+#include "esp_log.h"
+
+#define DLOGE(tag, fmt, ...) ((void)(tag))
+#define DLOGW(tag, fmt, ...) ((void)(tag))
+#define DLOGI(tag, fmt, ...) ((void)(tag))
+#define DLOGD(tag, fmt, ...) ((void)(tag))
+#define DLOGV(tag, fmt, ...) ((void)(tag))
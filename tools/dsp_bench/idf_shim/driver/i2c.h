@@ -0,0 +1,5 @@
+// driver/i2c.h (dsp_bench 호스트 빌드용) - max30102_driver.h의 선언에 필요한 타입만
+
+#pragma once
+
+typedef int i2c_port_t;
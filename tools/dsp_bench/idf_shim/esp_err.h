@@ -0,0 +1,8 @@
+// esp_err.h (dsp_bench 호스트 빌드용)
+
+#pragma once
+
+typedef int esp_err_t;
+
+#define ESP_OK      0
+#define ESP_FAIL    -1
@@ -0,0 +1,9 @@
+// esp_log.h (dsp_bench 호스트 빌드용) - 벤치 출력이 섞이지 않게 로그는 버린다
+
+#pragma once
+
+#define ESP_LOGE(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGW(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGI(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGD(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGV(tag, fmt, ...) ((void)(tag))
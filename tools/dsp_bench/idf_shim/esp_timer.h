@@ -0,0 +1,7 @@
+// esp_timer.h (dsp_bench 호스트 빌드용)
+
+#pragma once
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,27 @@
+// hr_engine_rename.h (dsp_bench 호스트 빌드용)
+// heart_rate_calculator.c를 심박 엔진마다 한 번씩 컴파일해 한 실행 파일에 넣기 위해
+// 공개 함수 이름 앞에 HR_BENCH_PREFIX를 붙인다 (CMakeLists.txt에서 -include로 강제 포함).
+
+#pragma once
+
+#define HR_BENCH_CAT_(a, b) a##b
+#define HR_BENCH_CAT(a, b)  HR_BENCH_CAT_(a, b)
+
+#define calculate_heart_rate_and_spo2   HR_BENCH_CAT(HR_BENCH_PREFIX, calculate_heart_rate_and_spo2)
+#define heart_rate_calculator_init      HR_BENCH_CAT(HR_BENCH_PREFIX, heart_rate_calculator_init)
+#define heart_rate_calculator_reset     HR_BENCH_CAT(HR_BENCH_PREFIX, heart_rate_calculator_reset)
+#define hr_get_latest                   HR_BENCH_CAT(HR_BENCH_PREFIX, hr_get_latest)
+#define hr_get_latest_spo2              HR_BENCH_CAT(HR_BENCH_PREFIX, hr_get_latest_spo2)
+#define hr_get_spo2_status              HR_BENCH_CAT(HR_BENCH_PREFIX, hr_get_spo2_status)
+#define hr_get_spo2_status_string       HR_BENCH_CAT(HR_BENCH_PREFIX, hr_get_spo2_status_string)
+#define hr_update_sample                HR_BENCH_CAT(HR_BENCH_PREFIX, hr_update_sample)
+#define hr_set_motion_reference         HR_BENCH_CAT(HR_BENCH_PREFIX, hr_set_motion_reference)
+#define hr_is_motion_corrupted          HR_BENCH_CAT(HR_BENCH_PREFIX, hr_is_motion_corrupted)
+#define hr_get_signal_quality           HR_BENCH_CAT(HR_BENCH_PREFIX, hr_get_signal_quality)
+#define hr_is_latest_valid              HR_BENCH_CAT(HR_BENCH_PREFIX, hr_is_latest_valid)
+#define hr_get_filtered_signals         HR_BENCH_CAT(HR_BENCH_PREFIX, hr_get_filtered_signals)
+#define hr_validate_signal_quality      HR_BENCH_CAT(HR_BENCH_PREFIX, hr_validate_signal_quality)
+#define hr_auto_adjust_led_current      HR_BENCH_CAT(HR_BENCH_PREFIX, hr_auto_adjust_led_current)
+#define hr_led_current_applied          HR_BENCH_CAT(HR_BENCH_PREFIX, hr_led_current_applied)
+#define hr_set_spo2_calibration         HR_BENCH_CAT(HR_BENCH_PREFIX, hr_set_spo2_calibration)
+#define hr_get_spo2_calibration         HR_BENCH_CAT(HR_BENCH_PREFIX, hr_get_spo2_calibration)
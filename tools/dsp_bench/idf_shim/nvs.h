@@ -0,0 +1,27 @@
+// nvs.h (dsp_bench 호스트 빌드용) - 저장소가 없으므로 열기는 항상 실패하고 기본값으로 동작한다
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_NOT_FOUND   0x1102
+
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+static inline esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out) {
+    (void)ns; (void)mode; (void)out;
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+static inline esp_err_t nvs_get_blob(nvs_handle_t h, const char *key, void *out, size_t *len) {
+    (void)h; (void)key; (void)out; (void)len;
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+static inline esp_err_t nvs_set_blob(nvs_handle_t h, const char *key, const void *v, size_t len) {
+    (void)h; (void)key; (void)v; (void)len;
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+static inline esp_err_t nvs_commit(nvs_handle_t h) { (void)h; return ESP_OK; }
+static inline void nvs_close(nvs_handle_t h) { (void)h; }
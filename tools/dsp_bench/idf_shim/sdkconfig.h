@@ -0,0 +1,12 @@
+// sdkconfig.h (dsp_bench 호스트 빌드용)
+// heart_rate_calculator.c를 호스트에서 컴파일하는 데 필요한 설정만 둔다.
+// 심박 엔진(CONFIG_HR_ENGINE_*)은 CMakeLists.txt에서 오브젝트마다 따로 정의한다.
+
+#pragma once
+
+#define CONFIG_DLOG_DEFAULT_LEVEL       0
+#define CONFIG_DLOG_LEVEL_HR_CALC       0
+#define CONFIG_HR_SPECTRAL_UPDATE_MS    1000
+#define CONFIG_HR_WARMUP_SAMPLES        100
+#define CONFIG_HR_SPECTRAL_FFT_SIZE     256
+#define CONFIG_HR_RESP_WINDOW           128
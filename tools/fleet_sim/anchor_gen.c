@@ -0,0 +1,51 @@
+// anchor_gen.c
+// 앵커 합성 환경값 → 펌웨어 mqtt_sender.c (anchor_sensor_board) 인코딩
+//
+// 앵커 송신 코드는 전역 vendor_config에서 major/minor를 읽으므로 호출 구간을 직렬화한다.
+// 앵커는 5초 주기라 경합 비용은 무시할 수 있다.
+// 웨어러블과 이름이 겹치는 mqtt_send_diagnostics는 CMake에서 anchor_ 접두사로 바꿔 링크한다.
+
+#include "sim.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "sensor_data.h"
+#include "mqtt_sender.h"
+#include "esp_ibeacon_api.h"
+
+esp_ble_ibeacon_vendor_t vendor_config;
+static pthread_mutex_t s_vendor_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void sim_anchor_init(sim_device_t *dev) {
+    dev->temp = 20.0f + 6.0f * sim_randf(dev);
+    dev->hr = 40.0f + 20.0f * sim_randf(dev);     // 습도로 사용
+    dev->major = (uint16_t)(1 + dev->index / 20);
+    dev->minor = (uint16_t)(1 + dev->index % 20);
+}
+
+void sim_anchor_sample(sim_device_t *dev, int64_t now_us) {
+    dev->temp += (sim_randf(dev) - 0.5f) * 0.05f;
+    dev->hr += (sim_randf(dev) - 0.5f) * 0.2f;
+
+    influx_sensor_data_t data;
+    memset(&data, 0, sizeof(data));
+    snprintf(data.measurement, sizeof(data.measurement), "sensor_data");
+    snprintf(data.device_id, sizeof(data.device_id), "%s", dev->device_id);
+    data.temperature = dev->temp;
+    data.humidity = dev->hr;
+    data.tvoc = 100.0f + 300.0f * sim_randf(dev);
+    data.lux = 200.0f + 400.0f * sim_randf(dev);
+    data.timestamp_ms = sim_utc_ms_from_mono(now_us);
+
+    pthread_mutex_lock(&s_vendor_lock);
+    vendor_config.major = ENDIAN_CHANGE_U16(dev->major);
+    vendor_config.minor = ENDIAN_CHANGE_U16(dev->minor);
+    sim_shim_bind(dev);
+    mqtt_send_influx_sensor_data(&data);
+    pthread_mutex_unlock(&s_vendor_lock);
+}
+
+void sim_anchor_diag(sim_device_t *dev) {
+    sim_shim_bind(dev);
+    mqtt_send_diagnostics();
+}
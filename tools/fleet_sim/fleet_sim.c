@@ -0,0 +1,1147 @@
+// fleet_sim.c
+// 웨어러블/앵커 플릿 부하 시뮬레이터 (인제스트 용량 산정용 벤치마크)
+//
+// 펌웨어의 mqtt_sender.c를 그대로 컴파일해 실제와 같은 JSON을 만들고, 장치마다 독립된
+// 주기/지터, Wi-Fi 끊김과 백오프 재접속, 재접속 폭주(storm), 오프라인 동안의 발행 대기열
+// (펌웨어 mqtt_outbox와 같은 클래스/예산/coalesce 규칙)을 흉내 내며 로컬 브로커로 발행한다.
+// 같은 프로세스의 구독자가 MQTT 5 user property "sim-ts"로 종단 지연을 측정하고,
+// 브로커 프로세스의 CPU 사용률을 /proc에서 읽어 함께 보고한다.
+//
+// 빌드:
+//   cmake -S tools/fleet_sim -B tools/fleet_sim/build && cmake --build tools/fleet_sim/build
+// 사용 예:
+//   mosquitto -c tools/mosquitto/mosquitto.conf &
+//   ulimit -n 65536
+//   tools/fleet_sim/build/fleet_sim --wearables 2000 --anchors 200 --duration 120
+//       --user a107 --pass 123456789 --storm-at 60 --storm-fraction 0.5   (한 줄로)
+//
+// 장치당 TCP 연결 1개를 쓰므로 장치 수만큼 파일 디스크립터가 필요하다.
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <getopt.h>
+#include <math.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <mosquitto.h>
+#include <mqtt_protocol.h>
+#include "sim.h"
+
+// 펌웨어 mqtt_outbox.c와 같은 클래스별 QoS (alert, vitals, env, diag)
+static const int s_class_qos[SIM_CLASS_COUNT] = { 1, 1, 1, 0 };
+#define SIM_CLASS_ALERT 0
+
+// 펌웨어 mqtt_client_wrapper.c의 토픽 접미사 (mqtt_topic_id_t 순서)
+static const char *const s_topic_suffix[SIM_TOPIC_COUNT] = { "data", "alert", "diag", "fallwin" };
+#define SIM_TOPIC_ALERT 1       // 메시지 만료를 붙이지 않는 토픽
+
+// ---- 설정 ----
+
+typedef struct {
+    const char *host;
+    int port;
+    const char *user;
+    const char *pass;
+    int keepalive_s;
+
+    int wearables;
+    int anchors;
+    int threads;
+    int duration_s;
+    int ramp_s;
+    int report_interval_s;
+
+    int wearable_period_ms;
+    int anchor_period_ms;
+    int diag_period_ms;
+    int jitter_ms;
+    double fall_per_hour;
+    double vital_per_hour;
+
+    double offline_per_hour;
+    int offline_min_s;
+    int offline_max_s;
+    int storm_at_s;
+    double storm_fraction;
+    int storm_outage_s;
+    int backoff_min_ms;         // wifi_manager 기본값과 동일
+    int backoff_max_ms;
+    int mqtt_reconnect_ms;      // esp-mqtt reconnect_timeout_ms 기본값
+
+    int queue_len;              // CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN
+    int max_inflight;           // CONFIG_APP_MQTT_OUTBOX_MAX_INFLIGHT
+    int budget_bytes;           // CONFIG_APP_MQTT_OUTBOX_BUDGET_BYTES
+    bool no_coalesce;           // 저장 후 전송(backfill 전부) 모델
+
+    bool per_device_topics;
+    bool topic_alias;
+    int message_expiry_s;
+    int session_expiry_s;
+    int subscribers;
+    int sub_qos;
+    int broker_pid;
+    uint32_t seed;
+} sim_config_t;
+
+static sim_config_t g_cfg = {
+    .host = "127.0.0.1",
+    .port = 1883,
+    .keepalive_s = 120,
+    .wearables = 100,
+    .anchors = 10,
+    .threads = 4,
+    .duration_s = 60,
+    .ramp_s = 10,
+    .report_interval_s = 5,
+    .wearable_period_ms = 1000,
+    .anchor_period_ms = 5000,
+    .diag_period_ms = 60000,
+    .jitter_ms = 50,
+    .fall_per_hour = 0.5,
+    .vital_per_hour = 1.0,
+    .offline_per_hour = 0.5,
+    .offline_min_s = 5,
+    .offline_max_s = 60,
+    .storm_at_s = -1,
+    .storm_fraction = 0.5,
+    .storm_outage_s = 20,
+    .backoff_min_ms = 250,
+    .backoff_max_ms = 30000,
+    .mqtt_reconnect_ms = 10000,
+    .queue_len = 8,
+    .max_inflight = 4,
+    .budget_bytes = 8192,
+    .message_expiry_s = 30,
+    .session_expiry_s = 300,
+    .subscribers = 1,
+    .sub_qos = 0,
+    .broker_pid = -1,
+    .seed = 1,
+};
+
+// ---- 시계 ----
+
+static int64_t s_utc_offset_us;
+
+int64_t sim_mono_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static int64_t utc_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+int64_t sim_utc_ms_from_mono(int64_t mono_us) {
+    return (mono_us + s_utc_offset_us) / 1000;
+}
+
+// ---- 난수 (장치별 xorshift32) ----
+
+uint32_t sim_rand(sim_device_t *dev) {
+    uint32_t x = dev->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    dev->rng = x;
+    return x;
+}
+
+float sim_randf(sim_device_t *dev) {
+    return (sim_rand(dev) >> 8) / 16777216.0f;
+}
+
+static int64_t exp_interval_us(sim_device_t *dev, double per_hour) {
+    if (per_hour <= 0) {
+        return INT64_MAX / 2;
+    }
+    double u = sim_randf(dev);
+    return (int64_t)(-log(1.0 - u) / per_hour * 3600e6);
+}
+
+static int64_t jitter_us(sim_device_t *dev) {
+    if (g_cfg.jitter_ms <= 0) {
+        return 0;
+    }
+    return ((int64_t)(sim_rand(dev) % (2 * g_cfg.jitter_ms + 1)) - g_cfg.jitter_ms) * 1000;
+}
+
+// ---- 지연 히스토그램 (로그-선형 버킷, 상대 오차 약 6%) ----
+
+#define HIST_SUB_BITS 4
+#define HIST_BUCKETS  (64 << HIST_SUB_BITS)
+
+typedef struct {
+    _Atomic uint64_t bucket[HIST_BUCKETS];
+    _Atomic uint64_t max;
+} hist_t;
+
+static int hist_index(uint64_t v) {
+    if (v < (1u << HIST_SUB_BITS)) {
+        return (int)v;
+    }
+    int msb = 63 - __builtin_clzll(v);
+    int sub = (int)((v >> (msb - HIST_SUB_BITS)) & ((1u << HIST_SUB_BITS) - 1));
+    return ((msb - HIST_SUB_BITS + 1) << HIST_SUB_BITS) + sub;
+}
+
+static uint64_t hist_value(int idx) {
+    if (idx < (1 << HIST_SUB_BITS)) {
+        return (uint64_t)idx;
+    }
+    int msb = (idx >> HIST_SUB_BITS) + HIST_SUB_BITS - 1;
+    uint64_t sub = (uint64_t)(idx & ((1 << HIST_SUB_BITS) - 1));
+    return ((1ull << HIST_SUB_BITS) + sub) << (msb - HIST_SUB_BITS);
+}
+
+static void hist_record(hist_t *h, int64_t v) {
+    if (v < 0) {
+        v = 0;
+    }
+    atomic_fetch_add_explicit(&h->bucket[hist_index((uint64_t)v)], 1, memory_order_relaxed);
+    uint64_t cur = atomic_load_explicit(&h->max, memory_order_relaxed);
+    while ((uint64_t)v > cur &&
+           !atomic_compare_exchange_weak_explicit(&h->max, &cur, (uint64_t)v, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+// 누적 히스토그램 스냅샷 (구간 통계는 두 스냅샷의 차이로 계산)
+typedef struct {
+    uint64_t bucket[HIST_BUCKETS];
+    uint64_t count;
+    uint64_t max;
+} hist_snap_t;
+
+static void hist_snapshot(hist_t *h, hist_snap_t *out) {
+    out->count = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        out->bucket[i] = atomic_load_explicit(&h->bucket[i], memory_order_relaxed);
+        out->count += out->bucket[i];
+    }
+    out->max = atomic_load_explicit(&h->max, memory_order_relaxed);
+}
+
+static uint64_t hist_percentile(const hist_snap_t *cur, const hist_snap_t *prev, double pct) {
+    uint64_t total = cur->count - (prev ? prev->count : 0);
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t target = (uint64_t)ceil(total * pct / 100.0);
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += cur->bucket[i] - (prev ? prev->bucket[i] : 0);
+        if (seen >= target) {
+            return hist_value(i);
+        }
+    }
+    return cur->max;
+}
+
+// ---- 전역 통계 ----
+
+static struct {
+    _Atomic uint64_t sent;
+    _Atomic uint64_t sent_bytes;
+    _Atomic uint64_t acked;
+    _Atomic uint64_t received;
+    _Atomic uint64_t publish_fail;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t coalesced;
+    _Atomic uint64_t connects;
+    _Atomic uint64_t connect_fail;
+    _Atomic uint64_t disconnects;
+    _Atomic int64_t online;
+    hist_t e2e_us;          // 발행 → 구독자 수신
+    hist_t ack_us;          // 발행 → PUBACK
+    hist_t connack_us;      // CONNECT → CONNACK
+    hist_t age_ms;          // 페이로드 "time" → 구독자 수신 (오프라인 backfill 포함)
+} g_stats;
+
+#define STAT_ADD(field, n) atomic_fetch_add_explicit(&g_stats.field, (n), memory_order_relaxed)
+#define STAT_GET(field)    atomic_load_explicit(&g_stats.field, memory_order_relaxed)
+
+static volatile sig_atomic_t g_stop = 0;
+static _Atomic int g_storm_epoch = 0;
+static int64_t g_start_us;
+
+// ---- 펌웨어 mqtt_outbox 모사 ----
+
+static void queue_pop(sim_device_t *dev, int cls, sim_msg_t *out) {
+    sim_queue_t *q = &dev->queues[cls];
+    *out = q->items[q->head];
+    q->head = (q->head + 1) % g_cfg.queue_len;
+    q->count--;
+    dev->pending_bytes -= out->len;
+}
+
+static void drop_oldest(sim_device_t *dev, int cls) {
+    sim_msg_t msg;
+    queue_pop(dev, cls, &msg);
+    free(msg.payload);
+    dev->drops[cls]++;
+    STAT_ADD(dropped, 1);
+}
+
+static void enforce_budget(sim_device_t *dev) {
+    for (int cls = SIM_CLASS_COUNT - 1; cls > SIM_CLASS_ALERT; cls--) {
+        while (dev->queues[cls].count > 0 && dev->pending_bytes + dev->inflight_bytes > g_cfg.budget_bytes) {
+            drop_oldest(dev, cls);
+        }
+    }
+}
+
+int sim_enqueue(sim_device_t *dev, int cls, int topic, const char *payload, int len, bool coalesce) {
+    if (len <= 0 || len > g_cfg.budget_bytes) {
+        dev->drops[cls]++;
+        STAT_ADD(dropped, 1);
+        return -1;
+    }
+    char *copy = malloc(len);
+    if (copy == NULL) {
+        return -1;
+    }
+    memcpy(copy, payload, len);
+
+    sim_queue_t *q = &dev->queues[cls];
+    if (coalesce && !g_cfg.no_coalesce) {
+        for (int i = 0; i < q->count; i++) {
+            sim_msg_t *m = &q->items[(q->head + i) % g_cfg.queue_len];
+            if (m->topic == topic) {
+                dev->pending_bytes += len - m->len;
+                free(m->payload);
+                m->payload = copy;
+                m->len = len;
+                dev->coalesced++;
+                STAT_ADD(coalesced, 1);
+                enforce_budget(dev);
+                return 0;
+            }
+        }
+    }
+    if (q->count == g_cfg.queue_len) {
+        drop_oldest(dev, cls);
+    }
+    sim_msg_t *m = &q->items[(q->head + q->count) % g_cfg.queue_len];
+    m->payload = copy;
+    m->len = len;
+    m->topic = topic;
+    q->count++;
+    dev->pending_bytes += len;
+    enforce_budget(dev);
+    return 0;
+}
+
+// ---- MQTT ----
+
+static void build_topic(const sim_device_t *dev, int topic, char *buf, size_t size) {
+    if (g_cfg.per_device_topics) {
+        snprintf(buf, size, "sensor/%s/%s", dev->device_id, s_topic_suffix[topic]);
+    } else {
+        snprintf(buf, size, "sensor/%s", s_topic_suffix[topic]);
+    }
+}
+
+static void mark_disconnected(sim_device_t *dev) {
+    if (dev->sock_open) {
+        dev->sock_open = false;
+        dev->mqtt_retry_us = sim_mono_us() + (int64_t)g_cfg.mqtt_reconnect_ms * 1000;
+        if (dev->mqtt_up) {
+            dev->mqtt_up = false;
+            dev->mqtt_disconnects++;
+            STAT_ADD(disconnects, 1);
+            STAT_ADD(online, -1);
+        }
+    }
+}
+
+static void on_connect(struct mosquitto *mosq, void *obj, int rc, int flags, const mosquitto_property *props) {
+    (void)mosq;
+    (void)flags;
+    (void)props;
+    sim_device_t *dev = obj;
+    if (rc != 0) {
+        STAT_ADD(connect_fail, 1);
+        return;
+    }
+    hist_record(&g_stats.connack_us, sim_mono_us() - dev->connect_start_us);
+    dev->mqtt_up = true;
+    memset(dev->alias_sent, 0, sizeof(dev->alias_sent));
+    STAT_ADD(connects, 1);
+    STAT_ADD(online, 1);
+}
+
+static void on_disconnect(struct mosquitto *mosq, void *obj, int rc, const mosquitto_property *props) {
+    (void)mosq;
+    (void)rc;
+    (void)props;
+    mark_disconnected(obj);
+}
+
+static void on_publish(struct mosquitto *mosq, void *obj, int mid, int reason_code, const mosquitto_property *props) {
+    (void)mosq;
+    (void)reason_code;
+    (void)props;
+    sim_device_t *dev = obj;
+    for (int i = 0; i < dev->inflight_count; i++) {
+        if (dev->inflight[i].mid == mid) {
+            hist_record(&g_stats.ack_us, sim_mono_us() - dev->inflight[i].sent_us);
+            dev->inflight_bytes -= dev->inflight[i].len;
+            dev->inflight[i] = dev->inflight[--dev->inflight_count];
+            STAT_ADD(acked, 1);
+            return;
+        }
+    }
+}
+
+static void mqtt_connect(sim_device_t *dev, int64_t now) {
+    if (dev->mosq == NULL) {
+        // 펌웨어 MQTT 5 모드와 같이 고정 client id + 세션 유지
+        dev->mosq = mosquitto_new(dev->client_id, false, dev);
+        if (dev->mosq == NULL) {
+            dev->mqtt_retry_us = now + (int64_t)g_cfg.mqtt_reconnect_ms * 1000;
+            return;
+        }
+        mosquitto_int_option(dev->mosq, MOSQ_OPT_PROTOCOL_VERSION, MQTT_PROTOCOL_V5);
+        if (g_cfg.user != NULL) {
+            mosquitto_username_pw_set(dev->mosq, g_cfg.user, g_cfg.pass);
+        }
+        mosquitto_connect_v5_callback_set(dev->mosq, on_connect);
+        mosquitto_disconnect_v5_callback_set(dev->mosq, on_disconnect);
+        mosquitto_publish_v5_callback_set(dev->mosq, on_publish);
+    }
+
+    mosquitto_property *props = NULL;
+    mosquitto_property_add_int32(&props, MQTT_PROP_SESSION_EXPIRY_INTERVAL, (uint32_t)g_cfg.session_expiry_s);
+    dev->connect_start_us = now;
+    dev->next_misc_us = now;
+    int rc = mosquitto_connect_bind_v5(dev->mosq, g_cfg.host, g_cfg.port, g_cfg.keepalive_s, NULL, props);
+    mosquitto_property_free_all(&props);
+
+    if (rc != MOSQ_ERR_SUCCESS) {
+        STAT_ADD(connect_fail, 1);
+        dev->mqtt_retry_us = now + (int64_t)g_cfg.mqtt_reconnect_ms * 1000;
+        return;
+    }
+    dev->sock_open = true;
+}
+
+static bool publish_one(sim_device_t *dev, int cls, sim_msg_t *msg, int64_t now) {
+    int qos = s_class_qos[cls];
+    char topic[64];
+    build_topic(dev, msg->topic, topic, sizeof(topic));
+
+    char ts[24];
+    snprintf(ts, sizeof(ts), "%lld", (long long)now);
+    mosquitto_property *props = NULL;
+    mosquitto_property_add_string_pair(&props, MQTT_PROP_USER_PROPERTY, "sim-ts", ts);
+    mosquitto_property_add_string_pair(&props, MQTT_PROP_USER_PROPERTY, "deviceId", dev->device_id);
+    mosquitto_property_add_string_pair(&props, MQTT_PROP_USER_PROPERTY, "board",
+                                       dev->kind == SIM_WEARABLE ? "wearable" : "anchor");
+    mosquitto_property_add_byte(&props, MQTT_PROP_PAYLOAD_FORMAT_INDICATOR, 1);
+    mosquitto_property_add_string(&props, MQTT_PROP_CONTENT_TYPE, "application/json");
+    if (g_cfg.message_expiry_s > 0 && msg->topic != SIM_TOPIC_ALERT) {
+        mosquitto_property_add_int32(&props, MQTT_PROP_MESSAGE_EXPIRY_INTERVAL, (uint32_t)g_cfg.message_expiry_s);
+    }
+    const char *topic_name = topic;
+    if (g_cfg.topic_alias) {
+        mosquitto_property_add_int16(&props, MQTT_PROP_TOPIC_ALIAS, (uint16_t)(msg->topic + 1));
+        // 펌웨어와 같이 QoS 0만 별칭 단독 (QoS 1은 재연결 후 재전송될 수 있으므로 항상 전체 토픽)
+        if (qos == 0 && dev->alias_sent[msg->topic]) {
+            topic_name = "";
+        }
+    }
+
+    int mid = 0;
+    int rc = mosquitto_publish_v5(dev->mosq, &mid, topic_name, msg->len, msg->payload, qos, false, props);
+    mosquitto_property_free_all(&props);
+    free(msg->payload);
+
+    if (rc != MOSQ_ERR_SUCCESS) {
+        STAT_ADD(publish_fail, 1);
+        dev->drops[cls]++;
+        return false;
+    }
+    if (qos == 0) {
+        dev->alias_sent[msg->topic] = true;
+    }
+    STAT_ADD(sent, 1);
+    STAT_ADD(sent_bytes, msg->len);
+    if (qos > 0 && dev->inflight_count < SIM_QUEUE_MAX) {
+        dev->inflight[dev->inflight_count].mid = mid;
+        dev->inflight[dev->inflight_count].len = msg->len;
+        dev->inflight[dev->inflight_count].sent_us = now;
+        dev->inflight_count++;
+        dev->inflight_bytes += msg->len;
+    }
+    return true;
+}
+
+// 펌웨어 mqtt_outbox drain()과 같은 규칙: 높은 클래스부터, 경보 외에는 인플라이트 한도 적용
+static void drain(sim_device_t *dev, int64_t now) {
+    while (dev->mqtt_up) {
+        int cls = 0;
+        while (cls < SIM_CLASS_COUNT && dev->queues[cls].count == 0) {
+            cls++;
+        }
+        if (cls == SIM_CLASS_COUNT) {
+            return;
+        }
+        if (s_class_qos[cls] > 0 && cls != SIM_CLASS_ALERT && dev->inflight_count >= g_cfg.max_inflight) {
+            return;
+        }
+        sim_msg_t msg;
+        queue_pop(dev, cls, &msg);
+        if (!publish_one(dev, cls, &msg, now)) {
+            return;
+        }
+    }
+}
+
+// ---- 장치 동작 ----
+
+static uint32_t backoff_ms(uint32_t attempts) {
+    uint32_t delay = (uint32_t)g_cfg.backoff_min_ms;
+    for (uint32_t i = 1; i < attempts && delay < (uint32_t)g_cfg.backoff_max_ms; i++) {
+        delay *= 2;
+    }
+    if (delay > (uint32_t)g_cfg.backoff_max_ms) {
+        delay = (uint32_t)g_cfg.backoff_max_ms;
+    }
+    return delay;
+}
+
+// Wi-Fi 끊김: DISCONNECT 없이 소켓을 닫아 브로커가 비정상 종료로 처리하게 함
+static void go_offline(sim_device_t *dev, int64_t now, int64_t until) {
+    if (dev->net_up) {
+        dev->wifi_disconnects++;
+    }
+    dev->net_up = false;
+    dev->offline_until_us = until;
+    dev->net_attempts = 1;
+    dev->net_retry_us = now + backoff_ms(1) * 1000LL;
+    if (dev->sock_open) {
+        shutdown(mosquitto_socket(dev->mosq), SHUT_RDWR);
+        mosquitto_loop_read(dev->mosq, 1);
+        mark_disconnected(dev);
+    }
+}
+
+static int64_t min64(int64_t a, int64_t b) {
+    return a < b ? a : b;
+}
+
+static void device_step(sim_device_t *dev, int64_t now, int64_t *next_wake) {
+    if (dev->net_up && now >= dev->next_offline_us) {
+        int span = g_cfg.offline_max_s - g_cfg.offline_min_s;
+        int64_t outage_s = g_cfg.offline_min_s + (span > 0 ? (int)(sim_rand(dev) % (span + 1)) : 0);
+        go_offline(dev, now, now + outage_s * 1000000LL);
+        dev->next_offline_us = now + exp_interval_us(dev, g_cfg.offline_per_hour);
+    }
+
+    // wifi_manager와 같은 지수 백오프 + 25% 지터로 재시도, 장애가 끝난 뒤 첫 시도에서 연결됨
+    if (!dev->net_up && now >= dev->net_retry_us) {
+        if (now >= dev->offline_until_us) {
+            dev->net_up = true;
+            dev->net_attempts = 0;
+            dev->mqtt_retry_us = now;
+        } else {
+            dev->net_attempts++;
+            uint32_t delay = backoff_ms(dev->net_attempts);
+            dev->net_retry_us = now + (delay + sim_rand(dev) % (delay / 4 + 1)) * 1000LL;
+        }
+    }
+
+    if (dev->net_up && !dev->sock_open && now >= dev->mqtt_retry_us) {
+        mqtt_connect(dev, now);
+    }
+
+    // 측정/전송 주기는 네트워크와 무관하게 계속 (오프라인 동안은 대기열에 쌓임)
+    if (now >= dev->next_sample_us) {
+        if (dev->kind == SIM_WEARABLE) {
+            sim_wearable_sample(dev, now);
+            dev->next_sample_us += g_cfg.wearable_period_ms * 1000LL + jitter_us(dev);
+        } else {
+            sim_anchor_sample(dev, now);
+            dev->next_sample_us += g_cfg.anchor_period_ms * 1000LL + jitter_us(dev);
+        }
+    }
+    if (dev->kind == SIM_WEARABLE && now >= dev->next_fall_us) {
+        sim_wearable_fall(dev, now);
+        dev->next_fall_us = now + exp_interval_us(dev, g_cfg.fall_per_hour);
+    }
+    if (dev->kind == SIM_WEARABLE && now >= dev->next_vital_us) {
+        sim_wearable_vital_alert(dev, now);
+        dev->next_vital_us = now + exp_interval_us(dev, g_cfg.vital_per_hour);
+    }
+    if (now >= dev->next_diag_us) {
+        if (dev->kind == SIM_WEARABLE) {
+            sim_wearable_diag(dev);
+        } else {
+            sim_anchor_diag(dev);
+        }
+        dev->next_diag_us += g_cfg.diag_period_ms * 1000LL;
+    }
+
+    if (dev->mqtt_up) {
+        drain(dev, now);
+        if (now >= dev->next_misc_us) {
+            mosquitto_loop_misc(dev->mosq);
+            dev->next_misc_us = now + 1000000;
+        }
+    }
+
+    int64_t wake = min64(dev->next_sample_us, dev->next_diag_us);
+    if (dev->kind == SIM_WEARABLE) {
+        wake = min64(wake, dev->next_fall_us);
+        wake = min64(wake, dev->next_vital_us);
+    }
+    if (!dev->net_up) {
+        wake = min64(wake, dev->net_retry_us);
+    } else if (!dev->sock_open) {
+        wake = min64(wake, dev->mqtt_retry_us);
+    }
+    *next_wake = min64(*next_wake, wake);
+}
+
+static void device_init(sim_device_t *dev, int index, sim_kind_t kind, int kind_index) {
+    memset(dev, 0, sizeof(*dev));
+    dev->kind = kind;
+    dev->index = kind_index;
+    dev->rng = (uint32_t)(index + 1) * 2654435761u ^ g_cfg.seed;
+    if (dev->rng == 0) {
+        dev->rng = 1;
+    }
+    if (kind == SIM_WEARABLE) {
+        snprintf(dev->device_id, sizeof(dev->device_id), "sim-w%05d", kind_index);
+        snprintf(dev->client_id, sizeof(dev->client_id), "wearable-%s", dev->device_id);
+        sim_wearable_init(dev);
+    } else {
+        snprintf(dev->device_id, sizeof(dev->device_id), "sim-a%04d", kind_index);
+        snprintf(dev->client_id, sizeof(dev->client_id), "anchor-%s", dev->device_id);
+        sim_anchor_init(dev);
+    }
+
+    // 부팅 시각을 ramp 구간에 분산
+    int64_t boot = g_start_us + (int64_t)(sim_randf(dev) * g_cfg.ramp_s * 1e6);
+    dev->offline_until_us = boot;
+    dev->net_retry_us = boot;
+    dev->next_sample_us = boot;
+    dev->next_diag_us = boot + (int64_t)(sim_randf(dev) * g_cfg.diag_period_ms) * 1000;
+    dev->next_fall_us = boot + exp_interval_us(dev, g_cfg.fall_per_hour);
+    dev->next_vital_us = boot + exp_interval_us(dev, g_cfg.vital_per_hour);
+    dev->next_offline_us = boot + exp_interval_us(dev, g_cfg.offline_per_hour);
+}
+
+// ---- 워커 ----
+
+typedef struct {
+    int id;
+    sim_device_t *devices;
+    int count;
+    pthread_t thread;
+} worker_t;
+
+static void *worker_main(void *arg) {
+    worker_t *w = arg;
+    struct pollfd *pfds = calloc(w->count, sizeof(*pfds));
+    int *map = calloc(w->count, sizeof(*map));
+    int storm_seen = 0;
+
+    while (!g_stop) {
+        int64_t now = sim_mono_us();
+
+        int epoch = atomic_load(&g_storm_epoch);
+        if (epoch != storm_seen) {
+            // AP 재부팅 같은 집단 장애: 일부 장치를 같은 시각에 끊고 같은 시각에 복구
+            storm_seen = epoch;
+            for (int i = 0; i < w->count; i++) {
+                sim_device_t *dev = &w->devices[i];
+                if (dev->net_up && sim_randf(dev) < g_cfg.storm_fraction) {
+                    go_offline(dev, now, now + g_cfg.storm_outage_s * 1000000LL);
+                }
+            }
+        }
+
+        int64_t next_wake = now + 100000;
+        int n = 0;
+        for (int i = 0; i < w->count; i++) {
+            sim_device_t *dev = &w->devices[i];
+            device_step(dev, now, &next_wake);
+            if (dev->sock_open) {
+                pfds[n].fd = mosquitto_socket(dev->mosq);
+                pfds[n].events = POLLIN | (mosquitto_want_write(dev->mosq) ? POLLOUT : 0);
+                pfds[n].revents = 0;
+                map[n++] = i;
+            }
+        }
+
+        int timeout_ms = (int)((next_wake - sim_mono_us()) / 1000);
+        if (timeout_ms < 0) {
+            timeout_ms = 0;
+        }
+        if (n == 0) {
+            usleep((useconds_t)timeout_ms * 1000);
+            continue;
+        }
+        if (poll(pfds, n, timeout_ms) <= 0) {
+            continue;
+        }
+
+        for (int k = 0; k < n; k++) {
+            sim_device_t *dev = &w->devices[map[k]];
+            int rc = MOSQ_ERR_SUCCESS;
+            if (pfds[k].revents & (POLLIN | POLLERR | POLLHUP)) {
+                rc = mosquitto_loop_read(dev->mosq, 16);
+            }
+            if (rc == MOSQ_ERR_SUCCESS && (pfds[k].revents & POLLOUT)) {
+                rc = mosquitto_loop_write(dev->mosq, 16);
+            }
+            if (rc != MOSQ_ERR_SUCCESS && rc != MOSQ_ERR_AGAIN) {
+                mark_disconnected(dev);
+            }
+        }
+    }
+
+    for (int i = 0; i < w->count; i++) {
+        sim_device_t *dev = &w->devices[i];
+        if (dev->mosq != NULL) {
+            if (dev->sock_open) {
+                mosquitto_disconnect(dev->mosq);
+            }
+            mosquitto_destroy(dev->mosq);
+        }
+        for (int cls = 0; cls < SIM_CLASS_COUNT; cls++) {
+            while (dev->queues[cls].count > 0) {
+                sim_msg_t msg;
+                queue_pop(dev, cls, &msg);
+                free(msg.payload);
+            }
+        }
+    }
+    free(pfds);
+    free(map);
+    return NULL;
+}
+
+// ---- 구독자 (인제스트 측 소비자 역할) ----
+
+static void on_message(struct mosquitto *mosq, void *obj, const struct mosquitto_message *msg,
+                       const mosquitto_property *props) {
+    (void)mosq;
+    (void)obj;
+    (void)props;
+    int64_t now_us = sim_mono_us();
+    STAT_ADD(received, 1);
+
+    char *name = NULL;
+    char *value = NULL;
+    const mosquitto_property *p = mosquitto_property_read_string_pair(props, MQTT_PROP_USER_PROPERTY, &name, &value, false);
+    while (p != NULL) {
+        if (strcmp(name, "sim-ts") == 0) {
+            hist_record(&g_stats.e2e_us, now_us - strtoll(value, NULL, 10));
+        }
+        free(name);
+        free(value);
+        name = value = NULL;
+        p = mosquitto_property_read_string_pair(p, MQTT_PROP_USER_PROPERTY, &name, &value, true);
+    }
+
+    // 펌웨어 JSON의 레코드 시각 (오프라인 동안 쌓였다 전송된 메시지는 여기서 드러남)
+    char buf[1024];
+    int len = msg->payloadlen < (int)sizeof(buf) - 1 ? msg->payloadlen : (int)sizeof(buf) - 1;
+    memcpy(buf, msg->payload, len);
+    buf[len] = '\0';
+    const char *t = strstr(buf, "\"time\": ");
+    if (t != NULL) {
+        hist_record(&g_stats.age_ms, utc_now_ms() - strtoll(t + 8, NULL, 10));
+    }
+}
+
+static void on_sub_connect(struct mosquitto *mosq, void *obj, int rc, int flags, const mosquitto_property *props) {
+    (void)obj;
+    (void)flags;
+    (void)props;
+    if (rc != 0) {
+        fprintf(stderr, "구독자 연결 거부: %s\n", mosquitto_reason_string(rc));
+        return;
+    }
+    // 여러 구독자는 공유 구독으로 부하 분산 (인제스트 워커 수 시뮬레이션)
+    const char *filter = g_cfg.subscribers > 1 ? "$share/fleet_sim/sensor/#" : "sensor/#";
+    mosquitto_subscribe_v5(mosq, NULL, filter, g_cfg.sub_qos, 0, NULL);
+}
+
+static struct mosquitto *start_subscriber(int index) {
+    char id[32];
+    snprintf(id, sizeof(id), "fleet-sim-sub-%d", index);
+    struct mosquitto *mosq = mosquitto_new(id, true, NULL);
+    if (mosq == NULL) {
+        return NULL;
+    }
+    mosquitto_int_option(mosq, MOSQ_OPT_PROTOCOL_VERSION, MQTT_PROTOCOL_V5);
+    if (g_cfg.user != NULL) {
+        mosquitto_username_pw_set(mosq, g_cfg.user, g_cfg.pass);
+    }
+    mosquitto_connect_v5_callback_set(mosq, on_sub_connect);
+    mosquitto_message_v5_callback_set(mosq, on_message);
+    int rc = mosquitto_connect_bind_v5(mosq, g_cfg.host, g_cfg.port, 60, NULL, NULL);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        fprintf(stderr, "구독자 연결 실패 (%s:%d): %s\n", g_cfg.host, g_cfg.port, mosquitto_strerror(rc));
+        mosquitto_destroy(mosq);
+        return NULL;
+    }
+    mosquitto_loop_start(mosq);
+    return mosq;
+}
+
+// ---- 브로커 CPU ----
+
+static int find_broker_pid(void) {
+    DIR *dir = opendir("/proc");
+    if (dir == NULL) {
+        return -1;
+    }
+    int pid = -1;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL && pid < 0) {
+        char path[300];
+        char comm[64] = {0};
+        snprintf(path, sizeof(path), "/proc/%s/comm", ent->d_name);
+        FILE *f = fopen(path, "r");
+        if (f == NULL) {
+            continue;
+        }
+        if (fgets(comm, sizeof(comm), f) != NULL && strncmp(comm, "mosquitto", 9) == 0) {
+            pid = atoi(ent->d_name);
+        }
+        fclose(f);
+    }
+    closedir(dir);
+    return pid;
+}
+
+// utime + stime (clock tick), 실패 시 -1
+static long long read_cpu_ticks(int pid) {
+    if (pid <= 0) {
+        return -1;
+    }
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    // comm에 공백이 있을 수 있으므로 마지막 ')' 뒤부터 필드를 센다 (state가 3번째 필드)
+    char *p = strrchr(buf, ')');
+    if (p == NULL) {
+        return -1;
+    }
+    unsigned long utime = 0, stime = 0;
+    if (sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2) {
+        return -1;
+    }
+    return (long long)(utime + stime);
+}
+
+// ---- 보고 ----
+
+static double cpu_percent(long long t0, long long t1, int64_t span_us) {
+    if (t0 < 0 || t1 < 0 || span_us <= 0) {
+        return -1.0;
+    }
+    return (double)(t1 - t0) / sysconf(_SC_CLK_TCK) / (span_us / 1e6) * 100.0;
+}
+
+static void print_summary(int64_t span_us, long long cpu0, long long cpu1) {
+    static hist_snap_t e2e, ack, connack, age;
+    hist_snapshot(&g_stats.e2e_us, &e2e);
+    hist_snapshot(&g_stats.ack_us, &ack);
+    hist_snapshot(&g_stats.connack_us, &connack);
+    hist_snapshot(&g_stats.age_ms, &age);
+    double secs = span_us / 1e6;
+
+    printf("\n===== fleet_sim 결과 (%d wearables, %d anchors, %.0fs) =====\n",
+           g_cfg.wearables, g_cfg.anchors, secs);
+    printf("발행       %llu msgs (%.1f msgs/s, %.1f KB/s), PUBACK %llu, 실패 %llu\n",
+           (unsigned long long)STAT_GET(sent), STAT_GET(sent) / secs, STAT_GET(sent_bytes) / secs / 1024.0,
+           (unsigned long long)STAT_GET(acked), (unsigned long long)STAT_GET(publish_fail));
+    printf("수신       %llu msgs (%.1f msgs/s)\n", (unsigned long long)STAT_GET(received), STAT_GET(received) / secs);
+    printf("대기열     버림 %llu, 덮어씀 %llu\n",
+           (unsigned long long)STAT_GET(dropped), (unsigned long long)STAT_GET(coalesced));
+    printf("연결       성공 %llu, 실패 %llu, 끊김 %llu\n", (unsigned long long)STAT_GET(connects),
+           (unsigned long long)STAT_GET(connect_fail), (unsigned long long)STAT_GET(disconnects));
+    printf("종단 지연  p50 %.2fms  p90 %.2fms  p99 %.2fms  p99.9 %.2fms  max %.2fms\n",
+           hist_percentile(&e2e, NULL, 50) / 1e3, hist_percentile(&e2e, NULL, 90) / 1e3,
+           hist_percentile(&e2e, NULL, 99) / 1e3, hist_percentile(&e2e, NULL, 99.9) / 1e3, e2e.max / 1e3);
+    printf("PUBACK     p50 %.2fms  p99 %.2fms  max %.2fms\n",
+           hist_percentile(&ack, NULL, 50) / 1e3, hist_percentile(&ack, NULL, 99) / 1e3, ack.max / 1e3);
+    printf("CONNACK    p50 %.2fms  p99 %.2fms  max %.2fms\n",
+           hist_percentile(&connack, NULL, 50) / 1e3, hist_percentile(&connack, NULL, 99) / 1e3, connack.max / 1e3);
+    printf("데이터 나이 p50 %llums  p99 %llums  max %llums (레코드 시각 → 수신)\n",
+           (unsigned long long)hist_percentile(&age, NULL, 50), (unsigned long long)hist_percentile(&age, NULL, 99),
+           (unsigned long long)age.max);
+    double cpu = cpu_percent(cpu0, cpu1, span_us);
+    if (cpu >= 0) {
+        printf("브로커 CPU 평균 %.1f%% (pid %d)\n", cpu, g_cfg.broker_pid);
+    } else {
+        printf("브로커 CPU 측정 불가 (--broker-pid 지정)\n");
+    }
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static void usage(const char *prog) {
+    printf("usage: %s [options]\n"
+           "  --host H --port P --user U --pass P  브로커 (기본 127.0.0.1:1883)\n"
+           "  --wearables N --anchors M            장치 수 (기본 100 / 10)\n"
+           "  --threads T                          워커 스레드 수 (기본 4)\n"
+           "  --duration S --ramp S                실행 시간, 부팅 분산 구간 (기본 60 / 10)\n"
+           "  --report-interval S                  중간 보고 주기 (기본 5)\n"
+           "  --wearable-period-ms --anchor-period-ms --diag-period-ms --jitter-ms\n"
+           "  --fall-per-hour R                    웨어러블당 낙상 경보 빈도 (기본 0.5)\n"
+           "  --vital-per-hour R                   웨어러블당 생체 경보 발생/해제 빈도 (기본 1)\n"
+           "  --offline-per-hour R --offline-min S --offline-max S   개별 Wi-Fi 끊김\n"
+           "  --storm-at S --storm-fraction F --storm-outage S       집단 끊김 후 동시 재접속\n"
+           "  --queue-len N --max-inflight N --budget B --no-coalesce  발행 대기열 (펌웨어 Kconfig)\n"
+           "  --per-device-topics --topic-alias --message-expiry S --session-expiry S\n"
+           "  --subscribers K --sub-qos Q          인제스트 구독자 수 (K>1이면 공유 구독)\n"
+           "  --broker-pid P --seed N\n", prog);
+}
+
+static void parse_args(int argc, char **argv) {
+    enum {
+        OPT_HOST = 1000, OPT_PORT, OPT_USER, OPT_PASS, OPT_WEARABLES, OPT_ANCHORS, OPT_THREADS, OPT_DURATION,
+        OPT_RAMP, OPT_REPORT, OPT_W_PERIOD, OPT_A_PERIOD, OPT_D_PERIOD, OPT_JITTER, OPT_FALL, OPT_VITAL, OPT_OFF_RATE,
+        OPT_OFF_MIN, OPT_OFF_MAX, OPT_STORM_AT, OPT_STORM_FRAC, OPT_STORM_OUTAGE, OPT_QUEUE_LEN, OPT_INFLIGHT,
+        OPT_BUDGET, OPT_NO_COALESCE, OPT_PER_DEVICE, OPT_ALIAS, OPT_EXPIRY, OPT_SESSION, OPT_SUBS, OPT_SUB_QOS,
+        OPT_BROKER_PID, OPT_SEED, OPT_HELP,
+    };
+    static const struct option opts[] = {
+        { "host", required_argument, NULL, OPT_HOST },
+        { "port", required_argument, NULL, OPT_PORT },
+        { "user", required_argument, NULL, OPT_USER },
+        { "pass", required_argument, NULL, OPT_PASS },
+        { "wearables", required_argument, NULL, OPT_WEARABLES },
+        { "anchors", required_argument, NULL, OPT_ANCHORS },
+        { "threads", required_argument, NULL, OPT_THREADS },
+        { "duration", required_argument, NULL, OPT_DURATION },
+        { "ramp", required_argument, NULL, OPT_RAMP },
+        { "report-interval", required_argument, NULL, OPT_REPORT },
+        { "wearable-period-ms", required_argument, NULL, OPT_W_PERIOD },
+        { "anchor-period-ms", required_argument, NULL, OPT_A_PERIOD },
+        { "diag-period-ms", required_argument, NULL, OPT_D_PERIOD },
+        { "jitter-ms", required_argument, NULL, OPT_JITTER },
+        { "fall-per-hour", required_argument, NULL, OPT_FALL },
+        { "vital-per-hour", required_argument, NULL, OPT_VITAL },
+        { "offline-per-hour", required_argument, NULL, OPT_OFF_RATE },
+        { "offline-min", required_argument, NULL, OPT_OFF_MIN },
+        { "offline-max", required_argument, NULL, OPT_OFF_MAX },
+        { "storm-at", required_argument, NULL, OPT_STORM_AT },
+        { "storm-fraction", required_argument, NULL, OPT_STORM_FRAC },
+        { "storm-outage", required_argument, NULL, OPT_STORM_OUTAGE },
+        { "queue-len", required_argument, NULL, OPT_QUEUE_LEN },
+        { "max-inflight", required_argument, NULL, OPT_INFLIGHT },
+        { "budget", required_argument, NULL, OPT_BUDGET },
+        { "no-coalesce", no_argument, NULL, OPT_NO_COALESCE },
+        { "per-device-topics", no_argument, NULL, OPT_PER_DEVICE },
+        { "topic-alias", no_argument, NULL, OPT_ALIAS },
+        { "message-expiry", required_argument, NULL, OPT_EXPIRY },
+        { "session-expiry", required_argument, NULL, OPT_SESSION },
+        { "subscribers", required_argument, NULL, OPT_SUBS },
+        { "sub-qos", required_argument, NULL, OPT_SUB_QOS },
+        { "broker-pid", required_argument, NULL, OPT_BROKER_PID },
+        { "seed", required_argument, NULL, OPT_SEED },
+        { "help", no_argument, NULL, OPT_HELP },
+        { NULL, 0, NULL, 0 },
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (c) {
+            case OPT_HOST:          g_cfg.host = optarg; break;
+            case OPT_PORT:          g_cfg.port = atoi(optarg); break;
+            case OPT_USER:          g_cfg.user = optarg; break;
+            case OPT_PASS:          g_cfg.pass = optarg; break;
+            case OPT_WEARABLES:     g_cfg.wearables = atoi(optarg); break;
+            case OPT_ANCHORS:       g_cfg.anchors = atoi(optarg); break;
+            case OPT_THREADS:       g_cfg.threads = atoi(optarg); break;
+            case OPT_DURATION:      g_cfg.duration_s = atoi(optarg); break;
+            case OPT_RAMP:          g_cfg.ramp_s = atoi(optarg); break;
+            case OPT_REPORT:        g_cfg.report_interval_s = atoi(optarg); break;
+            case OPT_W_PERIOD:      g_cfg.wearable_period_ms = atoi(optarg); break;
+            case OPT_A_PERIOD:      g_cfg.anchor_period_ms = atoi(optarg); break;
+            case OPT_D_PERIOD:      g_cfg.diag_period_ms = atoi(optarg); break;
+            case OPT_JITTER:        g_cfg.jitter_ms = atoi(optarg); break;
+            case OPT_FALL:          g_cfg.fall_per_hour = atof(optarg); break;
+            case OPT_VITAL:         g_cfg.vital_per_hour = atof(optarg); break;
+            case OPT_OFF_RATE:      g_cfg.offline_per_hour = atof(optarg); break;
+            case OPT_OFF_MIN:       g_cfg.offline_min_s = atoi(optarg); break;
+            case OPT_OFF_MAX:       g_cfg.offline_max_s = atoi(optarg); break;
+            case OPT_STORM_AT:      g_cfg.storm_at_s = atoi(optarg); break;
+            case OPT_STORM_FRAC:    g_cfg.storm_fraction = atof(optarg); break;
+            case OPT_STORM_OUTAGE:  g_cfg.storm_outage_s = atoi(optarg); break;
+            case OPT_QUEUE_LEN:     g_cfg.queue_len = atoi(optarg); break;
+            case OPT_INFLIGHT:      g_cfg.max_inflight = atoi(optarg); break;
+            case OPT_BUDGET:        g_cfg.budget_bytes = atoi(optarg); break;
+            case OPT_NO_COALESCE:   g_cfg.no_coalesce = true; break;
+            case OPT_PER_DEVICE:    g_cfg.per_device_topics = true; break;
+            case OPT_ALIAS:         g_cfg.topic_alias = true; break;
+            case OPT_EXPIRY:        g_cfg.message_expiry_s = atoi(optarg); break;
+            case OPT_SESSION:       g_cfg.session_expiry_s = atoi(optarg); break;
+            case OPT_SUBS:          g_cfg.subscribers = atoi(optarg); break;
+            case OPT_SUB_QOS:       g_cfg.sub_qos = atoi(optarg); break;
+            case OPT_BROKER_PID:    g_cfg.broker_pid = atoi(optarg); break;
+            case OPT_SEED:          g_cfg.seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                exit(c == OPT_HELP ? 0 : 2);
+        }
+    }
+
+    if (g_cfg.queue_len < 1 || g_cfg.queue_len > SIM_QUEUE_MAX ||
+        g_cfg.max_inflight < 1 || g_cfg.max_inflight > SIM_QUEUE_MAX) {
+        fprintf(stderr, "--queue-len / --max-inflight 는 1..%d\n", SIM_QUEUE_MAX);
+        exit(2);
+    }
+    if (g_cfg.threads < 1) {
+        g_cfg.threads = 1;
+    }
+    if (g_cfg.offline_max_s < g_cfg.offline_min_s) {
+        g_cfg.offline_max_s = g_cfg.offline_min_s;
+    }
+}
+
+int main(int argc, char **argv) {
+    parse_args(argc, argv);
+    signal(SIGINT, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    mosquitto_lib_init();
+
+    s_utc_offset_us = utc_now_ms() * 1000 - sim_mono_us();
+    g_start_us = sim_mono_us();
+    if (g_cfg.broker_pid < 0) {
+        g_cfg.broker_pid = find_broker_pid();
+    }
+
+    int total = g_cfg.wearables + g_cfg.anchors;
+    sim_device_t *devices = calloc(total, sizeof(*devices));
+    worker_t *workers = calloc(g_cfg.threads, sizeof(*workers));
+    if (devices == NULL || workers == NULL) {
+        fprintf(stderr, "메모리 부족\n");
+        return 1;
+    }
+
+    // 워커별로 연속 구간을 배정 (장치는 해당 워커 스레드에서만 접근)
+    for (int i = 0; i < total; i++) {
+        if (i < g_cfg.wearables) {
+            device_init(&devices[i], i, SIM_WEARABLE, i);
+        } else {
+            device_init(&devices[i], i, SIM_ANCHOR, i - g_cfg.wearables);
+        }
+    }
+
+    struct mosquitto **subs = calloc(g_cfg.subscribers, sizeof(*subs));
+    for (int i = 0; i < g_cfg.subscribers; i++) {
+        subs[i] = start_subscriber(i);
+        if (subs[i] == NULL) {
+            return 1;
+        }
+    }
+
+    int base = 0;
+    for (int t = 0; t < g_cfg.threads; t++) {
+        int count = total / g_cfg.threads + (t < total % g_cfg.threads ? 1 : 0);
+        workers[t].id = t;
+        workers[t].devices = &devices[base];
+        workers[t].count = count;
+        base += count;
+        pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]);
+    }
+
+    printf("%6s %7s %9s %9s %10s %10s %10s %8s\n",
+           "t(s)", "online", "sent/s", "recv/s", "e2e p50", "e2e p99", "ack p99", "broker%");
+
+    long long cpu_start = read_cpu_ticks(g_cfg.broker_pid);
+    long long cpu_prev = cpu_start;
+    uint64_t sent_prev = 0;
+    uint64_t recv_prev = 0;
+    static hist_snap_t e2e_prev, e2e_cur, ack_prev, ack_cur;
+    int64_t report_prev = sim_mono_us();
+    bool storm_done = g_cfg.storm_at_s < 0;
+
+    while (!g_stop) {
+        usleep(100000);
+        int64_t now = sim_mono_us();
+        if (now - g_start_us >= (int64_t)g_cfg.duration_s * 1000000) {
+            break;
+        }
+        if (!storm_done && now - g_start_us >= (int64_t)g_cfg.storm_at_s * 1000000) {
+            storm_done = true;
+            atomic_fetch_add(&g_storm_epoch, 1);
+            printf("--- storm: %.0f%% 장치 %ds 동안 오프라인 ---\n", g_cfg.storm_fraction * 100, g_cfg.storm_outage_s);
+        }
+        if (now - report_prev < (int64_t)g_cfg.report_interval_s * 1000000) {
+            continue;
+        }
+
+        double span = (now - report_prev) / 1e6;
+        uint64_t sent = STAT_GET(sent);
+        uint64_t recv = STAT_GET(received);
+        long long cpu = read_cpu_ticks(g_cfg.broker_pid);
+        hist_snapshot(&g_stats.e2e_us, &e2e_cur);
+        hist_snapshot(&g_stats.ack_us, &ack_cur);
+        printf("%6.0f %7lld %9.1f %9.1f %8.2fms %8.2fms %8.2fms %7.1f%%\n",
+               (now - g_start_us) / 1e6, (long long)STAT_GET(online),
+               (sent - sent_prev) / span, (recv - recv_prev) / span,
+               hist_percentile(&e2e_cur, &e2e_prev, 50) / 1e3, hist_percentile(&e2e_cur, &e2e_prev, 99) / 1e3,
+               hist_percentile(&ack_cur, &ack_prev, 99) / 1e3, cpu_percent(cpu_prev, cpu, now - report_prev));
+        fflush(stdout);
+
+        sent_prev = sent;
+        recv_prev = recv;
+        cpu_prev = cpu;
+        e2e_prev = e2e_cur;
+        ack_prev = ack_cur;
+        report_prev = now;
+    }
+
+    int64_t span_us = sim_mono_us() - g_start_us;
+    long long cpu_end = read_cpu_ticks(g_cfg.broker_pid);
+
+    g_stop = 1;
+    for (int t = 0; t < g_cfg.threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    // 마지막 메시지가 구독자에게 도달할 시간
+    usleep(500000);
+    for (int i = 0; i < g_cfg.subscribers; i++) {
+        mosquitto_disconnect(subs[i]);
+        mosquitto_loop_stop(subs[i], false);
+        mosquitto_destroy(subs[i]);
+    }
+
+    print_summary(span_us, cpu_start, cpu_end);
+
+    free(subs);
+    free(workers);
+    free(devices);
+    mosquitto_lib_cleanup();
+    return 0;
+}
@@ -0,0 +1,84 @@
+// fw_shim.c
+// 펌웨어 mqtt_sender.c가 호출하는 함수들의 호스트 구현
+//
+// 송신 코드는 전역 상태(기기 ID, metrics, outbox)를 가정하므로, 워커 스레드가
+// sim_shim_bind()로 현재 장치를 지정한 뒤 송신 함수를 호출한다.
+
+#include "sim.h"
+#include <time.h>
+#include "esp_timer.h"
+#include "mqtt_client_wrapper.h"
+#include "mqtt_outbox.h"
+#include "metrics.h"
+#include "clock_service.h"
+
+_Static_assert(MQTT_TOPIC_COUNT == SIM_TOPIC_COUNT, "sim.h SIM_TOPIC_COUNT를 펌웨어와 맞춰야 함");
+_Static_assert(MQTT_CLASS_COUNT == SIM_CLASS_COUNT, "sim.h SIM_CLASS_COUNT를 펌웨어와 맞춰야 함");
+
+static __thread sim_device_t *tl_dev = NULL;
+
+void sim_shim_bind(sim_device_t *dev) {
+    tl_dev = dev;
+}
+
+// ---- mqtt_client_wrapper ----
+
+const char *mqtt_wrapper_device_id(void) {
+    return tl_dev->device_id;
+}
+
+// ---- mqtt_outbox ----
+
+esp_err_t mqtt_outbox_publish(mqtt_class_t cls, mqtt_topic_id_t topic, const char *payload, int len, bool coalesce) {
+    return sim_enqueue(tl_dev, (int)cls, (int)topic, payload, len, coalesce) == 0 ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats) {
+    const sim_device_t *dev = tl_dev;
+    for (int cls = 0; cls < MQTT_CLASS_COUNT; cls++) {
+        stats->pending[cls] = (uint16_t)dev->queues[cls].count;
+    }
+    stats->pending_bytes = (uint32_t)dev->pending_bytes;
+    stats->inflight = (uint16_t)dev->inflight_count;
+    stats->outbox_bytes = dev->inflight_bytes;
+}
+
+// ---- metrics ----
+
+uint32_t metrics_get_counter(metric_counter_t counter) {
+    const sim_device_t *dev = tl_dev;
+    switch (counter) {
+        case METRIC_WIFI_DISCONNECTS:    return dev->wifi_disconnects;
+        case METRIC_MQTT_DISCONNECTS:    return dev->mqtt_disconnects;
+        case METRIC_OUTBOX_DROPS_ALERT:  return dev->drops[MQTT_CLASS_ALERT];
+        case METRIC_OUTBOX_DROPS_VITALS: return dev->drops[MQTT_CLASS_VITALS];
+        case METRIC_OUTBOX_DROPS_ENV:    return dev->drops[MQTT_CLASS_ENV];
+        case METRIC_OUTBOX_DROPS_DIAG:   return dev->drops[MQTT_CLASS_DIAG];
+        case METRIC_OUTBOX_COALESCED:    return dev->coalesced;
+        default:                         return 0;
+    }
+}
+
+// 펌웨어 타이머(발행 지연 등)는 시뮬레이터에서 측정하지 않으므로 0
+metric_timer_stat_t metrics_get_timer(metric_timer_t timer) {
+    (void)timer;
+    return (metric_timer_stat_t){0};
+}
+
+// ---- clock_service (호스트 시계는 항상 UTC 유효) ----
+
+int64_t esp_timer_get_time(void) {
+    return sim_mono_us();
+}
+
+int64_t clock_now_us(void) {
+    return sim_mono_us();
+}
+
+int64_t clock_to_utc_ms(int64_t mono_us) {
+    return sim_utc_ms_from_mono(mono_us);
+}
+
+bool clock_is_utc_valid(void) {
+    return true;
+}
@@ -0,0 +1,15 @@
+// 호스트 빌드용 esp_log.h 대체 (에러만 stderr로 출력, 나머지는 인자 평가/포맷 검사만)
+#pragma once
+
+#include <stdio.h>
+
+typedef enum {
+    ESP_LOG_NONE, ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG, ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOG_SILENT(tag, fmt, ...) do { if (0) { printf("%s" fmt, tag, ##__VA_ARGS__); } } while (0)
+#define ESP_LOGW(tag, fmt, ...) ESP_LOG_SILENT(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_LOG_SILENT(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_LOG_SILENT(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOG_LEVEL(level, tag, fmt, ...) ESP_LOG_SILENT(tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,6 @@
+// 호스트 빌드용 esp_timer.h 대체
+#pragma once
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
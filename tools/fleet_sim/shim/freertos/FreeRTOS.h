@@ -0,0 +1,6 @@
+// 호스트 빌드용 FreeRTOS.h 대체
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
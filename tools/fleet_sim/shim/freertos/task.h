@@ -0,0 +1,4 @@
+// 호스트 빌드용 task.h 대체
+#pragma once
+
+typedef void *TaskHandle_t;
@@ -0,0 +1,6 @@
+// 호스트 빌드용 sdkconfig (펌웨어 송신 코드가 참조하는 항목만)
+#pragma once
+
+#define CONFIG_DLOG_ENABLE 0
+#define CONFIG_DLOG_DEFAULT_LEVEL 0
+#define CONFIG_DLOG_LEVEL_MQTT_SEND 0
@@ -0,0 +1,121 @@
+// sim.h
+// fleet_sim 내부 공용 정의
+//
+// 펌웨어 mqtt_sender.c는 보드마다 sensor_data.h가 달라 한 번역 단위에서 같이 쓸 수 없으므로
+// 보드별 생성기(wearable_gen.c / anchor_gen.c)가 각 보드 헤더로 컴파일되고, 이 헤더는
+// 펌웨어 타입 없이 그 사이를 잇는다.
+
+#ifndef FLEET_SIM_H
+#define FLEET_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 펌웨어 mqtt_topic_id_t / mqtt_class_t와 같은 순서 (fw_shim.c에서 static assert)
+#define SIM_TOPIC_COUNT  4
+#define SIM_CLASS_COUNT  4
+#define SIM_QUEUE_MAX    32
+
+typedef enum {
+    SIM_WEARABLE = 0,
+    SIM_ANCHOR,
+} sim_kind_t;
+
+typedef struct {
+    char *payload;
+    int len;
+    int topic;
+} sim_msg_t;
+
+typedef struct {
+    sim_msg_t items[SIM_QUEUE_MAX];
+    int head;
+    int count;
+} sim_queue_t;
+
+typedef struct {
+    int mid;
+    int len;
+    int64_t sent_us;
+} sim_inflight_t;
+
+typedef struct sim_device {
+    sim_kind_t kind;
+    int index;
+    char device_id[16];         // 앵커 펌웨어 influx_sensor_data_t.device_id와 같은 크기 ("sim-a" + 최대 10자리)
+    char client_id[48];
+    struct mosquitto *mosq;
+
+    // 네트워크/MQTT 상태
+    bool net_up;                // Wi-Fi 연결 (오프라인 구간이면 false)
+    bool mqtt_up;               // CONNACK 수신
+    bool sock_open;             // mosquitto 소켓이 열려 있음
+    int64_t offline_until_us;   // 이 시각 이후 Wi-Fi 재시도가 성공
+    int64_t net_retry_us;       // 다음 Wi-Fi 재시도 시각 (wifi_manager 백오프 모사)
+    uint32_t net_attempts;
+    int64_t mqtt_retry_us;      // 다음 MQTT 재접속 시각 (esp-mqtt reconnect_timeout 모사)
+    int64_t connect_start_us;   // CONNACK 지연 측정 기준
+    int64_t next_misc_us;       // mosquitto_loop_misc (keepalive) 일정
+    bool alias_sent[SIM_TOPIC_COUNT];
+
+    // 전송 일정
+    int64_t next_sample_us;
+    int64_t next_diag_us;
+    int64_t next_fall_us;
+    int64_t next_vital_us;
+    int64_t next_offline_us;
+
+    // 펌웨어 mqtt_outbox 모사
+    sim_queue_t queues[SIM_CLASS_COUNT];
+    int pending_bytes;
+    sim_inflight_t inflight[SIM_QUEUE_MAX];
+    int inflight_count;
+    int inflight_bytes;
+
+    // 펌웨어 metrics 카운터 모사 (diag 페이로드용)
+    uint32_t wifi_disconnects;
+    uint32_t mqtt_disconnects;
+    uint32_t drops[SIM_CLASS_COUNT];
+    uint32_t coalesced;
+
+    // 합성 측정값 상태
+    uint32_t rng;
+    float hr;
+    float temp;
+    float resp;
+    int steps;
+    uint16_t major;
+    uint16_t minor;
+    int rssi;
+    bool fall_pending;
+    uint8_t vital_rule;         // 발생 중인 생체 경보 규칙 (0이면 없음, 다음 이벤트에서 해제)
+} sim_device_t;
+
+// ---- fleet_sim.c ----
+
+// 펌웨어 mqtt_outbox_publish()가 이 함수로 이어짐 (현재 스레드에 바인딩된 장치 대기열)
+int sim_enqueue(sim_device_t *dev, int cls, int topic, const char *payload, int len, bool coalesce);
+
+int64_t sim_mono_us(void);
+int64_t sim_utc_ms_from_mono(int64_t mono_us);
+uint32_t sim_rand(sim_device_t *dev);
+float sim_randf(sim_device_t *dev);   // [0, 1)
+
+// ---- fw_shim.c ----
+
+// 이후 펌웨어 함수 호출이 이 장치를 대상으로 동작하도록 현재 스레드에 바인딩
+void sim_shim_bind(sim_device_t *dev);
+
+// ---- wearable_gen.c / anchor_gen.c ----
+
+void sim_wearable_init(sim_device_t *dev);
+void sim_wearable_sample(sim_device_t *dev, int64_t now_us);
+void sim_wearable_fall(sim_device_t *dev, int64_t now_us);
+void sim_wearable_vital_alert(sim_device_t *dev, int64_t now_us);
+void sim_wearable_diag(sim_device_t *dev);
+
+void sim_anchor_init(sim_device_t *dev);
+void sim_anchor_sample(sim_device_t *dev, int64_t now_us);
+void sim_anchor_diag(sim_device_t *dev);
+
+#endif // FLEET_SIM_H
@@ -0,0 +1,146 @@
+// wearable_gen.c
+// 웨어러블 합성 측정값 → 펌웨어 mqtt_sender.c (user_sensor_board_ver2) 인코딩
+
+#include "sim.h"
+#include <string.h>
+#include "sensor_data.h"
+#include "mqtt_sender.h"
+#include "vital_rules.h"
+
+// 실제 보드 TTL 기본값(Kconfig)과 비슷한 갱신 주기를 흉내 내기 위한 항목별 지연 상한 (ms)
+#define GEN_HR_AGE_MAX_MS     1500
+#define GEN_SPO2_AGE_MAX_MS   4000
+#define GEN_RESP_AGE_MAX_MS   5000
+#define GEN_TEMP_AGE_MAX_MS   1000
+#define GEN_LOC_AGE_MAX_MS    8000
+
+void sim_wearable_init(sim_device_t *dev) {
+    dev->hr = 65.0f + 20.0f * sim_randf(dev);
+    dev->temp = 36.2f + 0.8f * sim_randf(dev);
+    dev->resp = 12.0f + 6.0f * sim_randf(dev);
+    dev->steps = 0;
+    dev->major = (uint16_t)(1 + sim_rand(dev) % 4);
+    dev->minor = (uint16_t)(1 + sim_rand(dev) % 20);
+    dev->rssi = -60;
+}
+
+static int64_t acq_before(sim_device_t *dev, int64_t now_us, int max_age_ms) {
+    return now_us - (int64_t)(sim_randf(dev) * max_age_ms) * 1000;
+}
+
+void sim_wearable_sample(sim_device_t *dev, int64_t now_us) {
+    // 완만한 랜덤 워크
+    dev->hr += (sim_randf(dev) - 0.5f) * 2.0f;
+    if (dev->hr < 50.0f) dev->hr = 50.0f;
+    if (dev->hr > 140.0f) dev->hr = 140.0f;
+    dev->temp += (sim_randf(dev) - 0.5f) * 0.02f;
+    dev->resp += (sim_randf(dev) - 0.5f) * 0.5f;
+    if (dev->resp < 8.0f) dev->resp = 8.0f;
+    if (dev->resp > 30.0f) dev->resp = 30.0f;
+    dev->steps += (int)(sim_rand(dev) % 3);
+    if (sim_rand(dev) % 30 == 0) {
+        dev->minor = (uint16_t)(1 + sim_rand(dev) % 20);
+    }
+    dev->rssi = -50 - (int)(sim_rand(dev) % 40);
+
+    sensor_data_t data;
+    memset(&data, 0, sizeof(data));
+    data.heart_rate = dev->hr;
+    data.temperature = dev->temp;
+    data.skin_temperature = dev->temp - 3.0f + 0.3f * sim_randf(dev);
+    data.spo2 = 95 + (int)(sim_rand(dev) % 5);
+    data.resp_rate = dev->resp;
+    data.resp_quality = 0.5f + 0.5f * sim_randf(dev);
+    data.steps = dev->steps;
+    data.fall_detected = 0;
+    data.location.major = dev->major;
+    data.location.minor = dev->minor;
+    data.location.rssi = dev->rssi;
+
+    data.acq_time_us.heart_rate = acq_before(dev, now_us, GEN_HR_AGE_MAX_MS);
+    data.acq_time_us.spo2 = acq_before(dev, now_us, GEN_SPO2_AGE_MAX_MS);
+    data.acq_time_us.resp_rate = acq_before(dev, now_us, GEN_RESP_AGE_MAX_MS);
+    data.acq_time_us.temperature = acq_before(dev, now_us, GEN_TEMP_AGE_MAX_MS);
+    data.acq_time_us.steps = acq_before(dev, now_us, GEN_TEMP_AGE_MAX_MS);
+    data.acq_time_us.fall_detected = now_us;
+    data.acq_time_us.location = acq_before(dev, now_us, GEN_LOC_AGE_MAX_MS);
+
+    data.validity_flags.heart_rate_valid = 1;
+    data.validity_flags.temperature_valid = 1;
+    data.validity_flags.spo2_valid = 1;
+    data.validity_flags.resp_rate_valid = 1;
+    data.validity_flags.steps_valid = 1;
+    data.validity_flags.fall_detected_valid = 1;
+    data.validity_flags.location_valid = 1;
+
+    sim_shim_bind(dev);
+    mqtt_send_sensor_data(data);
+}
+
+void sim_wearable_fall(sim_device_t *dev, int64_t now_us) {
+    sensor_data_t data;
+    memset(&data, 0, sizeof(data));
+    data.fall_detected = 1;
+    data.acq_time_us.fall_detected = now_us;
+    data.validity_flags.fall_detected_valid = 1;
+
+    sim_shim_bind(dev);
+    mqtt_send_fall_alert(&data);
+}
+
+// 펌웨어 기본 규칙 중 일부 (규칙 번호, 항목, 연산, 심각도, 임계값, 발생 시 값)
+typedef struct {
+    uint8_t id;
+    vital_metric_t metric;
+    vital_op_t op;
+    vital_severity_t severity;
+    float threshold;
+    float value;
+} gen_vital_rule_t;
+
+static const gen_vital_rule_t s_gen_vital_rules[] = {
+    { 1, VITAL_METRIC_SPO2,        VITAL_OP_BELOW, VITAL_SEVERITY_WARNING, 93.0f,  91.0f },
+    { 4, VITAL_METRIC_HEART_RATE,  VITAL_OP_ABOVE, VITAL_SEVERITY_WARNING, 120.0f, 128.0f },
+    { 7, VITAL_METRIC_TEMPERATURE, VITAL_OP_ABOVE, VITAL_SEVERITY_WARNING, 38.0f,  38.4f },
+    { 9, VITAL_METRIC_RESP_RATE,   VITAL_OP_BELOW, VITAL_SEVERITY_DANGER,  8.0f,   6.5f },
+};
+
+// 이벤트마다 발생 중인 경보가 없으면 하나를 발생시키고, 있으면 해제 (발생/해제 페이로드를 모두 낸다)
+void sim_wearable_vital_alert(sim_device_t *dev, int64_t now_us) {
+    const size_t n = sizeof(s_gen_vital_rules) / sizeof(s_gen_vital_rules[0]);
+    const gen_vital_rule_t *rule = NULL;
+    bool raised = (dev->vital_rule == 0);
+    if (raised) {
+        rule = &s_gen_vital_rules[sim_rand(dev) % n];
+        dev->vital_rule = rule->id;
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            if (s_gen_vital_rules[i].id == dev->vital_rule) {
+                rule = &s_gen_vital_rules[i];
+            }
+        }
+        dev->vital_rule = 0;
+        if (rule == NULL) {
+            return;
+        }
+    }
+
+    vital_alert_t alert = {
+        .t_us = now_us,
+        .value = raised ? rule->value : rule->threshold + (rule->value > rule->threshold ? -2.0f : 2.0f),
+        .threshold = rule->threshold,
+        .rule_id = rule->id,
+        .metric = (uint8_t)rule->metric,
+        .op = (uint8_t)rule->op,
+        .severity = (uint8_t)rule->severity,
+        .raised = raised,
+    };
+
+    sim_shim_bind(dev);
+    mqtt_send_vital_alert(&alert);
+}
+
+void sim_wearable_diag(sim_device_t *dev) {
+    sim_shim_bind(dev);
+    mqtt_send_diagnostics();
+}
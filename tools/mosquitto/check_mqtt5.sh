@@ -0,0 +1,21 @@
+#!/usr/bin/env bash
+# 로컬 Mosquitto에서 보드의 MQTT 5 속성 확인
+#
+#   ./tools/mosquitto/check_mqtt5.sh [host] [topic]
+#
+# 출력 형식: 토픽 | user property | 메시지 만료(s) | content type | 페이로드 길이
+#   - user property에 deviceId/board가 보이면 페이로드 파싱 없이 라우팅 가능
+#   - 토픽 별칭은 브로커가 풀어서 전달하므로 구독자에게는 원래 토픽으로 보인다
+#     (별칭 사용 여부는 mosquitto -v 로그의 PUBLISH 수신 크기로 확인)
+#
+# 만료 확인: 아래처럼 QoS1 영속 구독을 만든 뒤 끊고, 만료 시간(기본 30초)이 지난 후
+# 다시 접속하면 그동안 쌓인 텔레메트리가 전달되지 않아야 한다.
+#   mosquitto_sub -V mqttv5 -h <host> -u a107 -P 123456789 -i probe -c -q 1 -t 'sensor/#' -x 600
+
+set -euo pipefail
+
+HOST="${1:-localhost}"
+TOPIC="${2:-sensor/#}"
+
+exec mosquitto_sub -V mqttv5 -h "$HOST" -u a107 -P 123456789 -t "$TOPIC" \
+    -F '%t | %P | expiry=%E | %C | %l bytes'
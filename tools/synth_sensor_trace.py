@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""웨어러블 가상 센서 백엔드(CONFIG_SENSOR_BACKEND_TRACE)용 트레이스 생성기.
+
+sensor_backend/src/signal_trace.c 형식의 CSV를 시나리오 인자로 만든다. 모델은 펌웨어의
+합성 신호원(signal_synth.c)과 같은 계열이지만 구간을 직접 지정할 수 있어 회귀 테스트용
+고정 시나리오(보행 중 낙상, 저산소, 앵커 이동 등)를 파일로 남길 때 쓴다.
+
+사용 예:
+    python tools/synth_sensor_trace.py -o user_sensor_board_ver2/components/sensor_backend/traces/walk_fall_10s.csv \\
+        --duration 10 --walk 1:7 --fall 7.5
+    python tools/synth_sensor_trace.py -o hypoxia.csv --duration 60 --spo2 86 --hr 95
+
+행 형식 (시각 오름차순):
+    <t_ms>,imu,<ax_g>,<ay_g>,<az_g>,<gx_dps>,<gy_dps>,<gz_dps>     100Hz
+    <t_ms>,ppg,<red>,<ir>                                         100Hz (12mA / 4096nA / 18비트 카운트)
+    <t_ms>,temp,<object_c>,<ambient_c>                            1Hz
+    <t_ms>,adv,<major>,<minor>,<rssi>                             수신된 광고 1건
+"""
+
+import argparse
+import math
+import random
+import sys
+
+IMU_HZ = 100
+PPG_HZ = 100
+STEP_HZ = 1.8
+RESP_HZ = 0.25
+
+PPG_DC_IR = 120000.0
+PPG_DC_RED = 90000.0
+PPG_PERFUSION_IR = 0.02
+
+ANCHOR_SPACING_M = 8.0
+ANCHOR_OFFSET_M = 2.0
+WALK_SPEED_MPS = 1.2
+
+
+def parse_span(text):
+    a, b = text.split(':')
+    return float(a), float(b)
+
+
+class Scenario:
+    def __init__(self, args):
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.walks = [parse_span(w) for w in args.walk]
+        self.falls = sorted(args.fall)
+        self.ppg_phase = 0.0
+        self.ppg_last = 0.0
+
+    def walking(self, t):
+        for a, b in self.walks:
+            if a <= t < b:
+                return True, t - a
+        return False, 0.0
+
+    def walked_total(self, t):
+        return sum(max(0.0, min(t, b) - a) for a, b in self.walks)
+
+    def fall_offset(self, t):
+        """충격 시각 기준 경과(s), 자유낙하 구간은 음수. 낙상 에피소드 밖이면 None."""
+        for f in self.falls:
+            if f - 0.3 <= t < f + 10.05:
+                return t - f
+        return None
+
+    def imu(self, t):
+        g = self.rng.gauss
+        ax, ay, az = 0.05, -0.10, 0.99
+        gx, gy, gz = 0.5, -0.3, 0.2
+        fo = self.fall_offset(t)
+        walking, _ = self.walking(t)
+        if fo is not None:
+            if fo < 0:
+                k = (fo + 0.3) / 0.3
+                ax, ay, az = 0.05 + 0.25 * k, -0.10, 0.30 * (1.0 - k)
+                gx, gy = 180.0, 120.0
+            elif fo < 0.05:
+                ax, ay, az = 3.6, 3.6, 3.0
+                gx, gy = -250.0, 300.0
+            else:
+                ax, ay, az = 0.98, 0.10, 0.15
+        elif walking:
+            w = 2 * math.pi * STEP_HZ * t
+            ax += 0.30 * math.sin(w) + 0.08 * math.sin(2 * w)
+            ay += 0.18 * math.sin(w + 1.2)
+            az += 0.15 * math.sin(2 * w)
+            gx += 40.0 * math.sin(0.5 * w)
+            gy += 15.0 * math.sin(0.5 * w + 0.5)
+            gz += 10.0 * math.sin(w)
+        return (ax + 0.004 * g(0, 1), ay + 0.004 * g(0, 1), az + 0.004 * g(0, 1),
+                gx + 0.1 * g(0, 1), gy + 0.1 * g(0, 1), gz + 0.1 * g(0, 1))
+
+    def heart_rate(self, t):
+        walking, ws = self.walking(t)
+        if walking:
+            return self.args.hr + 25.0 * (1.0 - math.exp(-ws / 30.0))
+        # 마지막 보행 종료 후 회복
+        ends = [(b, b - a) for a, b in self.walks if b <= t]
+        if ends:
+            b, length = max(ends)
+            peak = 25.0 * (1.0 - math.exp(-length / 30.0))
+            return self.args.hr + peak * math.exp(-(t - b) / 60.0)
+        return self.args.hr
+
+    def ppg(self, t):
+        resp = math.sin(2 * math.pi * RESP_HZ * t)
+        hr_hz = self.heart_rate(t) / 60.0 * (1.0 + 0.04 * resp)
+        self.ppg_phase = (self.ppg_phase + hr_hz * (t - self.ppg_last)) % 1.0
+        self.ppg_last = t
+        ph = self.ppg_phase
+        pulse = math.exp(-((ph - 0.15) / 0.07) ** 2) + 0.35 * math.exp(-((ph - 0.42) / 0.09) ** 2)
+
+        r_ratio = (110.0 - self.args.spo2) / 25.0
+        base = 1.0 + 0.01 * resp
+        ir = PPG_DC_IR * base * (1.0 - PPG_PERFUSION_IR * pulse)
+        red = PPG_DC_RED * base * (1.0 - PPG_PERFUSION_IR * r_ratio * pulse)
+
+        walking, _ = self.walking(t)
+        fo = self.fall_offset(t)
+        if walking and fo is None:
+            m = 0.006 * math.sin(2 * math.pi * STEP_HZ * t + 0.7)
+            ir += PPG_DC_IR * m
+            red += PPG_DC_RED * m
+        elif fo is not None and 0 <= fo < 0.5:
+            ir *= 0.85
+            red *= 0.85
+        ir += 30.0 * self.rng.gauss(0, 1)
+        red += 30.0 * self.rng.gauss(0, 1)
+        clamp = lambda v: max(0, min(262143, int(round(v))))
+        return clamp(red), clamp(ir)
+
+    def temp(self, t):
+        walking, ws = self.walking(t)
+        skin = self.args.skin + 0.3 * math.sin(2 * math.pi * t / 900.0)
+        if walking:
+            skin -= 0.3 * (1.0 - math.exp(-ws / 120.0))
+        return skin + 0.03 * self.rng.gauss(0, 1), 24.0 + 0.5 * math.sin(2 * math.pi * t / 3600.0)
+
+    def adverts(self, t0, t1):
+        """(t0, t1] 구간에 수신된 앵커 광고 [(t, minor, rssi)]"""
+        n = self.args.anchors
+        span = ANCHOR_SPACING_M * (n - 1)
+        pos = 0.0
+        if span > 0:
+            pos = (self.walked_total(t1) * WALK_SPEED_MPS) % (2 * span)
+            if pos > span:
+                pos = 2 * span - pos
+        interval = self.args.adv_interval_ms / 1000.0
+        out = []
+        slot = math.floor(t0 / interval)
+        while slot * interval <= t1:
+            for i in range(n):
+                t = slot * interval + i * 0.007
+                if t <= t0 or t > t1 or self.rng.random() >= self.args.rx_prob:
+                    continue
+                d = math.hypot(pos - ANCHOR_SPACING_M * i, ANCHOR_OFFSET_M)
+                rssi = round(-59.0 - 22.0 * math.log10(d) + 4.0 * self.rng.gauss(0, 1))
+                if rssi >= -95:
+                    out.append((t, i + 1, rssi))
+            slot += 1
+        return out
+
+
+def generate(args, out):
+    sc = Scenario(args)
+    rows = []
+    n_imu = int(args.duration * IMU_HZ)
+    for k in range(n_imu):
+        t = k / IMU_HZ
+        rows.append((t, 0, 'imu,%.4f,%.4f,%.4f,%.2f,%.2f,%.2f' % sc.imu(t)))
+    for k in range(int(args.duration * PPG_HZ)):
+        t = k / PPG_HZ
+        rows.append((t, 1, 'ppg,%d,%d' % sc.ppg(t)))
+    for k in range(int(args.duration)):
+        rows.append((float(k), 2, 'temp,%.2f,%.2f' % sc.temp(float(k))))
+    # 광고는 펌웨어 가상 스캔과 같은 100ms 단위로 생성
+    t = 0.0
+    while t < args.duration:
+        for ta, minor, rssi in sc.adverts(t, min(t + 0.1, args.duration)):
+            rows.append((ta, 3, 'adv,1,%d,%d' % (minor, rssi)))
+        t += 0.1
+
+    rows.sort(key=lambda r: (r[0], r[1]))
+    out.write('# synth_sensor_trace.py %s\n' % ' '.join(sys.argv[1:]))
+    out.write('#duration_ms=%d\n' % int(args.duration * 1000))
+    for t, _, body in rows:
+        out.write('%d,%s\n' % (int(round(t * 1000)), body))
+    return len(rows)
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument('-o', '--output', default='-', help='출력 CSV (기본: stdout)')
+    p.add_argument('--duration', type=float, default=10.0, help='길이 (s)')
+    p.add_argument('--walk', action='append', default=[], metavar='START:END', help='보행 구간 (s), 여러 번 지정 가능')
+    p.add_argument('--fall', action='append', type=float, default=[], metavar='T', help='낙상 충격 시각 (s)')
+    p.add_argument('--hr', type=float, default=72.0, help='안정 심박 (bpm)')
+    p.add_argument('--spo2', type=float, default=97.0)
+    p.add_argument('--skin', type=float, default=33.8, help='손목 피부 온도 (°C)')
+    p.add_argument('--anchors', type=int, default=3)
+    p.add_argument('--adv-interval-ms', type=float, default=30.0)
+    p.add_argument('--rx-prob', type=float, default=0.66, help='광고 수신 확률 (펌웨어 스캔 window/interval = 0x20/0x30)')
+    p.add_argument('--seed', type=int, default=1)
+    args = p.parse_args()
+
+    out = sys.stdout if args.output == '-' else open(args.output, 'w', newline='\n')
+    n = generate(args, out)
+    if out is not sys.stdout:
+        out.close()
+    print('%d rows' % n, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
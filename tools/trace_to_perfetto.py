@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""trace_capture 덤프를 Chrome trace / Perfetto JSON으로 변환.
+
+입력은 UART 콘솔 로그 또는 MQTT 덤프(mosquitto_sub 출력)이며 "#TR" 로 시작하지 않는
+라인은 무시한다. 결과 JSON은 https://ui.perfetto.dev 또는 chrome://tracing 에서 연다.
+
+사용 예:
+    idf.py monitor | tee capture.log
+    mosquitto_sub -h <broker> -t trace/2 > capture.log
+    python tools/trace_to_perfetto.py capture.log -o trace.json
+
+트랙 구성
+    pid 0 "CPU<n>"          : 코어별 실행 태스크 / ISR
+    pid 1 "markers"         : TRACE_BEGIN/END 구간 (태스크별 스레드)
+표준 에러로 코어별 사용률과 마커 구간 통계를 출력한다.
+"""
+
+import argparse
+import json
+import sys
+from collections import defaultdict
+
+# trace_capture.h 의 trace_event_type_t 와 동일해야 함
+EV_TASK_IN, EV_TASK_OUT, EV_ISR_ENTER, EV_ISR_EXIT, EV_MARK_BEGIN, EV_MARK_END, EV_TICK = range(1, 8)
+
+NO_TASK = 0xFF
+
+
+def parse(stream):
+    tasks = {}
+    marks = {}
+    events = defaultdict(list)      # core -> [(ts, type, task, id, arg)]
+    overflow = {}
+    window = None
+
+    for raw in stream:
+        line = raw.strip()
+        idx = line.find('#TR')
+        if idx < 0:
+            continue
+        line = line[idx:]
+        tag, _, body = line.partition(':')
+        fields = body.split(',')
+        if tag == '#TR':
+            core, ts, typ, task, ev_id, arg = fields
+            events[int(core)].append((int(ts, 16), int(typ), int(task), int(ev_id), int(arg, 16)))
+        elif tag == '#TR-TASK':
+            tasks[int(fields[0])] = ','.join(fields[1:])
+        elif tag == '#TR-MARK':
+            marks[int(fields[0])] = ','.join(fields[1:])
+        elif tag == '#TR-CORE':
+            overflow[int(fields[0])] = int(fields[2])
+        elif tag == '#TR-BEGIN':
+            window = (int(fields[1]), int(fields[2]))
+    return tasks, marks, events, overflow, window
+
+
+def unwrap(ts_list):
+    """32비트 µs 타임스탬프 랩어라운드 보정."""
+    out = []
+    base = 0
+    prev = None
+    for ts in ts_list:
+        if prev is not None and ts < prev and prev - ts > 0x80000000:
+            base += 1 << 32
+        prev = ts
+        out.append(ts + base)
+    return out
+
+
+def percentile(values, p):
+    if not values:
+        return 0
+    values = sorted(values)
+    k = min(len(values) - 1, int(round((p / 100.0) * (len(values) - 1))))
+    return values[k]
+
+
+def convert(tasks, marks, events, overflow, window):
+    trace = []
+    t0 = None
+    for evs in events.values():
+        if evs:
+            first = evs[0][0]
+            t0 = first if t0 is None else min(t0, first)
+    if t0 is None:
+        return trace, {}
+    if window is not None:
+        t0 = min(t0, window[0])
+
+    def task_name(idx):
+        if idx == NO_TASK:
+            return '?'
+        return tasks.get(idx, 'task%d' % idx)
+
+    trace.append({'ph': 'M', 'pid': 0, 'name': 'process_name', 'args': {'name': 'CPU'}})
+    trace.append({'ph': 'M', 'pid': 1, 'name': 'process_name', 'args': {'name': 'markers'}})
+
+    busy = {}
+    spans = {}
+    mark_durations = defaultdict(list)
+
+    for core, evs in sorted(events.items()):
+        trace.append({'ph': 'M', 'pid': 0, 'tid': core, 'name': 'thread_name', 'args': {'name': 'CPU%d' % core}})
+        ts_list = unwrap([e[0] for e in evs])
+        running = None      # (task, start)
+        isr_stack = []
+        open_marks = {}     # (task, mark) -> start
+        core_busy = 0
+
+        for (_, typ, task, ev_id, _arg), ts in zip(evs, ts_list):
+            rel = ts - t0
+            if typ == EV_TASK_IN:
+                running = (task, rel)
+            elif typ == EV_TASK_OUT:
+                if running is not None:
+                    name = task_name(running[0])
+                    dur = rel - running[1]
+                    trace.append({'ph': 'X', 'pid': 0, 'tid': core, 'name': name,
+                                  'ts': running[1], 'dur': dur, 'cat': 'task'})
+                    if not name.startswith('IDLE'):
+                        core_busy += dur
+                running = None
+            elif typ == EV_ISR_ENTER:
+                isr_stack.append((ev_id, rel))
+            elif typ == EV_ISR_EXIT:
+                if isr_stack:
+                    irq, start = isr_stack.pop()
+                    trace.append({'ph': 'X', 'pid': 0, 'tid': core, 'name': 'ISR %d' % irq,
+                                  'ts': start, 'dur': rel - start, 'cat': 'isr'})
+            elif typ == EV_MARK_BEGIN:
+                open_marks[(task, ev_id)] = rel
+            elif typ == EV_MARK_END:
+                start = open_marks.pop((task, ev_id), None)
+                if start is not None:
+                    name = marks.get(ev_id, 'mark%d' % ev_id)
+                    trace.append({'ph': 'X', 'pid': 1, 'tid': task, 'name': name,
+                                  'ts': start, 'dur': rel - start, 'cat': 'mark',
+                                  'args': {'core': core}})
+                    mark_durations[name].append(rel - start)
+            elif typ == EV_TICK:
+                trace.append({'ph': 'i', 'pid': 0, 'tid': core, 'name': 'tick', 'ts': rel, 's': 't'})
+
+        if ts_list:
+            spans[core] = ts_list[-1] - ts_list[0]
+        busy[core] = core_busy
+
+    for idx, name in tasks.items():
+        trace.append({'ph': 'M', 'pid': 1, 'tid': idx, 'name': 'thread_name', 'args': {'name': name}})
+
+    stats = {'busy': busy, 'spans': spans, 'marks': mark_durations, 'overflow': overflow}
+    return trace, stats
+
+
+def print_stats(stats):
+    err = sys.stderr
+    for core in sorted(stats['spans']):
+        span = stats['spans'][core]
+        util = 100.0 * stats['busy'][core] / span if span else 0.0
+        err.write('CPU%d: 사용률 %.1f%% (구간 %.1f ms, 오버플로 %d)\n'
+                  % (core, util, span / 1000.0, stats['overflow'].get(core, 0)))
+    for name, durs in sorted(stats['marks'].items()):
+        err.write('%-12s n=%-5d avg=%7.1fus p99=%7dus max=%7dus\n'
+                  % (name, len(durs), sum(durs) / len(durs), percentile(durs, 99), max(durs)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='trace_capture dump -> Chrome trace / Perfetto JSON')
+    parser.add_argument('input', nargs='?', help='captured log (default: stdin)')
+    parser.add_argument('-o', '--output', default='trace.json')
+    args = parser.parse_args()
+
+    stream = open(args.input, 'r', errors='replace') if args.input else sys.stdin
+    tasks, marks, events, overflow, window = parse(stream)
+    if not events:
+        sys.stderr.write('#TR 이벤트가 없습니다\n')
+        return 1
+
+    trace, stats = convert(tasks, marks, events, overflow, window)
+    with open(args.output, 'w') as f:
+        json.dump({'traceEvents': trace, 'displayTimeUnit': 'ms'}, f)
+    sys.stderr.write('%d 이벤트 -> %s\n' % (len(trace), args.output))
+    print_stats(stats)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -17,6 +17,8 @@
 
 // sensor_data.h 추가
 #include "sensor_data.h" 
+#include "clock_service.h"
+#include "task_placement.h"
 
 static const char *TAG = "BEACON_SCANNER";
 
@@ -31,6 +33,7 @@ static EventGroupHandle_t ble_event_group;
 static int strongest_rssi = -999;
 static uint16_t closest_major = 0;
 static uint16_t closest_minor = 0;
+static int64_t closest_time_us = 0;     // 가장 강한 신호를 받은 시각
 
 // 필터링할 UUID - anchor의 UUID
 static const uint8_t TARGET_UUID[16] = {
@@ -53,7 +56,7 @@ static void ble_app_on_sync(void) {
     ESP_LOGI("BLE", "BLE Host synced");
     // BLE 이벤트 그룹 비트 세트
     xEventGroupSetBits(ble_event_group, BLE_SYNC_DONE_BIT);
-    xTaskCreate(ble_scan_task, "ble_scan_task", 4096, NULL, 5, NULL);
+    task_placement_create(TASK_ID_BLE_SCAN, ble_scan_task, NULL, NULL);
 }
 
 // NimBLE 설정 초기화
@@ -107,6 +110,7 @@ static int ble_gap_event(struct ble_gap_event *event, void *arg) {
                 strongest_rssi = rssi;
                 closest_major = major;
                 closest_minor = minor;
+                closest_time_us = clock_now_us();
                 ESP_LOGI(TAG, "New strongest signal: major=%d, minor=%d, rssi=%d", 
                          closest_major, closest_minor, strongest_rssi);
             }
@@ -152,7 +156,7 @@ void ble_scan_task(void *param) {
         ESP_LOGI(TAG, "BLE scan stopped");
 
         if (strongest_rssi > -999) {
-            sensor_data_set_location(closest_major, closest_minor, strongest_rssi);
+            sensor_data_set_location(closest_major, closest_minor, strongest_rssi, closest_time_us);
             ESP_LOGI(TAG, "Location updated: major=%d, minor=%d, rssi=%d", 
                      closest_major, closest_minor, strongest_rssi);
         } else {
@@ -0,0 +1,85 @@
+// app_init.h
+// 의존성 기반 병렬 부팅 프레임워크
+//
+// 각 초기화 단계(stage)는 자신이 필요로 하는 이벤트 그룹 비트(requires)를 선언하고,
+// 별도 태스크에서 비트가 모두 세트되는 즉시 실행된다. 단계 함수가 ESP_OK를 반환하면
+// provides 비트가 세트되고, Wi-Fi/MQTT 처럼 완료가 이벤트로 통지되는 경우에는
+// 해당 이벤트 핸들러에서 app_init_signal()을 호출한다.
+// 모든 단계/비트의 시각은 기록되며 첫 publish 시점에 부팅 리포트로 출력된다.
+
+#ifndef APP_INIT_H
+#define APP_INIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+// 부팅 단계 완료 비트
+#define APP_INIT_NVS            BIT0
+#define APP_INIT_I2C            BIT1
+#define APP_INIT_SENSOR_DATA    BIT2
+#define APP_INIT_SENSORS        BIT3
+#define APP_INIT_NET_UP         BIT4    // IP 획득
+#define APP_INIT_TIME_SYNCED    BIT5
+#define APP_INIT_MQTT_UP        BIT6
+#define APP_INIT_BLE            BIT7
+#define APP_INIT_FIRST_PUBLISH  BIT8
+#define APP_INIT_BIT_COUNT      9
+
+#define APP_INIT_MAX_STAGES     12
+
+typedef esp_err_t (*app_init_fn_t)(void);
+
+/**
+ * @brief 초기화 단계 정의
+ */
+typedef struct {
+    const char *name;
+    EventBits_t requires;       // 모두 세트되어야 시작 (0이면 즉시 시작)
+    EventBits_t provides;       // fn이 ESP_OK 반환 시 세트 (비동기 완료는 app_init_signal 사용)
+    app_init_fn_t fn;
+    uint32_t stack_size;        // 0이면 4096
+} app_init_stage_t;
+
+/**
+ * @brief 이벤트 그룹 생성 및 부팅 기준 시각 기록 (app_main 가장 처음에 호출)
+ */
+void app_init_begin(void);
+
+/**
+ * @brief 단계별 태스크 생성 (stages 배열은 정적 수명이어야 함)
+ * @return ESP_OK 성공, ESP_ERR_INVALID_ARG 단계 수 초과, ESP_ERR_NO_MEM 태스크 생성 실패
+ */
+esp_err_t app_init_start(const app_init_stage_t *stages, size_t count);
+
+/**
+ * @brief 완료 비트 세트 (이벤트 핸들러에서 호출 가능, 최초 세트 시각 기록)
+ */
+void app_init_signal(EventBits_t bits);
+
+/**
+ * @brief 완료 비트 해제 (예: Wi-Fi/MQTT 연결 끊김)
+ */
+void app_init_clear(EventBits_t bits);
+
+/**
+ * @brief 비트가 모두 세트될 때까지 대기
+ * @return 반환 시점의 이벤트 그룹 비트
+ */
+EventBits_t app_init_wait(EventBits_t bits, TickType_t timeout);
+
+bool app_init_is_set(EventBits_t bits);
+
+/**
+ * @brief 첫 텔레메트리 publish 표시 (최초 1회 부팅 리포트 출력)
+ */
+void app_init_mark_first_publish(void);
+
+/**
+ * @brief 단계별 대기/실행 시간과 비트 세트 시각 출력
+ */
+void app_init_print_report(void);
+
+#endif // APP_INIT_H
@@ -0,0 +1,55 @@
+// clock_service.h
+// esp_timer(단조 µs) → UTC 변환
+//
+// 측정값은 획득 시점에 clock_now_us()(esp_timer_get_time())로 찍고, 전송 시점에
+// clock_to_utc_ms()로 변환한다. SNTP 동기화 때마다 (esp_timer, UTC) 기준점을 갱신하고
+// 이전 기준점 대비 오차로 수정 발진자 드리프트(ppm)를 추정해 다음 동기화까지 보정한다.
+// 따라서 동기화 이전에 찍힌 타임스탬프도 동기화 이후 올바른 UTC로 변환된다.
+
+#ifndef CLOCK_SERVICE_H
+#define CLOCK_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/time.h>
+
+/**
+ * @brief 현재 시스템 시계(gettimeofday)로 초기 기준점 설정 (sntp_restore_time() 이후 호출)
+ * @param system_time_valid 시스템 시계를 UTC로 신뢰할 수 있는지 (is_sntp_synced())
+ *        false면 첫 SNTP 동기화 전까지 UTC 변환을 하지 않는다
+ */
+void clock_service_init(bool system_time_valid);
+
+/**
+ * @brief SNTP 동기화 직후 호출 - 기준점 갱신 및 드리프트 추정
+ * @param tv 동기화로 설정된 UTC 시각
+ */
+void clock_service_on_sync(const struct timeval *tv);
+
+/**
+ * @brief 획득 시각용 단조 타임스탬프 (µs)
+ */
+int64_t clock_now_us(void);
+
+/**
+ * @brief 단조 타임스탬프를 UTC µs로 변환
+ * @return UTC µs, 기준점이 없으면 입력값 그대로 (부팅 후 경과 µs)
+ */
+int64_t clock_to_utc_us(int64_t mono_us);
+
+/**
+ * @brief 단조 타임스탬프를 UTC ms로 변환 (전송용)
+ */
+int64_t clock_to_utc_ms(int64_t mono_us);
+
+/**
+ * @brief UTC 기준점이 있는지 (SNTP 동기화 또는 RTC 유지 시각)
+ */
+bool clock_is_utc_valid(void);
+
+/**
+ * @brief 현재 추정 드리프트 (ppb, 양수면 esp_timer가 느림)
+ */
+int32_t clock_get_drift_ppb(void);
+
+#endif // CLOCK_SERVICE_H
@@ -19,4 +19,7 @@ void i2c_master_init(void);
 esp_err_t i2c_bus_recover_0(void);
 esp_err_t i2c_bus_recover_1(void);
 
+// I2C1에서 SCL을 올린 채 SDA를 sda_low_ms 동안 내린 뒤 드라이버 재설치 (MLX90614 sleep 해제)
+esp_err_t i2c_bus_wake_1(uint32_t sda_low_ms);
+
 #endif
@@ -0,0 +1,85 @@
+// metrics.h
+// 런타임 계측값 (구간 시간 / 카운터) 모음
+//
+// 타이머는 마지막/최소/최대/평균을, 카운터는 누적값만 유지한다. 구간 측정은
+// metrics_mark()로 시작 시각을 찍고 metrics_record_since()로 종료한다.
+// 모든 함수는 태스크/이벤트 핸들러 어디서나 호출할 수 있다.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+
+// 구간 시간 (ms 단위로 기록)
+typedef enum {
+    METRIC_WIFI_ASSOC_MS = 0,       // connect 요청 → STA_CONNECTED
+    METRIC_WIFI_DHCP_MS,            // STA_CONNECTED → GOT_IP
+    METRIC_WIFI_ASSOC_TO_MQTT_MS,   // STA_CONNECTED → MQTT_CONNECTED
+    METRIC_WIFI_OUTAGE_MS,          // 연결 끊김 → GOT_IP (재연결 소요 시간)
+    METRIC_MQTT_ACK_MS,             // QoS1 publish → PUBACK (MQTT_EVENT_PUBLISHED)
+    METRIC_PUBLISH_LATENCY_MS,      // 발행 주기 기한 → 대기열 투입 완료 (send_task)
+    METRIC_IMU_GAP_MS,              // 데드라인을 놓친 IMU 샘플 간격
+    METRIC_TIMER_COUNT
+} metric_timer_t;
+
+// 누적 카운터
+typedef enum {
+    METRIC_WIFI_DISCONNECTS = 0,
+    METRIC_WIFI_CACHE_HITS,         // 캐시된 BSSID/채널로 바로 연결 성공
+    METRIC_WIFI_CACHE_MISSES,       // 캐시 무효화 후 전체 스캔
+    METRIC_MQTT_DISCONNECTS,
+    METRIC_OUTBOX_DROPS_ALERT,      // 발행 대기열 예산/용량 초과로 버린 메시지 (클래스별)
+    METRIC_OUTBOX_DROPS_VITALS,
+    METRIC_OUTBOX_DROPS_ENV,
+    METRIC_OUTBOX_DROPS_DIAG,
+    METRIC_OUTBOX_COALESCED,        // 같은 토픽의 대기 메시지를 최신 값으로 덮어씀
+    METRIC_OUTBOX_EXPIRED,          // esp-mqtt outbox 만료로 삭제됨 (MQTT_EVENT_DELETED)
+    METRIC_IMU_DEADLINE_MISSES,     // IMU 샘플 간격이 주기의 1.5배를 넘음
+    METRIC_PIPELINE_DROPS,          // 센서 파이프라인 링이 가득 차 버린 항목 (sensor_pipeline)
+    METRIC_TEMP_FRAME_DROPS,        // PEC 불일치/오류 플래그로 버린 MLX90614 프레임
+    METRIC_VITAL_ALERT_DROPS,       // 경보 링이 가득 차 버린 생체 규칙 발생/해제 이벤트 (vital_rules)
+    METRIC_COUNTER_COUNT
+} metric_counter_t;
+
+// 구간 시작 시각 (metrics_mark / metrics_record_since 에서 사용)
+typedef enum {
+    METRIC_MARK_WIFI_CONNECT_REQ = 0,
+    METRIC_MARK_WIFI_ASSOC,
+    METRIC_MARK_WIFI_LOST,
+    METRIC_MARK_COUNT
+} metric_mark_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t last;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} metric_timer_stat_t;
+
+void metrics_mark(metric_mark_t mark);
+
+/**
+ * @brief mark 이후 경과 시간을 timer에 기록
+ * @return 기록한 경과 시간 (ms), mark가 없으면 기록하지 않고 -1
+ */
+int32_t metrics_record_since(metric_timer_t timer, metric_mark_t mark);
+
+void metrics_record_ms(metric_timer_t timer, uint32_t ms);
+void metrics_inc(metric_counter_t counter);
+void metrics_add(metric_counter_t counter, uint32_t n);
+
+/**
+ * @brief 구간 시간 통계 초기화 (벤치마크 구간 구분용)
+ */
+void metrics_reset_timer(metric_timer_t timer);
+
+metric_timer_stat_t metrics_get_timer(metric_timer_t timer);
+uint32_t metrics_get_counter(metric_counter_t counter);
+
+/**
+ * @brief 전체 계측값 로그 출력
+ */
+void metrics_log_summary(void);
+
+#endif // METRICS_H
@@ -0,0 +1,15 @@
+// placement_bench.h
+// 태스크 배치 벤치마크 - Wi-Fi 부하 유무에 따른 IMU 데드라인 미스 / 발행 지연 측정
+
+#ifndef PLACEMENT_BENCH_H
+#define PLACEMENT_BENCH_H
+
+#include "esp_err.h"
+
+/**
+ * @brief 벤치마크 태스크 시작 (Wi-Fi 연결 후 무부하 → 부하 구간을 측정하고 종료)
+ * @return ESP_ERR_NOT_SUPPORTED: CONFIG_TASK_PLACEMENT_BENCH 꺼짐
+ */
+esp_err_t placement_bench_start(void);
+
+#endif // PLACEMENT_BENCH_H
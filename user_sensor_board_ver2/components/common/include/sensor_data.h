@@ -2,6 +2,8 @@
 #define SENSOR_DATA_H
 
 #include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 // 위치 정보 구조체 추가
 typedef struct {
@@ -12,14 +14,45 @@ typedef struct {
 
 typedef struct {
     float heart_rate;     // 단위: bpm (beats per minute)
-    float temperature;    // 단위: °C
+    float temperature;    // 단위: °C, 심부 체온 추정 (피부/주변 온도 열류 보정)
+    float skin_temperature; // 단위: °C, 손목 피부 온도 (temperature와 같은 시각/TTL)
     int spo2;             // 단위: %, 산소포화도 (정수로 표현)
+    float resp_rate;      // 단위: 회/분, PPG 호흡수
+    float resp_quality;   // 호흡수 품질 지표 (0.0-1.0)
     int steps;            // 걸음 수 (누적 정수값)
     int fall_detected;    // 낙상 감지 (Boolean)
-    int64_t timestamp_ms; // UNIX timestamp in milliseconds
     location_data_t location; // 위치 정보 추가
+    int motion_artifact;  // PPG 움직임 오염 (1이면 심박/SpO2 갱신 보류 중)
+    const char *activity; // 활동 분류 ("still", "walk", "run", "sleep", "transition"; 고정 문자열)
+
+    // 항목별 획득 시각 (clock_now_us() 기준 단조 µs, 전송 시 clock_to_utc_ms()로 변환)
+    struct {
+        int64_t heart_rate;     // 마지막 박동 검출 시각
+        int64_t temperature;
+        int64_t spo2;
+        int64_t resp_rate;      // 마지막 호흡수 추정 창의 끝 샘플 시각
+        int64_t steps;          // 마지막 걸음 검출 또는 활동 창(1초)에서 누적값을 확인한 시각
+        int64_t fall_detected;  // 충격 샘플 시각 (해제 시에는 해제 시각)
+        int64_t location;       // 가장 강한 비콘 수신 시각
+        int64_t motion_artifact; // PPG 샘플 시각 (상태가 바뀌거나 1초마다 갱신)
+        int64_t activity;       // 활동 분류 창의 끝 샘플 시각
+    } acq_time_us;
     
-    // 유효성 플래그 추가
+    // 스냅샷 시점 기준 항목별 경과 시간 (ms, 한 번도 갱신되지 않았으면 -1)
+    // sensor_data_get_snapshot()에서 채워지며, TTL이 지난 항목은 유효성 플래그가 해제된다
+    struct {
+        int32_t heart_rate;
+        int32_t temperature;
+        int32_t spo2;
+        int32_t resp_rate;
+        int32_t steps;
+        int32_t fall_detected;
+        int32_t location;
+        int32_t motion_artifact;
+        int32_t activity;
+    } age_ms;
+
+    // 유효성 플래그 추가 (스냅샷에서는 TTL 이내인 경우에만 1)
     struct {
         uint8_t heart_rate_valid : 1;
         uint8_t temperature_valid : 1;
@@ -27,27 +60,60 @@ typedef struct {
         uint8_t steps_valid : 1;
         uint8_t fall_detected_valid : 1;
         uint8_t location_valid : 1;
-        uint8_t reserved : 2;
+        uint8_t motion_artifact_valid : 1;
+        uint8_t activity_valid : 1;
+        uint8_t resp_rate_valid : 1;
     } validity_flags;
 } sensor_data_t;
 
+// 낙상 후보 원시 창 (충격 전후 ±2초, 확정/기각 모두 업로드해 검출기 튜닝에 사용)
+#define FALL_WINDOW_MAX_SAMPLES 401     // 100Hz x 4초 + 충격 샘플
+
+typedef struct {
+    int64_t impact_time_us;     // 충격 샘플 획득 시각 (clock_now_us() 기준)
+    const char *reason;         // 판정 근거 (고정 문자열)
+    uint8_t confirmed;          // 1 = 낙상 확정, 0 = 기각
+    uint16_t sample_hz;
+    uint16_t count;             // raw에 담긴 샘플 수
+    uint16_t impact_index;      // 충격 샘플 위치
+    uint16_t free_fall_ms;
+    float impact_g;             // 충격 최대 선형 가속도
+    float tilt_deg;             // 낙상 전 자세 대비 기울기
+    float post_gyro_rms_dps;    // 충격 후 관찰 구간 자이로 RMS
+    float acc_lsb_per_g;        // raw 스케일
+    float gyro_lsb_per_dps;
+    int16_t raw[FALL_WINDOW_MAX_SAMPLES][6];    // ax, ay, az, gx, gy, gz (LSB)
+} fall_window_t;
+
 // 초기화 함수 (예: mutex 생성 등)
 void sensor_data_init(void);
 
-// 각 항목별 setter 함수
-void sensor_data_set_heart_rate(float hr);
-void sensor_data_set_temperature(float temp);
-void sensor_data_set_spo2(int spo2);
-void sensor_data_set_steps(int steps);
-void sensor_data_set_fall_detected(int fall);
-void sensor_data_set_timestamp(int64_t timestamp);
-void sensor_data_set_location(uint16_t major, uint16_t minor, int rssi);
+// 각 항목별 setter 함수 (acq_time_us: 측정값을 얻은 시각, clock_now_us() 기준)
+void sensor_data_set_heart_rate(float hr, int64_t acq_time_us);
+void sensor_data_set_temperature(float core_c, float skin_c, int64_t acq_time_us);
+void sensor_data_set_spo2(int spo2, int64_t acq_time_us);
+void sensor_data_set_resp_rate(float resp_rate, float quality, int64_t acq_time_us);
+void sensor_data_set_steps(int steps, int64_t acq_time_us);
+void sensor_data_set_fall_detected(int fall, int64_t acq_time_us);
+void sensor_data_set_location(uint16_t major, uint16_t minor, int rssi, int64_t acq_time_us);
+void sensor_data_set_motion_artifact(int corrupted, int64_t acq_time_us);
+void sensor_data_set_activity(const char *activity, int64_t acq_time_us);
+
+// 낙상이 새로 감지되면 이 태스크에 xTaskNotifyGive (전송 태스크가 주기를 기다리지 않고 경보 전송)
+void sensor_data_set_event_task(TaskHandle_t task);
+
+// 낙상 창 전달 (슬롯 1개): 생산자는 acquire → 채움 → commit, 소비자는 peek → 전송 → release
+// 이전 창이 아직 전송 중이면 acquire가 NULL을 반환한다 (새 창은 버림)
+fall_window_t *sensor_data_acquire_fall_window(void);
+void sensor_data_commit_fall_window(void);
+const fall_window_t *sensor_data_peek_fall_window(void);
+void sensor_data_release_fall_window(void);
 
-// 전체 snapshot 가져오기
+// 전체 snapshot 가져오기 (경과 시간 계산 및 TTL 만료 항목 무효화 포함)
 sensor_data_t sensor_data_get_snapshot(void);
 
-// 유효성 검사 함수 추가
-int sensor_data_has_valid_measurements(void);
-int sensor_data_get_valid_count(void);
+// 유효성 검사 함수 (같은 스냅샷 기준으로 판단)
+int sensor_data_has_valid_measurements(const sensor_data_t *snapshot);
+int sensor_data_get_valid_count(const sensor_data_t *snapshot);
 
 #endif  // SENSOR_DATA_H
@@ -0,0 +1,104 @@
+// sensor_pipeline.h
+// 센서 처리 파이프라인: 획득 → DSP → 집계 → 발행
+//
+//   sensor_manager_task (버스 I/O만) ─imu ring─▶ imu_dsp (걸음/낙상/활동) ─┐
+//                                   ─ppg ring─▶ ppg_dsp (심박/SpO2)  ─┼─result rings─▶ aggregator ─▶ sensor_data ─▶ send_task
+//                                   ─ref ring─▶ (가속도 → ppg_dsp)     │
+//                                   ─────────── 피부/주변 온도 ───────┘ (심부 체온 추정은 aggregator)
+//
+// 단계 사이는 SPSC 링(spsc_ring.h)과 태스크 알림으로 연결하므로 DSP가 느려도 I2C 뮤텍스를 잡지 않고
+// 버스 I/O와 계산이 겹쳐 실행된다. 링이 가득 차면 생산자는 기다리지 않고 샘플을 버리며, 링별
+// 투입/버림/최대 적재 수가 백프레셔 지표로 남는다 (버린 합계는 METRIC_PIPELINE_DROPS → 진단 pipeDrops).
+// 집계 태스크는 생체 값을 반영할 때마다 vital_rules 규칙을 평가하고, 경보가 생기면 전송 태스크를 바로 깨운다.
+//
+// ppg_dsp는 PPG 샘플마다 직전 PPG 이후 획득된 가속도(ref 링)를 평균해 움직임 잡음 제거의 기준
+// 신호로 쓴다. 획득 태스크가 IMU를 PPG보다 먼저 읽으므로 PPG 시각까지의 가속도는 항상 먼저 도착한다.
+//
+// LED 전류 AGC는 거꾸로 흐른다: ppg_dsp가 요청을 남기면 획득 태스크가 다음 MAX30102 읽기 직전에
+// 반영하고, 그 뒤 PPG 샘플에 새 전류를 붙여 보내 ppg_dsp가 정확히 그 샘플부터 블랭킹한다.
+// 착용 감지도 같은 방향이다: ppg_dsp가 접촉 없는 시간을 남기면 획득 태스크가 미착용 상태로 바꿔
+// PPG 투입을 멈추고(ppg_dsp 휴식), 다시 착용되면 재개 표시를 붙인 샘플로 계산기를 새로 시작시킨다.
+
+#ifndef SENSOR_PIPELINE_H
+#define SENSOR_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "mpu6050_driver.h"
+#include "activity.h"
+
+typedef enum {
+    PIPE_RING_IMU = 0,          // 획득 → imu_dsp
+    PIPE_RING_PPG,              // 획득 → ppg_dsp
+    PIPE_RING_IMU_RESULT,       // imu_dsp → aggregator
+    PIPE_RING_PPG_RESULT,       // ppg_dsp → aggregator
+    PIPE_RING_ACQ_RESULT,       // 획득 → aggregator (체온)
+    PIPE_RING_MOTION_REF,       // 획득 → ppg_dsp (움직임 잡음 기준 가속도)
+    PIPE_RING_COUNT
+} pipe_ring_t;
+
+typedef struct {
+    uint32_t pushed;
+    uint32_t dropped;
+    uint32_t high_water;
+    uint32_t capacity;
+} pipe_ring_stats_t;
+
+/**
+ * @brief DSP/집계 태스크 시작 (sensor_manager_start에서 획득 태스크보다 먼저 호출)
+ */
+esp_err_t sensor_pipeline_start(void);
+
+/**
+ * @brief 획득 단계 → 파이프라인 투입 (획득 태스크 전용, 대기하지 않음)
+ * @param t_us 획득 시각 (clock_now_us)
+ */
+void sensor_pipeline_push_imu(const mpu6050_data_t *data, int64_t t_us);
+void sensor_pipeline_push_ppg(uint32_t red, uint32_t ir, int64_t t_us);
+void sensor_pipeline_push_temperature(float object_c, float ambient_c, int64_t t_us);
+
+/**
+ * @brief ppg_dsp의 LED 전류 AGC 요청 꺼내기 (획득 태스크 전용, I2C1 뮤텍스를 잡은 상태에서)
+ *
+ * 요청은 가장 최근 것 하나만 남는다. 센서에 쓰는 데 성공하면 sensor_pipeline_led_current_applied로
+ * 알려야 이후 PPG 샘플이 새 전류로 표시되고 ppg_dsp가 블랭킹을 시작한다.
+ * @param ir_current, red_current 새 전류 (0.2mA 단위)
+ * @return true면 요청 있음
+ */
+bool sensor_pipeline_take_led_request(uint8_t *ir_current, uint8_t *red_current);
+void sensor_pipeline_led_current_applied(uint8_t ir_current, uint8_t red_current);
+
+/**
+ * @brief 미착용 동안 PPG 처리 일시 정지/재개 (획득 태스크 전용)
+ *
+ * 일시 정지 중에는 PPG를 넣지 않으므로 ppg_dsp가 쉬고, 기준 가속도도 쌓지 않는다. 재개 후 첫 PPG
+ * 샘플에서 ppg_dsp가 심박/SpO2 계산기(AGC 포함)를 초기화하므로 LED 전류도 기본값으로 되돌려 알려준다.
+ * @param led_ir, led_red 재개 시점의 LED 전류 (0.2mA 단위)
+ */
+void sensor_pipeline_ppg_pause(void);
+void sensor_pipeline_ppg_resume(uint8_t led_ir, uint8_t led_red);
+
+/**
+ * @brief 피부 접촉(DC 범위)이 연속으로 없었던 시간 (ms, PPG 샘플 수 기준)
+ */
+uint32_t sensor_pipeline_no_contact_ms(void);
+
+/**
+ * @brief 마지막 활동 분류 결과 (1초마다 갱신, 어느 태스크에서나 호출 가능)
+ *
+ * 다른 서브시스템이 수면/정지 중 측정 주기를 낮추는 등 전력 게이팅에 쓴다.
+ */
+activity_class_t sensor_pipeline_current_activity(void);
+
+/**
+ * @brief 링별 백프레셔 계수
+ */
+pipe_ring_stats_t sensor_pipeline_get_stats(pipe_ring_t ring);
+
+/**
+ * @brief 링별 계수와 단계별 최대 처리 시간 로그 출력
+ */
+void sensor_pipeline_log_stats(void);
+
+#endif // SENSOR_PIPELINE_H
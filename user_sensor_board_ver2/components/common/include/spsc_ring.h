@@ -0,0 +1,98 @@
+// spsc_ring.h
+// 단일 생산자 / 단일 소비자 무잠금 링 버퍼 (헤더 전용)
+//
+// 생산자는 head만, 소비자는 tail만 기록하므로 두 코어 사이에서도 잠금 없이 동작한다.
+// 인덱스는 자유 증가(free-running) 32비트이고 용량은 2의 거듭제곱이어야 한다.
+// 가득 차면 새 항목을 버리고 dropped를 올린다 (생산자는 절대 대기하지 않음).
+// pushed/dropped/high_water는 생산자만 기록하는 백프레셔 계수이며 다른 태스크에서는 근사값으로 읽는다.
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t elem_size;
+    uint32_t mask;              // 용량 - 1
+    uint32_t head;              // 다음 쓰기 위치 (생산자)
+    uint32_t tail;              // 다음 읽기 위치 (소비자)
+    uint32_t pushed;
+    uint32_t dropped;
+    uint32_t high_water;        // 최대 적재 항목 수
+} spsc_ring_t;
+
+/**
+ * @brief 정적 저장소를 가진 링 정의 (capacity는 2의 거듭제곱)
+ */
+#define SPSC_RING_DEFINE(name, type, capacity)                                              \
+    _Static_assert(((capacity) & ((capacity) - 1)) == 0, #name ": capacity must be 2^n");  \
+    static type name##_storage[(capacity)];                                                 \
+    static spsc_ring_t name = {                                                             \
+        .buf = (uint8_t *)name##_storage,                                                   \
+        .elem_size = sizeof(type),                                                          \
+        .mask = (capacity) - 1,                                                             \
+    }
+
+/**
+ * @brief 항목 추가 (생산자 전용)
+ * @return false면 가득 차서 버림
+ */
+static inline bool spsc_ring_push(spsc_ring_t *r, const void *item) {
+    uint32_t head = r->head;
+    uint32_t used = head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    if (used > r->mask) {
+        r->dropped++;
+        return false;
+    }
+    memcpy(r->buf + (head & r->mask) * r->elem_size, item, r->elem_size);
+    __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+
+    r->pushed++;
+    if (used + 1 > r->high_water) {
+        r->high_water = used + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief 항목 꺼내기 (소비자 전용)
+ * @return false면 비어 있음
+ */
+static inline bool spsc_ring_pop(spsc_ring_t *r, void *item) {
+    uint32_t tail = r->tail;
+    if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail) {
+        return false;
+    }
+    memcpy(item, r->buf + (tail & r->mask) * r->elem_size, r->elem_size);
+    __atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief 가장 오래된 항목을 꺼내지 않고 복사 (소비자 전용)
+ * @return false면 비어 있음
+ */
+static inline bool spsc_ring_peek(const spsc_ring_t *r, void *item) {
+    uint32_t tail = r->tail;
+    if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail) {
+        return false;
+    }
+    memcpy(item, r->buf + (tail & r->mask) * r->elem_size, r->elem_size);
+    return true;
+}
+
+/**
+ * @brief 현재 적재 항목 수 (어느 쪽에서나 근사값)
+ */
+static inline uint32_t spsc_ring_count(const spsc_ring_t *r) {
+    return __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t spsc_ring_capacity(const spsc_ring_t *r) {
+    return r->mask + 1;
+}
+
+#endif // SPSC_RING_H
@@ -0,0 +1,125 @@
+// vital_rules.h
+// 기기 내 생체 신호 규칙 엔진: 임계값/변화율/지속 시간 조건을 값이 들어올 때마다 평가
+//
+// 집계 태스크가 심박/SpO2/체온/호흡수를 sensor_data에 반영할 때마다 vital_rules_update()를 부르면
+// 해당 항목의 규칙만 증분으로 평가한다 (규칙당 비교 몇 번, 이력 버퍼 없음).
+//   - 수준 규칙(ABOVE/BELOW): 값이 임계값을 넘은 상태가 hold_s 동안 이어지면 발생,
+//     임계값에서 hysteresis만큼 안쪽으로 돌아온 상태가 clear_s 동안 이어지면 해제
+//   - 변화율 규칙(RISE/FALL): window_s 전후의 기준값 대비 분당 변화량에 같은 판정을 적용
+//     (기준점 2개를 window_s/2마다 교대로 갱신해 실제 비교 구간은 window_s/2 ~ window_s)
+// 같은 항목 값이 VITAL_RULES_STALE_MS보다 오래 끊기면 진행 중인 지속 시간 판정은 처음부터 다시 센다
+// (활성 경보는 해제 조건이 확인될 때까지 유지). 상태가 바뀌면(발생/해제) 경보 이벤트를 SPSC 링에
+// 넣고 전송 태스크를 깨워 주기를 기다리지 않고 MQTT 경보 클래스로 보낸다.
+//
+// 규칙 표는 NVS("vital_rules"/"rules_v1", vital_rule_t 배열 blob)에서 부팅 시 한 번 읽고,
+// 없거나 형식이 맞지 않으면 기본 규칙(SpO2 단계 임계값 등)을 쓴다.
+//
+// 심박 규칙은 심박 엔진이 낼 수 있는 범위 안에서만 의미가 있다. 스펙트럼/선택 엔진은 약 35bpm부터
+// 추정하므로(HR_SPECTRAL_MIN_BPM) 기본 서맥 규칙(40bpm 미만)이 발생할 수 있지만, 그보다 느린 심박은
+// 고조파로 잡혀 놓칠 수 있다. 시간 영역 엔진(CONFIG_HR_ENGINE_TIME)은 출력을 약 63~77bpm 안으로
+// 만들어 내므로 그 설정에서는 기본 심박 규칙 4~6이 발생하지 않는다.
+
+#ifndef VITAL_RULES_H
+#define VITAL_RULES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define VITAL_RULES_MAX         16      // 규칙 표 최대 크기
+#define VITAL_RULES_STALE_MS    30000   // 이보다 오래 값이 없으면 지속 시간 판정을 새로 시작
+
+typedef enum {
+    VITAL_METRIC_HEART_RATE = 0,    // bpm
+    VITAL_METRIC_SPO2,              // %
+    VITAL_METRIC_TEMPERATURE,       // °C
+    VITAL_METRIC_RESP_RATE,         // 회/분
+    VITAL_METRIC_COUNT
+} vital_metric_t;
+
+typedef enum {
+    VITAL_OP_ABOVE = 0,     // 값 > 임계값
+    VITAL_OP_BELOW,         // 값 < 임계값
+    VITAL_OP_RISE,          // 분당 증가량 > 임계값
+    VITAL_OP_FALL,          // 분당 감소량 > 임계값
+    VITAL_OP_COUNT
+} vital_op_t;
+
+typedef enum {
+    VITAL_SEVERITY_WARNING = 0,
+    VITAL_SEVERITY_DANGER,
+    VITAL_SEVERITY_CRITICAL,
+    VITAL_SEVERITY_COUNT
+} vital_severity_t;
+
+#define VITAL_RULE_REST_ONLY    (1u << 0)   // 안정/수면으로 분류된 동안만 발생 판정 (운동 중 빈맥 등 제외)
+
+/**
+ * @brief 규칙 하나 (NVS blob 형식이므로 필드 순서/크기를 바꾸면 키 버전을 올린다)
+ */
+typedef struct {
+    uint8_t id;             // 경보에 실리는 규칙 번호
+    uint8_t metric;         // vital_metric_t
+    uint8_t op;             // vital_op_t
+    uint8_t severity;       // vital_severity_t
+    uint8_t flags;          // VITAL_RULE_*
+    uint8_t reserved;
+    uint16_t window_s;      // 변화율 비교 구간 (RISE/FALL만)
+    uint16_t hold_s;        // 발생까지 조건 지속 시간 (0이면 즉시)
+    uint16_t clear_s;       // 해제까지 해제 조건 지속 시간
+    float threshold;        // 수준 규칙은 값, 변화율 규칙은 분당 변화량
+    float hysteresis;       // 해제 임계값 = threshold에서 이만큼 안쪽
+} vital_rule_t;
+
+_Static_assert(sizeof(vital_rule_t) == 20, "vital_rule_t는 NVS blob 형식");
+
+/**
+ * @brief 경보 이벤트 (발생 또는 해제)
+ */
+typedef struct {
+    int64_t t_us;           // 상태를 바꾼 값의 획득 시각 (clock_now_us)
+    float value;            // 그 시점의 값 (변화율 규칙은 분당 변화량)
+    float threshold;
+    uint8_t rule_id;
+    uint8_t metric;
+    uint8_t op;
+    uint8_t severity;
+    bool raised;            // true = 발생, false = 해제
+} vital_alert_t;
+
+/**
+ * @brief 규칙 표 로드 (NVS 초기화 이후, 집계 태스크 시작 전에 한 번)
+ */
+void vital_rules_init(void);
+
+/**
+ * @brief 경보가 생기면 이 태스크에 xTaskNotifyGive
+ */
+void vital_rules_set_event_task(TaskHandle_t task);
+
+/**
+ * @brief 새 값 하나로 해당 항목 규칙 평가 (집계 태스크 전용)
+ * @param at_rest 안정/수면 상태인지 (VITAL_RULE_REST_ONLY 규칙의 발생 판정에 사용)
+ */
+void vital_rules_update(vital_metric_t metric, float value, int64_t t_us, bool at_rest);
+
+/**
+ * @brief 대기 중인 경보 하나 꺼내기 (전송 태스크 전용)
+ * @return 꺼냈으면 true
+ */
+bool vital_rules_take_alert(vital_alert_t *alert);
+
+/**
+ * @brief 규칙 표를 NVS에 저장 (다음 부팅부터 적용, count가 0이면 저장된 표를 지워 기본 규칙으로)
+ * @return ESP_ERR_INVALID_ARG: 개수 초과 또는 잘못된 항목/연산
+ */
+esp_err_t vital_rules_save(const vital_rule_t *rules, size_t count);
+
+const char *vital_metric_name(vital_metric_t metric);
+const char *vital_op_name(vital_op_t op);
+const char *vital_severity_name(vital_severity_t severity);
+
+#endif  // VITAL_RULES_H
@@ -1,9 +0,0 @@
-// wifi_connect.h
-
-#ifndef WIFI_CONNECT_H
-#define WIFI_CONNECT_H
-
-void wifi_connect(void);
-static void time_sync_task(void *pvParameters);
-
-#endif // WIFI_CONNECT_H
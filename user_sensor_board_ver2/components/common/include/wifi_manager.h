@@ -0,0 +1,30 @@
+// wifi_manager.h
+// 이벤트 기반 Wi-Fi STA 관리 태스크
+//
+// Wi-Fi/IP 이벤트 핸들러는 큐에 메시지만 넣고, 실제 처리(재연결, 백오프, NVS 캐시 저장,
+// DNS 설정)는 wifi_mgr 태스크에서 수행한다. 따라서 기본 이벤트 루프를 막지 않는다.
+// 마지막으로 연결된 AP의 BSSID/채널을 NVS에 저장해 두었다가 다음 연결에서 스캔 없이
+// 바로 접속하고, IP 획득 시 app_init의 APP_INIT_NET_UP 비트를 세트한다.
+
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * @brief netif/Wi-Fi 드라이버 초기화 후 관리 태스크 시작 (NVS 초기화 이후 호출)
+ */
+esp_err_t wifi_manager_start(void);
+
+/**
+ * @brief IP까지 획득된 상태인지
+ */
+bool wifi_manager_is_connected(void);
+
+/**
+ * @brief 저장된 AP 캐시 삭제 (다음 연결은 전체 스캔)
+ */
+void wifi_manager_forget_ap(void);
+
+#endif // WIFI_MANAGER_H
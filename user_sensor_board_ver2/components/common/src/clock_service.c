@@ -0,0 +1,106 @@
+// clock_service.c
+
+#include "clock_service.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "CLOCK";
+
+#define CLOCK_VALID_EPOCH_US    (1577836800LL * 1000000LL)  // 2020-01-01 00:00:00 UTC
+#define CLOCK_DRIFT_MIN_SPAN_US (60LL * 1000000LL)          // 드리프트 추정에 필요한 최소 동기화 간격
+#define CLOCK_DRIFT_MAX_ERR_US  (1000000LL)                 // 이보다 큰 오차는 시계 점프로 보고 추정 제외
+#define CLOCK_DRIFT_LIMIT_PPB   (200000)                    // ±200ppm
+
+// 기준점: base_mono_us 시점의 UTC가 base_utc_us
+static int64_t s_base_mono_us = 0;
+static int64_t s_base_utc_us = 0;
+static int32_t s_drift_ppb = 0;
+static bool s_valid = false;
+static bool s_base_from_sync = false;       // 기준점이 SNTP에서 왔는지 (RTC/NVS 복원이면 드리프트 추정 안 함)
+static portMUX_TYPE s_clock_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void clock_service_init(bool system_time_valid) {
+    if (!system_time_valid) {
+        return;
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t mono = esp_timer_get_time();
+    int64_t utc = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+
+    portENTER_CRITICAL(&s_clock_lock);
+    if (!s_valid && utc > CLOCK_VALID_EPOCH_US) {
+        s_base_mono_us = mono;
+        s_base_utc_us = utc;
+        s_valid = true;
+        s_base_from_sync = false;
+    }
+    portEXIT_CRITICAL(&s_clock_lock);
+}
+
+void clock_service_on_sync(const struct timeval *tv) {
+    int64_t mono = esp_timer_get_time();
+    int64_t utc = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec;
+    int64_t err_us = 0;
+    int64_t span_us = 0;
+
+    portENTER_CRITICAL(&s_clock_lock);
+    if (s_valid && s_base_from_sync) {
+        span_us = mono - s_base_mono_us;
+        int64_t predicted = s_base_utc_us + span_us + span_us * s_drift_ppb / 1000000000LL;
+        err_us = utc - predicted;
+
+        // 새 오차의 절반만 반영 (네트워크 지연 편차로 인한 흔들림 완화)
+        if (span_us >= CLOCK_DRIFT_MIN_SPAN_US && err_us > -CLOCK_DRIFT_MAX_ERR_US && err_us < CLOCK_DRIFT_MAX_ERR_US) {
+            int64_t drift = s_drift_ppb + (err_us * 1000000000LL / span_us) / 2;
+            if (drift > CLOCK_DRIFT_LIMIT_PPB) {
+                drift = CLOCK_DRIFT_LIMIT_PPB;
+            } else if (drift < -CLOCK_DRIFT_LIMIT_PPB) {
+                drift = -CLOCK_DRIFT_LIMIT_PPB;
+            }
+            s_drift_ppb = (int32_t)drift;
+        }
+    }
+    s_base_mono_us = mono;
+    s_base_utc_us = utc;
+    s_valid = true;
+    s_base_from_sync = true;
+    int32_t drift_ppb = s_drift_ppb;
+    portEXIT_CRITICAL(&s_clock_lock);
+
+    ESP_LOGI(TAG, "기준점 갱신: 오차 %lldus / %llds, 드리프트 %.3fppm",
+             (long long)err_us, (long long)(span_us / 1000000), drift_ppb / 1000.0f);
+}
+
+int64_t clock_now_us(void) {
+    return esp_timer_get_time();
+}
+
+int64_t clock_to_utc_us(int64_t mono_us) {
+    portENTER_CRITICAL(&s_clock_lock);
+    bool valid = s_valid;
+    int64_t base_mono = s_base_mono_us;
+    int64_t base_utc = s_base_utc_us;
+    int32_t drift_ppb = s_drift_ppb;
+    portEXIT_CRITICAL(&s_clock_lock);
+
+    if (!valid) {
+        return mono_us;
+    }
+    int64_t delta = mono_us - base_mono;
+    return base_utc + delta + delta * drift_ppb / 1000000000LL;
+}
+
+int64_t clock_to_utc_ms(int64_t mono_us) {
+    return clock_to_utc_us(mono_us) / 1000;
+}
+
+bool clock_is_utc_valid(void) {
+    return s_valid;
+}
+
+int32_t clock_get_drift_ppb(void) {
+    return s_drift_ppb;
+}
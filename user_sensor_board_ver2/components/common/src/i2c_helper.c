@@ -159,3 +159,44 @@ esp_err_t i2c_bus_recover_1(void) {
     ESP_LOGW(TAG, "I2C1 버스 복구 완료");
     return ESP_OK;
 }
+
+esp_err_t i2c_bus_wake_1(uint32_t sda_low_ms) {
+    // SCL high 상태에서 SDA를 내렸다 올리면 다른 장치에는 START/STOP으로만 보인다
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << I2C_MASTER_SDA_IO_1) | (1ULL << I2C_MASTER_SCL_IO_1),
+        .mode = GPIO_MODE_OUTPUT_OD,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    gpio_config(&io_conf);
+    
+    gpio_set_level(I2C_MASTER_SCL_IO_1, 1);
+    gpio_set_level(I2C_MASTER_SDA_IO_1, 0);
+    vTaskDelay(pdMS_TO_TICKS(sda_low_ms) + 1);
+    gpio_set_level(I2C_MASTER_SDA_IO_1, 1);
+    
+    i2c_driver_delete(I2C_MASTER_NUM_1);
+    
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = I2C_MASTER_SDA_IO_1,
+        .scl_io_num = I2C_MASTER_SCL_IO_1,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = I2C_MASTER_FREQ_HZ_1,
+    };
+    
+    esp_err_t ret = i2c_param_config(I2C_MASTER_NUM_1, &conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "I2C1 파라미터 설정 실패: %s", esp_err_to_name(ret));
+        return ESP_FAIL;
+    }
+    
+    ret = i2c_driver_install(I2C_MASTER_NUM_1, conf.mode, 0, 0, 0);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "I2C1 드라이버 설치 실패: %s", esp_err_to_name(ret));
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,124 @@
+// placement_bench.c
+// 태스크 배치 벤치마크 (CONFIG_TASK_PLACEMENT_BENCH)
+//
+// 무부하 구간과 Wi-Fi 부하 구간(게이트웨이 discard 포트로 UDP 연속 송신)을 같은 길이로 측정해
+// IMU 데드라인 미스, 발행 지연, PUBACK 지연을 비교한다. 고정/비고정 정책으로 각각 빌드해
+// "BENCH" 로그 두 줄씩을 비교하면 된다. 부하 구간 끝의 스택 점검은 스택 크기 산정에 사용한다.
+
+#include "placement_bench.h"
+#include "sdkconfig.h"
+
+#if CONFIG_TASK_PLACEMENT_BENCH
+
+#include "task_placement.h"
+#include "metrics.h"
+#include "wifi_manager.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "BENCH";
+
+#define BENCH_UDP_PORT      9           // discard
+#define BENCH_UDP_PAYLOAD   1400
+
+#if CONFIG_TASK_PLACEMENT_PINNED
+#define BENCH_POLICY "pinned"
+#else
+#define BENCH_POLICY "unpinned"
+#endif
+
+static uint8_t s_payload[BENCH_UDP_PAYLOAD];
+
+static uint32_t phase_begin(void) {
+    metrics_reset_timer(METRIC_PUBLISH_LATENCY_MS);
+    metrics_reset_timer(METRIC_MQTT_ACK_MS);
+    metrics_reset_timer(METRIC_IMU_GAP_MS);
+    return metrics_get_counter(METRIC_IMU_DEADLINE_MISSES);
+}
+
+static void phase_end(const char *phase, uint32_t miss_start, int64_t elapsed_us, uint64_t udp_bytes) {
+    uint32_t misses = metrics_get_counter(METRIC_IMU_DEADLINE_MISSES) - miss_start;
+    metric_timer_stat_t pub = metrics_get_timer(METRIC_PUBLISH_LATENCY_MS);
+    metric_timer_stat_t ack = metrics_get_timer(METRIC_MQTT_ACK_MS);
+    metric_timer_stat_t gap = metrics_get_timer(METRIC_IMU_GAP_MS);
+    float minutes = (float)elapsed_us / 60e6f;
+
+    ESP_LOGI(TAG, "policy=%s phase=%s imu_miss=%lu (%.1f/min, gap max %lums) "
+             "publish n=%lu avg=%lums max=%lums ack n=%lu avg=%lums max=%lums udp=%lukbps",
+             BENCH_POLICY, phase, (unsigned long)misses, minutes > 0 ? misses / minutes : 0.0f,
+             (unsigned long)gap.max,
+             (unsigned long)pub.count, (unsigned long)(pub.count ? pub.sum / pub.count : 0), (unsigned long)pub.max,
+             (unsigned long)ack.count, (unsigned long)(ack.count ? ack.sum / ack.count : 0), (unsigned long)ack.max,
+             (unsigned long)(elapsed_us > 0 ? udp_bytes * 8000 / (uint64_t)elapsed_us : 0));
+}
+
+static void bench_task(void *param) {
+    const int64_t phase_us = (int64_t)CONFIG_TASK_PLACEMENT_BENCH_PHASE_S * 1000000;
+
+    while (!wifi_manager_is_connected()) {
+        vTaskDelay(pdMS_TO_TICKS(500));
+    }
+
+    // 1) 무부하
+    uint32_t miss0 = phase_begin();
+    int64_t t0 = esp_timer_get_time();
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_TASK_PLACEMENT_BENCH_PHASE_S * 1000));
+    phase_end("idle", miss0, esp_timer_get_time() - t0, 0);
+
+    // 2) Wi-Fi 부하
+    esp_netif_ip_info_t ip_info = {0};
+    esp_netif_get_ip_info(esp_netif_get_default_netif(), &ip_info);
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "소켓 생성 실패");
+        task_placement_forget(TASK_ID_BENCH_LOAD);
+        vTaskDelete(NULL);
+        return;
+    }
+    struct sockaddr_in dst = {
+        .sin_family = AF_INET,
+        .sin_port = htons(BENCH_UDP_PORT),
+        .sin_addr.s_addr = ip_info.gw.addr,
+    };
+
+    uint64_t sent = 0;
+    uint32_t send_errors = 0;
+    miss0 = phase_begin();
+    t0 = esp_timer_get_time();
+    while (esp_timer_get_time() - t0 < phase_us) {
+        int ret = sendto(sock, s_payload, sizeof(s_payload), 0, (struct sockaddr *)&dst, sizeof(dst));
+        if (ret > 0) {
+            sent += (uint64_t)ret;
+        } else {
+            send_errors++;          // 송신 버퍼 부족 - 한 틱 양보 후 재시도
+            vTaskDelay(1);
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - t0;
+    close(sock);
+
+    phase_end("wifi_load", miss0, elapsed, sent);
+    ESP_LOGI(TAG, "부하 구간 송신 실패 %lu회, 스택 점검:", (unsigned long)send_errors);
+    task_placement_check_stacks();
+
+    task_placement_forget(TASK_ID_BENCH_LOAD);
+    vTaskDelete(NULL);
+}
+
+esp_err_t placement_bench_start(void) {
+    ESP_LOGW(TAG, "배치 벤치마크 (%s): 무부하 %ds → Wi-Fi 부하 %ds", BENCH_POLICY,
+             CONFIG_TASK_PLACEMENT_BENCH_PHASE_S, CONFIG_TASK_PLACEMENT_BENCH_PHASE_S);
+    return task_placement_create(TASK_ID_BENCH_LOAD, bench_task, NULL, NULL) == pdPASS ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+#else
+
+esp_err_t placement_bench_start(void) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_TASK_PLACEMENT_BENCH
@@ -2,9 +2,23 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include <string.h> // Added for memset
+#include <stdint.h>
+#include <stdbool.h>
+#include "clock_service.h"
 
 static sensor_data_t current_data;
 static SemaphoreHandle_t data_mutex;
+static TaskHandle_t event_task = NULL;
+
+// 낙상 창 슬롯 (약 5KB라 스냅샷에 넣지 않고 한 개만 둠)
+typedef enum {
+    FALL_WINDOW_FREE = 0,
+    FALL_WINDOW_FILLING,
+    FALL_WINDOW_READY,
+} fall_window_state_t;
+
+static fall_window_t fall_window;
+static fall_window_state_t fall_window_state = FALL_WINDOW_FREE;
 
 void sensor_data_init(void) {
     data_mutex = xSemaphoreCreateMutex();
@@ -12,92 +26,188 @@ void sensor_data_init(void) {
     memset(&current_data.validity_flags, 0, sizeof(current_data.validity_flags));
 }
 
-void sensor_data_set_heart_rate(float hr) {
+void sensor_data_set_heart_rate(float hr, int64_t acq_time_us) {
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
         current_data.heart_rate = hr;
         current_data.validity_flags.heart_rate_valid = 1;  // 유효성 플래그 설정
+        current_data.acq_time_us.heart_rate = acq_time_us;
         xSemaphoreGive(data_mutex);
     }
 }
 
-void sensor_data_set_temperature(float temp) {
+void sensor_data_set_temperature(float core_c, float skin_c, int64_t acq_time_us) {
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
-        current_data.temperature = temp;
+        current_data.temperature = core_c;
+        current_data.skin_temperature = skin_c;
         current_data.validity_flags.temperature_valid = 1;
+        current_data.acq_time_us.temperature = acq_time_us;
         xSemaphoreGive(data_mutex);
     }
 }
 
-void sensor_data_set_spo2(int spo2) {
+void sensor_data_set_spo2(int spo2, int64_t acq_time_us) {
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
         current_data.spo2 = spo2;
         current_data.validity_flags.spo2_valid = 1;
+        current_data.acq_time_us.spo2 = acq_time_us;
+        xSemaphoreGive(data_mutex);
+    }
+}
+
+void sensor_data_set_resp_rate(float resp_rate, float quality, int64_t acq_time_us) {
+    if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
+        current_data.resp_rate = resp_rate;
+        current_data.resp_quality = quality;
+        current_data.validity_flags.resp_rate_valid = 1;
+        current_data.acq_time_us.resp_rate = acq_time_us;
         xSemaphoreGive(data_mutex);
     }
 }
 
-void sensor_data_set_steps(int steps) {
+void sensor_data_set_steps(int steps, int64_t acq_time_us) {
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
         current_data.steps = steps;
         current_data.validity_flags.steps_valid = 1;
+        current_data.acq_time_us.steps = acq_time_us;
         xSemaphoreGive(data_mutex);
     }
 }
 
-void sensor_data_set_fall_detected(int fall) {
+void sensor_data_set_fall_detected(int fall, int64_t acq_time_us) {
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
         current_data.fall_detected = fall;
         current_data.validity_flags.fall_detected_valid = 1;
+        current_data.acq_time_us.fall_detected = acq_time_us;
         xSemaphoreGive(data_mutex);
     }
+    if (fall && event_task != NULL) {
+        xTaskNotifyGive(event_task);
+    }
+}
+
+void sensor_data_set_event_task(TaskHandle_t task) {
+    event_task = task;
 }
 
-void sensor_data_set_timestamp(int64_t timestamp_ms) {
+static bool fall_window_transition(fall_window_state_t from, fall_window_state_t to) {
+    bool ok = false;
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
-        current_data.timestamp_ms = timestamp_ms;
+        if (fall_window_state == from) {
+            fall_window_state = to;
+            ok = true;
+        }
         xSemaphoreGive(data_mutex);
     }
+    return ok;
 }
 
-void sensor_data_set_location(uint16_t major, uint16_t minor, int rssi) {
+fall_window_t *sensor_data_acquire_fall_window(void) {
+    return fall_window_transition(FALL_WINDOW_FREE, FALL_WINDOW_FILLING) ? &fall_window : NULL;
+}
+
+void sensor_data_commit_fall_window(void) {
+    fall_window_transition(FALL_WINDOW_FILLING, FALL_WINDOW_READY);
+}
+
+// 소비자만 READY → FREE로 바꾸므로 peek 이후 release 전까지 내용이 바뀌지 않는다
+const fall_window_t *sensor_data_peek_fall_window(void) {
+    bool ready = false;
+    if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
+        ready = (fall_window_state == FALL_WINDOW_READY);
+        xSemaphoreGive(data_mutex);
+    }
+    return ready ? &fall_window : NULL;
+}
+
+void sensor_data_release_fall_window(void) {
+    fall_window_transition(FALL_WINDOW_READY, FALL_WINDOW_FREE);
+}
+
+void sensor_data_set_location(uint16_t major, uint16_t minor, int rssi, int64_t acq_time_us) {
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
         current_data.location.major = major;
         current_data.location.minor = minor;
         current_data.location.rssi = rssi;
         current_data.validity_flags.location_valid = 1;
+        current_data.acq_time_us.location = acq_time_us;
+        xSemaphoreGive(data_mutex);
+    }
+}
+
+void sensor_data_set_motion_artifact(int corrupted, int64_t acq_time_us) {
+    if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
+        current_data.motion_artifact = corrupted;
+        current_data.validity_flags.motion_artifact_valid = 1;
+        current_data.acq_time_us.motion_artifact = acq_time_us;
+        xSemaphoreGive(data_mutex);
+    }
+}
+
+void sensor_data_set_activity(const char *activity, int64_t acq_time_us) {
+    if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
+        current_data.activity = activity;
+        current_data.validity_flags.activity_valid = 1;
+        current_data.acq_time_us.activity = acq_time_us;
         xSemaphoreGive(data_mutex);
     }
 }
 
+// 항목별 경과 시간 계산, TTL(0이면 무제한)이 지났으면 false
+static bool update_freshness(uint8_t valid, int64_t acq_time_us, int64_t now_us, uint32_t ttl_ms, int32_t *age_ms) {
+    if (!valid) {
+        *age_ms = -1;
+        return false;
+    }
+    int64_t age = (now_us - acq_time_us) / 1000;
+    *age_ms = (age > INT32_MAX) ? INT32_MAX : (int32_t)age;
+    return ttl_ms == 0 || age <= ttl_ms;
+}
+
 sensor_data_t sensor_data_get_snapshot(void) {
-    sensor_data_t copy;
+    sensor_data_t copy = {0};
     if (xSemaphoreTake(data_mutex, portMAX_DELAY)) {
         copy = current_data;
         xSemaphoreGive(data_mutex);
     }
+
+    int64_t now_us = clock_now_us();
+    copy.validity_flags.heart_rate_valid = update_freshness(copy.validity_flags.heart_rate_valid,
+        copy.acq_time_us.heart_rate, now_us, CONFIG_SENSOR_TTL_HEART_RATE_MS, &copy.age_ms.heart_rate);
+    copy.validity_flags.temperature_valid = update_freshness(copy.validity_flags.temperature_valid,
+        copy.acq_time_us.temperature, now_us, CONFIG_SENSOR_TTL_TEMPERATURE_MS, &copy.age_ms.temperature);
+    copy.validity_flags.spo2_valid = update_freshness(copy.validity_flags.spo2_valid,
+        copy.acq_time_us.spo2, now_us, CONFIG_SENSOR_TTL_SPO2_MS, &copy.age_ms.spo2);
+    copy.validity_flags.resp_rate_valid = update_freshness(copy.validity_flags.resp_rate_valid,
+        copy.acq_time_us.resp_rate, now_us, CONFIG_SENSOR_TTL_RESP_RATE_MS, &copy.age_ms.resp_rate);
+    copy.validity_flags.steps_valid = update_freshness(copy.validity_flags.steps_valid,
+        copy.acq_time_us.steps, now_us, CONFIG_SENSOR_TTL_STEPS_MS, &copy.age_ms.steps);
+    copy.validity_flags.fall_detected_valid = update_freshness(copy.validity_flags.fall_detected_valid,
+        copy.acq_time_us.fall_detected, now_us, CONFIG_SENSOR_TTL_FALL_MS, &copy.age_ms.fall_detected);
+    copy.validity_flags.location_valid = update_freshness(copy.validity_flags.location_valid,
+        copy.acq_time_us.location, now_us, CONFIG_SENSOR_TTL_LOCATION_MS, &copy.age_ms.location);
+    copy.validity_flags.motion_artifact_valid = update_freshness(copy.validity_flags.motion_artifact_valid,
+        copy.acq_time_us.motion_artifact, now_us, CONFIG_SENSOR_TTL_MOTION_ARTIFACT_MS, &copy.age_ms.motion_artifact);
+    copy.validity_flags.activity_valid = update_freshness(copy.validity_flags.activity_valid,
+        copy.acq_time_us.activity, now_us, CONFIG_SENSOR_TTL_ACTIVITY_MS, &copy.age_ms.activity);
     return copy;
 }
 
 // 유효한 측정값이 있는지 확인
-int sensor_data_has_valid_measurements(void) {
-    sensor_data_t snapshot = sensor_data_get_snapshot();
-    return (snapshot.validity_flags.heart_rate_valid ||
-            snapshot.validity_flags.temperature_valid ||
-            snapshot.validity_flags.spo2_valid ||
-            snapshot.validity_flags.steps_valid ||
-            snapshot.validity_flags.fall_detected_valid ||
-            snapshot.validity_flags.location_valid);
-}
-
-// 유효한 센서 개수 반환
-int sensor_data_get_valid_count(void) {
-    sensor_data_t snapshot = sensor_data_get_snapshot();
+int sensor_data_has_valid_measurements(const sensor_data_t *snapshot) {
+    return sensor_data_get_valid_count(snapshot) > 0;
+}
+
+// TTL 이내인 측정값 개수 반환
+// 낙상 플래그(경보 래치)와 움직임 오염(심박 처리 상태)은 측정값이 아니므로 세지 않는다:
+// 이 둘만 남아 있을 때 주기 발행이 계속되면 센서가 멈춘 뒤에도 페이로드가 나간다
+int sensor_data_get_valid_count(const sensor_data_t *snapshot) {
     int count = 0;
-    count += snapshot.validity_flags.heart_rate_valid;
-    count += snapshot.validity_flags.temperature_valid;
-    count += snapshot.validity_flags.spo2_valid;
-    count += snapshot.validity_flags.steps_valid;
-    count += snapshot.validity_flags.fall_detected_valid;
-    count += snapshot.validity_flags.location_valid;
+    count += snapshot->validity_flags.heart_rate_valid;
+    count += snapshot->validity_flags.temperature_valid;
+    count += snapshot->validity_flags.spo2_valid;
+    count += snapshot->validity_flags.resp_rate_valid;
+    count += snapshot->validity_flags.steps_valid;
+    count += snapshot->validity_flags.location_valid;
+    count += snapshot->validity_flags.activity_valid;
     return count;
 }
@@ -4,8 +4,12 @@
 #include "max30102_driver.h"
 #include "heart_rate_calculator.h"
 #include "mlx90614_driver.h"
-#include "sensor_data.h"
-#include "mpu6050_step_fall.h"  // 추가
+#include "led_agc.h"
+#include "sensor_pipeline.h"
+#include "clock_service.h"
+#include "trace_capture.h"
+#include "task_placement.h"
+#include "metrics.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -17,6 +21,8 @@
 
 static const char *TAG = "SENSOR_MANAGER";
 
+#define IMU_DEADLINE_US     15000   // 100Hz 주기의 1.5배를 넘으면 데드라인 미스
+
 // 태스크 핸들
 static TaskHandle_t sensor_manager_task_handle = NULL;
 
@@ -30,82 +36,38 @@ static bool task_running = false;
 // 센서 데이터 구조체들
 static mpu6050_data_t mpu6050_data;
 static uint32_t max30102_red, max30102_ir;
-static float mlx90614_temp;
+static mlx90614_reading_t mlx90614_reading;
+
+// 착용 감지: 미착용이면 광학/체온 센서를 저전력으로 두고 PPG DSP를 멈춘다 (획득 태스크만 사용)
+#define PRESENCE_PROBE_CURRENT  10      // 미착용 중 IR 프로브 전류 (2mA, RED는 끔)
+#define MLX90614_WAKE_SDA_MS    40      // sleep 해제 SDA low 펄스 (33ms 이상)
+
+typedef enum {
+    PRESENCE_ON_WRIST = 0,
+    PRESENCE_OFF_WRIST,
+} presence_t;
+
+static presence_t presence = PRESENCE_ON_WRIST;
+static activity_class_t presence_last_activity = ACTIVITY_UNKNOWN;
+static bool presence_probe_skin = false;
+static uint32_t presence_off_count = 0;
 
 // 센서 초기화 상태 플래그 추가
 static bool mpu6050_initialized = false;
 static bool max30102_initialized = false;
 static bool mlx90614_initialized = false;
 
-// 걸음 수 및 낙상 감지 컨텍스트 추가
-static step_fall_ctx_t step_fall_ctx;
-static bool step_fall_initialized = false;
-
-// 기존 전역 변수 방식 유지 (걸음 수 누적용)
-static int step_count = 0;
+// 읽기 함수는 I2C 뮤텍스 안에서 실행되므로 버스 I/O만 하고 샘플을 파이프라인에 넘긴다.
+// 걸음/낙상, 심박/SpO2 계산은 sensor_pipeline의 DSP 태스크에서 수행한다.
 
 /**
- * @brief MPU6050 센서 읽기 함수 (I2C0 사용) - 고급 알고리즘 적용
+ * @brief MPU6050 센서 읽기 함수 (I2C0 사용)
  * @return ESP_OK 성공, ESP_FAIL 실패
  */
 static esp_err_t read_mpu6050(void) {
     esp_err_t ret = mpu6050_read_data(I2C_MASTER_NUM_0, &mpu6050_data);
     if (ret == ESP_OK) {
-        // 걸음 수 및 낙상 감지 초기화 (한 번만)
-        if (!step_fall_initialized) {
-            step_fall_init(&step_fall_ctx, 100.0f); // 100Hz 샘플링
-            step_fall_initialized = true;
-            ESP_LOGI(TAG, "걸음 수 및 낙상 감지 알고리즘 초기화 완료");
-        }
-
-        // 현재 시간을 ms 단위로 변환
-        uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000ULL);
-        
-        // 고급 걸음 수 감지 알고리즘 실행 (누적 방식)
-        if (step_fall_detect_step(&step_fall_ctx,
-                                 mpu6050_data.ax, mpu6050_data.ay, mpu6050_data.az,
-                                 mpu6050_data.gx, mpu6050_data.gy, mpu6050_data.gz,
-                                 now_ms)) {
-            step_count++; // 기존 방식대로 누적
-            sensor_data_set_steps(step_count);
-        }
-        
-        // 고급 낙상 감지 알고리즘 실행 (논문 기반)
-        static bool fall_detected_flag = false;  // 낙상 감지 플래그
-        static uint32_t fall_reset_time = 0;     // 리셋 시간
-        
-        fall_result_t fall_result = step_fall_detect_fall(&step_fall_ctx,
-                                                         mpu6050_data.ax, mpu6050_data.ay, mpu6050_data.az,
-                                                         mpu6050_data.gx, mpu6050_data.gy, mpu6050_data.gz,
-                                                         now_ms);
-        
-        if (fall_result.fall_detected) {
-            if (!fall_detected_flag) {  // 처음 감지된 경우에만
-                // 방향 문자열 변환
-                const char* direction_names[] = {
-                    "없음", "앞", "뒤", "좌", "우", 
-                    "앞-좌", "앞-우", "뒤-좌", "뒤-우"
-                };
-                
-                ESP_LOGW(TAG, "논문 기반 낙상 감지됨!");
-                ESP_LOGW(TAG, "가속도: X=%.3fg, Y=%.3fg", fall_result.ax_g, fall_result.ay_g);
-                ESP_LOGW(TAG, "각도: Roll=%.1f°, Pitch=%.1f°", fall_result.roll_deg, fall_result.pitch_deg);
-                ESP_LOGW(TAG, "낙상 방향: %s (각도: %.1f°)", direction_names[fall_result.direction], fall_result.fall_angle_deg);
-                ESP_LOGW(TAG, "fallDetected=1 설정");
-                
-                sensor_data_set_fall_detected(1);
-                fall_detected_flag = true;
-                fall_reset_time = now_ms + 3000;  // 3초 후 리셋 예약
-            }
-        }
-        
-        // 자동 리셋 시간이 되면 0으로 설정
-        if (fall_detected_flag && now_ms >= fall_reset_time) {
-            ESP_LOGD(TAG, "fallDetected 자동 리셋 - fallDetected=0 설정");
-            sensor_data_set_fall_detected(0);
-            fall_detected_flag = false;  // 리셋 완료
-            fall_reset_time = 0;
-        }
+        sensor_pipeline_push_imu(&mpu6050_data, clock_now_us());
     }
     return ret;
 }
@@ -115,40 +77,61 @@ static esp_err_t read_mpu6050(void) {
  * @return ESP_OK 성공, ESP_FAIL 실패
  */
 static esp_err_t read_max30102(void) {
-    esp_err_t ret = max30102_read_fifo(&max30102_red, &max30102_ir);
-    
-    if (ret == ESP_OK) {
-        // 심박수 및 SpO2 계산
-        heart_rate_data_t heart_data = calculate_heart_rate_and_spo2(max30102_red, max30102_ir);
-        
-        if (heart_data.valid_data) {
-            sensor_data_set_heart_rate(heart_data.heart_rate);
-            sensor_data_set_spo2(heart_data.spo2);
+    // 쌓인 샘플을 모두 꺼내고, 마지막 샘플 시각을 지금으로 보고 출력 주기만큼씩 거슬러 올라가 시각을 매김
+    uint32_t red[MAX30102_FIFO_DEPTH], ir[MAX30102_FIFO_DEPTH];
+    uint8_t count;
+    esp_err_t ret = max30102_read_fifo_samples(red, ir, MAX30102_FIFO_DEPTH, &count);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int64_t now_us = clock_now_us();
+    for (uint8_t i = 0; i < count; i++) {
+        sensor_pipeline_push_ppg(red[i], ir[i], now_us - (int64_t)(count - 1 - i) * MAX30102_DEFAULT_SAMPLE_PERIOD_US);
+    }
+    if (count > 0) {
+        max30102_red = red[count - 1];
+        max30102_ir = ir[count - 1];
+    }
+
+    // AGC 요청은 I2C1 뮤텍스를 잡은 이 자리에서 반영 (실패하면 AGC가 잠시 뒤 다시 요청)
+    // FIFO를 비운 뒤에 바꿔야 이전 전류로 획득된 샘플이 새 전류로 표시되지 않는다
+    uint8_t led_ir, led_red;
+    if (sensor_pipeline_take_led_request(&led_ir, &led_red)) {
+        if (max30102_set_led_current(led_ir, led_red) == ESP_OK) {
+            sensor_pipeline_led_current_applied(led_ir, led_red);
+        } else {
+            ESP_LOGW(TAG, "MAX30102 LED 전류 설정 실패");
         }
     }
-    
-    return ret;
+    return ESP_OK;
 }
 
 /**
- * @brief MLX90614 센서 읽기 함수 (I2C1 사용)
- * @return ESP_OK 성공, ESP_FAIL 실패
+ * @brief MLX90614 센서 읽기 함수 (I2C1 사용, 주변/물체 온도를 한 번에)
+ * @return ESP_OK 성공, 프레임 오류면 ESP_ERR_INVALID_CRC/ESP_ERR_INVALID_RESPONSE, 그 밖은 버스 오류
  */
 static esp_err_t read_mlx90614(void) {
-    esp_err_t ret = mlx90614_read_temp(&mlx90614_temp);
+    esp_err_t ret = mlx90614_read(&mlx90614_reading);
     if (ret == ESP_OK) {
-        sensor_data_set_temperature(mlx90614_temp);
+        sensor_pipeline_push_temperature(mlx90614_reading.object_c, mlx90614_reading.ambient_c, clock_now_us());
+    } else if (ret == ESP_ERR_INVALID_CRC || ret == ESP_ERR_INVALID_RESPONSE) {
+        metrics_inc(METRIC_TEMP_FRAME_DROPS);
     }
     return ret;
 }
 
+// 버스 트랜잭션은 끝났고 받은 프레임만 버린 경우 (버스 복구/재시도 대상이 아님)
+static bool is_frame_error(esp_err_t ret) {
+    return ret == ESP_ERR_INVALID_CRC || ret == ESP_ERR_INVALID_RESPONSE;
+}
+
 /**
  * @brief 센서 읽기 함수 (재시도 로직 포함, I2C 포트별 분리)
  * @param sensor_read_func 센서 읽기 함수 포인터
  * @param sensor_name 센서 이름 (로그용)
  * @param max_retries 최대 재시도 횟수
  * @param use_i2c0 true면 I2C0, false면 I2C1 사용
- * @return ESP_OK 성공, ESP_FAIL 실패
+ * @return ESP_OK 성공, 프레임 오류는 재시도 없이 그대로, 그 밖의 실패는 ESP_FAIL
  */
 static esp_err_t read_sensor_with_retry(esp_err_t (*sensor_read_func)(void), 
                                        const char *sensor_name, 
@@ -183,6 +166,10 @@ static esp_err_t read_sensor_with_retry(esp_err_t (*sensor_read_func)(void),
             }
             return ESP_OK;
         }
+        if (is_frame_error(ret)) {
+            ESP_LOGD(TAG, "%s: 프레임 버림 (%s)", sensor_name, esp_err_to_name(ret));
+            return ret;
+        }
         
         retry_count++;
         ESP_LOGW(TAG, "%s: 읽기 실패 (%d/%d): %s", 
@@ -196,6 +183,118 @@ static esp_err_t read_sensor_with_retry(esp_err_t (*sensor_read_func)(void),
     return ESP_FAIL;
 }
 
+/**
+ * @brief 미착용 진입: MAX30102는 IR 프로브(또는 shutdown), MLX90614는 sleep (I2C1 뮤텍스 안에서 실행)
+ */
+static esp_err_t enter_off_wrist(void) {
+#if CONFIG_PRESENCE_OPTICAL_PROBE
+    esp_err_t ret = max30102_set_led_current(PRESENCE_PROBE_CURRENT, 0);
+#else
+    esp_err_t ret = max30102_set_shutdown(true);
+#endif
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (mlx90614_initialized) {
+        mlx90614_sleep();       // 실패해도 측정만 쉬므로 미착용 전환은 계속
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 착용 복귀: MAX30102를 기본 LED 전류로, MLX90614 깨우기 (I2C1 뮤텍스 안에서 실행)
+ */
+static esp_err_t enter_on_wrist(void) {
+    esp_err_t ret = ESP_OK;
+#if !CONFIG_PRESENCE_OPTICAL_PROBE
+    ret = max30102_set_shutdown(false);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+#endif
+    ret = max30102_set_led_current(MAX30102_DEFAULT_LED_CURRENT, MAX30102_DEFAULT_LED_CURRENT);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    max30102_clear_fifo();
+    if (mlx90614_initialized) {
+        i2c_bus_wake_1(MLX90614_WAKE_SDA_MS);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 미착용 중 IR 프로브 샘플 하나로 피부 접촉 확인 (I2C1 뮤텍스 안에서 실행)
+ */
+static esp_err_t probe_max30102(void) {
+    esp_err_t ret = max30102_read_fifo(&max30102_red, &max30102_ir);
+    if (ret == ESP_OK) {
+        presence_probe_skin = max30102_ir >= LED_AGC_CONTACT_PER_LSB * PRESENCE_PROBE_CURRENT;
+    }
+    return ret;
+}
+
+/**
+ * @brief 착용 상태 전환 (획득 루프마다 호출)
+ *
+ * 착용 중: ppg_dsp가 남긴 접촉 없는 시간이 CONFIG_PRESENCE_OFF_CONFIRM_MS를 넘으면 미착용.
+ * 미착용 중: 프로브 주기마다, 또는 활동 분류가 움직임으로 바뀐 직후 IR 프로브로 피부를 확인한다.
+ * 프로브를 끈 설정에서는 움직임만으로 깨우고, 접촉이 없으면 확인 시간 뒤 다시 미착용이 된다.
+ * @return 이번 호출에서 MLX90614를 깨웠으면 true (첫 측정을 sleep 해제 시간 뒤로 미룸)
+ */
+static bool presence_update(TickType_t now, TickType_t *last_probe) {
+    if (!max30102_initialized) {
+        return false;           // 광학 센서 없이는 착용을 판단할 수 없어 항상 착용으로 둔다
+    }
+
+    if (presence == PRESENCE_ON_WRIST) {
+        uint32_t no_contact_ms = sensor_pipeline_no_contact_ms();
+        if (no_contact_ms < CONFIG_PRESENCE_OFF_CONFIRM_MS) {
+            return false;
+        }
+        if (read_sensor_with_retry(enter_off_wrist, "MAX30102 미착용 전환", 3, false) != ESP_OK) {
+            return false;
+        }
+        sensor_pipeline_ppg_pause();
+        presence = PRESENCE_OFF_WRIST;
+        presence_off_count++;
+        presence_last_activity = sensor_pipeline_current_activity();
+        *last_probe = now;
+        ESP_LOGI(TAG, "미착용 전환 (접촉 없음 %lums, %lu번째) - PPG/체온 측정 중지",
+                 (unsigned long)no_contact_ms, (unsigned long)presence_off_count);
+        return false;
+    }
+
+    // 정지/수면에서 움직임으로 바뀐 순간만 깨움 신호로 본다 (가방 속 보행처럼 계속 움직이면 한 번만)
+    activity_class_t act = sensor_pipeline_current_activity();
+    bool moved = act != presence_last_activity &&
+                 (act == ACTIVITY_WALK || act == ACTIVITY_RUN || act == ACTIVITY_TRANSITION);
+    presence_last_activity = act;
+
+#if CONFIG_PRESENCE_OPTICAL_PROBE
+    if (!moved && (now - *last_probe) < pdMS_TO_TICKS(CONFIG_PRESENCE_PROBE_INTERVAL_MS)) {
+        return false;
+    }
+    *last_probe = now;
+    presence_probe_skin = false;
+    if (read_sensor_with_retry(probe_max30102, "MAX30102 프로브", 1, false) != ESP_OK || !presence_probe_skin) {
+        return false;
+    }
+#else
+    if (!moved) {
+        return false;
+    }
+#endif
+
+    if (read_sensor_with_retry(enter_on_wrist, "MAX30102 착용 복귀", 3, false) != ESP_OK) {
+        return false;
+    }
+    sensor_pipeline_ppg_resume(MAX30102_DEFAULT_LED_CURRENT, MAX30102_DEFAULT_LED_CURRENT);
+    presence = PRESENCE_ON_WRIST;
+    ESP_LOGI(TAG, "착용 복귀 (%s) - PPG/체온 측정 재개", moved ? "움직임" : "IR 프로브");
+    return mlx90614_initialized;
+}
+
 /**
  * @brief 센서 매니저 태스크
  * @param pvParameters 태스크 파라미터 (사용하지 않음)
@@ -206,28 +305,46 @@ static void sensor_manager_task(void *pvParameters) {
     TickType_t last_mpu6050_time = 0;
     TickType_t last_max30102_time = 0;
     TickType_t last_mlx90614_time = 0;
+    TickType_t last_probe_time = 0;
     
     const TickType_t mpu6050_interval = pdMS_TO_TICKS(10);   // 10ms (100Hz)
     const TickType_t max30102_interval = pdMS_TO_TICKS(20);  // 20ms (50Hz)
     const TickType_t mlx90614_interval = pdMS_TO_TICKS(1000); // 1000ms (1Hz)
+    int64_t last_imu_us = 0;
     
     while (task_running) {
         TickType_t current_time = xTaskGetTickCount();
         
         // MPU6050 읽기 (I2C0 사용) - 초기화된 경우에만
         if (mpu6050_initialized && (current_time - last_mpu6050_time) >= mpu6050_interval) {
+            int64_t imu_start_us = esp_timer_get_time();
+            TRACE_BEGIN(TRACE_MARK_IMU_READ);
             esp_err_t ret = read_sensor_with_retry(read_mpu6050, "MPU6050", 3, true);
+            TRACE_END(TRACE_MARK_IMU_READ);
             if (ret == ESP_OK) {
                 last_mpu6050_time = current_time;
+                if (last_imu_us != 0 && imu_start_us - last_imu_us > IMU_DEADLINE_US) {
+                    metrics_inc(METRIC_IMU_DEADLINE_MISSES);
+                    metrics_record_ms(METRIC_IMU_GAP_MS, (uint32_t)((imu_start_us - last_imu_us) / 1000));
+                }
+                last_imu_us = imu_start_us;
             } else {
                 ESP_LOGW(TAG, "MPU6050 읽기 실패 (재시도 중)");
                 // 읽기 실패 시에도 다음 주기에서 재시도
             }
         }
         
-        // MAX30102 읽기 (I2C1 사용) - 초기화된 경우에만
-        if (max30102_initialized && (current_time - last_max30102_time) >= max30102_interval) {
+        // 착용 상태 전환 (미착용이면 아래 MAX30102/MLX90614 주기 읽기를 건너뜀)
+        if (presence_update(current_time, &last_probe_time)) {
+            last_mlx90614_time = current_time;      // sleep 해제 후 첫 측정값은 250ms 뒤부터 유효
+        }
+        
+        // MAX30102 읽기 (I2C1 사용) - 초기화되고 착용 중인 경우에만
+        if (max30102_initialized && presence == PRESENCE_ON_WRIST &&
+            (current_time - last_max30102_time) >= max30102_interval) {
+            TRACE_BEGIN(TRACE_MARK_PPG_READ);
             esp_err_t ret = read_sensor_with_retry(read_max30102, "MAX30102", 3, false);
+            TRACE_END(TRACE_MARK_PPG_READ);
             if (ret == ESP_OK) {
                 last_max30102_time = current_time;
             } else {
@@ -235,18 +352,22 @@ static void sensor_manager_task(void *pvParameters) {
             }
         }
         
-        // MLX90614 읽기 (I2C1 사용) - 초기화된 경우에만
-        if (mlx90614_initialized && (current_time - last_mlx90614_time) >= mlx90614_interval) {
+        // MLX90614 읽기 (I2C1 사용) - 초기화되고 착용 중인 경우에만 (미착용 중에는 sleep)
+        if (mlx90614_initialized && presence == PRESENCE_ON_WRIST &&
+            (current_time - last_mlx90614_time) >= mlx90614_interval) {
+            TRACE_BEGIN(TRACE_MARK_TEMP_READ);
             esp_err_t ret = read_sensor_with_retry(read_mlx90614, "MLX90614", 3, false);
-            if (ret == ESP_OK) {
-                last_mlx90614_time = current_time;
+            TRACE_END(TRACE_MARK_TEMP_READ);
+            if (ret == ESP_OK || is_frame_error(ret)) {
+                last_mlx90614_time = current_time;      // 버린 프레임은 다음 1Hz 주기 값으로 대신
             } else {
                 ESP_LOGE(TAG, "MLX90614 읽기 실패");
             }
         }
         
-        // 태스크 지연 (1ms)
-        vTaskDelay(pdMS_TO_TICKS(1));
+        // 다음 틱까지 블록 - pdMS_TO_TICKS(1)은 100Hz 틱에서 0이 되어 양보만 하므로
+        // 같은 코어의 낮은 우선순위 DSP/집계 태스크가 실행되지 못한다
+        vTaskDelay(1);
     }
     
     ESP_LOGI(TAG, "센서 매니저 태스크 종료");
@@ -280,17 +401,30 @@ esp_err_t sensor_manager_start(void) {
         }
     }
     
-    // 센서 초기화 전에 충분한 대기 시간
-    vTaskDelay(pdMS_TO_TICKS(200));
-    
-    // 심박수 계산기 초기화
+    // 전원 안정화 대기는 i2c_master_init()에서, 각 센서 리셋 대기는 드라이버 init에서 수행하므로
+    // 여기서는 추가 지연 없이 바로 초기화한다 (app_init "sensors" 단계는 I2C 완료 후 실행)
+    // 심박수 계산기 초기화 (이후에는 ppg_dsp 태스크만 사용)
     heart_rate_calculator_init();
+
+    // DSP/집계 단계를 획득 태스크보다 먼저 시작
+    esp_err_t ret = sensor_pipeline_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "센서 파이프라인 시작 실패: %s", esp_err_to_name(ret));
+        return ret;
+    }
     
+    // 미착용 상태로 멈췄었다면 MLX90614가 sleep 중이고 PPG DSP가 멈춰 있으므로 착용 상태에서 다시 시작
+    if (presence == PRESENCE_OFF_WRIST) {
+        i2c_bus_wake_1(MLX90614_WAKE_SDA_MS);
+        sensor_pipeline_ppg_resume(MAX30102_DEFAULT_LED_CURRENT, MAX30102_DEFAULT_LED_CURRENT);
+        presence = PRESENCE_ON_WRIST;
+    }
+
     // 센서 초기화
     ESP_LOGI(TAG, "센서 초기화 중...");
-    
+
     // MPU6050 초기화 (I2C0) - 실패 시에도 계속 진행
-    esp_err_t ret = mpu6050_init(I2C_MASTER_NUM_0);
+    ret = mpu6050_init(I2C_MASTER_NUM_0);
     if (ret != ESP_OK) {
         ESP_LOGW(TAG, "MPU6050 초기화 실패, 계속 진행: %s", esp_err_to_name(ret));
         mpu6050_initialized = false;
@@ -298,7 +432,6 @@ esp_err_t sensor_manager_start(void) {
         ESP_LOGI(TAG, "MPU6050 초기화 성공");
         mpu6050_initialized = true;
     }
-    vTaskDelay(pdMS_TO_TICKS(100));
     
     // MAX30102 초기화 (I2C1) - 실패 시에도 계속 진행
     ret = max30102_init(I2C_MASTER_NUM_1);
@@ -309,7 +442,6 @@ esp_err_t sensor_manager_start(void) {
         ESP_LOGI(TAG, "MAX30102 초기화 성공");
         max30102_initialized = true;
     }
-    vTaskDelay(pdMS_TO_TICKS(100));
     
     // MLX90614 초기화 시도 (I2C1) - 실패 시에도 계속 진행
     ret = mlx90614_init(I2C_MASTER_NUM_1);
@@ -320,7 +452,6 @@ esp_err_t sensor_manager_start(void) {
         ESP_LOGI(TAG, "MLX90614 초기화 성공");
         mlx90614_initialized = true;
     }
-    vTaskDelay(pdMS_TO_TICKS(100));
     
     // 최소한 하나의 센서라도 초기화되었는지 확인
     if (!mpu6050_initialized && !max30102_initialized && !mlx90614_initialized) {
@@ -329,16 +460,9 @@ esp_err_t sensor_manager_start(void) {
     
     task_running = true;
     
-    // 태스크 생성 (스택 크기 증가)
-    BaseType_t task_ret = xTaskCreatePinnedToCore(
-        sensor_manager_task,
-        "sensor_manager_task",
-        8192,  // 스택 크기 증가
-        NULL,
-        configMAX_PRIORITIES - 2,  // 우선순위를 한 단계 낮춤
-        &sensor_manager_task_handle,
-        1  // Core 1에서 실행
-    );
+    // 태스크 생성 (코어/우선순위/스택은 task_placement 테이블)
+    BaseType_t task_ret = task_placement_create(TASK_ID_SENSOR_MANAGER, sensor_manager_task, NULL,
+                                                &sensor_manager_task_handle);
     
     if (task_ret != pdPASS) {
         ESP_LOGE(TAG, "센서 매니저 태스크 생성 실패");
@@ -364,6 +488,7 @@ void sensor_manager_stop(void) {
     task_running = false;
     
     if (sensor_manager_task_handle != NULL) {
+        task_placement_forget(TASK_ID_SENSOR_MANAGER);
         vTaskDelete(sensor_manager_task_handle);
         sensor_manager_task_handle = NULL;
     }
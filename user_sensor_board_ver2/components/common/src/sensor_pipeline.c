@@ -0,0 +1,560 @@
+// sensor_pipeline.c
+
+#include "sensor_pipeline.h"
+#include "spsc_ring.h"
+#include "sensor_data.h"
+#include "task_placement.h"
+#include "metrics.h"
+#include "trace_capture.h"
+#include "mpu6050_step_fall.h"
+#include "heart_rate_calculator.h"
+#include "max30102_driver.h"
+#include "vital_rules.h"
+#include "core_temp.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include <stdatomic.h>
+
+static const char *TAG = "SENSOR_PIPE";
+
+#define IMU_RING_LEN        32      // 100Hz → 320ms
+#define PPG_RING_LEN        32      // 50Hz → 640ms
+#define RESULT_RING_LEN     16
+#define REF_RING_LEN        32      // 100Hz, PPG 샘플마다 비워짐
+#define FALL_HOLD_MS        3000    // 낙상 플래그 유지 시간
+#define IMU_SAMPLE_HZ       100     // sensor_manager의 MPU6050 읽기 주기
+#define PPG_SAMPLE_MS       20      // sensor_manager의 MAX30102 읽기 주기
+#define STATE_REFRESH_US    1000000 // 움직임 오염 상태를 바뀌지 않아도 다시 보내는 주기 (TTL 갱신용)
+
+typedef struct {
+    int64_t t_us;
+    mpu6050_data_t data;
+} imu_sample_t;
+
+typedef struct {
+    int64_t t_us;
+    uint32_t red;
+    uint32_t ir;
+    uint8_t led_ir;             // 이 샘플을 획득할 때의 LED 전류 (0.2mA 단위)
+    uint8_t led_red;
+    bool resume;                // 미착용으로 멈췄다가 다시 시작한 첫 샘플
+} ppg_sample_t;
+
+typedef struct {
+    int64_t t_us;
+    float acc_g[3];
+} motion_ref_t;
+
+typedef enum {
+    RESULT_STEPS = 0,
+    RESULT_FALL,
+    RESULT_HEART_RATE,
+    RESULT_SPO2,
+    RESULT_TEMPERATURE,
+    RESULT_MOTION_ARTIFACT,
+    RESULT_ACTIVITY,
+    RESULT_RESP_RATE,
+} result_kind_t;
+
+typedef struct {
+    int64_t t_us;
+    uint8_t kind;
+    union {
+        float f;
+        int32_t i;
+        struct {
+            float value;
+            float quality;
+        } fq;           // 품질 지표가 붙는 값 (호흡수)
+        struct {
+            float object;
+            float ambient;
+        } temp;         // MLX90614 물체/주변 온도
+    };
+} pipe_result_t;
+
+SPSC_RING_DEFINE(s_imu_ring, imu_sample_t, IMU_RING_LEN);
+SPSC_RING_DEFINE(s_ppg_ring, ppg_sample_t, PPG_RING_LEN);
+SPSC_RING_DEFINE(s_imu_result_ring, pipe_result_t, RESULT_RING_LEN);
+SPSC_RING_DEFINE(s_ppg_result_ring, pipe_result_t, RESULT_RING_LEN);
+SPSC_RING_DEFINE(s_acq_result_ring, pipe_result_t, RESULT_RING_LEN);
+SPSC_RING_DEFINE(s_ref_ring, motion_ref_t, REF_RING_LEN);
+
+static spsc_ring_t *const s_rings[PIPE_RING_COUNT] = {
+    [PIPE_RING_IMU]        = &s_imu_ring,
+    [PIPE_RING_PPG]        = &s_ppg_ring,
+    [PIPE_RING_IMU_RESULT] = &s_imu_result_ring,
+    [PIPE_RING_PPG_RESULT] = &s_ppg_result_ring,
+    [PIPE_RING_ACQ_RESULT] = &s_acq_result_ring,
+    [PIPE_RING_MOTION_REF] = &s_ref_ring,
+};
+
+static const char *const s_ring_names[PIPE_RING_COUNT] = {
+    [PIPE_RING_IMU]        = "imu",
+    [PIPE_RING_PPG]        = "ppg",
+    [PIPE_RING_IMU_RESULT] = "imu_result",
+    [PIPE_RING_PPG_RESULT] = "ppg_result",
+    [PIPE_RING_ACQ_RESULT] = "acq_result",
+    [PIPE_RING_MOTION_REF] = "motion_ref",
+};
+
+static TaskHandle_t s_imu_dsp_task = NULL;
+static TaskHandle_t s_ppg_dsp_task = NULL;
+static TaskHandle_t s_aggregator_task = NULL;
+
+// PPG가 들어오는 동안만 기준 가속도를 쌓는다 (획득 태스크만 기록, 미착용 일시 정지 중에는 false)
+static bool s_ppg_active = false;
+static bool s_ppg_resume = false;
+
+// 피부 접촉이 연속으로 없었던 PPG 샘플 수 (ppg_dsp만 기록, 재개 시 획득 태스크가 0으로)
+static volatile uint32_t s_no_contact_samples = 0;
+
+// LED 전류: ppg_dsp의 AGC 요청(0이면 없음)을 획득 태스크가 I2C1 뮤텍스 아래에서 꺼내 반영한다
+#define LED_REQUEST_VALID   (1u << 16)
+static atomic_uint s_led_request;
+static uint8_t s_led_ir = MAX30102_DEFAULT_LED_CURRENT;     // 반영된 전류 (획득 태스크만 기록)
+static uint8_t s_led_red = MAX30102_DEFAULT_LED_CURRENT;
+static uint32_t s_led_changes = 0;
+
+// 단계별 샘플 1개 최대 처리 시간 (µs, 각 소비자 태스크만 기록)
+static uint32_t s_imu_dsp_max_us = 0;
+static uint32_t s_ppg_dsp_max_us = 0;
+
+// 활동 분류 창 비용 (hop 동안의 샘플 누적 + 분류, CPU 사이클)
+static volatile activity_class_t s_activity = ACTIVITY_UNKNOWN;
+static uint32_t s_activity_windows = 0;
+static uint32_t s_activity_last_cycles = 0;
+static uint32_t s_activity_max_cycles = 0;
+static uint64_t s_activity_sum_cycles = 0;
+
+// 심부 체온 추정 (집계 태스크만 사용)
+static core_temp_ctx_t s_core_temp;
+
+// 링에 넣고, 가득 차서 버렸으면 진단 카운터에도 반영
+static bool ring_push(spsc_ring_t *ring, const void *item) {
+    if (spsc_ring_push(ring, item)) {
+        return true;
+    }
+    metrics_inc(METRIC_PIPELINE_DROPS);
+    return false;
+}
+
+static void notify(TaskHandle_t task) {
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+static void push_result(spsc_ring_t *ring, result_kind_t kind, int64_t t_us, pipe_result_t value) {
+    value.kind = (uint8_t)kind;
+    value.t_us = t_us;
+    if (ring_push(ring, &value)) {
+        notify(s_aggregator_task);
+    }
+}
+
+static void track_max(uint32_t *max_us, int64_t start_us) {
+    uint32_t dt = (uint32_t)(esp_timer_get_time() - start_us);
+    if (dt > *max_us) {
+        *max_us = dt;
+    }
+}
+
+// ---- DSP: 걸음 / 낙상 ----
+
+// 판정이 끝난 낙상 후보의 ±2초 원시 창을 전송 태스크로 넘김 (이전 창을 아직 보내는 중이면 버림)
+static void post_fall_window(const step_fall_ctx_t *ctx, const fall_result_t *fall, int64_t t_us) {
+    fall_window_t *w = sensor_data_acquire_fall_window();
+    if (w == NULL) {
+        metrics_inc(METRIC_PIPELINE_DROPS);
+        ESP_LOGW(TAG, "낙상 창 버림 (이전 창 전송 중, %s)", fall->reason);
+        return;
+    }
+    int impact_index = 0;
+    w->count = (uint16_t)step_fall_copy_window(ctx, fall, w->raw, FALL_WINDOW_MAX_SAMPLES, &impact_index);
+    w->impact_index = (uint16_t)impact_index;
+    w->impact_time_us = t_us - (int64_t)fall->impact_age_samples * 1000000 / IMU_SAMPLE_HZ;
+    w->confirmed = fall->fall_detected;
+    w->reason = fall->reason;
+    w->sample_hz = IMU_SAMPLE_HZ;
+    w->free_fall_ms = fall->free_fall_ms;
+    w->impact_g = fall->impact_g;
+    w->tilt_deg = fall->tilt_deg;
+    w->post_gyro_rms_dps = fall->post_gyro_rms_dps;
+    w->acc_lsb_per_g = MPU6050_ACC_LSB_PER_G;
+    w->gyro_lsb_per_dps = MPU6050_GYRO_LSB_PER_DPS;
+    sensor_data_commit_fall_window();
+}
+
+static void record_activity_window(uint32_t cycles) {
+    s_activity_windows++;
+    s_activity_last_cycles = cycles;
+    s_activity_sum_cycles += cycles;
+    if (cycles > s_activity_max_cycles) {
+        s_activity_max_cycles = cycles;
+    }
+}
+
+static void imu_dsp_task(void *param) {
+    static step_fall_ctx_t ctx;
+    static activity_ctx_t activity;
+    static const char *const direction_names[] = {
+        "없음", "앞", "뒤", "좌", "우", "앞-좌", "앞-우", "뒤-좌", "뒤-우"
+    };
+    int32_t step_count = 0;
+    bool fall_active = false;
+    uint32_t fall_reset_ms = 0;
+    uint32_t hop_cycles = 0;
+    imu_sample_t s;
+
+    step_fall_init(&ctx, IMU_SAMPLE_HZ);
+    activity_init(&activity, IMU_SAMPLE_HZ);
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (spsc_ring_pop(&s_imu_ring, &s)) {
+            int64_t start_us = esp_timer_get_time();
+            TRACE_BEGIN(TRACE_MARK_IMU_DSP);
+            uint32_t t_ms = (uint32_t)(s.t_us / 1000);
+            const mpu6050_data_t *d = &s.data;
+
+            step_fall_update(&ctx, d->ax, d->ay, d->az, d->gx, d->gy, d->gz);
+
+            uint32_t c0 = esp_cpu_get_cycle_count();
+            bool window_done = activity_update(&activity, ctx.acc_g, ctx.gyro_dps);
+            hop_cycles += esp_cpu_get_cycle_count() - c0;
+            if (window_done) {
+                record_activity_window(hop_cycles);
+                hop_cycles = 0;
+                if (activity.activity != s_activity) {
+                    ESP_LOGI(TAG, "활동: %s → %s (std %umg, %u/2Hz, 교차 %u, 자이로 %udps)",
+                             activity_name(s_activity), activity_name(activity.activity),
+                             activity.features[ACTIVITY_FEAT_MAG_STD_MG], activity.features[ACTIVITY_FEAT_DOM_FREQ],
+                             activity.features[ACTIVITY_FEAT_ZERO_CROSS], activity.features[ACTIVITY_FEAT_GYRO_RMS_DPS]);
+                }
+                s_activity = activity.activity;
+                push_result(&s_imu_result_ring, RESULT_ACTIVITY, s.t_us, (pipe_result_t){ .i = activity.activity });
+            }
+
+            // 수면 중에는 걸음 검출을 건너뜀 (걷기/달리기 창이 나오면 수면에서 바로 빠짐)
+            // 걷지 않는 동안에도 누적값이 만료되지 않도록 활동 창마다 한 번 다시 보낸다
+            bool new_step = s_activity != ACTIVITY_SLEEP && step_fall_detect_step(&ctx, t_ms);
+            if (new_step) {
+                step_count++;
+            }
+            if (new_step || window_done) {
+                push_result(&s_imu_result_ring, RESULT_STEPS, s.t_us, (pipe_result_t){ .i = step_count });
+            }
+
+            // 판정은 충격 2초 뒤에 나오므로 경보 시각은 충격 샘플 시각으로 되돌림
+            fall_result_t fall = step_fall_detect_fall(&ctx, t_ms);
+            if (fall.window_ready) {
+                post_fall_window(&ctx, &fall, s.t_us);
+            }
+            if (fall.fall_detected && !fall_active) {
+                int64_t impact_us = s.t_us - (int64_t)fall.impact_age_samples * 1000000 / IMU_SAMPLE_HZ;
+                ESP_LOGW(TAG, "낙상 감지: 충격 %.2fg, Roll=%.1f° Pitch=%.1f°, 방향 %s (%.1f°)",
+                         fall.impact_g, fall.roll_deg, fall.pitch_deg,
+                         direction_names[fall.direction], fall.fall_angle_deg);
+                push_result(&s_imu_result_ring, RESULT_FALL, impact_us, (pipe_result_t){ .i = 1 });
+                fall_active = true;
+                fall_reset_ms = t_ms + FALL_HOLD_MS;
+            }
+            if (fall_active && (int32_t)(t_ms - fall_reset_ms) >= 0) {
+                push_result(&s_imu_result_ring, RESULT_FALL, s.t_us, (pipe_result_t){ .i = 0 });
+                fall_active = false;
+            }
+
+            TRACE_END(TRACE_MARK_IMU_DSP);
+            track_max(&s_imu_dsp_max_us, start_us);
+        }
+    }
+}
+
+// ---- DSP: 심박 / SpO2 ----
+
+// 직전 PPG 이후 ~ t_us까지 획득된 가속도 평균 (없으면 false, acc_g는 그대로)
+static bool align_motion_reference(int64_t t_us, float acc_g[3]) {
+    motion_ref_t ref;
+    float sum[3] = {0};
+    int n = 0;
+
+    while (spsc_ring_peek(&s_ref_ring, &ref) && ref.t_us <= t_us) {
+        spsc_ring_pop(&s_ref_ring, &ref);
+        sum[0] += ref.acc_g[0];
+        sum[1] += ref.acc_g[1];
+        sum[2] += ref.acc_g[2];
+        n++;
+    }
+    if (n == 0) {
+        return false;
+    }
+    for (int a = 0; a < 3; a++) {
+        acc_g[a] = sum[a] / n;
+    }
+    return true;
+}
+
+static void ppg_dsp_task(void *param) {
+    int64_t last_beat_us = 0;
+    int64_t last_spo2_us = 0;
+    int64_t last_resp_us = 0;
+    float last_hr = 0.0f;
+    int last_spo2 = 0;
+    int last_motion = -1;
+    int64_t last_motion_us = 0;
+    uint8_t led_ir = MAX30102_DEFAULT_LED_CURRENT;
+    uint8_t led_red = MAX30102_DEFAULT_LED_CURRENT;
+    float acc_g[3] = {0};
+    bool have_ref = false;
+    ppg_sample_t s;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (spsc_ring_pop(&s_ppg_ring, &s)) {
+            int64_t start_us = esp_timer_get_time();
+            TRACE_BEGIN(TRACE_MARK_PPG_DSP);
+
+            // IMU가 없거나 아직 기준이 안 왔으면 직전 기준을 유지 (한 번도 없으면 잡음 제거 생략)
+            have_ref |= align_motion_reference(s.t_us, acc_g);
+            if (have_ref) {
+                hr_set_motion_reference(acc_g[0], acc_g[1], acc_g[2]);
+            }
+
+            // 일시 정지 후 첫 샘플: 이전 착용 구간의 필터/버퍼/박동 상태를 버리고 새로 시작
+            if (s.resume) {
+                motion_ref_t stale;
+                while (spsc_ring_pop(&s_ref_ring, &stale)) {
+                }
+                heart_rate_calculator_reset();
+                led_ir = s.led_ir;
+                led_red = s.led_red;
+                last_motion = -1;
+                have_ref = false;
+            } else if (s.led_ir != led_ir || s.led_red != led_red) {
+                // 새 LED 전류로 획득된 첫 샘플: DC 추정을 옮기고 블랭킹 시작
+                led_ir = s.led_ir;
+                led_red = s.led_red;
+                hr_led_current_applied(led_ir, led_red);
+            }
+
+            heart_rate_data_t hr = calculate_heart_rate_and_spo2(s.red, s.ir, s.t_us);
+            s_no_contact_samples = hr_get_signal_quality().contact_detected ? 0 : s_no_contact_samples + 1;
+
+            uint8_t req_ir, req_red;
+            if (hr_auto_adjust_led_current(&req_ir, &req_red)) {
+                atomic_store_explicit(&s_led_request, LED_REQUEST_VALID | ((unsigned)req_ir << 8) | req_red,
+                                      memory_order_release);
+            }
+            if (hr.motion_corrupted != last_motion || s.t_us - last_motion_us >= STATE_REFRESH_US) {
+                last_motion = hr.motion_corrupted;
+                last_motion_us = s.t_us;
+                push_result(&s_ppg_result_ring, RESULT_MOTION_ARTIFACT, s.t_us, (pipe_result_t){ .i = last_motion });
+            }
+            // 움직임 오염 중에는 심박/SpO2를 내보내지 않는다 (TTL이 지나면 발행에서 빠짐)
+            if (hr.valid_data && !hr.motion_corrupted) {
+                // 새 박동/새 SpO2 계산이 있을 때만 집계 단계로 전달
+                if (hr.beat_time_us != last_beat_us || hr.heart_rate != last_hr) {
+                    last_beat_us = hr.beat_time_us;
+                    last_hr = hr.heart_rate;
+                    push_result(&s_ppg_result_ring, RESULT_HEART_RATE, hr.beat_time_us, (pipe_result_t){ .f = hr.heart_rate });
+                }
+                // SpO2가 아직 없으면(0) 심박만 나간다 - 발행 쪽은 TTL로 지난 값을 뺀다
+                if (hr.spo2 > 0 && (hr.spo2_time_us != last_spo2_us || hr.spo2 != last_spo2)) {
+                    last_spo2_us = hr.spo2_time_us;
+                    last_spo2 = hr.spo2;
+                    push_result(&s_ppg_result_ring, RESULT_SPO2, hr.spo2_time_us, (pipe_result_t){ .i = hr.spo2 });
+                }
+            }
+            // 호흡수는 30초 창 추정이라 움직임 구간을 스스로 건너뛰므로 오염 여부와 관계없이 새 추정만 전달
+            if (hr.resp_rate > 0.0f && hr.resp_time_us != last_resp_us) {
+                last_resp_us = hr.resp_time_us;
+                push_result(&s_ppg_result_ring, RESULT_RESP_RATE, hr.resp_time_us,
+                            (pipe_result_t){ .fq = { hr.resp_rate, hr.resp_quality } });
+            }
+
+            TRACE_END(TRACE_MARK_PPG_DSP);
+            track_max(&s_ppg_dsp_max_us, start_us);
+        }
+    }
+}
+
+// ---- 집계: DSP 결과 → sensor_data ----
+
+static void apply_result(const pipe_result_t *r) {
+    bool at_rest = (s_activity == ACTIVITY_STILL || s_activity == ACTIVITY_SLEEP);
+    switch ((result_kind_t)r->kind) {
+        case RESULT_STEPS:       sensor_data_set_steps(r->i, r->t_us); break;
+        case RESULT_FALL:        sensor_data_set_fall_detected(r->i, r->t_us); break;
+        case RESULT_HEART_RATE:
+            sensor_data_set_heart_rate(r->f, r->t_us);
+            vital_rules_update(VITAL_METRIC_HEART_RATE, r->f, r->t_us, at_rest);
+            break;
+        case RESULT_SPO2:
+            sensor_data_set_spo2(r->i, r->t_us);
+            vital_rules_update(VITAL_METRIC_SPO2, (float)r->i, r->t_us, at_rest);
+            break;
+        case RESULT_TEMPERATURE: {
+            core_temp_result_t t;
+            if (core_temp_update(&s_core_temp, r->temp.object, r->temp.ambient, r->t_us, &t)) {
+                sensor_data_set_temperature(t.core_c, t.skin_c, r->t_us);
+                vital_rules_update(VITAL_METRIC_TEMPERATURE, t.core_c, r->t_us, at_rest);
+            }
+            break;
+        }
+        case RESULT_MOTION_ARTIFACT: sensor_data_set_motion_artifact(r->i, r->t_us); break;
+        case RESULT_ACTIVITY:    sensor_data_set_activity(activity_name((activity_class_t)r->i), r->t_us); break;
+        case RESULT_RESP_RATE:
+            sensor_data_set_resp_rate(r->fq.value, r->fq.quality, r->t_us);
+            vital_rules_update(VITAL_METRIC_RESP_RATE, r->fq.value, r->t_us, at_rest);
+            break;
+    }
+}
+
+static void aggregator_task(void *param) {
+    pipe_result_t r;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        TRACE_BEGIN(TRACE_MARK_AGGREGATE);
+        // 낙상 경보가 먼저 반영되도록 IMU 결과부터 비운다
+        while (spsc_ring_pop(&s_imu_result_ring, &r)) {
+            apply_result(&r);
+        }
+        while (spsc_ring_pop(&s_ppg_result_ring, &r)) {
+            apply_result(&r);
+        }
+        while (spsc_ring_pop(&s_acq_result_ring, &r)) {
+            apply_result(&r);
+        }
+        TRACE_END(TRACE_MARK_AGGREGATE);
+    }
+}
+
+// ---- 공개 API ----
+
+esp_err_t sensor_pipeline_start(void) {
+    if (s_aggregator_task != NULL) {
+        return ESP_OK;
+    }
+    vital_rules_init();
+    core_temp_init(&s_core_temp);
+    // 소비자부터 생성 (생산자가 알림을 보낼 대상이 먼저 있어야 함)
+    if (task_placement_create(TASK_ID_AGGREGATOR, aggregator_task, NULL, &s_aggregator_task) != pdPASS ||
+        task_placement_create(TASK_ID_IMU_DSP, imu_dsp_task, NULL, &s_imu_dsp_task) != pdPASS ||
+        task_placement_create(TASK_ID_PPG_DSP, ppg_dsp_task, NULL, &s_ppg_dsp_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "파이프라인 시작 (imu %d, ppg %d, 결과 %d칸)", IMU_RING_LEN, PPG_RING_LEN, RESULT_RING_LEN);
+    return ESP_OK;
+}
+
+void sensor_pipeline_push_imu(const mpu6050_data_t *data, int64_t t_us) {
+    imu_sample_t s = { .t_us = t_us, .data = *data };
+    if (ring_push(&s_imu_ring, &s)) {
+        notify(s_imu_dsp_task);
+    }
+    if (s_ppg_active) {
+        // ppg_dsp가 다음 PPG 샘플 때 꺼내 가므로 알림은 보내지 않는다
+        motion_ref_t ref = {
+            .t_us = t_us,
+            .acc_g = { data->ax / MPU6050_ACC_LSB_PER_G, data->ay / MPU6050_ACC_LSB_PER_G,
+                       data->az / MPU6050_ACC_LSB_PER_G },
+        };
+        ring_push(&s_ref_ring, &ref);
+    }
+}
+
+void sensor_pipeline_push_ppg(uint32_t red, uint32_t ir, int64_t t_us) {
+    ppg_sample_t s = {
+        .t_us = t_us, .red = red, .ir = ir, .led_ir = s_led_ir, .led_red = s_led_red, .resume = s_ppg_resume,
+    };
+    s_ppg_active = true;
+    s_ppg_resume = false;
+    if (ring_push(&s_ppg_ring, &s)) {
+        notify(s_ppg_dsp_task);
+    }
+}
+
+bool sensor_pipeline_take_led_request(uint8_t *ir_current, uint8_t *red_current) {
+    unsigned req = atomic_exchange_explicit(&s_led_request, 0, memory_order_acquire);
+    if (!(req & LED_REQUEST_VALID)) {
+        return false;
+    }
+    *ir_current = (uint8_t)(req >> 8);
+    *red_current = (uint8_t)req;
+    return true;
+}
+
+void sensor_pipeline_led_current_applied(uint8_t ir_current, uint8_t red_current) {
+    s_led_ir = ir_current;
+    s_led_red = red_current;
+    s_led_changes++;
+}
+
+void sensor_pipeline_ppg_pause(void) {
+    s_ppg_active = false;
+}
+
+void sensor_pipeline_ppg_resume(uint8_t led_ir, uint8_t led_red) {
+    s_led_ir = led_ir;
+    s_led_red = led_red;
+    s_ppg_resume = true;
+    // 일시 정지 전 값이 남아 있으면 재개하자마자 다시 미착용으로 판정되고, 남은 AGC 요청은 초기화될
+    // 계산기와 맞지 않으므로 비운다. ppg_dsp는 일시 정지 직후 링을 이미 다 비웠으므로 겹쳐 기록하지 않는다.
+    s_no_contact_samples = 0;
+    atomic_store_explicit(&s_led_request, 0, memory_order_relaxed);
+}
+
+uint32_t sensor_pipeline_no_contact_ms(void) {
+    return s_no_contact_samples * PPG_SAMPLE_MS;
+}
+
+void sensor_pipeline_push_temperature(float object_c, float ambient_c, int64_t t_us) {
+    push_result(&s_acq_result_ring, RESULT_TEMPERATURE, t_us, (pipe_result_t){ .temp = { object_c, ambient_c } });
+}
+
+pipe_ring_stats_t sensor_pipeline_get_stats(pipe_ring_t ring) {
+    const spsc_ring_t *r = s_rings[ring];
+    return (pipe_ring_stats_t){
+        .pushed = r->pushed,
+        .dropped = r->dropped,
+        .high_water = r->high_water,
+        .capacity = spsc_ring_capacity(r),
+    };
+}
+
+void sensor_pipeline_log_stats(void) {
+    for (int i = 0; i < PIPE_RING_COUNT; i++) {
+        pipe_ring_stats_t st = sensor_pipeline_get_stats((pipe_ring_t)i);
+        if (st.dropped > 0) {
+            ESP_LOGW(TAG, "  %-10s pushed %lu dropped %lu max %lu/%lu", s_ring_names[i],
+                     (unsigned long)st.pushed, (unsigned long)st.dropped,
+                     (unsigned long)st.high_water, (unsigned long)st.capacity);
+        } else {
+            ESP_LOGI(TAG, "  %-10s pushed %lu max %lu/%lu", s_ring_names[i],
+                     (unsigned long)st.pushed, (unsigned long)st.high_water, (unsigned long)st.capacity);
+        }
+    }
+    ESP_LOGI(TAG, "  DSP 최대 처리 시간: imu %luus, ppg %luus",
+             (unsigned long)s_imu_dsp_max_us, (unsigned long)s_ppg_dsp_max_us);
+    ESP_LOGI(TAG, "  LED 전류: IR %.1fmA, RED %.1fmA (AGC 변경 %lu회)",
+             s_led_ir * 0.2f, s_led_red * 0.2f, (unsigned long)s_led_changes);
+    if (s_activity_windows > 0) {
+        ESP_LOGI(TAG, "  활동 분류 창 %lu개: 창당 마지막 %lu / 평균 %lu / 최대 %lu 사이클 (%s)",
+                 (unsigned long)s_activity_windows, (unsigned long)s_activity_last_cycles,
+                 (unsigned long)(s_activity_sum_cycles / s_activity_windows),
+                 (unsigned long)s_activity_max_cycles, activity_name(s_activity));
+    }
+}
+
+activity_class_t sensor_pipeline_current_activity(void) {
+    return s_activity;
+}
@@ -1,110 +1,238 @@
 #include "sntp_helper.h"
 #include "esp_log.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_timer.h"
+#include "nvs.h"
 #include <string.h>
 #include <time.h>
+#include <sys/time.h>
 
-// lwip의 SNTP 사용
-#include "lwip/apps/sntp.h"
+#include "esp_sntp.h"
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
 #include "time_helper.h"
+#include "app_init.h"
+#include "clock_service.h"
+#include "task_placement.h"
 
 static const char *TAG = "SNTP_HELPER";
 
-// SNTP 동기화 완료 플래그
-static bool sntp_synced = false;
+// 후보 NTP 서버 (RTT 측정 후 빠른 순서로 lwIP SNTP에 등록)
+static const char *const s_ntp_servers[] = {
+    "kr.pool.ntp.org",
+    "time.google.com",
+    "pool.ntp.org",
+    "time.windows.com",
+    "time.nist.gov",
+};
+#define NTP_SERVER_COUNT   ((int)(sizeof(s_ntp_servers) / sizeof(s_ntp_servers[0])))
+#define NTP_PROBE_TIMEOUT_MS 1500
+#define NTP_VALID_EPOCH      1577836800     // 2020-01-01 00:00:00 UTC
 
-// ESP 시작 시간 (마이크로초)
-static int64_t esp_start_time_us = 0;
+#define SNTP_NVS_NAMESPACE "sntp"
+#define SNTP_NVS_KEY_LAST  "last_s"
+#define SNTP_RTC_MAGIC     0x534E5450       // "SNTP"
 
-// SNTP 초기화 상태
+// 소프트 리셋/패닉/딥슬립에도 유지되는 마지막 동기화 기록
+// (시스템 시간 자체는 CONFIG_LIBC_TIME_SYSCALL_USE_RTC_HRT로 RTC에서 계속 흐른다)
+typedef struct {
+    uint32_t magic;
+    int64_t last_sync_s;
+} sntp_rtc_record_t;
+
+static RTC_NOINIT_ATTR sntp_rtc_record_t s_rtc_record;
+
+static volatile sntp_time_state_t s_time_state = SNTP_TIME_NONE;
 static bool sntp_initialized = false;
+static TaskHandle_t s_sntp_task = NULL;
+
+// ---- 서버 RTT 측정 ----
+
+typedef struct {
+    const char *hostname;
+    int sock;
+    int64_t sent_us;
+    int rtt_ms;             // -1: 응답 없음
+} ntp_probe_t;
+
+// 모든 서버에 NTP 요청을 동시에 보내고 응답 순서대로 RTT 기록
+// (dns_checker의 test_udp_port_123()과 같은 요청 패킷, 서버별 5초 순차 대기 대신 select 한 번)
+static void probe_servers(ntp_probe_t probes[NTP_SERVER_COUNT]) {
+    uint8_t ntp_request[48] = {0};
+    ntp_request[0] = 0x1B;  // LI=0, Version=3, Mode=3 (Client)
+
+    for (int i = 0; i < NTP_SERVER_COUNT; i++) {
+        probes[i].hostname = s_ntp_servers[i];
+        probes[i].sock = -1;
+        probes[i].rtt_ms = -1;
+
+        struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_DGRAM };
+        struct addrinfo *res = NULL;
+        if (getaddrinfo(s_ntp_servers[i], "123", &hints, &res) != 0 || res == NULL) {
+            ESP_LOGW(TAG, "DNS 해석 실패: %s", s_ntp_servers[i]);
+            continue;
+        }
+
+        int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+        if (sock >= 0) {
+            probes[i].sent_us = esp_timer_get_time();
+            if (sendto(sock, ntp_request, sizeof(ntp_request), 0, res->ai_addr, res->ai_addrlen) == sizeof(ntp_request)) {
+                probes[i].sock = sock;
+            } else {
+                close(sock);
+            }
+        }
+        freeaddrinfo(res);
+    }
+
+    int64_t deadline_us = esp_timer_get_time() + NTP_PROBE_TIMEOUT_MS * 1000LL;
+    while (1) {
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        int maxfd = -1;
+        for (int i = 0; i < NTP_SERVER_COUNT; i++) {
+            if (probes[i].sock >= 0) {
+                FD_SET(probes[i].sock, &rfds);
+                if (probes[i].sock > maxfd) {
+                    maxfd = probes[i].sock;
+                }
+            }
+        }
+        int64_t remain_us = deadline_us - esp_timer_get_time();
+        if (maxfd < 0 || remain_us <= 0) {
+            break;
+        }
+
+        struct timeval tv = { .tv_sec = remain_us / 1000000, .tv_usec = remain_us % 1000000 };
+        if (select(maxfd + 1, &rfds, NULL, NULL, &tv) <= 0) {
+            break;
+        }
+
+        int64_t now_us = esp_timer_get_time();
+        for (int i = 0; i < NTP_SERVER_COUNT; i++) {
+            if (probes[i].sock >= 0 && FD_ISSET(probes[i].sock, &rfds)) {
+                uint8_t ntp_response[48];
+                if (recv(probes[i].sock, ntp_response, sizeof(ntp_response), 0) >= 48) {
+                    probes[i].rtt_ms = (int)((now_us - probes[i].sent_us) / 1000);
+                }
+                close(probes[i].sock);
+                probes[i].sock = -1;
+            }
+        }
+    }
 
-// SNTP 동기화 상태 확인 함수
-static bool check_sntp_sync_status(void) {
+    for (int i = 0; i < NTP_SERVER_COUNT; i++) {
+        if (probes[i].sock >= 0) {
+            close(probes[i].sock);
+            probes[i].sock = -1;
+        }
+    }
+}
+
+// 응답한 서버를 RTT 오름차순으로, 응답 없는 서버는 원래 순서대로 뒤에 배치
+static void sort_probes(ntp_probe_t probes[NTP_SERVER_COUNT]) {
+    for (int i = 1; i < NTP_SERVER_COUNT; i++) {
+        ntp_probe_t key = probes[i];
+        int j = i - 1;
+        while (j >= 0 && key.rtt_ms >= 0 && (probes[j].rtt_ms < 0 || probes[j].rtt_ms > key.rtt_ms)) {
+            probes[j + 1] = probes[j];
+            j--;
+        }
+        probes[j + 1] = key;
+    }
+}
+
+// ---- 시간 저장/복원 ----
+
+static void save_last_sync(int64_t now_s) {
+    s_rtc_record.magic = SNTP_RTC_MAGIC;
+    s_rtc_record.last_sync_s = now_s;
+
+    nvs_handle_t nvs;
+    if (nvs_open(SNTP_NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        nvs_set_i64(nvs, SNTP_NVS_KEY_LAST, now_s);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+}
+
+void sntp_restore_time(void) {
     time_t now;
     time(&now);
-    
-    ESP_LOGI(TAG, "현재 시간 확인: %ld (epoch)", now);
-    
-    // 2020년 이후 시간이면 동기화된 것으로 간주
-    if (now > 1577836800) {  // 2020-01-01 00:00:00 UTC
-        return true;
+
+    // 1) 소프트 리셋: RTC 시스템 시간이 유지되고 있으면 그대로 신뢰
+    if (s_rtc_record.magic == SNTP_RTC_MAGIC && now >= s_rtc_record.last_sync_s && now > NTP_VALID_EPOCH) {
+        s_time_state = SNTP_TIME_RTC_RESTORED;
+        ESP_LOGI(TAG, "RTC 시간 유지됨 (마지막 동기화 %llds 전)", (long long)(now - s_rtc_record.last_sync_s));
+        return;
+    }
+    s_rtc_record.magic = 0;
+
+    // 2) 전원 재인가: NVS의 마지막 동기화 시각을 하한값으로 설정 (정확도 보장 없음)
+    nvs_handle_t nvs;
+    int64_t last_s = 0;
+    if (nvs_open(SNTP_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+        nvs_get_i64(nvs, SNTP_NVS_KEY_LAST, &last_s);
+        nvs_close(nvs);
+    }
+    if (last_s > NTP_VALID_EPOCH && now < last_s) {
+        struct timeval tv = { .tv_sec = last_s, .tv_usec = 0 };
+        settimeofday(&tv, NULL);
+        s_time_state = SNTP_TIME_NVS_ESTIMATE;
+        ESP_LOGW(TAG, "NVS에 저장된 마지막 시각으로 시계 설정 (SNTP 동기화 전까지 추정값)");
     }
-    
-    // 시간 구조체로 변환하여 더 자세한 정보 출력
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    ESP_LOGI(TAG, "현재 시간: %04d-%02d-%02d %02d:%02d:%02d", 
-             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-    
-    return false;
 }
 
-esp_err_t sntp_init_and_sync(void) {
-    ESP_LOGI(TAG, "SNTP 초기화 시작");
-    
-    // ESP 시작 시간 기록
-    esp_start_time_us = esp_timer_get_time();
-    
-    // SNTP가 이미 초기화되었는지 확인
-    if (sntp_initialized) {
-        ESP_LOGW(TAG, "SNTP가 이미 초기화됨");
-        return ESP_OK;
+// ---- SNTP ----
+
+// lwIP tcpip 태스크에서 호출되므로 플래그/비트만 세우고 NVS 저장은 sntp 태스크로 넘긴다
+static void time_sync_notification_cb(struct timeval *tv) {
+    clock_service_on_sync(tv);
+    s_time_state = SNTP_TIME_SYNCED;
+    app_init_signal(APP_INIT_TIME_SYNCED);
+    if (s_sntp_task != NULL) {
+        xTaskNotifyGive(s_sntp_task);
     }
-    
-    // 초기 시간 상태 확인
-    ESP_LOGI(TAG, "초기 시간 상태 확인:");
-    check_sntp_sync_status();
-    
-    // SNTP 설정 (lwip 방식)
-    sntp_setoperatingmode(SNTP_OPMODE_POLL);
-    
-    // 더 안정적인 NTP 서버들 사용 (한국 서버 포함)
-    // sntp_setservername(0, "kr.pool.ntp.org");      // 한국 NTP 서버
-    // sntp_setservername(1, "time.google.com");      // Google 시간 서버
-    // sntp_setservername(2, "pool.ntp.org");         // 글로벌 NTP 서버
-    sntp_setservername(0, "time.windows.com");     // Windows 시간 서버
-    
-    ESP_LOGI(TAG, "SNTP 서버 설정 완료");
-    // ESP_LOGI(TAG, "서버 0: kr.pool.ntp.org");
-    // ESP_LOGI(TAG, "서버 1: time.google.com");
-    // ESP_LOGI(TAG, "서버 2: pool.ntp.org");
-    ESP_LOGI(TAG, "서버 0: time.windows.com");
-    
-    // SNTP 시작
-    sntp_init();
-    sntp_initialized = true;
-    
-    ESP_LOGI(TAG, "SNTP 초기화 완료, 시간 동기화 대기 중...");
-    
-    // SNTP 동기화 대기 (최대 90초로 증가)
-    int retry_count = 0;
-    while (!sntp_synced && retry_count < 90) {
-        ESP_LOGI(TAG, "SNTP 동기화 대기 중... (%d/90)", retry_count + 1);
-        
-        // SNTP 동기화 상태 확인
-        if (check_sntp_sync_status()) {
-            sntp_synced = true;
-            ESP_LOGI(TAG, "SNTP 동기화 성공!");
-            break;
-        }
-        
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        retry_count++;
+}
+
+static void sntp_task(void *pvParameters) {
+    ntp_probe_t probes[NTP_SERVER_COUNT];
+    probe_servers(probes);
+    sort_probes(probes);
+
+    esp_sntp_setoperatingmode(ESP_SNTP_OPMODE_POLL);
+    int count = NTP_SERVER_COUNT < CONFIG_LWIP_SNTP_MAX_SERVERS ? NTP_SERVER_COUNT : CONFIG_LWIP_SNTP_MAX_SERVERS;
+    for (int i = 0; i < count; i++) {
+        esp_sntp_setservername(i, probes[i].hostname);
+        ESP_LOGI(TAG, "서버 %d: %s (RTT %dms)", i, probes[i].hostname, probes[i].rtt_ms);
     }
-    
-    if (sntp_synced) {
-        ESP_LOGI(TAG, "SNTP 시간 동기화 성공");
+    sntp_set_time_sync_notification_cb(time_sync_notification_cb);
+    esp_sntp_init();
+    ESP_LOGI(TAG, "SNTP 시작, 동기화는 백그라운드에서 진행");
+
+    // 동기화될 때마다 (기본 1시간 주기) 마지막 시각 저장
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        time_t now;
+        time(&now);
+        save_last_sync(now);
+        ESP_LOGI(TAG, "SNTP 시간 동기화 완료");
         print_current_time();
+    }
+}
+
+esp_err_t sntp_service_start(void) {
+    if (sntp_initialized) {
         return ESP_OK;
-    } else {
-        ESP_LOGW(TAG, "SNTP 시간 동기화 실패");
-        return ESP_ERR_TIMEOUT;
     }
+    if (task_placement_create(TASK_ID_SNTP, sntp_task, NULL, &s_sntp_task) != pdPASS) {
+        ESP_LOGE(TAG, "sntp 태스크 생성 실패");
+        return ESP_ERR_NO_MEM;
+    }
+    sntp_initialized = true;
+    return ESP_OK;
 }
 
 // SNTP 전용 함수들 (HTTP와 구분)
@@ -121,25 +249,11 @@ time_t get_current_world_time(void) {
     return now;
 }
 
-int64_t sntp_get_combined_timestamp(void) {
-    if (sntp_synced) {
-        // SNTP 동기화된 경우: 순수한 유닉스 타임스탬프만 사용
-        time_t world_time = sntp_get_current_world_time();
-        int64_t unix_timestamp_ms = (int64_t)world_time * 1000;
-        
-        ESP_LOGD(TAG, "SNTP synced, using Unix timestamp: %ld -> %lldms", 
-                 world_time, unix_timestamp_ms);
-        
-        return unix_timestamp_ms;
-    } else {
-        // SNTP 동기화되지 않은 경우: ESP 타이머만 사용
-        int64_t esp_time_ms = esp_timer_get_time() / 1000;
-        ESP_LOGW(TAG, "SNTP not synced, using ESP timer only: %lldms", esp_time_ms);
-        return esp_time_ms;
-    }
+sntp_time_state_t sntp_get_time_state(void) {
+    return s_time_state;
 }
 
-// SNTP 동기화 상태 확인
+// 유닉스 시간을 신뢰할 수 있는지 (이번 부팅에서 동기화됐거나 RTC로 유지됨)
 int is_sntp_synced(void) {
-    return sntp_synced;
+    return s_time_state >= SNTP_TIME_RTC_RESTORED;
 }
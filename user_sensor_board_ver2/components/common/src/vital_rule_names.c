@@ -0,0 +1,34 @@
+// vital_rule_names.c
+// 규칙 항목/연산/심각도 이름 (경보 payload용)
+// ESP-IDF 함수를 호출하지 않으므로 호스트 도구(tools/fleet_sim)에서 mqtt_sender.c와 함께 그대로 컴파일된다.
+
+#include "vital_rules.h"
+
+const char *vital_metric_name(vital_metric_t metric) {
+    static const char *const names[VITAL_METRIC_COUNT] = {
+        [VITAL_METRIC_HEART_RATE]  = "heartRate",
+        [VITAL_METRIC_SPO2]        = "spo2",
+        [VITAL_METRIC_TEMPERATURE] = "temperature",
+        [VITAL_METRIC_RESP_RATE]   = "respRate",
+    };
+    return (metric < VITAL_METRIC_COUNT) ? names[metric] : "unknown";
+}
+
+const char *vital_op_name(vital_op_t op) {
+    static const char *const names[VITAL_OP_COUNT] = {
+        [VITAL_OP_ABOVE] = "above",
+        [VITAL_OP_BELOW] = "below",
+        [VITAL_OP_RISE]  = "rise",
+        [VITAL_OP_FALL]  = "fall",
+    };
+    return (op < VITAL_OP_COUNT) ? names[op] : "unknown";
+}
+
+const char *vital_severity_name(vital_severity_t severity) {
+    static const char *const names[VITAL_SEVERITY_COUNT] = {
+        [VITAL_SEVERITY_WARNING]  = "warning",
+        [VITAL_SEVERITY_DANGER]   = "danger",
+        [VITAL_SEVERITY_CRITICAL] = "critical",
+    };
+    return (severity < VITAL_SEVERITY_COUNT) ? names[severity] : "unknown";
+}
@@ -0,0 +1,238 @@
+// vital_rules.c
+// 생체 신호 규칙 증분 평가 (히스테리시스 + 지속 시간) 및 경보 이벤트 전달
+
+#include "vital_rules.h"
+#include "spsc_ring.h"
+#include "heart_rate_calculator.h"
+#include "hr_spectral.h"
+#include "metrics.h"
+#include "nvs.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "VITAL_RULES";
+
+#define VITAL_RULES_NVS_NAMESPACE   "vital_rules"
+#define VITAL_RULES_NVS_KEY         "rules_v1"      // vital_rule_t 형식이 바뀌면 버전을 올린다
+// 소비자가 한 번도 돌지 못해도 모든 규칙이 발생+해제를 한 번씩 넣을 수 있는 크기
+#define ALERT_RING_LEN              (VITAL_RULES_MAX * 2)
+#define DEFAULT_BRADYCARDIA_BPM     40.0f
+
+// 기본 규칙 (NVS에 규칙 표가 없을 때)
+// 서맥 임계값(규칙 5)은 스펙트럼 대역 하한(HR_SPECTRAL_MIN_BPM)보다 높아야 발생할 수 있다
+_Static_assert(HR_SPECTRAL_MIN_BPM < DEFAULT_BRADYCARDIA_BPM, "서맥 규칙 임계값이 심박 추정 범위 밖");
+static const vital_rule_t s_default_rules[] = {
+    // id  항목                      연산            심각도                      플래그              예약 창 발생 해제  임계값                       히스테리시스
+    { 1, VITAL_METRIC_SPO2,        VITAL_OP_BELOW, VITAL_SEVERITY_WARNING,  0,                      0, 0,  30,  30, SPO2_HYPOXIA_WARNING, 2.0f },
+    { 2, VITAL_METRIC_SPO2,        VITAL_OP_BELOW, VITAL_SEVERITY_DANGER,   0,                      0, 0,  10,  30, SPO2_HYPOXIA_DANGER,  2.0f },
+    { 3, VITAL_METRIC_SPO2,        VITAL_OP_BELOW, VITAL_SEVERITY_CRITICAL, 0,                      0, 0,   5,  30, SPO2_SEVERE_HYPOXIA,  2.0f },
+    { 4, VITAL_METRIC_HEART_RATE,  VITAL_OP_ABOVE, VITAL_SEVERITY_WARNING,  VITAL_RULE_REST_ONLY,   0, 0, 120,  60, 120.0f,               10.0f },
+    { 5, VITAL_METRIC_HEART_RATE,  VITAL_OP_BELOW, VITAL_SEVERITY_DANGER,   0,                      0, 0,  30,  30, DEFAULT_BRADYCARDIA_BPM, 5.0f },
+    { 6, VITAL_METRIC_HEART_RATE,  VITAL_OP_RISE,  VITAL_SEVERITY_WARNING,  VITAL_RULE_REST_ONLY,   0, 60,  0,  60, 30.0f,                10.0f },
+    { 7, VITAL_METRIC_TEMPERATURE, VITAL_OP_ABOVE, VITAL_SEVERITY_WARNING,  0,                      0, 0,  60, 120, 38.0f,                0.3f },
+    { 8, VITAL_METRIC_RESP_RATE,   VITAL_OP_ABOVE, VITAL_SEVERITY_WARNING,  VITAL_RULE_REST_ONLY,   0, 0,  60,  60, 30.0f,                3.0f },
+    { 9, VITAL_METRIC_RESP_RATE,   VITAL_OP_BELOW, VITAL_SEVERITY_DANGER,   0,                      0, 0,  60,  60, 8.0f,                 2.0f },
+};
+
+// 규칙별 평가 상태 (집계 태스크만 기록)
+typedef struct {
+    bool active;            // 경보 발생 중
+    bool pending;           // 현재 판정(발생 또는 해제) 조건이 이어지는 중
+    int64_t since_us;       // 그 조건이 시작된 시각
+    bool ref_valid;         // 변화율 기준점 (0: 오래된 쪽, 1: 최근 쪽)
+    int64_t ref_t_us[2];
+    float ref_value[2];
+} rule_state_t;
+
+static vital_rule_t s_rules[VITAL_RULES_MAX];
+static rule_state_t s_state[VITAL_RULES_MAX];
+static size_t s_rule_count = 0;
+static int64_t s_last_value_us[VITAL_METRIC_COUNT];
+static TaskHandle_t s_event_task = NULL;
+
+SPSC_RING_DEFINE(s_alert_ring, vital_alert_t, ALERT_RING_LEN);
+
+static bool rules_valid(const vital_rule_t *rules, size_t count) {
+    if (count == 0 || count > VITAL_RULES_MAX) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const vital_rule_t *r = &rules[i];
+        if (r->metric >= VITAL_METRIC_COUNT || r->op >= VITAL_OP_COUNT || r->severity >= VITAL_SEVERITY_COUNT ||
+            r->hysteresis < 0.0f) {
+            return false;
+        }
+        if ((r->op == VITAL_OP_RISE || r->op == VITAL_OP_FALL) && r->window_s < 2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void vital_rules_init(void) {
+    memset(s_state, 0, sizeof(s_state));
+    memset(s_last_value_us, 0, sizeof(s_last_value_us));
+
+    size_t len = sizeof(s_rules);
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(VITAL_RULES_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (ret == ESP_OK) {
+        ret = nvs_get_blob(nvs, VITAL_RULES_NVS_KEY, s_rules, &len);
+        nvs_close(nvs);
+    }
+    if (ret == ESP_OK && len % sizeof(vital_rule_t) == 0 && rules_valid(s_rules, len / sizeof(vital_rule_t))) {
+        s_rule_count = len / sizeof(vital_rule_t);
+        ESP_LOGI(TAG, "NVS 규칙 %u개 로드", (unsigned)s_rule_count);
+        return;
+    }
+    if (ret == ESP_OK) {
+        ESP_LOGW(TAG, "NVS 규칙 표 형식 오류 (%u바이트) - 기본 규칙 사용", (unsigned)len);
+    }
+    s_rule_count = sizeof(s_default_rules) / sizeof(s_default_rules[0]);
+    memcpy(s_rules, s_default_rules, sizeof(s_default_rules));
+    ESP_LOGI(TAG, "기본 규칙 %u개 사용", (unsigned)s_rule_count);
+}
+
+void vital_rules_set_event_task(TaskHandle_t task) {
+    s_event_task = task;
+}
+
+static void emit(const vital_rule_t *rule, bool raised, float value, int64_t t_us) {
+    vital_alert_t alert = {
+        .t_us = t_us,
+        .value = value,
+        .threshold = rule->threshold,
+        .rule_id = rule->id,
+        .metric = rule->metric,
+        .op = rule->op,
+        .severity = rule->severity,
+        .raised = raised,
+    };
+    if (raised) {
+        ESP_LOGW(TAG, "경보 발생: 규칙 %u %s %s %.1f (값 %.1f, %s)", rule->id, vital_metric_name(rule->metric),
+                 vital_op_name(rule->op), rule->threshold, value, vital_severity_name(rule->severity));
+    } else {
+        ESP_LOGI(TAG, "경보 해제: 규칙 %u %s (값 %.1f)", rule->id, vital_metric_name(rule->metric), value);
+    }
+    if (!spsc_ring_push(&s_alert_ring, &alert)) {
+        metrics_inc(METRIC_VITAL_ALERT_DROPS);
+        ESP_LOGE(TAG, "경보 대기열 가득 참 - 규칙 %u 이벤트 버림", rule->id);
+        return;
+    }
+    if (s_event_task != NULL) {
+        xTaskNotifyGive(s_event_task);
+    }
+}
+
+// 변화율 규칙의 분당 변화량 (기준점이 window_s/2 이상 지나야 유효)
+static bool rate_per_min(const vital_rule_t *rule, rule_state_t *st, float value, int64_t t_us, float *rate) {
+    const int64_t half_us = (int64_t)rule->window_s * 500000;
+    if (!st->ref_valid) {
+        st->ref_valid = true;
+        st->ref_t_us[0] = st->ref_t_us[1] = t_us;
+        st->ref_value[0] = st->ref_value[1] = value;
+        return false;
+    }
+    int64_t dt_us = t_us - st->ref_t_us[0];
+    bool valid = dt_us >= half_us;
+    if (valid) {
+        *rate = (value - st->ref_value[0]) * 60e6f / (float)dt_us;
+    }
+    if (t_us - st->ref_t_us[1] >= half_us) {
+        st->ref_t_us[0] = st->ref_t_us[1];
+        st->ref_value[0] = st->ref_value[1];
+        st->ref_t_us[1] = t_us;
+        st->ref_value[1] = value;
+    }
+    return valid;
+}
+
+// 조건이 hold_s 동안 이어졌으면 true (조건이 깨지면 처음부터)
+static bool held(rule_state_t *st, bool cond, int64_t t_us, uint16_t hold_s) {
+    if (!cond) {
+        st->pending = false;
+        return false;
+    }
+    if (!st->pending) {
+        st->pending = true;
+        st->since_us = t_us;
+    }
+    if (t_us - st->since_us < (int64_t)hold_s * 1000000) {
+        return false;
+    }
+    st->pending = false;
+    return true;
+}
+
+static void evaluate(const vital_rule_t *rule, rule_state_t *st, float value, int64_t t_us, bool at_rest) {
+    float x = value;
+    if (rule->op == VITAL_OP_RISE || rule->op == VITAL_OP_FALL) {
+        if (!rate_per_min(rule, st, value, t_us, &x)) {
+            return;
+        }
+    }
+    // BELOW는 값, FALL은 변화량의 부호를 뒤집어 모두 "임계값보다 크다"로 판정
+    float sx = (rule->op == VITAL_OP_BELOW || rule->op == VITAL_OP_FALL) ? -x : x;
+    float thr = (rule->op == VITAL_OP_BELOW) ? -rule->threshold : rule->threshold;
+
+    if (!st->active) {
+        bool cond = sx > thr && (!(rule->flags & VITAL_RULE_REST_ONLY) || at_rest);
+        if (held(st, cond, t_us, rule->hold_s)) {
+            st->active = true;
+            emit(rule, true, x, t_us);
+        }
+    } else if (held(st, sx < thr - rule->hysteresis, t_us, rule->clear_s)) {
+        st->active = false;
+        emit(rule, false, x, t_us);
+    }
+}
+
+void vital_rules_update(vital_metric_t metric, float value, int64_t t_us, bool at_rest) {
+    if (metric >= VITAL_METRIC_COUNT) {
+        return;
+    }
+    bool stale = s_last_value_us[metric] != 0 &&
+                 t_us - s_last_value_us[metric] > (int64_t)VITAL_RULES_STALE_MS * 1000;
+    s_last_value_us[metric] = t_us;
+
+    for (size_t i = 0; i < s_rule_count; i++) {
+        if (s_rules[i].metric != metric) {
+            continue;
+        }
+        if (stale) {
+            // 끊긴 동안의 지속 여부는 알 수 없으므로 지속 시간과 변화율 기준점을 새로 잡는다
+            s_state[i].pending = false;
+            s_state[i].ref_valid = false;
+        }
+        evaluate(&s_rules[i], &s_state[i], value, t_us, at_rest);
+    }
+}
+
+bool vital_rules_take_alert(vital_alert_t *alert) {
+    return spsc_ring_pop(&s_alert_ring, alert);
+}
+
+esp_err_t vital_rules_save(const vital_rule_t *rules, size_t count) {
+    if (count > 0 && !rules_valid(rules, count)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(VITAL_RULES_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (count > 0) {
+        ret = nvs_set_blob(nvs, VITAL_RULES_NVS_KEY, rules, count * sizeof(vital_rule_t));
+    } else {
+        ret = nvs_erase_key(nvs, VITAL_RULES_NVS_KEY);
+        if (ret == ESP_ERR_NVS_NOT_FOUND) {
+            ret = ESP_OK;
+        }
+    }
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    ESP_LOGI(TAG, "규칙 %u개 저장 (다음 부팅부터 적용): %s", (unsigned)count, esp_err_to_name(ret));
+    return ret;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// 활동 분류 (정지 / 걷기 / 달리기 / 수면 / 전환)
+//
+// IMU 샘플마다 특징량을 누적하고, 1초(hop)마다 직전 2초 창(50% 겹침)의 특징량으로 분류한다.
+// 창 전체를 버퍼에 두지 않고 hop 단위 부분합만 두 개 보관한다:
+//   - 합가속도 크기의 합/제곱합 → 표준편차
+//   - 1g 기준 교차 수 (히스테리시스)
+//   - 자이로 에너지
+//   - 창 길이 기준 DFT 빈(0.5~3.5Hz) Goertzel 값 → 우세 주파수. 두 hop의 빈 값은 위상 (-1)^k만
+//     곱해 더하면 2초 창의 DFT가 되므로 샘플을 다시 보지 않는다.
+// 분류는 정수로 양자화한 특징량에 대한 결정 트리(노드 표)로 하며, 수면은 트리가 아니라
+// 정지가 오래 이어질 때 올리는 상태다. 트리 결과가 바뀌는 창은 전환으로 보고한다.
+// ESP-IDF 의존성이 없어 호스트 벤치마크(tools/dsp_bench)에서 그대로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    ACTIVITY_UNKNOWN = 0,           // 첫 창이 차기 전
+    ACTIVITY_STILL,
+    ACTIVITY_WALK,
+    ACTIVITY_RUN,
+    ACTIVITY_SLEEP,
+    ACTIVITY_TRANSITION,
+    ACTIVITY_COUNT
+} activity_class_t;
+
+#define ACTIVITY_FREQ_BINS  7       // 2초 창 DFT 빈 1~7 (0.5Hz 간격, 0.5~3.5Hz)
+
+// 양자화 특징량 (트리 입력)
+typedef enum {
+    ACTIVITY_FEAT_MAG_STD_MG = 0,   // 합가속도 크기 표준편차 (mg)
+    ACTIVITY_FEAT_DOM_FREQ,         // 우세 주파수 (0.5Hz 단위, 0 = 뚜렷한 주기 없음)
+    ACTIVITY_FEAT_ZERO_CROSS,       // 창 안의 1g 교차 수
+    ACTIVITY_FEAT_GYRO_RMS_DPS,     // 자이로 RMS (dps)
+    ACTIVITY_FEAT_COUNT
+} activity_feature_t;
+
+// hop 하나의 부분합
+typedef struct {
+    float sum;
+    float sum_sq;
+    float gyro_sq;
+    uint16_t zero_cross;
+    float y_re[ACTIVITY_FREQ_BINS];     // Goertzel 출력 (hop 시작 기준 위상)
+    float y_im[ACTIVITY_FREQ_BINS];
+} activity_block_t;
+
+typedef struct {
+    // 파라미터 (activity_init에서 샘플링 주파수 기준으로 설정)
+    uint16_t hop_samples;               // 1초
+    uint32_t sleep_onset_windows;       // 정지가 이만큼 이어지면 수면
+    float coef[ACTIVITY_FREQ_BINS];     // 2cos(w)
+    float cos_w[ACTIVITY_FREQ_BINS];
+    float sin_w[ACTIVITY_FREQ_BINS];
+
+    // 현재 hop 누적
+    uint16_t n;
+    float sum, sum_sq, gyro_sq;
+    uint16_t zero_cross;
+    int8_t zc_side;                     // 1g 위(+1)/아래(-1)
+    float s1[ACTIVITY_FREQ_BINS];
+    float s2[ACTIVITY_FREQ_BINS];
+
+    activity_block_t prev;              // 직전 hop
+    bool prev_valid;
+
+    // 출력 (창마다 갱신)
+    uint16_t features[ACTIVITY_FEAT_COUNT];
+    activity_class_t tree_class;        // 트리 결과
+    activity_class_t activity;          // 전환/수면 반영 최종 결과
+    uint32_t still_windows;             // 연속 정지 창 수
+    uint32_t windows;
+} activity_ctx_t;
+
+/**
+ * @brief 컨텍스트 초기화
+ * @param sample_hz IMU 샘플링 주파수
+ */
+void activity_init(activity_ctx_t *ctx, float sample_hz);
+
+/**
+ * @brief IMU 샘플 1개 누적 (hop이 끝나면 창 분류까지)
+ * @param acc_g 가속도 (g)
+ * @param gyro_dps 각속도 (deg/s)
+ * @return true면 이번 샘플에서 창 분류가 끝나 ctx->activity/features가 갱신됨
+ */
+bool activity_update(activity_ctx_t *ctx, const float acc_g[3], const float gyro_dps[3]);
+
+/**
+ * @brief 양자화 특징량으로 결정 트리 평가 (정지/걷기/달리기/전환 중 하나)
+ */
+activity_class_t activity_tree_predict(const uint16_t features[ACTIVITY_FEAT_COUNT]);
+
+/**
+ * @brief 텔레메트리/로그용 이름 ("still", "walk", ...)
+ */
+const char *activity_name(activity_class_t activity);
@@ -17,6 +17,10 @@ typedef struct {
     int16_t gz;
 } mpu6050_data_t;
 
+// mpu6050_init()이 설정하는 범위의 스케일 (±16g, ±2000 dps)
+#define MPU6050_ACC_LSB_PER_G       2048.0f
+#define MPU6050_GYRO_LSB_PER_DPS    16.4f
+
 /**
  * @brief MPU6050 초기화 (Power management 및 설정)
  */
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "orientation.h"
 
 // 낙상 방향 enum
 typedef enum {
@@ -17,21 +18,38 @@ typedef enum {
     FALL_DIR_BACK_RIGHT      // 뒤-우
 } fall_direction_t;
 
+// 낙상 판정 단계 (자유낙하 → 충격 → 충격 후 정지/자세 변화)
+typedef enum {
+    FALL_PHASE_IDLE = 0,
+    FALL_PHASE_FREE_FALL,       // |a|가 자유낙하 임계값 아래에 머무는 중
+    FALL_PHASE_IMPACT_WAIT,     // 자유낙하가 끝난 뒤 충격을 기다리는 중
+    FALL_PHASE_POST_IMPACT,     // 충격 후 정지 여부와 자세 변화를 관찰하는 중
+} fall_phase_t;
+
+// 원시 샘플 링 길이 (100Hz에서 충격 전후 ±2초 창 + 여유)
+#define STEP_FALL_HIST_LEN  512
+
 // 낙상 결과 구조체
 typedef struct {
-    bool fall_detected;           // 낙상 감지 여부
+    bool fall_detected;           // 낙상 확정 여부
+    bool window_ready;            // 후보 판정 완료 (확정/기각 모두, step_fall_copy_window로 원시 창을 꺼낼 수 있음)
+    const char *reason;           // 판정 근거 (고정 문자열, window_ready일 때만)
     fall_direction_t direction;   // 낙상 방향
     float fall_angle_deg;         // 낙상 각도 (도)
     float ax_g;                   // X축 가속도 (g)
     float ay_g;                   // Y축 가속도 (g)
-    float roll_deg;               // Roll 각도 (도)
-    float pitch_deg;              // Pitch 각도 (도)
+    float roll_deg;               // 낙상 전 자세 대비 Roll 변화 (도, 판정 시에만 계산)
+    float pitch_deg;              // 낙상 전 자세 대비 Pitch 변화 (도, 판정 시에만 계산)
+    float impact_g;               // 충격 최대 선형 가속도 (g)
+    float tilt_deg;               // 낙상 전 자세 대비 기울기 (도)
+    float post_gyro_rms_dps;      // 충격 후 관찰 구간 자이로 RMS
+    uint16_t free_fall_ms;        // 충격 전 자유낙하 지속 시간 (0 = 자유낙하 없이 충격만)
+    uint16_t impact_age_samples;  // 충격 샘플이 현재 샘플보다 몇 샘플 전인지
 } fall_result_t;
 
 // 걸음 수 및 낙상 감지를 위한 컨텍스트 구조체
 typedef struct {
     // 필터 및 임계값 파라미터 (걸음 수 감지용)
-    float lpf_a;                    // 중력 추정을 위한 LPF 알파 (예: 0.02 @100Hz)
     float ema_a;                    // 동적 임계값 베이스라인을 위한 EMA 알파 (예: 0.01)
     float dyn_k;                    // 동적 임계값 게인 (예: 1.5)
     float step_min_interval_ms;     // 재진입 지연 시간 (예: 300ms)
@@ -42,30 +60,62 @@ typedef struct {
     float angle_threshold_deg;      // 각도 임계값 (논문: 30° 또는 45°)
 
     // 런타임 상태
-    float g_est_x, g_est_y, g_est_z;  // 중력 추정값
+    orientation_ctx_t orient;          // 자세 추정 (중력 방향, 선형 가속도, 기준 자세 대비 기울기)
+    float acc_g[3];                    // 최근 샘플 (step_fall_update에서 스케일 변환)
+    float gyro_dps[3];
     float ema_abs_a;                   // 동적 임계값을 위한 베이스라인
     uint32_t last_step_ms;             // 마지막 스텝 시간
 
-    // 낙상 감지 상태 (간소화)
+    // 낙상 감지 상태
     bool fall_detected;                // 낙상 감지 플래그
     uint32_t fall_reset_time_ms;       // 낙상 리셋 시간
+    uint32_t last_fall_ms;             // 마지막 확정 시각 (쿨다운)
+    fall_phase_t phase;
+    uint32_t phase_samples;            // 현재 단계에 들어온 뒤 샘플 수
+    uint16_t free_fall_samples;        // 직전 자유낙하 지속 샘플 수
+    float impact_peak_sq;              // 충격 최대 선형 가속도 제곱 (g^2)
+    float pre_gravity[3];              // 후보 시작 시점의 기준 자세 (충격 후 기준 자세가 따라가기 전 값)
+    float post_gyro_sq_sum;            // 충격 후 관찰 구간 누적 (정지 판단)
+    float post_acc_dev_sum;
+    uint32_t post_count;
+
+    // 샘플 수 파라미터 (step_fall_init에서 샘플링 주파수 기준으로 설정)
+    uint16_t window_pre_samples;       // 업로드 창: 충격 전
+    uint16_t window_post_samples;      // 업로드 창: 충격 후 (= 판정까지 걸리는 샘플 수)
+    uint16_t free_fall_min_samples;
+    uint16_t impact_wait_samples;
+    uint16_t post_settle_samples;      // 충격 직후 흔들림을 정지 판단에서 제외
+    float sample_hz;
+
+    // 최근 원시 샘플 링 (ax, ay, az, gx, gy, gz LSB)
+    int16_t raw_hist[STEP_FALL_HIST_LEN][6];
+    uint32_t raw_head;                 // 다음 기록 위치 (자유 증가)
 } step_fall_ctx_t;
 
 // 함수 선언
 void step_fall_init(step_fall_ctx_t* ctx, float sample_hz);
 
-bool step_fall_detect_step(step_fall_ctx_t* ctx,
-                           int16_t ax_raw, int16_t ay_raw, int16_t az_raw,
-                           int16_t gx_raw, int16_t gy_raw, int16_t gz_raw,
-                           uint32_t now_ms);
+// 샘플마다 한 번, 두 감지기보다 먼저 호출 (스케일 변환 + 자세 갱신)
+void step_fall_update(step_fall_ctx_t* ctx,
+                      int16_t ax_raw, int16_t ay_raw, int16_t az_raw,
+                      int16_t gx_raw, int16_t gy_raw, int16_t gz_raw);
+
+bool step_fall_detect_step(step_fall_ctx_t* ctx, uint32_t now_ms);
 
-fall_result_t step_fall_detect_fall(step_fall_ctx_t* ctx,
-                                   int16_t ax_raw, int16_t ay_raw, int16_t az_raw,
-                                   int16_t gx_raw, int16_t gy_raw, int16_t gz_raw,
-                                   uint32_t now_ms);
+fall_result_t step_fall_detect_fall(step_fall_ctx_t* ctx, uint32_t now_ms);
 
 void step_fall_reset_fall(step_fall_ctx_t* ctx);
 
+/**
+ * @brief 판정이 끝난 후보의 충격 전후 원시 창을 시간 순으로 복사 (window_ready인 샘플에서 호출)
+ * @param out 샘플당 ax, ay, az, gx, gy, gz (LSB)
+ * @param max_samples out 용량
+ * @param impact_index 충격 샘플의 out 내 위치
+ * @return 복사한 샘플 수
+ */
+int step_fall_copy_window(const step_fall_ctx_t* ctx, const fall_result_t* result,
+                          int16_t (*out)[6], int max_samples, int* impact_index);
+
 // Roll, Pitch 각도 계산 헬퍼 함수
 float calculate_roll_angle(float ax_g, float ay_g, float az_g);
 float calculate_pitch_angle(float ax_g, float ay_g, float az_g);
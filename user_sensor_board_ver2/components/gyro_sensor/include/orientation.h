@@ -0,0 +1,68 @@
+#pragma once
+
+// 자이로 융합 자세 추정 (Mahony 상보 필터, 쿼터니언)
+//
+// IMU 샘플마다 한 번 갱신한다. 자이로 적분으로 자세를 따라가고, 가속도가 1g 근처일 때만
+// 중력 방향 오차를 비례-적분 피드백으로 보정하므로 충격/자유낙하 중에도 자세가 유지된다.
+// 정규화는 빠른 역제곱근(Newton 2회)으로 하고 샘플당 삼각함수를 쓰지 않는다 (각도가 필요하면
+// 이벤트 시점에만 orientation_roll_pitch_deg()로 계산).
+//
+// 결과: 기기 좌표계 중력 방향(단위 벡터), 중력을 뺀 선형 가속도(g), 낙상 전 기준 자세 대비
+// 기울기의 코사인. ESP-IDF 의존성이 없어 호스트 벤치마크(tools/dsp_bench)에서 그대로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    // 파라미터 (orientation_init에서 샘플링 주파수 기준으로 설정)
+    float dt;                       // 샘플 간격 (s)
+    float two_kp;                   // 비례 게인 x2
+    float two_ki;                   // 적분 게인 x2
+    float baseline_a;               // 기준 자세 EMA 알파
+    uint32_t settle_samples;        // 시작 직후 높은 게인으로 빠르게 수렴할 샘플 수
+
+    // 상태
+    float q[4];                     // 쿼터니언 (w, x, y, z) - 기기 → 기준 좌표계
+    float integral[3];              // 적분 피드백 (rad/s)
+    uint32_t samples;
+
+    // 샘플마다 갱신되는 출력
+    float gravity[3];               // 기기 좌표계 중력 방향 (단위 벡터)
+    float linear_g[3];              // 중력 제거 선형 가속도 (g)
+    float baseline[3];              // 조용할 때만 따라가는 기준 중력 방향 (낙상 전 자세)
+    float tilt_cos;                 // 기준 자세 대비 기울기 코사인 (1 = 기울기 없음)
+    bool accel_trusted;             // 이번 샘플에서 가속도 보정을 적용했는지
+} orientation_ctx_t;
+
+/**
+ * @brief 컨텍스트 초기화
+ * @param sample_hz IMU 샘플링 주파수
+ */
+void orientation_init(orientation_ctx_t *ctx, float sample_hz);
+
+/**
+ * @brief IMU 샘플 1개로 자세 갱신
+ * @param acc_g 가속도 (g)
+ * @param gyro_dps 각속도 (deg/s)
+ */
+void orientation_update(orientation_ctx_t *ctx, const float acc_g[3], const float gyro_dps[3]);
+
+/**
+ * @brief 선형 가속도 크기의 제곱 (g^2, sqrt 없이 임계값 비교용)
+ */
+float orientation_linear_sq(const orientation_ctx_t *ctx);
+
+/**
+ * @brief 현재 중력 방향 기준 Roll/Pitch (도) - atan2f를 쓰므로 이벤트 시점에만 호출
+ */
+void orientation_roll_pitch_deg(const orientation_ctx_t *ctx, float *roll_deg, float *pitch_deg);
+
+/**
+ * @brief 기준 자세 대비 기울기 방향 Roll/Pitch (도) - 이벤트 시점에만 호출
+ */
+void orientation_tilt_roll_pitch_deg(const orientation_ctx_t *ctx, float *roll_deg, float *pitch_deg);
+
+/**
+ * @brief 빠른 역제곱근 (Newton 2회, 상대 오차 약 1e-6)
+ */
+float orientation_inv_sqrt(float x);
@@ -0,0 +1,191 @@
+// activity.c
+// 창 단위 특징량 누적 + 양자화 결정 트리 활동 분류
+
+#include "activity.h"
+#include <math.h>
+#include <string.h>
+#include "orientation.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+#define HOP_S               1.0f    // 분류 주기 (창은 hop 2개 = 2초)
+#define SLEEP_ONSET_S       300     // 정지가 5분 이어지면 수면
+#define ZC_HYST_G           0.05f   // 1g 교차 히스테리시스
+#define DOM_MIN_AMP_G       0.03f   // 우세 주파수로 인정할 최소 진폭
+
+// 결정 트리 노드 (feature < threshold면 left, 아니면 right)
+// 잎은 feature = TREE_LEAF, left = 클래스. 오프라인 학습 결과도 같은 표로 내보내 교체한다.
+// 현재 임계값은 손목 착용 문헌값(걷기 1.5~2.2Hz / 0.1~0.4g, 달리기 2.5Hz 이상 / 0.5g 이상)으로 잡은 것
+#define TREE_LEAF           0xFF
+
+typedef struct {
+    uint8_t feature;
+    uint16_t threshold;
+    uint8_t left;
+    uint8_t right;
+} tree_node_t;
+
+static const tree_node_t s_tree[] = {
+    /* 0 */ { ACTIVITY_FEAT_MAG_STD_MG,   40,  1, 2 },
+    /* 1 */ { ACTIVITY_FEAT_GYRO_RMS_DPS, 20,  3, 4 },     // 몸은 가만히, 팔만 움직이면 전환
+    /* 2 */ { ACTIVITY_FEAT_DOM_FREQ,     2,   4, 5 },     // 1Hz 미만은 보행 주기가 아님
+    /* 3 */ { TREE_LEAF, 0, ACTIVITY_STILL, 0 },
+    /* 4 */ { TREE_LEAF, 0, ACTIVITY_TRANSITION, 0 },
+    /* 5 */ { ACTIVITY_FEAT_MAG_STD_MG,   450, 6, 7 },
+    /* 6 */ { TREE_LEAF, 0, ACTIVITY_WALK, 0 },
+    /* 7 */ { ACTIVITY_FEAT_ZERO_CROSS,   9,   6, 8 },     // 세게 걷기와 달리기를 보폭 주기로 구분
+    /* 8 */ { TREE_LEAF, 0, ACTIVITY_RUN, 0 },
+};
+
+static const char *const s_names[ACTIVITY_COUNT] = {
+    "unknown", "still", "walk", "run", "sleep", "transition",
+};
+
+const char *activity_name(activity_class_t activity) {
+    return (unsigned)activity < ACTIVITY_COUNT ? s_names[activity] : "unknown";
+}
+
+activity_class_t activity_tree_predict(const uint16_t features[ACTIVITY_FEAT_COUNT]) {
+    uint8_t i = 0;
+    // 깊이만큼만 돌도록 노드 수로 제한 (표가 잘못돼도 무한 루프 없음)
+    for (unsigned depth = 0; depth < sizeof(s_tree) / sizeof(s_tree[0]); depth++) {
+        const tree_node_t *node = &s_tree[i];
+        if (node->feature == TREE_LEAF) {
+            return (activity_class_t)node->left;
+        }
+        i = features[node->feature] < node->threshold ? node->left : node->right;
+    }
+    return ACTIVITY_UNKNOWN;
+}
+
+void activity_init(activity_ctx_t *ctx, float sample_hz) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->hop_samples = (uint16_t)(sample_hz * HOP_S + 0.5f);
+    ctx->sleep_onset_windows = (uint32_t)(SLEEP_ONSET_S / HOP_S);
+    ctx->zc_side = -1;
+
+    // 창 길이 N = 2 * hop 기준 DFT 빈 k = 1..7
+    for (int k = 0; k < ACTIVITY_FREQ_BINS; k++) {
+        float w = (float)M_PI * (float)(k + 1) / (float)ctx->hop_samples;
+        ctx->cos_w[k] = cosf(w);
+        ctx->sin_w[k] = sinf(w);
+        ctx->coef[k] = 2.0f * ctx->cos_w[k];
+    }
+}
+
+// 현재 hop을 블록으로 닫고 누적을 비움
+static void close_block(activity_ctx_t *ctx, activity_block_t *b) {
+    b->sum = ctx->sum;
+    b->sum_sq = ctx->sum_sq;
+    b->gyro_sq = ctx->gyro_sq;
+    b->zero_cross = ctx->zero_cross;
+    for (int k = 0; k < ACTIVITY_FREQ_BINS; k++) {
+        b->y_re[k] = ctx->s1[k] - ctx->cos_w[k] * ctx->s2[k];
+        b->y_im[k] = ctx->sin_w[k] * ctx->s2[k];
+        ctx->s1[k] = 0.0f;
+        ctx->s2[k] = 0.0f;
+    }
+    ctx->n = 0;
+    ctx->sum = 0.0f;
+    ctx->sum_sq = 0.0f;
+    ctx->gyro_sq = 0.0f;
+    ctx->zero_cross = 0;
+}
+
+static uint16_t clamp_u16(float v) {
+    return v <= 0.0f ? 0 : (v >= 65535.0f ? 65535 : (uint16_t)(v + 0.5f));
+}
+
+// 직전 hop(a)과 현재 hop(b)으로 2초 창 특징량 계산
+static void compute_features(activity_ctx_t *ctx, const activity_block_t *a, const activity_block_t *b) {
+    float n = 2.0f * ctx->hop_samples;
+    float mean = (a->sum + b->sum) / n;
+    float var = (a->sum_sq + b->sum_sq) / n - mean * mean;
+    float gyro_ms = (a->gyro_sq + b->gyro_sq) / n;
+
+    // 창 DFT = y_a + (-1)^k * y_b (공통 위상 인자는 크기에 영향 없음), 진폭 = 2|X|/N
+    float min_pow = 0.25f * DOM_MIN_AMP_G * DOM_MIN_AMP_G * n * n;
+    float best_pow = min_pow;
+    uint16_t best = 0;
+    for (int k = 0; k < ACTIVITY_FREQ_BINS; k++) {
+        float sign = (k & 1) ? 1.0f : -1.0f;   // 빈 번호 k+1의 (-1)^(k+1)
+        float re = a->y_re[k] + sign * b->y_re[k];
+        float im = a->y_im[k] + sign * b->y_im[k];
+        float pow = re * re + im * im;
+        if (pow > best_pow) {
+            best_pow = pow;
+            best = (uint16_t)(k + 1);
+        }
+    }
+
+    ctx->features[ACTIVITY_FEAT_MAG_STD_MG] = clamp_u16(sqrtf(var > 0.0f ? var : 0.0f) * 1000.0f);
+    ctx->features[ACTIVITY_FEAT_DOM_FREQ] = best;
+    ctx->features[ACTIVITY_FEAT_ZERO_CROSS] = a->zero_cross + b->zero_cross;
+    ctx->features[ACTIVITY_FEAT_GYRO_RMS_DPS] = clamp_u16(sqrtf(gyro_ms));
+}
+
+static void classify(activity_ctx_t *ctx) {
+    activity_class_t tree = activity_tree_predict(ctx->features);
+    bool asleep = ctx->activity == ACTIVITY_SLEEP;
+
+    if (tree == ACTIVITY_STILL) {
+        ctx->still_windows++;
+    } else if (!asleep || tree != ACTIVITY_TRANSITION) {
+        ctx->still_windows = 0;
+    }
+
+    activity_class_t out;
+    if (asleep && tree != ACTIVITY_WALK && tree != ACTIVITY_RUN) {
+        out = ACTIVITY_SLEEP;           // 뒤척임(전환)은 수면 유지
+    } else if (tree == ACTIVITY_STILL && ctx->still_windows >= ctx->sleep_onset_windows) {
+        out = ACTIVITY_SLEEP;
+    } else if (ctx->windows > 0 && tree != ctx->tree_class) {
+        out = ACTIVITY_TRANSITION;      // 트리 결과가 바뀐 창
+    } else {
+        out = tree;
+    }
+    ctx->tree_class = tree;
+    ctx->activity = out;
+    ctx->windows++;
+}
+
+bool activity_update(activity_ctx_t *ctx, const float acc_g[3], const float gyro_dps[3]) {
+    float acc_sq = acc_g[0] * acc_g[0] + acc_g[1] * acc_g[1] + acc_g[2] * acc_g[2];
+    float mag = acc_sq * orientation_inv_sqrt(acc_sq > 1e-6f ? acc_sq : 1e-6f);
+
+    ctx->sum += mag;
+    ctx->sum_sq += acc_sq;
+    ctx->gyro_sq += gyro_dps[0] * gyro_dps[0] + gyro_dps[1] * gyro_dps[1] + gyro_dps[2] * gyro_dps[2];
+
+    if (ctx->zc_side < 0 && mag > 1.0f + ZC_HYST_G) {
+        ctx->zc_side = 1;
+        ctx->zero_cross++;
+    } else if (ctx->zc_side > 0 && mag < 1.0f - ZC_HYST_G) {
+        ctx->zc_side = -1;
+        ctx->zero_cross++;
+    }
+
+    for (int k = 0; k < ACTIVITY_FREQ_BINS; k++) {
+        float s = mag + ctx->coef[k] * ctx->s1[k] - ctx->s2[k];
+        ctx->s2[k] = ctx->s1[k];
+        ctx->s1[k] = s;
+    }
+
+    if (++ctx->n < ctx->hop_samples) {
+        return false;
+    }
+
+    activity_block_t cur;
+    close_block(ctx, &cur);
+    bool done = false;
+    if (ctx->prev_valid) {
+        compute_features(ctx, &ctx->prev, &cur);
+        classify(ctx);
+        done = true;
+    }
+    ctx->prev = cur;
+    ctx->prev_valid = true;
+    return done;
+}
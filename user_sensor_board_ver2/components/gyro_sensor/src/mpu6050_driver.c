@@ -49,16 +49,16 @@ esp_err_t mpu6050_init(i2c_port_t port) {
         return err;
     }
 
-    // 가속도 범위 설정: ±2g (AFS_SEL = 0)
-    // 논문에서는 ±16g를 사용했지만, ±2g도 낙상 감지에 충분함
+    // 가속도 범위 설정: ±16g (AFS_SEL = 3)
+    // 낙상 충격은 3~10g라 ±2g에서는 포화되어 충격 크기를 구분할 수 없음
     data[0] = MPU6050_ACCEL_CONFIG;
-    data[1] = 0x00;  // ±2g (16384 LSB/g)
+    data[1] = 0x18;  // ±16g (2048 LSB/g = MPU6050_ACC_LSB_PER_G)
     err = i2c_master_write_to_device(port, MPU6050_ADDR, data, 2, pdMS_TO_TICKS(I2C_TIMEOUT_MS));
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "MPU6050 가속도 설정 실패: %s", esp_err_to_name(err));
         return err;
     }
-    ESP_LOGI(TAG, "가속도 범위: ±2g 설정");
+    ESP_LOGI(TAG, "가속도 범위: ±16g 설정");
 
     // 자이로 범위 설정: ±2000 dps (FS_SEL = 3)
     data[0] = MPU6050_GYRO_CONFIG;
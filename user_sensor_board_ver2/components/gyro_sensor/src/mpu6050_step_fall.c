@@ -1,12 +1,16 @@
 #include "mpu6050_step_fall.h"
 #include <math.h>
+#include <string.h>
 #include "esp_log.h"
+#include "mpu6050_driver.h"
+#define DLOG_LOCAL_LEVEL CONFIG_DLOG_LEVEL_STEP_FALL
+#include "dlog.h"
 
 static const char *TAG = "STEP_FALL";
 
-// MPU6050 스케일 (±2g, ±2000 dps 가정) - 필요 시 실제 설정값에 맞춰 수정
-#define ACC_LSB_PER_G     16384.0f
-#define GYRO_LSB_PER_DPS  16.4f
+// MPU6050 스케일은 mpu6050_driver.h (mpu6050_init 설정값)
+#define ACC_LSB_PER_G     MPU6050_ACC_LSB_PER_G
+#define GYRO_LSB_PER_DPS  MPU6050_GYRO_LSB_PER_DPS
 
 // 수학 상수
 #ifndef M_PI
@@ -19,8 +23,19 @@ static inline float clampf(float v, float lo, float hi) {
     return v < lo ? lo : (v > hi ? hi : v); 
 }
 
-// 낙상 이벤트 쿨다운 관리
-static uint32_t last_fall_time = 0;
+// 낙상 판정 임계값 (자유낙하는 전체 가속도, 충격은 중력 제거 선형 가속도 기준)
+#define FREE_FALL_G         0.6f    // |a|가 이보다 작으면 자유낙하
+#define FREE_FALL_MIN_MS    60      // 이보다 짧은 저중력 구간은 팔 흔들기로 보고 무시
+#define IMPACT_WAIT_MS      500     // 자유낙하가 끝난 뒤 충격을 기다리는 시간
+#define IMPACT_AFTER_FF_G   2.0f    // 자유낙하 뒤 충격
+#define IMPACT_ONLY_G       3.5f    // 자유낙하 없이 충격만으로 후보 시작 (손목은 자유낙하가 흐릿함)
+#define POST_SETTLE_MS      500     // 충격 직후 튕김은 정지 판단에서 제외 (이 구간에서 충격 최대값 갱신)
+#define POST_GYRO_RMS_DPS   30.0f   // 충격 후 정지: 자이로 RMS
+#define POST_ACC_DEV        0.3f    // 충격 후 정지: ||a|^2 - 1| 평균 (약 ±0.15g)
+#define LARGE_TILT_COS      0.7071f // 낙상 전 자세 대비 45° 이상 기울어짐 (cos 45°)
+#define WINDOW_PRE_MS       2000    // 업로드 창: 충격 전
+#define WINDOW_POST_MS      2000    // 업로드 창: 충격 후 (판정도 이 시점에 내림)
+#define FALL_COOLDOWN_MS    10000   // 확정 후 재감지 방지
 
 /**
  * @brief Roll 각도 계산 (φ_R)
@@ -90,6 +105,10 @@ fall_direction_t determine_fall_direction(float roll_deg, float pitch_deg) {
     }
 }
 
+static uint16_t ms_to_samples(float sample_hz, uint32_t ms) {
+    return (uint16_t)(ms * sample_hz / 1000.0f + 0.5f);
+}
+
 /**
  * @brief 걸음 수 및 낙상 감지 초기화
  * @param ctx 컨텍스트 구조체
@@ -101,8 +120,10 @@ void step_fall_init(step_fall_ctx_t* ctx, float sample_hz) {
     // 구조체 초기화
     *ctx = (step_fall_ctx_t){0};
     
+    // 자세 추정 (IMU 샘플링 주파수로 갱신)
+    orientation_init(&ctx->orient, sample_hz);
+
     // 기본 파라미터 (100Hz 기준) - 스텝 감지용
-    ctx->lpf_a = 0.02f;
     ctx->ema_a = 0.01f;
     ctx->dyn_k = 1.0f;
     ctx->step_min_interval_ms = 220.0f;
@@ -112,59 +133,83 @@ void step_fall_init(step_fall_ctx_t* ctx, float sample_hz) {
     ctx->accel_threshold_g = 2.8f;      // 3.5g → 2.8g (적당히 완화)
     ctx->angle_threshold_deg = 50.0f;   // 50° → 40° (적당히 완화)
 
+    // 낙상 단계별 샘플 수 (창 전체가 원시 링에 들어가도록 충격 전 구간을 줄임)
+    ctx->sample_hz = sample_hz;
+    ctx->window_post_samples = ms_to_samples(sample_hz, WINDOW_POST_MS);
+    ctx->window_pre_samples = ms_to_samples(sample_hz, WINDOW_PRE_MS);
+    if (ctx->window_post_samples > STEP_FALL_HIST_LEN / 2) {
+        ctx->window_post_samples = STEP_FALL_HIST_LEN / 2;
+    }
+    if (ctx->window_pre_samples + ctx->window_post_samples + 1 > STEP_FALL_HIST_LEN) {
+        ctx->window_pre_samples = STEP_FALL_HIST_LEN - ctx->window_post_samples - 1;
+    }
+    ctx->free_fall_min_samples = ms_to_samples(sample_hz, FREE_FALL_MIN_MS);
+    ctx->impact_wait_samples = ms_to_samples(sample_hz, IMPACT_WAIT_MS);
+    ctx->post_settle_samples = ms_to_samples(sample_hz, POST_SETTLE_MS);
+
     // 초기 상태 설정
     ctx->fall_detected = false;
     ctx->fall_reset_time_ms = 0;
+    ctx->phase = FALL_PHASE_IDLE;
     
-    ESP_LOGI(TAG, "엄격한 이벤트 기반 낙상 감지 알고리즘 초기화 완료 (샘플링: %.1f Hz)", sample_hz);
-    ESP_LOGI(TAG, "낙상 조건: 1)매우큰충격≥5.0g OR 2)강한충격≥4.0g+기울기≥30° OR 3)충격≥3.0g+기울기≥45°");
-    ESP_LOGI(TAG, "쿨다운: 10초간 재감지 방지");
+    ESP_LOGI(TAG, "다단계 낙상 감지 초기화 완료 (샘플링: %.1f Hz)", sample_hz);
+    ESP_LOGI(TAG, "낙상 단계: 자유낙하(|a|<%.1fg, ≥%dms) → 충격(≥%.1fg, 자유낙하 없으면 ≥%.1fg) → %dms 후 정지/자세변화 판정",
+             FREE_FALL_G, FREE_FALL_MIN_MS, IMPACT_AFTER_FF_G, IMPACT_ONLY_G, WINDOW_POST_MS);
+    ESP_LOGI(TAG, "쿨다운: 확정 후 %d초간 재감지 방지", FALL_COOLDOWN_MS / 1000);
     ESP_LOGI(TAG, "걸음 수 감지: dyn_k=%.1f, 간격=%dms, 자이로게이트=%.0fdps", 
              ctx->dyn_k, (int)ctx->step_min_interval_ms, ctx->gyro_gate_dps);
 }
 
 /**
- * @brief 중력 추정 (1차 LPF 사용)
+ * @brief 샘플 스케일 변환 및 자세 갱신 (샘플마다 한 번, 감지 함수보다 먼저)
  * @param ctx 컨텍스트
- * @param ax_g, ay_g, az_g 가속도 값 (g 단위)
+ * @param ax_raw, ay_raw, az_raw 가속도 원시값 (LSB)
+ * @param gx_raw, gy_raw, gz_raw 자이로 원시값 (LSB)
  */
-static void estimate_gravity(step_fall_ctx_t* ctx, float ax_g, float ay_g, float az_g) {
-    // 1차 LPF로 중력 추정 (정지/저주파 추정)
-    ctx->g_est_x = (1 - ctx->lpf_a) * ctx->g_est_x + ctx->lpf_a * ax_g;
-    ctx->g_est_y = (1 - ctx->lpf_a) * ctx->g_est_y + ctx->lpf_a * ay_g;
-    ctx->g_est_z = (1 - ctx->lpf_a) * ctx->g_est_z + ctx->lpf_a * az_g;
+void step_fall_update(step_fall_ctx_t* ctx,
+                      int16_t ax_raw, int16_t ay_raw, int16_t az_raw,
+                      int16_t gx_raw, int16_t gy_raw, int16_t gz_raw) {
+    if (ctx == NULL) return;
+
+    ctx->acc_g[0] = ax_raw / ACC_LSB_PER_G;
+    ctx->acc_g[1] = ay_raw / ACC_LSB_PER_G;
+    ctx->acc_g[2] = az_raw / ACC_LSB_PER_G;
+    ctx->gyro_dps[0] = gx_raw / GYRO_LSB_PER_DPS;
+    ctx->gyro_dps[1] = gy_raw / GYRO_LSB_PER_DPS;
+    ctx->gyro_dps[2] = gz_raw / GYRO_LSB_PER_DPS;
+
+    int16_t *h = ctx->raw_hist[ctx->raw_head % STEP_FALL_HIST_LEN];
+    h[0] = ax_raw;
+    h[1] = ay_raw;
+    h[2] = az_raw;
+    h[3] = gx_raw;
+    h[4] = gy_raw;
+    h[5] = gz_raw;
+    ctx->raw_head++;
+
+    orientation_update(&ctx->orient, ctx->acc_g, ctx->gyro_dps);
 }
 
 /**
- * @brief 걸음 수 감지 (기존 로직 유지)
+ * @brief 걸음 수 감지 (step_fall_update로 갱신된 샘플 사용)
  * @param ctx 컨텍스트
- * @param ax_raw, ay_raw, az_raw 가속도 원시값 (LSB)
- * @param gx_raw, gy_raw, gz_raw 자이로 원시값 (LSB)
  * @param now_ms 현재 시간 (ms)
  * @return true: 스텝 감지됨, false: 스텝 아님
  */
-bool step_fall_detect_step(step_fall_ctx_t* ctx,
-                           int16_t ax_raw, int16_t ay_raw, int16_t az_raw,
-                           int16_t gx_raw, int16_t gy_raw, int16_t gz_raw,
-                           uint32_t now_ms) {
+bool step_fall_detect_step(step_fall_ctx_t* ctx, uint32_t now_ms) {
     if (ctx == NULL) return false;
 
-    // 스케일 변환
-    float ax_g = ax_raw / ACC_LSB_PER_G;
-    float ay_g = ay_raw / ACC_LSB_PER_G;
-    float az_g = az_raw / ACC_LSB_PER_G;
-    float gx_dps = gx_raw / GYRO_LSB_PER_DPS;
-    float gy_dps = gy_raw / GYRO_LSB_PER_DPS;
-    float gz_dps = gz_raw / GYRO_LSB_PER_DPS;
-
-    // 중력 추정 갱신
-    estimate_gravity(ctx, ax_g, ay_g, az_g);
+    float ax_g = ctx->acc_g[0];
+    float ay_g = ctx->acc_g[1];
+    float az_g = ctx->acc_g[2];
+    float gx_dps = ctx->gyro_dps[0];
+    float gy_dps = ctx->gyro_dps[1];
 
-    // ===== 팔목 착용 XY축 전용 스텝 검출 (기존 로직 유지) =====
+    // ===== 팔목 착용 XY축 전용 스텝 검출 =====
     
-    // 1. XY축만 사용 (Z축 완전 제외)
-    float lx = ax_g - ctx->g_est_x;  // X축 움직임
-    float ly = ay_g - ctx->g_est_y;  // Y축 움직임  
+    // 1. XY축만 사용 (Z축 완전 제외) - 자세 추정으로 중력을 뺀 선형 가속도
+    float lx = ctx->orient.linear_g[0];  // X축 움직임
+    float ly = ctx->orient.linear_g[1];  // Y축 움직임  
     
     // XY축만의 선형 가속도 (걷기의 주요 신호)
     float xy_motion = sqrtf(lx * lx + ly * ly);
@@ -203,7 +248,7 @@ bool step_fall_detect_step(step_fall_ctx_t* ctx,
     if (!above && sufficient_xy_motion && xy_gyro_ok && min_xy_activity) {
         above = true;
         peak_value = walk_signal;
-        ESP_LOGD(TAG, "스텝 후보 시작 (XY신호: %.3f, XY움직임: %.3f, XY변화: %.3f, XY자이로: %.1f)", 
+        DLOGD(TAG, "스텝 후보 시작 (XY신호: %.3f, XY움직임: %.3f, XY변화: %.3f, XY자이로: %.1f)", 
                  walk_signal, xy_motion, xy_delta, xy_gyro);
     } else if (above) {
         // 피크 값 업데이트
@@ -227,11 +272,11 @@ bool step_fall_detect_step(step_fall_ctx_t* ctx,
                 
                 if (valid_xy_step) {
                     ctx->last_step_ms = now_ms;
-                    ESP_LOGI(TAG, "스텝 감지! (XY신호: %.3f, XY움직임: %.3f, XY변화: %.3f, 피크: %.3f)", 
+                    DLOGI(TAG, "스텝 감지! (XY신호: %.3f, XY움직임: %.3f, XY변화: %.3f, 피크: %.3f)", 
                              walk_signal, xy_motion, xy_delta, peak_magnitude);
                     return true;
                 } else {
-                    ESP_LOGD(TAG, "스텝 후보 무효 (피크: %.3f, XY움직임: %.3f, XY변화: %.3f)", 
+                    DLOGD(TAG, "스텝 후보 무효 (피크: %.3f, XY움직임: %.3f, XY변화: %.3f)", 
                              peak_magnitude, xy_motion, xy_delta);
                 }
             }
@@ -248,111 +293,198 @@ bool step_fall_detect_step(step_fall_ctx_t* ctx,
     return false;
 }
 
+static void fall_set_phase(step_fall_ctx_t* ctx, fall_phase_t phase) {
+    ctx->phase = phase;
+    ctx->phase_samples = 0;
+}
+
+// 후보 시작: 충격 후에는 기준 자세가 누운 자세로 따라가므로 낙상 전 자세를 따로 보관
+static void fall_begin_candidate(step_fall_ctx_t* ctx) {
+    memcpy(ctx->pre_gravity, ctx->orient.baseline, sizeof(ctx->pre_gravity));
+}
+
+static void fall_enter_post_impact(step_fall_ctx_t* ctx, float linear_sq) {
+    fall_set_phase(ctx, FALL_PHASE_POST_IMPACT);
+    ctx->impact_peak_sq = linear_sq;
+    ctx->post_gyro_sq_sum = 0.0f;
+    ctx->post_acc_dev_sum = 0.0f;
+    ctx->post_count = 0;
+}
+
+/**
+ * @brief 충격 후 관찰이 끝난 후보 판정 (충격 + WINDOW_POST_MS 샘플에서 한 번)
+ *
+ * 정지해 있고(자이로/가속도 변화가 작음) 자유낙하가 있었거나 자세가 45° 이상 바뀌었으면 확정.
+ * 각도와 방향은 여기서만 계산한다.
+ */
+static void fall_decide(step_fall_ctx_t* ctx, fall_result_t* result, uint32_t now_ms) {
+    float n = ctx->post_count > 0 ? (float)ctx->post_count : 1.0f;
+    float gyro_rms = sqrtf(ctx->post_gyro_sq_sum / n);
+    float acc_dev = ctx->post_acc_dev_sum / n;
+    const float *g = ctx->orient.gravity;
+    const float *b = ctx->pre_gravity;
+    float tilt_cos = g[0] * b[0] + g[1] * b[1] + g[2] * b[2];
+
+    bool still = gyro_rms < POST_GYRO_RMS_DPS && acc_dev < POST_ACC_DEV;
+    bool tilted = tilt_cos <= LARGE_TILT_COS;
+    bool free_fall = ctx->free_fall_samples >= ctx->free_fall_min_samples;
+    bool confirmed = still && (tilted || free_fall);
+
+    float roll_deg = calculate_roll_angle(g[0], g[1], g[2]) - calculate_roll_angle(b[0], b[1], b[2]);
+    float pitch_deg = calculate_pitch_angle(g[0], g[1], g[2]) - calculate_pitch_angle(b[0], b[1], b[2]);
+
+    result->window_ready = true;
+    result->fall_detected = confirmed;
+    result->ax_g = ctx->acc_g[0];
+    result->ay_g = ctx->acc_g[1];
+    result->roll_deg = roll_deg;
+    result->pitch_deg = pitch_deg;
+    result->fall_angle_deg = atan2f(roll_deg, pitch_deg) * 180.0f / M_PI;
+    result->direction = determine_fall_direction(roll_deg, pitch_deg);
+    result->impact_g = sqrtf(ctx->impact_peak_sq);
+    result->tilt_deg = acosf(clampf(tilt_cos, -1.0f, 1.0f)) * 180.0f / M_PI;
+    result->post_gyro_rms_dps = gyro_rms;
+    result->free_fall_ms = free_fall ? (uint16_t)(ctx->free_fall_samples * 1000.0f / ctx->sample_hz) : 0;
+    result->impact_age_samples = (uint16_t)ctx->phase_samples;
+
+    if (!still) {
+        result->reason = "moving_after_impact";
+    } else if (!confirmed) {
+        result->reason = "no_free_fall_no_tilt";
+    } else if (free_fall && tilted) {
+        result->reason = "free_fall_impact_tilt_still";
+    } else if (free_fall) {
+        result->reason = "free_fall_impact_still";
+    } else {
+        result->reason = "impact_tilt_still";
+    }
+
+    if (!confirmed) {
+        ESP_LOGI(TAG, "낙상 후보 기각 [%s] 충격=%.2fg 자유낙하=%ums 기울기=%.1f° 자이로RMS=%.1fdps 가속도편차=%.2f",
+                 result->reason, result->impact_g, result->free_fall_ms, result->tilt_deg, gyro_rms, acc_dev);
+        return;
+    }
+
+    ctx->last_fall_ms = now_ms;
+
+    // 방향 문자열 변환
+    const char* dir_str[] = {
+        "없음", "앞", "뒤", "좌", "우", 
+        "앞-좌", "앞-우", "뒤-좌", "뒤-우"
+    };
+
+    ESP_LOGW(TAG, "🚨 낙상 확정 [%s] 🚨", result->reason);
+    ESP_LOGW(TAG, "자유낙하: %ums, 충격: 선형가속도=%.2fg", result->free_fall_ms, result->impact_g);
+    ESP_LOGW(TAG, "충격 후: 자이로RMS=%.1fdps 가속도편차=%.2f, 낙상전자세대비 기울기=%.1f°",
+             gyro_rms, acc_dev, result->tilt_deg);
+    ESP_LOGW(TAG, "낙상 방향: %s (각도: %.1f°)", dir_str[result->direction], result->fall_angle_deg);
+    ESP_LOGW(TAG, "⚠️  %d초간 재감지 방지 ⚠️", FALL_COOLDOWN_MS / 1000);
+    ESP_LOGW(TAG, "=======================================");
+}
+
 /**
- * @brief 논문 기반 낙상 감지 및 방향 판단
+ * @brief 다단계 낙상 감지 (step_fall_update로 갱신된 샘플 사용)
+ *
+ * 자유낙하(|a| < 0.6g가 60ms 이상) → 0.5초 안의 충격 → 충격 후 정지/자세 변화 순으로 진행하며,
+ * 자유낙하 없이 매우 큰 충격만으로도 후보가 시작된다. 판정은 충격 2초 뒤에 내리므로 그 시점에
+ * 원시 링에 충격 전후 ±2초가 모두 들어 있다. 충격에 이른 후보는 확정/기각과 관계없이
+ * window_ready로 알린다. 샘플당 비용은 제곱 비교와 누적뿐이다.
  * @param ctx 컨텍스트
- * @param ax_raw, ay_raw, az_raw 가속도 원시값 (LSB)
- * @param gx_raw, gy_raw, gz_raw 자이로 원시값 (LSB)
  * @param now_ms 현재 시간 (ms)
- * @return 낙상 결과 구조체
+ * @return 낙상 결과 구조체 (판정 샘플에서만 window_ready)
  */
-fall_result_t step_fall_detect_fall(step_fall_ctx_t* ctx,
-                                   int16_t ax_raw, int16_t ay_raw, int16_t az_raw,
-                                   int16_t gx_raw, int16_t gy_raw, int16_t gz_raw,
-                                   uint32_t now_ms) {
+fall_result_t step_fall_detect_fall(step_fall_ctx_t* ctx, uint32_t now_ms) {
     fall_result_t result = {0};
     
     if (ctx == NULL) return result;
 
-    // 스케일 변환
-    float ax_g = ax_raw / ACC_LSB_PER_G;
-    float ay_g = ay_raw / ACC_LSB_PER_G;
-    float az_g = az_raw / ACC_LSB_PER_G;
+    const float *a = ctx->acc_g;
+    float acc_sq = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+    float linear_sq = orientation_linear_sq(&ctx->orient);
+    ctx->phase_samples++;
 
-    // Roll, Pitch 각도 계산
-    float roll_deg = calculate_roll_angle(ax_g, ay_g, az_g);
-    float pitch_deg = calculate_pitch_angle(ax_g, ay_g, az_g);
-    
-    // 결과 구조체에 기본 정보 저장
-    result.ax_g = ax_g;
-    result.ay_g = ay_g;
-    result.roll_deg = roll_deg;
-    result.pitch_deg = pitch_deg;
-    result.fall_angle_deg = atan2f(roll_deg, pitch_deg) * 180.0f / M_PI;
-    
-    // ===== 이벤트 기반 낙상 감지 (넘어지는 순간만 감지) =====
-    
-    // 최근 낙상 감지를 방지하기 위한 쿨다운 (10초)
-    if (now_ms - last_fall_time < 10000) {
-        return result;  // 쿨다운 중이면 감지 안함
-    }
-    
-    // 가속도 및 각도 조건 확인
-    bool accel_x_exceed = (fabsf(ax_g) >= ctx->accel_threshold_g);
-    bool accel_y_exceed = (fabsf(ay_g) >= ctx->accel_threshold_g);
-    bool pitch_exceed = (fabsf(pitch_deg) >= ctx->angle_threshold_deg);
-    bool roll_exceed = (fabsf(roll_deg) >= ctx->angle_threshold_deg);
-    
-    // 총 가속도 및 각도 변화 계산
-    float total_accel = sqrtf(ax_g * ax_g + ay_g * ay_g + az_g * az_g);
-    float total_angle_change = sqrtf(pitch_deg * pitch_deg + roll_deg * roll_deg);
-    
-    // 낙상 이벤트 감지 조건들 (매우 엄격하게 수정)
-    
-    // 1. 매우 큰 충격 (확실한 낙상)
-    bool extreme_impact = (total_accel >= 5.0f);  // 5.0g 이상의 매우 큰 충격
-    
-    // // 2. 충격 + 기울기 동시 발생 (실제 넘어짐)
-    // bool significant_impact = (total_accel >= 3.0f);  // 중간 정도 충격
-    // bool significant_tilt = (total_angle_change >= 45.0f);  // 중간 정도 기울기
-    // bool impact_with_tilt = significant_impact && significant_tilt;
-    
-    // 3. 강한 충격 + 매우 큰 기울기 동시 발생 (확실한 낙상)
-    bool strong_impact = (total_accel >= 3.3f);  // 강한 충격
-    bool very_large_tilt = (total_angle_change >= 45.0f);  // 매우 큰 기울기 (실제 낙상 수준)
-    bool strong_impact_with_tilt = strong_impact && very_large_tilt;
-    
-    // 최종 낙상 이벤트 조건: 매우 큰 충격 OR (충격 + 기울기)
-    bool fall_event = extreme_impact || strong_impact_with_tilt;
-    
-    if (fall_event) {
-        // 낙상 이벤트 감지! (한 번만 알림)
-        result.fall_detected = true;
-        result.direction = determine_fall_direction(roll_deg, pitch_deg);
-        
-        // 쿨다운 시작 (10초간 추가 감지 방지)
-        last_fall_time = now_ms;
-        
-        // 방향 문자열 변환
-        const char* dir_str[] = {
-            "없음", "앞", "뒤", "좌", "우", 
-            "앞-좌", "앞-우", "뒤-좌", "뒤-우"
-        };
-        
-        // 감지 경로 확인
-        const char* detection_path = "";
-        if (extreme_impact) {
-            detection_path = " [매우큰충격]";
-        } else if (strong_impact_with_tilt) {
-            detection_path = " [강한충격+매우큰기울기]";
-        } else {
-            detection_path = " [기타]";
-        }
-        
-        ESP_LOGW(TAG, "🚨 낙상 이벤트 감지%s 🚨", detection_path);
-        ESP_LOGW(TAG, "충격: 총가속도=%.3fg", total_accel);
-        ESP_LOGW(TAG, "기울기: 총변화=%.1f°", total_angle_change);
-        ESP_LOGW(TAG, "낙상 방향: %s (각도: %.1f°)", dir_str[result.direction], result.fall_angle_deg);
-        ESP_LOGW(TAG, "조건: 매우큰충격=%s(≥5.0g), 강한충격+매우큰기울기=%s(≥3.5g+70°)",
-                 extreme_impact ? "✓" : "✗",
-                 strong_impact_with_tilt ? "✓" : "✗");
-        ESP_LOGW(TAG, "⚠️  알림 전송 후 5초간 재감지 방지 ⚠️");
-        ESP_LOGW(TAG, "=======================================");
+    switch (ctx->phase) {
+        case FALL_PHASE_IDLE:
+            // 최근 낙상 확정 후 쿨다운 (10초)
+            if (ctx->last_fall_ms != 0 && now_ms - ctx->last_fall_ms < FALL_COOLDOWN_MS) {
+                break;
+            }
+            if (acc_sq < sqr(FREE_FALL_G)) {
+                fall_begin_candidate(ctx);
+                fall_set_phase(ctx, FALL_PHASE_FREE_FALL);
+                ctx->free_fall_samples = 1;
+            } else if (linear_sq >= sqr(IMPACT_ONLY_G)) {
+                fall_begin_candidate(ctx);
+                ctx->free_fall_samples = 0;
+                fall_enter_post_impact(ctx, linear_sq);
+                DLOGD(TAG, "낙상 후보: 충격만 %.2fg", sqrtf(linear_sq));
+            }
+            break;
+
+        case FALL_PHASE_FREE_FALL:
+            if (acc_sq < sqr(FREE_FALL_G)) {
+                if (ctx->free_fall_samples < UINT16_MAX) {
+                    ctx->free_fall_samples++;
+                }
+            } else if (ctx->free_fall_samples < ctx->free_fall_min_samples) {
+                fall_set_phase(ctx, FALL_PHASE_IDLE);
+            } else if (linear_sq >= sqr(IMPACT_AFTER_FF_G)) {
+                fall_enter_post_impact(ctx, linear_sq);
+            } else {
+                fall_set_phase(ctx, FALL_PHASE_IMPACT_WAIT);
+            }
+            break;
+
+        case FALL_PHASE_IMPACT_WAIT:
+            // 충격 없는 자유낙하(점프 후 부드러운 착지 등)는 후보로 치지 않음
+            if (linear_sq >= sqr(IMPACT_AFTER_FF_G)) {
+                DLOGD(TAG, "낙상 후보: 자유낙하 %u샘플 뒤 충격 %.2fg", ctx->free_fall_samples, sqrtf(linear_sq));
+                fall_enter_post_impact(ctx, linear_sq);
+            } else if (ctx->phase_samples >= ctx->impact_wait_samples) {
+                fall_set_phase(ctx, FALL_PHASE_IDLE);
+            }
+            break;
+
+        case FALL_PHASE_POST_IMPACT:
+            if (ctx->phase_samples <= ctx->post_settle_samples) {
+                if (linear_sq > ctx->impact_peak_sq) {
+                    ctx->impact_peak_sq = linear_sq;
+                }
+            } else {
+                const float *g = ctx->gyro_dps;
+                ctx->post_gyro_sq_sum += g[0] * g[0] + g[1] * g[1] + g[2] * g[2];
+                ctx->post_acc_dev_sum += fabsf(acc_sq - 1.0f);
+                ctx->post_count++;
+            }
+            if (ctx->phase_samples >= ctx->window_post_samples) {
+                fall_decide(ctx, &result, now_ms);
+                fall_set_phase(ctx, FALL_PHASE_IDLE);
+            }
+            break;
     }
     
     return result;
 }
 
+int step_fall_copy_window(const step_fall_ctx_t* ctx, const fall_result_t* result,
+                          int16_t (*out)[6], int max_samples, int* impact_index) {
+    if (ctx == NULL || result == NULL || !result->window_ready || out == NULL) return 0;
+
+    uint32_t count = ctx->window_pre_samples + result->impact_age_samples + 1u;
+    if (count > STEP_FALL_HIST_LEN) count = STEP_FALL_HIST_LEN;
+    if (count > ctx->raw_head) count = ctx->raw_head;
+    if (count > (uint32_t)max_samples) count = (uint32_t)max_samples;
+
+    // 뒤쪽(충격 후)을 우선 보존하고 앞쪽을 자름
+    uint32_t start = ctx->raw_head - count;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(out[i], ctx->raw_hist[(start + i) % STEP_FALL_HIST_LEN], sizeof(out[i]));
+    }
+    int idx = (int)count - 1 - (int)result->impact_age_samples;
+    if (impact_index != NULL) *impact_index = idx < 0 ? 0 : idx;
+    return (int)count;
+}
+
 /**
  * @brief 낙상 감지 쿨다운 리셋 (수동으로 재감지 활성화)
  * @param ctx 컨텍스트
@@ -362,9 +494,10 @@ void step_fall_reset_fall(step_fall_ctx_t* ctx) {
     
     ctx->fall_detected = false;
     ctx->fall_reset_time_ms = 0;
+    fall_set_phase(ctx, FALL_PHASE_IDLE);
     
     // 쿨다운 해제 (즉시 재감지 가능)
-    last_fall_time = 0;
+    ctx->last_fall_ms = 0;
     
     ESP_LOGI(TAG, "낙상 감지 쿨다운 수동 리셋 - 즉시 재감지 가능");
 }
@@ -0,0 +1,152 @@
+// orientation.c
+// Mahony 상보 필터 (자이로 + 가속도, 지자기 없음)
+
+#include "orientation.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+#define DEG_TO_RAD          ((float)M_PI / 180.0f)
+#define RAD_TO_DEG          (180.0f / (float)M_PI)
+
+#define TWO_KP              1.0f    // 정상 상태 비례 게인 x2
+#define TWO_KP_SETTLE       10.0f   // 시작 직후 (초기 자세를 모르므로 가속도에 빠르게 맞춤)
+#define TWO_KI              0.0f    // 자이로 바이어스 보정 (MPU6050 정지 바이어스가 작아 기본 비활성)
+#define SETTLE_S            1.0f
+#define ACC_TRUST_MIN_SQ    (0.7f * 0.7f)   // |a|가 0.7~1.3g일 때만 중력 보정
+#define ACC_TRUST_MAX_SQ    (1.3f * 1.3f)
+#define BASELINE_TAU_S      2.0f    // 기준 자세 시간 상수
+#define BASELINE_GYRO_DPS   30.0f   // 이보다 빠르게 회전 중이면 기준 자세를 고정
+
+float orientation_inv_sqrt(float x) {
+    float half = 0.5f * x;
+    uint32_t i;
+    float y;
+
+    memcpy(&i, &x, sizeof(i));
+    i = 0x5f375a86u - (i >> 1);
+    memcpy(&y, &i, sizeof(y));
+    y *= 1.5f - half * y * y;
+    // Newton 1회는 상대 오차 0.17%라 쿼터니언 노름이 1에서 벗어나고, 1 근처의 acos(기울기)에서
+    // 약 5°로 증폭된다. 2회면 1e-6 수준
+    return y * (1.5f - half * y * y);
+}
+
+static void update_gravity(orientation_ctx_t *ctx) {
+    const float *q = ctx->q;
+    ctx->gravity[0] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+    ctx->gravity[1] = 2.0f * (q[0] * q[1] + q[2] * q[3]);
+    ctx->gravity[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+void orientation_init(orientation_ctx_t *ctx, float sample_hz) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->dt = 1.0f / sample_hz;
+    ctx->two_kp = TWO_KP;
+    ctx->two_ki = TWO_KI;
+    ctx->baseline_a = 1.0f / (sample_hz * BASELINE_TAU_S);
+    ctx->settle_samples = (uint32_t)(sample_hz * SETTLE_S);
+    ctx->q[0] = 1.0f;
+    ctx->tilt_cos = 1.0f;
+    update_gravity(ctx);
+    memcpy(ctx->baseline, ctx->gravity, sizeof(ctx->baseline));
+}
+
+void orientation_update(orientation_ctx_t *ctx, const float acc_g[3], const float gyro_dps[3]) {
+    float *q = ctx->q;
+    float gx = gyro_dps[0] * DEG_TO_RAD;
+    float gy = gyro_dps[1] * DEG_TO_RAD;
+    float gz = gyro_dps[2] * DEG_TO_RAD;
+    bool settling = ctx->samples < ctx->settle_samples;
+
+    // 1) 가속도가 1g 근처일 때만 추정 중력과의 오차(외적)를 피드백
+    float acc_sq = acc_g[0] * acc_g[0] + acc_g[1] * acc_g[1] + acc_g[2] * acc_g[2];
+    ctx->accel_trusted = acc_sq > ACC_TRUST_MIN_SQ && acc_sq < ACC_TRUST_MAX_SQ;
+    if (ctx->accel_trusted || (settling && acc_sq > 0.0f)) {
+        float r = orientation_inv_sqrt(acc_sq);
+        float ax = acc_g[0] * r, ay = acc_g[1] * r, az = acc_g[2] * r;
+        float vx = 0.5f * ctx->gravity[0], vy = 0.5f * ctx->gravity[1], vz = 0.5f * ctx->gravity[2];
+        float ex = ay * vz - az * vy;
+        float ey = az * vx - ax * vz;
+        float ez = ax * vy - ay * vx;
+
+        if (ctx->two_ki > 0.0f && !settling) {
+            ctx->integral[0] += ctx->two_ki * ex * ctx->dt;
+            ctx->integral[1] += ctx->two_ki * ey * ctx->dt;
+            ctx->integral[2] += ctx->two_ki * ez * ctx->dt;
+            gx += ctx->integral[0];
+            gy += ctx->integral[1];
+            gz += ctx->integral[2];
+        }
+        float kp = settling ? TWO_KP_SETTLE : ctx->two_kp;
+        gx += kp * ex;
+        gy += kp * ey;
+        gz += kp * ez;
+    }
+
+    // 2) 쿼터니언 미분 적분 (1차)
+    float h = 0.5f * ctx->dt;
+    gx *= h;
+    gy *= h;
+    gz *= h;
+    float qa = q[0], qb = q[1], qc = q[2];
+    q[0] += -qb * gx - qc * gy - q[3] * gz;
+    q[1] += qa * gx + qc * gz - q[3] * gy;
+    q[2] += qa * gy - qb * gz + q[3] * gx;
+    q[3] += qa * gz + qb * gy - qc * gx;
+
+    float r = orientation_inv_sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    q[0] *= r;
+    q[1] *= r;
+    q[2] *= r;
+    q[3] *= r;
+    ctx->samples++;
+
+    // 3) 출력: 중력 방향, 선형 가속도
+    update_gravity(ctx);
+    for (int i = 0; i < 3; i++) {
+        ctx->linear_g[i] = acc_g[i] - ctx->gravity[i];
+    }
+
+    // 4) 기준 자세: 가속도가 믿을 만하고 천천히 움직일 때만 따라간다 (낙상 중에는 고정)
+    float gyro_sq = gyro_dps[0] * gyro_dps[0] + gyro_dps[1] * gyro_dps[1] + gyro_dps[2] * gyro_dps[2];
+    if (settling) {
+        memcpy(ctx->baseline, ctx->gravity, sizeof(ctx->baseline));
+    } else if (ctx->accel_trusted && gyro_sq < BASELINE_GYRO_DPS * BASELINE_GYRO_DPS) {
+        float *b = ctx->baseline;
+        for (int i = 0; i < 3; i++) {
+            b[i] += ctx->baseline_a * (ctx->gravity[i] - b[i]);
+        }
+        float rb = orientation_inv_sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+        b[0] *= rb;
+        b[1] *= rb;
+        b[2] *= rb;
+    }
+    ctx->tilt_cos = ctx->gravity[0] * ctx->baseline[0] + ctx->gravity[1] * ctx->baseline[1] +
+                    ctx->gravity[2] * ctx->baseline[2];
+}
+
+float orientation_linear_sq(const orientation_ctx_t *ctx) {
+    const float *l = ctx->linear_g;
+    return l[0] * l[0] + l[1] * l[1] + l[2] * l[2];
+}
+
+static void vector_roll_pitch(const float v[3], float *roll_deg, float *pitch_deg) {
+    *roll_deg = atan2f(v[1], sqrtf(v[0] * v[0] + v[2] * v[2])) * RAD_TO_DEG;
+    *pitch_deg = atan2f(-v[0], sqrtf(v[1] * v[1] + v[2] * v[2])) * RAD_TO_DEG;
+}
+
+void orientation_roll_pitch_deg(const orientation_ctx_t *ctx, float *roll_deg, float *pitch_deg) {
+    vector_roll_pitch(ctx->gravity, roll_deg, pitch_deg);
+}
+
+void orientation_tilt_roll_pitch_deg(const orientation_ctx_t *ctx, float *roll_deg, float *pitch_deg) {
+    float roll, pitch, base_roll, base_pitch;
+    vector_roll_pitch(ctx->gravity, &roll, &pitch);
+    vector_roll_pitch(ctx->baseline, &base_roll, &base_pitch);
+    *roll_deg = roll - base_roll;
+    *pitch_deg = pitch - base_pitch;
+}
@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "esp_err.h"
+#include "spo2_beat.h"
 
 // SpO2 의료적 기준 임계값
 #define SPO2_NORMAL_MIN 95          // 정상 범위 최소값
@@ -16,7 +18,7 @@ typedef enum {
     SPO2_STATUS_NORMAL = 0,         // 95-100%: 정상
     SPO2_STATUS_WARNING,            // 90-94%: 저산소증 주의
     SPO2_STATUS_DANGER,             // 80-89%: 저산소증 위험
-    SPO2_STATUS_SEVERE,             // 75-79%: 매우 심한 저산소증
+    SPO2_STATUS_SEVERE,             // 80% 미만: 매우 심한 저산소증
     SPO2_STATUS_INVALID             // 측정 불가 또는 비정상
 } spo2_status_t;
 
@@ -29,8 +31,16 @@ typedef struct {
     bool valid_data;       // 유효한 데이터 여부
     float signal_quality;  // 신호 품질 지표 (0.0-1.0)
     float perfusion_index; // PI 값 (혈액 순환 지표)
-    float r_ratio;         // R 비율 (SpO2 계산용)
+    float r_ratio;         // R 비율 (최근 박동 R의 중앙값)
     spo2_status_t spo2_status; // SpO2 의료적 상태
+    int64_t beat_time_us;  // 마지막 박동(주파수 영역/선택 엔진은 마지막 심박 추정) 샘플의 획득 시각 (clock_now_us)
+    int64_t spo2_time_us;  // 마지막 SpO2를 낸 박동 검출 샘플의 획득 시각 (clock_now_us)
+    bool motion_corrupted; // 움직임 잡음으로 심박/SpO2를 신뢰할 수 없음 (그동안 값은 갱신되지 않음)
+    float motion_weight;   // 움직임 잡음 제거 후 신뢰 가중치 (0.0-1.0)
+    float hr_confidence;   // 심박 추정 신뢰도 (0.0-1.0, 스펙트럼 피크 비율/박동 간격 규칙성, 시간 영역 엔진은 0)
+    float resp_rate;       // 분당 호흡수 (유효하지 않으면 0)
+    float resp_quality;    // 호흡수 품질 지표 (0.0-1.0, 기저선/진폭/간격 추정의 일치도)
+    int64_t resp_time_us;  // 마지막 호흡수 추정 샘플의 획득 시각 (clock_now_us)
 } heart_rate_data_t;
 
 /**
@@ -63,9 +73,10 @@ typedef struct {
  * @brief MAX30102 센서 데이터를 처리하여 심박수와 SpO2를 계산
  * @param red RED LED 센서 값
  * @param ir IR LED 센서 값
+ * @param t_us 샘플 획득 시각 (clock_now_us) - 박동/SpO2 시각은 처리 시점이 아니라 이 값을 기준으로 한다
  * @return 계산된 심박수 및 SpO2 데이터
  */
-heart_rate_data_t calculate_heart_rate_and_spo2(uint32_t red, uint32_t ir);
+heart_rate_data_t calculate_heart_rate_and_spo2(uint32_t red, uint32_t ir, int64_t t_us);
 
 /**
  * @brief 심박수 및 SpO2 계산기 초기화
@@ -89,6 +100,21 @@ float hr_get_latest(void);
  */
 int hr_get_latest_spo2(void);
 
+/**
+ * @brief SpO2 교정 계수 설정 후 NVS에 저장 (재부팅 후에도 유지)
+ *
+ * 기준 산소포화도계와 동시에 잰 (R, SpO2) 쌍으로 맞춘 SpO2 = a + b·R + c·R² 계수를 넣는다.
+ * 저장하지 않은 기기는 SPO2_CALIBRATION_DEFAULT를 쓴다.
+ * @param cal 교정 계수
+ * @return ESP_OK 또는 NVS 오류
+ */
+esp_err_t hr_set_spo2_calibration(const spo2_calibration_t *cal);
+
+/**
+ * @brief 현재 쓰고 있는 SpO2 교정 계수 반환
+ */
+spo2_calibration_t hr_get_spo2_calibration(void);
+
 /**
  * @brief 최근 SpO2 상태 반환
  * @return SpO2 의료적 상태
@@ -106,8 +132,23 @@ const char* hr_get_spo2_status_string(spo2_status_t status);
  * @brief 심박수 샘플 업데이트 (빠른 샘플링용)
  * @param red RED LED 센서 값
  * @param ir IR LED 센서 값
+ * @param t_us 샘플 획득 시각 (clock_now_us)
  */
-void hr_update_sample(uint32_t red, uint32_t ir);
+void hr_update_sample(uint32_t red, uint32_t ir, int64_t t_us);
+
+/**
+ * @brief 다음 PPG 샘플에 대응하는 가속도 설정 (움직임 잡음 제거 기준 신호)
+ *
+ * calculate_heart_rate_and_spo2() 직전에 같은 PPG 샘플 주기의 가속도 평균을 넣는다.
+ * 한 번도 호출하지 않으면 잡음 제거 없이 동작한다.
+ * @param ax_g, ay_g, az_g 가속도 (g)
+ */
+void hr_set_motion_reference(float ax_g, float ay_g, float az_g);
+
+/**
+ * @brief 현재 PPG가 움직임으로 오염되었는지 (심박/SpO2 출력 보류 중)
+ */
+bool hr_is_motion_corrupted(void);
 
 /**
  * @brief 현재 신호 품질 평가 반환
@@ -136,9 +177,20 @@ filtered_signal_t hr_get_filtered_signals(void);
 bool hr_validate_signal_quality(uint32_t red, uint32_t ir);
 
 /**
- * @brief LED 전류 자동 조정 (AGC - Automatic Gain Control)
- * @param current_red_dc 현재 RED DC 값
- * @param current_ir_dc 현재 IR DC 값
- * @return true if adjustment needed, false otherwise
+ * @brief LED 전류 자동 조정 (AGC - Automatic Gain Control) 요청 확인
+ *
+ * 판정은 calculate_heart_rate_and_spo2()가 샘플마다 filtered_signals의 DC로 하고, 여기서는
+ * 쌓인 요청을 꺼내기만 한다 (led_agc.h 참고). 센서 반영은 I2C 버스를 가진 쪽에서 하고
+ * 반영된 샘플부터 hr_led_current_applied()로 알려야 한다.
+ * @param ir_current, red_current 새 전류 (0.2mA 단위)
+ * @return true면 새 전류를 센서에 반영해야 함
+ */
+bool hr_auto_adjust_led_current(uint8_t *ir_current, uint8_t *red_current);
+
+/**
+ * @brief 새 LED 전류로 획득된 첫 샘플 전에 호출
+ *
+ * DC 추정을 전류 배율만큼 옮기고 필터 이력/기준 박동을 비운 뒤, 블랭킹 동안 박동/SpO2 계산을 쉰다.
+ * @param ir_current, red_current 반영된 전류 (0.2mA 단위)
  */
-bool hr_auto_adjust_led_current(uint32_t current_red_dc, uint32_t current_ir_dc);
\ No newline at end of file
+void hr_led_current_applied(uint8_t ir_current, uint8_t red_current);
\ No newline at end of file
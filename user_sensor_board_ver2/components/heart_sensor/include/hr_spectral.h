@@ -0,0 +1,104 @@
+#pragma once
+
+// 주파수 영역 심박 추정 (창 FFT) + 시간 영역 추정과의 선택 규칙
+//
+// 움직임 잡음이 제거된 IR AC를 2:1로 줄여(50Hz → 25Hz) 최근 HR_SPECTRAL_FFT_SIZE개(약 10초)를
+// 링에 모으고, 일정 샘플마다 평균 제거 + Hann 창 → radix-2 FFT → 30~200bpm 대역 파워에서 피크를 찾는다.
+//   - 피크 주파수는 양옆 빈과 포물선 보간 (빈 간격 5.9bpm → 정지 상태 오차 1bpm 안쪽)
+//   - 피크의 절반 주파수에도 피크의 40% 이상 파워가 있으면 그쪽을 기본파로 본다 (2차 고조파 오검출 방지)
+//   - 신뢰도는 피크와 대역 안 2, 3차 고조파(각 ±1빈)가 대역 전체 파워에서 차지하는 비율.
+//     잡음만 있으면 평균 0.33(최대 0.6 남짓), 맥파면 0.75 이상 (느린 심박도 고조파 파워가 빠지지 않는다)
+//   - 대역 하한은 서맥 경보(40bpm 미만)를 낼 수 있도록 40bpm 아래로 둔다. 실제 첫 빈은 창 256개에서
+//     35bpm이고, 그보다 느린 심박은 2차 고조파가 피크로 잡힌다
+// 박동 하나하나의 모양(국소 최대값)에 기대지 않으므로 관류가 낮아 피크 검출이 흔들려도 주기 성분이
+// 남아 있으면 추정이 된다. 대신 10초 창이라 심박 변화에 몇 초 늦는다.
+//
+// 타깃에서는 esp-dsp의 radix-2 FFT(dsps_fft2r_fc32, ESP32는 ae32 어셈블리 구현)를 쓰고,
+// ESP-IDF 밖(tools/dsp_bench)에서는 같은 결과를 내는 이식용 radix-2 구현으로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#define HR_SPECTRAL_DECIM       2       // 입력 2샘플 평균 → 스펙트럼 샘플 1개
+#ifdef CONFIG_HR_SPECTRAL_FFT_SIZE
+#define HR_SPECTRAL_FFT_SIZE    CONFIG_HR_SPECTRAL_FFT_SIZE     // 2의 거듭제곱 (256이면 25Hz에서 10.24초 창)
+#else
+#define HR_SPECTRAL_FFT_SIZE    256
+#endif
+#define HR_SPECTRAL_MIN_BPM     30.0f   // 기본 규칙의 서맥 임계값(40bpm)보다 낮아야 한다
+#define HR_SPECTRAL_MAX_BPM     200.0f
+#define HR_SPECTRAL_MIN_CONF    0.4f    // 이보다 낮으면 추정을 무효로 본다 (잡음만 있을 때 평균 0.33)
+
+/**
+ * @brief 심박 추정 하나 (시간 영역/주파수 영역/선택 결과 공용)
+ */
+typedef struct {
+    float bpm;
+    float confidence;       // 0.0-1.0
+    bool valid;
+} hr_estimate_t;
+
+/**
+ * @brief 최종 심박을 어느 추정에서 가져왔는지
+ */
+typedef enum {
+    HR_SOURCE_NONE = 0,     // 둘 다 믿을 수 없음 (직전 값 유지)
+    HR_SOURCE_TIME,         // 박동 간격
+    HR_SOURCE_SPECTRAL,     // 스펙트럼 피크
+    HR_SOURCE_BOTH,         // 두 추정이 일치해 신뢰도 가중 평균
+} hr_source_t;
+
+typedef struct {
+    // 파라미터 (hr_spectral_init에서 설정)
+    float fs;                           // 스펙트럼 샘플링 주파수 (입력 / HR_SPECTRAL_DECIM)
+    uint16_t update_samples;            // 추정 간격 (입력 샘플 수)
+    uint16_t bin_lo;                    // 탐색 대역 (FFT 빈 번호)
+    uint16_t bin_hi;
+    bool fft_ready;                     // FFT 계수 초기화 성공 (실패하면 추정은 항상 무효)
+
+    // 상태
+    float ring[HR_SPECTRAL_FFT_SIZE];   // 줄인 IR AC (head가 가장 오래된 샘플)
+    uint16_t head;
+    uint16_t count;
+    float decim_sum;
+    uint8_t decim_n;
+    uint16_t since_update;
+
+    float work[2 * HR_SPECTRAL_FFT_SIZE] __attribute__((aligned(16)));  // FFT 작업 버퍼 (복소 re/im 교대)
+} hr_spectral_ctx_t;
+
+/**
+ * @brief 컨텍스트 초기화 (FFT 계수/창 테이블도 처음 한 번 만든다)
+ * @param fs_hz 입력 샘플링 주파수
+ * @param update_ms 추정 간격
+ * @return FFT 계수 초기화(esp-dsp)에 실패하면 false. 이때도 hr_spectral_process()는 추정 주기마다
+ *         valid=false인 결과를 내므로 호출자는 시간 영역 추정으로 대신할 수 있다
+ */
+bool hr_spectral_init(hr_spectral_ctx_t *ctx, float fs_hz, uint32_t update_ms);
+
+/**
+ * @brief 창 비우기 (접촉이 끊겼거나 센서를 다시 붙였을 때) - 다음 추정은 창이 다시 찬 뒤
+ */
+void hr_spectral_reset(hr_spectral_ctx_t *ctx);
+
+/**
+ * @brief 입력 샘플 1개 추가, 추정 주기가 되면 스펙트럼 계산
+ * @param ir_ac 움직임 잡음을 뺀 IR AC
+ * @param out 새 추정 (반환값이 true일 때만 채워짐, 신뢰도가 낮으면 valid=false)
+ * @return 이번 샘플에서 스펙트럼을 계산했으면 true
+ */
+bool hr_spectral_process(hr_spectral_ctx_t *ctx, float ir_ac, hr_estimate_t *out);
+
+/**
+ * @brief 시간 영역/주파수 영역 추정 중 최종 심박 선택
+ *
+ *  - 둘 다 유효하고 가까우면 신뢰도 가중 평균
+ *  - 어긋나면 스펙트럼 신뢰도가 높을 때 스펙트럼 (박동 누락/중복맥 이중 검출은 간격을 2배/절반으로 만든다)
+ *  - 스펙트럼이 약하고 박동 간격이 규칙적이면 시간 영역
+ *  - 둘 다 약하면 직전 심박에 가까운 쪽, 직전 값과도 멀면 선택하지 않는다
+ * @param prev_bpm 직전 최종 심박 (없으면 0)
+ * @param bpm 선택된 심박 (HR_SOURCE_NONE이면 건드리지 않음)
+ */
+hr_source_t hr_fusion_select(const hr_estimate_t *time_est, const hr_estimate_t *spec_est, float prev_bpm,
+                             float *bpm);
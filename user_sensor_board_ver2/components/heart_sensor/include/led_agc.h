@@ -0,0 +1,75 @@
+#pragma once
+
+// MAX30102 LED 전류 자동 조정 (AGC)
+//
+// 피부색/접촉 압력에 따라 같은 전류에서도 DC가 수천~포화까지 달라지므로, 채널(IR/RED)마다
+// 전류를 따로 조정한다. ADC가 선형이므로 새 전류는 배율 하나로 한 번에 계산한다.
+//   - 포화/과다: DC가 상한을 넘으면 대역 가운데로 내린다.
+//   - 부족: DC나 맥파 진폭(|x - DC| 평균)이 모자라면 둘 다 채우는 만큼 올린다.
+//   - 절전: 진폭이 충분히 남으면 DC 하한과 진폭 목표를 지키는 가장 작은 전류까지 내린다.
+//   - 히스테리시스: 조정 목표와 다시 움직이는 기준 사이를 떼어 두어 왕복하지 않는다.
+//   - 블랭킹: 새 전류가 실제로 반영된 샘플부터 일정 시간 박동/SpO2 계산을 쉬게 하고(상위에서
+//     led_agc_is_blanking으로 확인), 그 뒤에도 DC/진폭 추정이 다시 모일 때까지 판정을 미룬다.
+// 판정 결과는 요청일 뿐이며, I2C 쓰기는 버스를 가진 획득 태스크가 하고 반영되면 led_agc_applied로
+// 알려준다. 요청이 반영되지 않으면 일정 시간 뒤 다시 판정한다.
+// ESP-IDF 의존성이 없어 호스트 벤치마크(tools/dsp_bench)에서 그대로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    LED_AGC_IR = 0,
+    LED_AGC_RED,
+    LED_AGC_CHANNELS
+} led_agc_channel_t;
+
+#define LED_AGC_MA_PER_LSB      0.2f    // LEDx_PA 1 LSB = 0.2mA
+#define LED_AGC_MIN_CURRENT     10      // 2mA
+#define LED_AGC_MAX_CURRENT     200     // 40mA
+#define LED_AGC_FULL_SCALE      262143.0f   // 18비트 ADC (펄스 폭 411µs)
+#define LED_AGC_CONTACT_PER_LSB 30.0f       // 전류 1 LSB당 DC가 이보다 낮으면 피부 없음 (착용 감지도 같은 기준)
+
+typedef struct {
+    // 파라미터 (led_agc_init에서 샘플링 주파수 기준으로 설정)
+    float ac_a;                         // 맥파 진폭 추정 EMA 알파 (~1초)
+    uint16_t blank_samples;             // 전류 반영 후 박동/SpO2를 쉬는 샘플 수
+    uint16_t hold_samples;              // 전류 반영 후 다음 판정까지 샘플 수 (블랭킹 포함)
+    uint16_t pending_timeout;           // 요청 후 반영 소식이 없으면 다시 판정하기까지 샘플 수
+
+    // 상태
+    uint8_t current[LED_AGC_CHANNELS];  // 현재 반영된 전류 (0.2mA 단위)
+    float ac_abs[LED_AGC_CHANNELS];     // |x - DC| 평균 (맥파 진폭 추정)
+    uint16_t blank;                     // 남은 블랭킹 샘플
+    uint16_t hold;                      // 다음 판정까지 남은 샘플
+    uint16_t pending;                   // 0이 아니면 요청 반영 대기 중 (남은 대기 샘플)
+    uint32_t changes;                   // 반영된 전류 변경 횟수
+} led_agc_ctx_t;
+
+/**
+ * @brief 컨텍스트 초기화
+ * @param fs_hz PPG 샘플링 주파수
+ * @param ir_current, red_current 센서에 설정되어 있는 초기 전류 (0.2mA 단위)
+ */
+void led_agc_init(led_agc_ctx_t *ctx, float fs_hz, uint8_t ir_current, uint8_t red_current);
+
+/**
+ * @brief PPG 샘플 1개마다 호출해 진폭을 추정하고 전류 변경이 필요한지 판정
+ * @param raw 원시 샘플 (IR, RED 순)
+ * @param dc 채널별 DC 추정값 (IR, RED 순)
+ * @param out 변경이 필요하면 새 전류 (IR, RED 순, 바뀌지 않는 채널은 현재 값)
+ * @return true면 out을 센서에 반영해야 함
+ */
+bool led_agc_update(led_agc_ctx_t *ctx, const float raw[LED_AGC_CHANNELS], const float dc[LED_AGC_CHANNELS],
+                    uint8_t out[LED_AGC_CHANNELS]);
+
+/**
+ * @brief 새 전류가 반영된 첫 샘플 전에 호출 (블랭킹 시작)
+ * @param current 반영된 전류 (IR, RED 순)
+ * @param gain 채널별 신호 배율 (새 전류 / 이전 전류) - 상위의 DC 추정을 같은 배율로 옮기는 데 쓴다
+ */
+void led_agc_applied(led_agc_ctx_t *ctx, const uint8_t current[LED_AGC_CHANNELS], float gain[LED_AGC_CHANNELS]);
+
+/**
+ * @brief 전류 변경 직후라 박동/SpO2 계산을 쉬어야 하는지
+ */
+bool led_agc_is_blanking(const led_agc_ctx_t *ctx);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "driver/i2c.h"
 #include "esp_err.h"
 
@@ -23,8 +24,8 @@
 #define MAX30102_REG_FIFO_CONFIG  0x08
 #define MAX30102_REG_MODE_CONFIG  0x09
 #define MAX30102_REG_SPO2_CONFIG  0x0A
-#define MAX30102_REG_LED1_PA      0x0C  // IR LED
-#define MAX30102_REG_LED2_PA      0x0D  // RED LED
+#define MAX30102_REG_LED1_PA      0x0C  // RED LED (FIFO 슬롯 1)
+#define MAX30102_REG_LED2_PA      0x0D  // IR LED (FIFO 슬롯 2)
 #define MAX30102_REG_PILOT_PA     0x10
 #define MAX30102_REG_MULTI_LED_CTRL1 0x11
 #define MAX30102_REG_MULTI_LED_CTRL2 0x12
@@ -59,6 +60,19 @@
 #define MAX30102_ADCRANGE_8192    0x02
 #define MAX30102_ADCRANGE_16384   0x03
 
+// FIFO 샘플 평균 설정값 (FIFO_CONFIG SMP_AVE[7:5] 코드, 출력률 = 샘플레이트 / 평균 수)
+#define MAX30102_SAMPLEAVG_1      0x00
+#define MAX30102_SAMPLEAVG_2      0x01
+#define MAX30102_SAMPLEAVG_4      0x02
+#define MAX30102_SAMPLEAVG_8      0x03
+#define MAX30102_SAMPLEAVG_16     0x04
+#define MAX30102_SAMPLEAVG_32     0x05
+
+#define MAX30102_FIFO_DEPTH       32
+#define MAX30102_DEFAULT_SAMPLE_PERIOD_US 20000   // 기본 설정의 FIFO 출력 주기 (200sps / 4샘플 평균 = 50Hz)
+
+#define MAX30102_DEFAULT_LED_CURRENT 60   // 기본 설정 LED 전류 (12mA, AGC 시작값)
+
 // Pulse Width 설정값
 #define MAX30102_PULSEWIDTH_69    0x00  // 13 bit
 #define MAX30102_PULSEWIDTH_118   0x01  // 14 bit
@@ -75,7 +89,7 @@ typedef struct {
     uint8_t adc_range;          // ADC 범위
     uint8_t ir_current;         // IR LED 전류 (0-255, 0.2mA 단위)
     uint8_t red_current;        // RED LED 전류 (0-255, 0.2mA 단위)
-    uint8_t sample_averaging;   // 평균화 샘플 수 (1, 2, 4, 8, 16, 32)
+    uint8_t sample_averaging;   // 평균화 코드 (MAX30102_SAMPLEAVG_*)
     bool fifo_rollover;         // FIFO 롤오버 활성화
 } max30102_config_t;
 
@@ -105,13 +119,26 @@ esp_err_t max30102_init(i2c_port_t port);
 esp_err_t max30102_init_advanced(i2c_port_t port, const max30102_config_t *config);
 
 /**
- * @brief MAX30102 FIFO에서 데이터 읽기
- * @param red 적외선 LED 데이터 포인터
+ * @brief FIFO를 비우고 가장 최근 샘플 하나만 돌려줌 (프로브처럼 최신 값만 필요한 경우)
+ * @param red 적색 LED 데이터 포인터
  * @param ir 적외선 LED 데이터 포인터
- * @return ESP_OK 성공, ESP_FAIL 실패
+ * @return ESP_OK 성공, 새 샘플이 없으면 ESP_ERR_NOT_FOUND, 버스 오류 시 I2C 오류 코드
  */
 esp_err_t max30102_read_fifo(uint32_t *red, uint32_t *ir);
 
+/**
+ * @brief FIFO에 쌓인 샘플을 WR_PTR - RD_PTR 개수만큼 한 번에 읽기
+ *
+ * 센서 클록으로 쌓인 샘플을 모두 가져오므로 폴링 주기가 흔들려도 샘플이 빠지거나 중복되지 않는다.
+ * max_samples보다 많이 쌓여 있으면 남은 샘플은 다음 호출에서 읽는다.
+ * @param red 적색 샘플 배열 (오래된 것부터)
+ * @param ir 적외선 샘플 배열 (오래된 것부터)
+ * @param max_samples 배열 크기 (MAX30102_FIFO_DEPTH면 충분)
+ * @param count 읽은 샘플 수 (새 샘플이 없으면 0)
+ * @return ESP_OK 성공 (count가 0이어도), 버스 오류 시 I2C 오류 코드
+ */
+esp_err_t max30102_read_fifo_samples(uint32_t *red, uint32_t *ir, uint8_t max_samples, uint8_t *count);
+
 /**
  * @brief MAX30102 FIFO에서 다중 샘플 읽기
  * @param fifo_data FIFO 데이터 구조체 포인터
@@ -134,6 +161,13 @@ esp_err_t max30102_check_status(void);
  */
 esp_err_t max30102_set_led_current(uint8_t ir_current, uint8_t red_current);
 
+/**
+ * @brief 저전력 shutdown 진입/해제 (MODE_CONFIG SHDN 비트, 레지스터 설정은 유지)
+ * @param shutdown true면 shutdown (LED/ADC 정지, 0.7µA)
+ * @return ESP_OK 성공, ESP_FAIL 실패
+ */
+esp_err_t max30102_set_shutdown(bool shutdown);
+
 /**
  * @brief 온도 측정 시작
  * @return ESP_OK 성공, ESP_FAIL 실패
@@ -0,0 +1,74 @@
+#pragma once
+
+// PPG 움직임 잡음 제거 (가속도 기준 NLMS 적응 필터)
+//
+// 손목이 움직이면 센서와 피부 사이 접촉/혈류가 흔들려 PPG에 걸음 주기 성분이 섞이고,
+// 이 성분은 같은 시각의 가속도와 상관이 있다. 가속도 3축의 동적 성분(중력 제거)을 기준 신호로
+// 탭 지연선을 만들고 NLMS로 PPG AC 성분에서 가속도로 설명되는 부분을 빼낸다.
+//
+// 움직임이 너무 크거나 필터가 빼낸 잡음 전력이 남은 신호보다 훨씬 크면 결과를 믿을 수 없으므로
+// motion_corrupted를 세우고, 상위(심박/SpO2 계산)는 그동안 출력을 내지 않는다.
+// ESP-IDF 의존성이 없어 호스트 벤치마크(tools/dsp_bench)에서 그대로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MA_REF_AXES     3           // 기준 신호 축 수 (가속도 X/Y/Z)
+#define MA_TAPS         8           // 축당 탭 수 (50Hz에서 160ms 지연까지 보정)
+#define MA_WEIGHTS      (MA_REF_AXES * MA_TAPS)
+
+typedef struct {
+    // 파라미터 (motion_artifact_init에서 샘플링 주파수 기준으로 설정)
+    float mu;                       // NLMS 스텝 크기 (0 < mu < 2)
+    float gravity_a;                // 축별 중력(저주파) 추정 EMA 알파
+    float power_a;                  // 움직임/잡음 전력 추정 EMA 알파 (~1초)
+    uint32_t hold_samples;          // 조건 해제 후 플래그 유지 샘플 수
+
+    // 필터 상태
+    float w[MA_WEIGHTS];            // 필터 계수 (축별 MA_TAPS개씩)
+    float x[MA_WEIGHTS];            // 기준 신호 지연선 (축별 MA_TAPS개, 최신 → 과거 순)
+    float gravity[MA_REF_AXES];     // 축별 중력 성분 (g)
+    bool gravity_ready;
+
+    // 상태 추정
+    float motion_pow;               // 동적 가속도 전력 (g^2)
+    float artifact_pow;             // 필터가 움직임 잡음으로 추정한 전력
+    float clean_pow;                // 잡음 제거 후 남은 전력
+    float rest_pow;                 // 정지 상태에서의 PPG AC 전력 (맥파 기준치, 0이면 아직 모름)
+    uint32_t hold;                  // 플래그 해제까지 남은 샘플
+    bool corrupted;
+} motion_artifact_ctx_t;
+
+/**
+ * @brief 컨텍스트 초기화
+ * @param fs_hz PPG 샘플링 주파수 (기준 신호도 이 주기로 맞춰 넣는다)
+ */
+void motion_artifact_init(motion_artifact_ctx_t *ctx, float fs_hz);
+
+/**
+ * @brief 필터 계수와 상태 추정 초기화 (센서 재부착 등)
+ */
+void motion_artifact_reset(motion_artifact_ctx_t *ctx);
+
+/**
+ * @brief PPG 샘플 1개 처리
+ * @param acc_g 이 PPG 샘플 주기에 해당하는 가속도 (g, 축별 평균)
+ * @param ppg_ac DC를 뺀 PPG 값
+ * @return 움직임 성분을 뺀 PPG AC 값
+ */
+float motion_artifact_process(motion_artifact_ctx_t *ctx, const float acc_g[MA_REF_AXES], float ppg_ac);
+
+/**
+ * @brief 현재 출력이 움직임으로 오염되었는지 (히스테리시스 적용)
+ */
+bool motion_artifact_is_corrupted(const motion_artifact_ctx_t *ctx);
+
+/**
+ * @brief 출력 신뢰 가중치 (0.0~1.0, 남은 신호 전력 / (남은 신호 + 추정 잡음))
+ */
+float motion_artifact_weight(const motion_artifact_ctx_t *ctx);
+
+/**
+ * @brief 동적 가속도 RMS (g)
+ */
+float motion_artifact_motion_rms(const motion_artifact_ctx_t *ctx);
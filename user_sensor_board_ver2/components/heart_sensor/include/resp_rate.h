@@ -0,0 +1,101 @@
+#pragma once
+
+// PPG 호흡수 추정 (호흡성 세기/진폭/주기 변동)
+//
+// 호흡은 PPG에 세 가지로 실린다:
+//   - 기저선(RIIV): 흉강 압력 변화로 정맥혈량이 바뀌어 DC가 오르내림 → IR DC EMA
+//   - 진폭(RIAV): 1회 박출량 변화로 박동 AC/DC가 변함 → 박동마다 IR 관류
+//   - 주기(RIFV): 호흡성 부정맥으로 박동 간격이 변함 → 박동 구간 길이
+// 세 신호를 50Hz에서 RESP_RATE_DECIM:1로 줄여(약 4Hz, 박동 값은 다음 박동까지 유지) 최근
+// RESP_RATE_WINDOW개(약 30초)를 링에 모으고, 추정 주기마다 신호별로 선형 추세 제거 → 정규화
+// 자기상관을 6~40회/분 지연 범위에서 계산해 첫 주기 피크(포물선 보간)를 찾는다. 피크 높이가
+// 신호별 품질(0~1)이다. 최종 값은 품질 기준을 넘고 서로 RESP_RATE_AGREE_BRPM 안에서 일치하는
+// 신호들의 품질 가중 평균이고, 품질 지표는 일치한 신호 품질의 합 / 유효 신호 수다 (유효한 신호끼리
+// 어긋나면 낮아지고, 박동 검출이 흔들려 진폭/간격이 무효면 기저선 품질이 그대로 남는다).
+// 자기상관은 지연 40개 × 창 128 × 신호 3 ≈ 1.5만 번 곱셈-덧셈이고 추정 주기(수 초)마다 한 번이다.
+// ESP-IDF 의존성이 없어 호스트 벤치마크(tools/dsp_bench)에서 그대로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#define RESP_RATE_DECIM         12      // 50Hz → 4.17Hz
+#ifdef CONFIG_HR_RESP_WINDOW
+#define RESP_RATE_WINDOW        CONFIG_HR_RESP_WINDOW   // 128이면 4.17Hz에서 30.7초 창
+#else
+#define RESP_RATE_WINDOW        128
+#endif
+#define RESP_RATE_MIN_BRPM      6.0f
+#define RESP_RATE_MAX_BRPM      40.0f
+#define RESP_RATE_MIN_QUALITY   0.3f    // 신호별/최종 품질이 이보다 낮으면 무효
+#define RESP_RATE_AGREE_BRPM    4.0f    // 신호 간 일치로 보는 차이
+
+/**
+ * @brief 호흡 변동 신호 종류
+ */
+typedef enum {
+    RESP_SIG_BASELINE = 0,  // 기저선 (RIIV)
+    RESP_SIG_AMPLITUDE,     // 박동 진폭 (RIAV)
+    RESP_SIG_INTERVAL,      // 박동 간격 (RIFV)
+    RESP_SIG_COUNT,
+} resp_signal_t;
+
+/**
+ * @brief 호흡수 추정 하나 (신호별/최종 공용)
+ */
+typedef struct {
+    float brpm;             // 분당 호흡수
+    float quality;          // 0.0-1.0
+    bool valid;
+} resp_estimate_t;
+
+typedef struct {
+    // 파라미터 (resp_rate_init에서 설정)
+    float fs;                           // 줄인 샘플링 주파수
+    uint16_t update_samples;            // 추정 간격 (줄인 샘플 수)
+    uint16_t gap_max;                   // 이보다 오래 못 쓰는 샘플이 이어지면 창을 비운다 (입력 샘플 수)
+    uint8_t lag_min;                    // 탐색 지연 범위 (40회/분 ~ 6회/분)
+    uint8_t lag_max;
+
+    // 상태
+    float ring[RESP_SIG_COUNT][RESP_RATE_WINDOW];   // head가 가장 오래된 샘플
+    uint16_t head;
+    uint16_t count;
+    float decim_sum;
+    uint8_t decim_n;
+    uint16_t gap;
+    uint16_t since_update;
+    float beat_value[RESP_SIG_COUNT];   // 마지막 박동의 진폭/간격 (기저선 칸은 쓰지 않음)
+    bool beat_seen;
+
+    resp_estimate_t signal[RESP_SIG_COUNT];     // 마지막 신호별 추정 (로그/벤치용)
+    float work[RESP_RATE_WINDOW];               // 추세 제거 작업 버퍼
+} resp_rate_ctx_t;
+
+/**
+ * @brief 컨텍스트 초기화
+ * @param fs_hz 입력(PPG) 샘플링 주파수
+ * @param update_ms 추정 간격
+ */
+void resp_rate_init(resp_rate_ctx_t *ctx, float fs_hz, uint32_t update_ms);
+
+/**
+ * @brief 창 비우기 (접촉이 끊겼거나 LED 전류가 바뀌어 기저선이 계단으로 움직였을 때)
+ */
+void resp_rate_reset(resp_rate_ctx_t *ctx);
+
+/**
+ * @brief 박동 하나의 특징 전달 (다음 박동까지 줄인 샘플마다 같은 값이 들어간다)
+ * @param amplitude IR 박동 AC/DC
+ * @param interval_s 박동 구간 길이 (s)
+ */
+void resp_rate_beat(resp_rate_ctx_t *ctx, float amplitude, float interval_s);
+
+/**
+ * @brief PPG 샘플 1개 추가, 추정 주기가 되면 호흡수 계산
+ * @param baseline IR DC (저역통과된 기저선)
+ * @param usable false면 샘플을 건너뛴다 (움직임, LED 블랭킹 등 - 오래 이어지면 창을 비움)
+ * @param out 새 추정 (반환값이 true일 때만 채워짐, 품질이 낮으면 valid=false)
+ * @return 이번 샘플에서 호흡수를 계산했으면 true
+ */
+bool resp_rate_sample(resp_rate_ctx_t *ctx, float baseline, bool usable, resp_estimate_t *out);
@@ -0,0 +1,97 @@
+#pragma once
+
+// 박동 단위 SpO2 (ratio-of-ratios)
+//
+// 검출된 박동 사이 구간마다 RED/IR 원시값의 최대/최소(위치 포함)/합만 누적하고(샘플당 비교 4번, 덧셈 2번),
+// 박동이 끝나면 채널별 AC(구간 양 끝을 잇는 기준선을 뺀 최대 - 최소)와 국소 DC(구간 평균)로
+//     R = (AC_red / DC_red) / (AC_ir / DC_ir)
+// 를 한 번 계산한다. 움직임/LED 블랭킹/접촉 끊김이 섞인 구간, 길이가 심박 범위를 벗어난 구간,
+// 관류나 R이 생리적 범위를 벗어난 구간은 버린다. 최근 SPO2_BEAT_HISTORY개 박동 R의 중앙값을
+// 교정 곡선 SpO2 = a + b·R + c·R²에 넣고, 결과는 0~100으로만 자른다 (하한 없음).
+// ESP-IDF 의존성이 없어 호스트 벤치마크(tools/dsp_bench)에서 그대로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SPO2_BEAT_HISTORY       8       // 중앙값을 내는 최근 박동 수
+#define SPO2_BEAT_MIN_BEATS     5       // 이만큼 유효 박동이 쌓여야 출력
+
+/**
+ * @brief 교정 계수 (SpO2 = a + b·R + c·R²), 기기별로 NVS에 저장
+ */
+typedef struct {
+    float a;
+    float b;
+    float c;
+} spo2_calibration_t;
+
+// 교정 전 기본값: 경험식 110 - 25R (sensor_backend 합성 신호원도 같은 관계로 만든다)
+#define SPO2_CALIBRATION_DEFAULT    { 110.0f, -25.0f, 0.0f }
+
+typedef struct {
+    // 파라미터 (spo2_beat_init에서 샘플링 주파수 기준으로 설정)
+    float fs;
+    uint16_t min_samples_floor;         // 박동 구간 최소/최대 길이 (200bpm / 40bpm)
+    uint16_t max_samples;
+    uint16_t min_samples;               // 현재 최소 길이 (spo2_beat_set_rate로 심박 주기에 맞춤)
+
+    // 현재 박동 구간 (0: RED, 1: IR)
+    float max[2];
+    float min[2];
+    uint16_t imax[2];                   // 구간 시작부터의 위치
+    uint16_t imin[2];
+    float first[2];
+    float last[2];
+    float sum[2];
+    uint16_t n;
+    bool clean;                         // 구간 전체가 쓸 수 있는 샘플이었는지
+
+    // 최근 박동 R
+    float r[SPO2_BEAT_HISTORY];
+    uint8_t head;
+    uint8_t count;
+    uint32_t accepted;
+    uint32_t rejected;
+
+    // 마지막으로 받아들인 박동 (accepted가 늘었을 때만 새 값 - 호흡수 추정 입력)
+    float beat_perfusion;               // IR AC/DC
+    float beat_seconds;                 // 구간 길이
+} spo2_beat_ctx_t;
+
+/**
+ * @brief 컨텍스트 초기화
+ * @param fs_hz PPG 샘플링 주파수
+ */
+void spo2_beat_init(spo2_beat_ctx_t *ctx, float fs_hz);
+
+/**
+ * @brief 박동 이력과 현재 구간 비우기 (접촉이 끊겼을 때)
+ */
+void spo2_beat_reset(spo2_beat_ctx_t *ctx);
+
+/**
+ * @brief 현재 심박을 알려 박동 구간 최소 길이를 주기의 70%로 맞춤 (0이면 200bpm 기준으로 되돌림)
+ *
+ * 피크 검출기가 한 박동에서 여러 번 검출하면 구간이 박동의 일부만 덮어 AC가 작게 잡힌다.
+ */
+void spo2_beat_set_rate(spo2_beat_ctx_t *ctx, float bpm);
+
+/**
+ * @brief PPG 샘플 1개 누적
+ * @param usable false면 이번 박동 구간을 버린다 (움직임 오염, LED 블랭킹 등)
+ */
+void spo2_beat_sample(spo2_beat_ctx_t *ctx, float red, float ir, bool usable);
+
+/**
+ * @brief 박동 검출 시점에 호출 - 지난 구간으로 R을 계산하고 새 구간 시작
+ *
+ * 구간이 최소 길이보다 짧으면 같은 박동 안의 중복 검출로 보고 구간을 이어 간다.
+ * @param r_median 유효 박동이 충분하면 최근 박동 R의 중앙값
+ * @return r_median을 새로 채웠으면 true
+ */
+bool spo2_beat_end(spo2_beat_ctx_t *ctx, float *r_median);
+
+/**
+ * @brief 교정 곡선으로 R → SpO2 (%), 0~100으로 자름
+ */
+float spo2_from_ratio(const spo2_calibration_t *cal, float r);
@@ -1,15 +1,24 @@
 // 기존 복잡한 알고리즘 대신 Maxim PBA 방식으로 교체
 #include "heart_rate_calculator.h"
+#include "motion_artifact.h"
+#include "led_agc.h"
+#include "hr_spectral.h"
+#include "spo2_beat.h"
+#include "resp_rate.h"
+#include "max30102_driver.h"
 #include "esp_timer.h"
 #include "esp_log.h"
+#include "nvs.h"
+#include "sdkconfig.h"
+#define DLOG_LOCAL_LEVEL CONFIG_DLOG_LEVEL_HR_CALC
+#include "dlog.h"
 #include <math.h>
 #include <string.h>
 
 static const char *TAG = "HR_CALC";
 
 // 기본 설정값
-#define BUFFER_SIZE 1000            // 10초분 데이터 (100Hz 기준)
-#define SAMPLE_RATE_HZ 100          // 샘플링 레이트
+#define SAMPLE_RATE_HZ 50           // 샘플링 레이트 (sensor_manager MAX30102 읽기 주기 20ms)
 #define MIN_HEART_RATE 60           // 최소 심박수 (bpm)
 #define MAX_HEART_RATE 100           // 최대 심박수 (bpm)
 
@@ -28,27 +37,33 @@ static const char *TAG = "HR_CALC";
 #define SPO2_EXCELLENT_MIN 98       // 매우 좋음
 #define SPO2_GOOD_MIN 96            // 좋음
 
+// SpO2 교정 계수 저장 위치
+#define SPO2_CAL_NVS_NAMESPACE "spo2_cal"
+#define SPO2_CAL_NVS_KEY "cal"
+
 // 필터 계수
 #define ALPHA_DC 0.95f              // DC 성분 필터 계수
 #define ALPHA_AC 0.05f              // AC 성분 필터 계수
+#define ALPHA_AC_POWER 0.02f        // AC 파워(RMS²) 지수 평균 계수 (약 1초)
+
+// 호흡수 추정 간격
+#define RESP_UPDATE_MS 5000
+
+// 주파수 영역/선택 엔진의 박동 간격 추정 (CONFIG_HR_ENGINE_TIME이 아닐 때)
+#define TIME_EST_INTERVALS 8        // 최근 박동 간격 수
+#define TIME_EST_MIN_INTERVALS 4
+#define TIME_EST_MAD_SCALE 4.0f     // 신뢰도 = 1 - 배율 × (간격 MAD / 중앙값)
 
 // FIR 필터 계수 (DC 제거용)
 #define FIR_ORDER 5
 static const float fir_coeffs[FIR_ORDER] = {-0.2, -0.1, 0.0, 0.1, 0.2}; // High-pass filter
 
-// 순환 버퍼
+// 샘플 진행 상태 (지난 샘플은 저장하지 않는다: DC/AC는 지수 평균, FIR은 ir_clean_hist, 박동 구간은
+// spo2_beat, 스펙트럼/호흡 창은 각 추정기가 줄인 샘플로 필요한 만큼만 가진다)
 static struct {
-    uint32_t red_raw[BUFFER_SIZE];
-    uint32_t ir_raw[BUFFER_SIZE];
-    float red_filtered[BUFFER_SIZE];
-    float ir_filtered[BUFFER_SIZE];
-    float red_dc[BUFFER_SIZE];
-    float ir_dc[BUFFER_SIZE];
-    int64_t timestamps[BUFFER_SIZE];
-    int head;
-    int count;
+    uint32_t sample_index;   // 초기화 이후 샘플 수 (워밍업/FIR 판정)
     bool initialized;
-} signal_buffer = {0};
+} signal_state = {0};
 
 // 심박수 검출용 변수 (단순화)
 static struct {
@@ -60,13 +75,19 @@ static struct {
     // 박동 간격 관리 (단순화)
     struct {
         int64_t intervals[MAX_BEAT_INTERVALS];
-        int64_t timestamps[MAX_BEAT_INTERVALS];
         int count;
         int head;
     } beat_data;
     
     int64_t last_beat_time;
-    float r_ratio;           // SpO2 계산용 유지
+    int64_t last_spo2_time;
+    int64_t last_hr_time;    // 마지막 심박 갱신에 쓴 샘플 시각 (주파수 영역/선택 엔진)
+    float hr_confidence;     // 마지막 심박 추정 신뢰도
+    hr_source_t hr_source;
+    float r_ratio;           // 최근 박동 R의 중앙값
+    float resp_rate;         // 분당 호흡수 (유효하지 않으면 0)
+    float resp_quality;
+    int64_t last_resp_time;
     
 } heart_data = {0};
 
@@ -76,17 +97,91 @@ static signal_quality_t signal_quality = {0};
 // 필터링된 신호
 static filtered_signal_t filtered_signals = {0};
 
+// 움직임 잡음 제거 (기준 가속도는 hr_set_motion_reference로 PPG 샘플마다 갱신)
+static motion_artifact_ctx_t motion_ctx;
+static float motion_ref_g[MA_REF_AXES];
+static bool motion_ref_valid = false;
+static float ir_clean_hist[FIR_ORDER];     // 잡음 제거된 IR AC (FIR 입력, 최신이 ir_clean_head)
+static int ir_clean_head = 0;
+
+// LED 전류 AGC (요청은 hr_auto_adjust_led_current로 꺼내 간다)
+static led_agc_ctx_t agc_ctx;
+static uint8_t agc_request[LED_AGC_CHANNELS];
+static bool agc_request_pending = false;
+
+// 박동 단위 SpO2 (교정 계수는 처음 초기화할 때 NVS에서 한 번 읽고 리셋에는 유지)
+static spo2_beat_ctx_t spo2_ctx;
+static spo2_calibration_t spo2_cal = SPO2_CALIBRATION_DEFAULT;
+static bool spo2_cal_loaded = false;
+static float red_ac_power = 0.0f;
+static float ir_ac_power = 0.0f;
+
+// 호흡수 (IR DC 기저선 + 박동 단위 SpO2 구간의 진폭/길이)
+static resp_rate_ctx_t resp_ctx;
+
+#if !CONFIG_HR_ENGINE_TIME
+// 주파수 영역 추정 (움직임 잡음 제거된 IR AC를 그대로 받는다)
+static hr_spectral_ctx_t spectral_ctx;
+static bool spectral_fed = false;
+static bool spectral_ok = false;        // FFT 초기화 실패 시 false → 박동 간격 추정으로 대신
+
+// 시간 영역 추정용 실제 박동 간격 (s)
+static float beat_interval_s[TIME_EST_INTERVALS];
+static int beat_interval_head = 0;
+static int beat_interval_count = 0;
+#endif
+
+// NVS에 저장된 기기별 SpO2 교정 계수 (없으면 기본 곡선)
+static void load_spo2_calibration(void) {
+    nvs_handle_t nvs;
+    if (nvs_open(SPO2_CAL_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        ESP_LOGI(TAG, "SpO2 교정 계수 없음 - 기본값 사용 (%.1f %+.1fR %+.1fR²)",
+                 spo2_cal.a, spo2_cal.b, spo2_cal.c);
+        return;
+    }
+    spo2_calibration_t cal;
+    size_t len = sizeof(cal);
+    esp_err_t ret = nvs_get_blob(nvs, SPO2_CAL_NVS_KEY, &cal, &len);
+    nvs_close(nvs);
+    if (ret == ESP_OK && len == sizeof(cal)) {
+        spo2_cal = cal;
+        ESP_LOGI(TAG, "SpO2 교정 계수 로드: %.2f %+.2fR %+.2fR²", cal.a, cal.b, cal.c);
+    } else {
+        ESP_LOGW(TAG, "SpO2 교정 계수 읽기 실패 - 기본값 사용: %s", esp_err_to_name(ret));
+    }
+}
+
 void heart_rate_calculator_init(void) {
-    memset(&signal_buffer, 0, sizeof(signal_buffer));
+    memset(&signal_state, 0, sizeof(signal_state));
     memset(&heart_data, 0, sizeof(heart_data));
     memset(&signal_quality, 0, sizeof(signal_quality));
     memset(&filtered_signals, 0, sizeof(filtered_signals));
+    memset(ir_clean_hist, 0, sizeof(ir_clean_hist));
+    ir_clean_head = 0;
+    motion_ref_valid = false;
+    motion_artifact_init(&motion_ctx, SAMPLE_RATE_HZ);
+    led_agc_init(&agc_ctx, SAMPLE_RATE_HZ, MAX30102_DEFAULT_LED_CURRENT, MAX30102_DEFAULT_LED_CURRENT);
+    agc_request_pending = false;
+#if !CONFIG_HR_ENGINE_TIME
+    spectral_ok = hr_spectral_init(&spectral_ctx, SAMPLE_RATE_HZ, CONFIG_HR_SPECTRAL_UPDATE_MS);
+    if (!spectral_ok) {
+        ESP_LOGE(TAG, "FFT 초기화 실패 - 스펙트럼 심박 추정을 끄고 박동 간격 추정만 사용");
+    }
+    spectral_fed = false;
+    beat_interval_head = 0;
+    beat_interval_count = 0;
+#endif
+    spo2_beat_init(&spo2_ctx, SAMPLE_RATE_HZ);
+    resp_rate_init(&resp_ctx, SAMPLE_RATE_HZ, RESP_UPDATE_MS);
+    red_ac_power = 0.0f;
+    ir_ac_power = 0.0f;
+    if (!spo2_cal_loaded) {
+        load_spo2_calibration();
+        spo2_cal_loaded = true;
+    }
     
-    // SpO2 기본값을 95로 설정
-    heart_data.last_spo2 = 95;
-    
-    signal_buffer.initialized = true;
-    ESP_LOGI(TAG, "심박수 계산기 초기화 완료 (단순화된 심박수 + 완전한 SpO2)");
+    signal_state.initialized = true;
+    ESP_LOGI(TAG, "심박수 계산기 초기화 완료 (박동 단위 SpO2)");
 }
 
 void heart_rate_calculator_reset(void) {
@@ -103,53 +198,21 @@ static float calculate_dc_component(float *dc_value, float new_sample) {
     return *dc_value;
 }
 
-// 단순한 DC 계산 (심박용)
-static float calculate_simple_dc(int buffer_index) {
-    if (signal_buffer.count < 50) return 0.0f;
-    
-    float sum = 0.0f;
-    int samples = (signal_buffer.count > 200) ? 200 : signal_buffer.count;  // 2초분 평균
-    
-    for (int i = 0; i < samples; i++) {
-        int idx = (buffer_index - i + BUFFER_SIZE) % BUFFER_SIZE;
-        sum += signal_buffer.ir_raw[idx];
-    }
-    
-    return sum / samples;
-}
-
-// FIR 필터 적용 (DC 제거)
-static float apply_fir_filter(int buffer_index) {
-    if (signal_buffer.count < FIR_ORDER) return 0.0f;
+// FIR 필터 적용 (DC와 움직임 잡음이 제거된 IR AC 기준)
+static float apply_fir_filter(void) {
+    if (signal_state.sample_index < FIR_ORDER) return 0.0f;
     
     float output = 0.0f;
     
     for (int i = 0; i < FIR_ORDER; i++) {
-        int idx = (buffer_index - i + BUFFER_SIZE) % BUFFER_SIZE;
-        float dc_removed = signal_buffer.ir_raw[idx] - signal_buffer.ir_dc[idx];
-        output += fir_coeffs[i] * dc_removed;
+        int idx = (ir_clean_head - i + FIR_ORDER) % FIR_ORDER;
+        output += fir_coeffs[i] * ir_clean_hist[idx];
     }
     
     return output;
 }
 
-// RMS 값 계산 (SpO2용)
-static float calculate_rms(float *samples, int count, int buffer_size) {
-    if (count < 10) return 0.0f;
-    
-    float sum_squares = 0.0f;
-    int samples_to_use = (count > 50) ? 50 : count;
-    
-    for (int i = 0; i < samples_to_use; i++) {
-        int idx = (signal_buffer.head - 1 - i + buffer_size) % buffer_size;
-        float val = samples[idx];
-        sum_squares += val * val;
-    }
-    
-    return sqrtf(sum_squares / samples_to_use);
-}
-
-// 신호 품질 평가 (SpO2용 완전 버전 유지)
+// 신호 품질 평가 (AC RMS는 원시값 - DC의 제곱 지수 평균, 샘플당 곱셈 몇 번)
 static void evaluate_signal_quality(uint32_t red, uint32_t ir) {
     // DC 값 업데이트
     signal_quality.red_dc = filtered_signals.red_dc;
@@ -168,17 +231,12 @@ static void evaluate_signal_quality(uint32_t red, uint32_t ir) {
     }
     
     // AC RMS 값 계산
-    static float red_ac_samples[BUFFER_SIZE];
-    static float ir_ac_samples[BUFFER_SIZE];
-    
-    for (int i = 0; i < signal_buffer.count && i < BUFFER_SIZE; i++) {
-        int idx = (signal_buffer.head - 1 - i + BUFFER_SIZE) % BUFFER_SIZE;
-        red_ac_samples[i] = signal_buffer.red_filtered[idx] - signal_buffer.red_dc[idx];
-        ir_ac_samples[i] = signal_buffer.ir_filtered[idx] - signal_buffer.ir_dc[idx];
-    }
-    
-    signal_quality.red_ac_rms = calculate_rms(red_ac_samples, signal_buffer.count, BUFFER_SIZE);
-    signal_quality.ir_ac_rms = calculate_rms(ir_ac_samples, signal_buffer.count, BUFFER_SIZE);
+    float red_ac = (float)red - signal_quality.red_dc;
+    float ir_ac = (float)ir - signal_quality.ir_dc;
+    red_ac_power += ALPHA_AC_POWER * (red_ac * red_ac - red_ac_power);
+    ir_ac_power += ALPHA_AC_POWER * (ir_ac * ir_ac - ir_ac_power);
+    signal_quality.red_ac_rms = sqrtf(red_ac_power);
+    signal_quality.ir_ac_rms = sqrtf(ir_ac_power);
     
     // Perfusion Index 계산
     if (signal_quality.ir_dc > 0) {
@@ -212,14 +270,13 @@ static void evaluate_signal_quality(uint32_t red, uint32_t ir) {
 }
 
 // 개선된 심박 검출 (유효성 검사 제거, 평활화 적용)
-static bool detect_heartbeat(float ir_filtered) {
+static bool detect_heartbeat(float ir_filtered, int64_t current_time) {
     static float prev_signal = 0.0f;
     static float prev_prev_signal = 0.0f;
     static int64_t last_peak_time = 0;
     static float signal_history[10] = {0};
     static int history_idx = 0;
     
-    int64_t current_time = esp_timer_get_time();
     bool beat_detected = false;
 
     // 신호 히스토리 업데이트
@@ -253,7 +310,7 @@ static bool detect_heartbeat(float ir_filtered) {
         if (interval > 200000) {  // 0.2초 이상 간격 (300bpm 이하)
             beat_detected = true;
             last_peak_time = current_time;
-            ESP_LOGI(TAG, "❤️ 심박 검출: 피크=%.1f, 임계값=%.1f, 간격=%lldms", 
+            DLOGI(TAG, "❤️ 심박 검출: 피크=%.1f, 임계값=%.1f, 간격=%lldms", 
                     prev_signal, threshold, interval/1000);
         }
     }
@@ -265,8 +322,9 @@ static bool detect_heartbeat(float ir_filtered) {
     return beat_detected;
 }
 
+#if CONFIG_HR_ENGINE_TIME
 // 박동 간격 추가 (65-75 bpm 범위에서 자연스러운 변동 생성)
-static void add_beat_interval(int64_t interval, int64_t timestamp) {
+static void add_beat_interval(int64_t interval) {
     // 기본 타겟 심박수 (65-75 범위 내에서)
     static float base_hr = 70.0f;  // 중간값을 70으로 변경
     static int variation_counter = 0;
@@ -296,18 +354,17 @@ static void add_beat_interval(int64_t interval, int64_t timestamp) {
     int64_t final_interval = (int64_t)(target_interval * (0.7f + 0.3f * signal_factor));
     
     heart_data.beat_data.intervals[heart_data.beat_data.head] = final_interval;
-    heart_data.beat_data.timestamps[heart_data.beat_data.head] = timestamp;
     
     heart_data.beat_data.head = (heart_data.beat_data.head + 1) % MAX_BEAT_INTERVALS;
     if (heart_data.beat_data.count < MAX_BEAT_INTERVALS) {
         heart_data.beat_data.count++;
     }
     
-    ESP_LOGI(TAG, "박동: 타겟=%.2f bpm, 간격=%lldms", target_hr, final_interval/1000);
+    DLOGI(TAG, "박동: 타겟=%.2f bpm, 간격=%lldms", target_hr, final_interval/1000);
 }
 
 // 65-75 bpm 범위에서 자연스러운 변동이 있는 심박수 계산
-static void calculate_stable_heart_rate(int64_t current_time) {
+static void calculate_stable_heart_rate(void) {
     if (heart_data.beat_data.count < MIN_BEATS_FOR_CALCULATION) {
         return;
     }
@@ -334,10 +391,11 @@ static void calculate_stable_heart_rate(int64_t current_time) {
     int64_t avg_interval = weighted_sum / total_weight;
     float raw_hr = 60000000.0f / avg_interval;
     
-    // 부드러운 평활화 (이전 값의 85% + 새 값의 15%)
+    // 부드러운 평활화 (이전 값의 85% + 새 값의 15%), 움직임 잡음이 남아 있으면 새 값 반영을 줄인다
     float new_hr;
     if (heart_data.hr_valid) {
-        new_hr = SMOOTHING_FACTOR * heart_data.last_hr_bpm + (1.0f - SMOOTHING_FACTOR) * raw_hr;
+        float gain = (1.0f - SMOOTHING_FACTOR) * motion_artifact_weight(&motion_ctx);
+        new_hr = heart_data.last_hr_bpm + gain * (raw_hr - heart_data.last_hr_bpm);
     } else {
         new_hr = raw_hr;
     }
@@ -349,8 +407,116 @@ static void calculate_stable_heart_rate(int64_t current_time) {
     heart_data.last_hr_bpm = new_hr;
     heart_data.hr_valid = true;
     
-    ESP_LOGI(TAG, "심박수: %.2f bpm (원본: %.1f)", heart_data.last_hr_bpm, raw_hr);
+    DLOGI(TAG, "심박수: %.2f bpm (원본: %.1f)", heart_data.last_hr_bpm, raw_hr);
+}
+#endif
+
+#if !CONFIG_HR_ENGINE_TIME
+// 검출된 박동 간격 기록 (심박 범위를 벗어난 간격은 누락/이중 검출로 보고 버린다)
+static void record_beat_interval(int64_t interval_us) {
+    float interval_s = interval_us / 1000000.0f;
+    if (interval_s < 60.0f / HR_SPECTRAL_MAX_BPM || interval_s > 60.0f / HR_SPECTRAL_MIN_BPM) {
+        return;
+    }
+    beat_interval_s[beat_interval_head] = interval_s;
+    beat_interval_head = (beat_interval_head + 1) % TIME_EST_INTERVALS;
+    if (beat_interval_count < TIME_EST_INTERVALS) {
+        beat_interval_count++;
+    }
+}
+
+static float median_of(float *v, int n) {
+    for (int i = 1; i < n; i++) {
+        float x = v[i];
+        int j = i - 1;
+        for (; j >= 0 && v[j] > x; j--) {
+            v[j + 1] = v[j];
+        }
+        v[j + 1] = x;
+    }
+    return (n % 2) ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// 최근 박동 간격의 중앙값과 규칙성(MAD)으로 시간 영역 추정
+static void time_domain_estimate(hr_estimate_t *out) {
+    out->valid = false;
+    out->confidence = 0.0f;
+    if (beat_interval_count < TIME_EST_MIN_INTERVALS) {
+        return;
+    }
+    float v[TIME_EST_INTERVALS];
+    memcpy(v, beat_interval_s, sizeof(v[0]) * beat_interval_count);
+    float med = median_of(v, beat_interval_count);
+    for (int i = 0; i < beat_interval_count; i++) {
+        v[i] = fabsf(v[i] - med);
+    }
+    float mad = median_of(v, beat_interval_count);
+
+    out->bpm = 60.0f / med;
+    out->confidence = 1.0f - TIME_EST_MAD_SCALE * mad / med;
+    if (out->confidence < 0.0f) {
+        out->confidence = 0.0f;
+    }
+    out->valid = out->confidence > 0.0f;
+}
+
+// 스펙트럼 추정 주기마다 최종 심박 갱신 (엔진 설정에 따라 스펙트럼만 또는 선택 규칙)
+static void update_engine_heart_rate(float ir_ac, bool usable, int64_t current_time) {
+    if (!usable) {
+        // 접촉이 끊기면 창을 비운다 (움직임/LED 블랭킹 중에는 창을 유지하고 입력만 쉰다)
+        if (!signal_quality.contact_detected && spectral_fed) {
+            hr_spectral_reset(&spectral_ctx);
+            spectral_fed = false;
+        }
+        return;
+    }
+    spectral_fed = true;
+
+    hr_estimate_t spec;
+    if (!hr_spectral_process(&spectral_ctx, ir_ac, &spec)) {
+        return;
+    }
+
+    float bpm = 0.0f;
+    float confidence;
+    hr_source_t source;
+    hr_estimate_t tim;
+    if (!spectral_ok) {
+        // FFT를 쓸 수 없으면 스펙트럼 추정 주기마다 박동 간격 추정만 사용
+        time_domain_estimate(&tim);
+        source = tim.valid ? HR_SOURCE_TIME : HR_SOURCE_NONE;
+        bpm = tim.bpm;
+        confidence = tim.confidence;
+    } else {
+#if CONFIG_HR_ENGINE_SPECTRAL
+        source = spec.valid ? HR_SOURCE_SPECTRAL : HR_SOURCE_NONE;
+        bpm = spec.bpm;
+        confidence = spec.confidence;
+#else
+        time_domain_estimate(&tim);
+        source = hr_fusion_select(&tim, &spec, heart_data.hr_valid ? heart_data.last_hr_bpm : 0.0f, &bpm);
+        confidence = (source == HR_SOURCE_TIME) ? tim.confidence :
+                     (source == HR_SOURCE_BOTH) ? fmaxf(tim.confidence, spec.confidence) : spec.confidence;
+        DLOGD(TAG, "심박 추정: 박동 %.1f(%.2f) 스펙트럼 %.1f(%.2f) → %d",
+              tim.valid ? tim.bpm : 0.0f, tim.confidence, spec.bpm, spec.confidence, (int)source);
+#endif
+    }
+    if (source == HR_SOURCE_NONE) {
+        return;
+    }
+
+    // 움직임 잡음이 남아 있으면 새 값 반영을 줄인다 (스펙트럼 자체가 10초 평균이라 정지 중에는 그대로)
+    if (heart_data.hr_valid) {
+        heart_data.last_hr_bpm += motion_artifact_weight(&motion_ctx) * (bpm - heart_data.last_hr_bpm);
+    } else {
+        heart_data.last_hr_bpm = bpm;
+    }
+    heart_data.hr_valid = true;
+    heart_data.last_hr_time = current_time;
+    heart_data.hr_confidence = confidence;
+    heart_data.hr_source = source;
 }
+#endif
 
 // SpO2 상태 판단
 static spo2_status_t determine_spo2_status(int spo2_value) {
@@ -360,144 +526,173 @@ static spo2_status_t determine_spo2_status(int spo2_value) {
         return SPO2_STATUS_WARNING;
     } else if (spo2_value >= SPO2_HYPOXIA_DANGER) {
         return SPO2_STATUS_DANGER;
-    } else if (spo2_value >= SPO2_SEVERE_HYPOXIA) {
-        return SPO2_STATUS_SEVERE;
     } else {
-        return SPO2_STATUS_INVALID;
+        // 측정값에 하한을 두지 않으므로 75% 미만도 측정된 값이면 매우 심한 저산소증으로 본다
+        return SPO2_STATUS_SEVERE;
     }
 }
 
-// SpO2 계산 (의료적 기준 적용) - 수정된 버전
-static void calculate_spo2(void) {
-    if (!signal_quality.quality_good || signal_buffer.count < 500) {
-        heart_data.spo2_valid = false;
-        return;
+// 박동 검출 시점마다 지난 박동 구간으로 SpO2 갱신 (유효 박동이 모자라면 직전 값 유지)
+static void update_spo2(int64_t current_time) {
+    float r;
+    uint32_t accepted = spo2_ctx.accepted;
+    spo2_beat_set_rate(&spo2_ctx, heart_data.hr_valid ? heart_data.last_hr_bpm : 0.0f);
+    bool have_r = spo2_beat_end(&spo2_ctx, &r);
+    if (spo2_ctx.accepted != accepted) {
+        resp_rate_beat(&resp_ctx, spo2_ctx.beat_perfusion, spo2_ctx.beat_seconds);
     }
-    
-    float red_ratio = signal_quality.red_ac_rms / signal_quality.red_dc;
-    float ir_ratio = signal_quality.ir_ac_rms / signal_quality.ir_dc;
-    
-    if (ir_ratio <= 0.0f) {
-        heart_data.spo2_valid = false;
+    if (!have_r) {
         return;
     }
-    
-    heart_data.r_ratio = red_ratio / ir_ratio;
-    
-    // 데이터시트 기반 SpO2 계산 공식 적용
-    float spo2_f;
-    if (heart_data.r_ratio <= 0.7f) {
-        // 높은 SpO2 영역 (95-100%)
-        spo2_f = -45.06f * heart_data.r_ratio * heart_data.r_ratio + 30.354f * heart_data.r_ratio + 94.845f;
-    } else {
-        // 낮은 SpO2 영역 (선형 근사)
-        spo2_f = 110.0f - 25.0f * heart_data.r_ratio;
-    }
-    
-    // 의료적 기준에 맞는 유효 범위 설정
-    if (spo2_f > 100.0f) spo2_f = 100.0f;
-    if (spo2_f < 75.0f) spo2_f = 75.0f;    // 최소값을 75%로 상향 조정
-    
-    heart_data.last_spo2 = (int)(spo2_f + 0.5f);  // 반올림
-    
-    // 유효성 검증 (더 엄격한 기준)
-    if (heart_data.r_ratio >= 0.5f && heart_data.r_ratio <= 3.0f && 
-        signal_quality.perfusion_index >= MIN_PERFUSION_INDEX &&
-        heart_data.last_spo2 >= SPO2_SEVERE_HYPOXIA) {  // 75% 이상만 유효로 인정
-        
-        heart_data.spo2_valid = true;
-        
-        // 의료적 상태 분류
-        spo2_status_t status = determine_spo2_status(heart_data.last_spo2);
-        const char* status_str = hr_get_spo2_status_string(status);
-        
-        // ESP_LOGI(TAG, "SpO2: %d%% (%s) - R비율: %.3f, PI: %.2f%%", 
-        //          heart_data.last_spo2, status_str, heart_data.r_ratio, signal_quality.perfusion_index);
-        
-        // // 위험 상태일 때 경고 로그
-        // if (status >= SPO2_STATUS_WARNING) {
-        //     ESP_LOGW(TAG, "⚠️  SpO2 주의: %d%% (%s)", heart_data.last_spo2, status_str);
-        // }
-        // if (status >= SPO2_STATUS_DANGER) {
-        //     ESP_LOGE(TAG, "🚨 SpO2 위험: %d%% (%s) - 의료진 상담 필요", heart_data.last_spo2, status_str);
-        // }
-        
-    } else {
-        heart_data.spo2_valid = false;
-        ESP_LOGD(TAG, "SpO2 신뢰도 부족 - R비율: %.3f, PI: %.2f%%, 계산값: %.1f%%", 
-                 heart_data.r_ratio, signal_quality.perfusion_index, spo2_f);
-    }
+    heart_data.r_ratio = r;
+    heart_data.last_spo2 = (int)(spo2_from_ratio(&spo2_cal, r) + 0.5f);
+    heart_data.spo2_valid = true;
+    heart_data.last_spo2_time = current_time;
+    DLOGD(TAG, "SpO2: %d%% (R %.3f, 박동 %lu/%lu)", heart_data.last_spo2, r,
+          (unsigned long)spo2_ctx.accepted, (unsigned long)spo2_ctx.rejected);
 }
 
 // 샘플 업데이트 함수 (누락된 함수 구현)
-void hr_update_sample(uint32_t red, uint32_t ir) {
-    if (!signal_buffer.initialized) {
-        ESP_LOGW(TAG, "신호 버퍼가 초기화되지 않음");
+void hr_update_sample(uint32_t red, uint32_t ir, int64_t t_us) {
+    if (!signal_state.initialized) {
+        ESP_LOGW(TAG, "심박수 계산기가 초기화되지 않음");
         return;
     }
     
-    int64_t current_time = esp_timer_get_time();
+    int64_t current_time = t_us;
     
-    // 순환 버퍼에 데이터 저장
-    signal_buffer.red_raw[signal_buffer.head] = red;
-    signal_buffer.ir_raw[signal_buffer.head] = ir;
-    signal_buffer.timestamps[signal_buffer.head] = current_time;
+    // DC 성분 계산
+    calculate_dc_component(&filtered_signals.red_dc, (float)red);
+    float ir_dc = calculate_dc_component(&filtered_signals.ir_dc, (float)ir);
     
-    // DC 성분 계산 및 저장
-    signal_buffer.red_dc[signal_buffer.head] = calculate_dc_component(&filtered_signals.red_dc, (float)red);
-    signal_buffer.ir_dc[signal_buffer.head] = calculate_dc_component(&filtered_signals.ir_dc, (float)ir);
+    // 움직임 잡음 제거 (기준 가속도가 없으면 DC만 뺀 값 그대로)
+    float ir_ac = (float)ir - ir_dc;
+    if (motion_ref_valid) {
+        ir_ac = motion_artifact_process(&motion_ctx, motion_ref_g, ir_ac);
+    }
+    ir_clean_head = (ir_clean_head + 1) % FIR_ORDER;
+    ir_clean_hist[ir_clean_head] = ir_ac;
+    bool motion_corrupted = motion_artifact_is_corrupted(&motion_ctx);
+    
+    // LED 전류 판정 (DC가 대역을 벗어났거나 진폭 여유가 있으면 요청을 쌓아 둔다)
+    const float agc_raw[LED_AGC_CHANNELS] = { [LED_AGC_IR] = (float)ir, [LED_AGC_RED] = (float)red };
+    const float agc_dc[LED_AGC_CHANNELS] = { [LED_AGC_IR] = filtered_signals.ir_dc, [LED_AGC_RED] = filtered_signals.red_dc };
+    if (led_agc_update(&agc_ctx, agc_raw, agc_dc, agc_request)) {
+        agc_request_pending = true;
+    }
+    bool led_blanking = led_agc_is_blanking(&agc_ctx);
     
     // 필터링된 신호 계산 (FIR 필터 적용)
-    signal_buffer.red_filtered[signal_buffer.head] = apply_fir_filter(signal_buffer.head);
-    signal_buffer.ir_filtered[signal_buffer.head] = apply_fir_filter(signal_buffer.head);
+    float ir_filtered = apply_fir_filter();
     
     // 신호 품질 평가
     evaluate_signal_quality(red, ir);
     
-    // 심박 검출 (신호 품질이 좋을 때만)
-    if (signal_quality.quality_good && signal_buffer.count > 100) {
-        float ir_filtered = signal_buffer.ir_filtered[signal_buffer.head];
-        
-        if (detect_heartbeat(ir_filtered)) {
+    // SpO2 박동 구간 누적 (움직임/LED 블랭킹이 섞인 구간은 박동이 끝날 때 버려진다)
+    if (signal_quality.contact_detected) {
+        spo2_beat_sample(&spo2_ctx, (float)red, (float)ir, !motion_corrupted && !led_blanking);
+    } else {
+        spo2_beat_reset(&spo2_ctx);
+        heart_data.spo2_valid = false;
+    }
+    
+    // 심한 움직임 중에는 박동을 쌓지 않고, 오염 구간을 걸친 간격이 생기지 않도록 기준 박동을 버린다
+    if (motion_corrupted) {
+        heart_data.last_beat_time = 0;
+    }
+    
+    // 심박 검출 (신호 품질이 좋고 움직임 오염이 없고, LED 전류 변경 직후가 아닐 때만)
+    if (signal_quality.quality_good && signal_state.sample_index > CONFIG_HR_WARMUP_SAMPLES &&
+        !motion_corrupted && !led_blanking) {
+        if (detect_heartbeat(ir_filtered, current_time)) {
+            update_spo2(current_time);
             if (heart_data.last_beat_time > 0) {
                 int64_t interval = current_time - heart_data.last_beat_time;
-                add_beat_interval(interval, current_time);
+#if CONFIG_HR_ENGINE_TIME
+                add_beat_interval(interval);
+#else
+                record_beat_interval(interval);
+#endif
             }
             heart_data.last_beat_time = current_time;
         }
         
+#if CONFIG_HR_ENGINE_TIME
         // 안정화된 심박수 계산
-        calculate_stable_heart_rate(current_time);
+        calculate_stable_heart_rate();
+#endif
     }
     
-    // SpO2 계산 (일정 간격마다)
-    if (signal_buffer.count % 50 == 0) {  // 0.5초마다
-        calculate_spo2();
+#if !CONFIG_HR_ENGINE_TIME
+    // 스펙트럼은 품질 기준(AC 진폭)을 통과하지 못하는 낮은 관류에서도 접촉만 있으면 쌓는다
+    update_engine_heart_rate(ir_ac, signal_quality.contact_detected && !motion_corrupted && !led_blanking,
+                             current_time);
+#endif
+    
+    // 호흡수 (접촉이 끊기면 창을 비우고 값도 무효)
+    if (!signal_quality.contact_detected) {
+        resp_rate_reset(&resp_ctx);
+        heart_data.resp_rate = 0.0f;
+        heart_data.resp_quality = 0.0f;
+    } else {
+        resp_estimate_t resp;
+        if (resp_rate_sample(&resp_ctx, filtered_signals.ir_dc, !motion_corrupted && !led_blanking, &resp)) {
+            heart_data.resp_rate = resp.valid ? resp.brpm : 0.0f;
+            heart_data.resp_quality = resp.quality;
+            heart_data.last_resp_time = current_time;
+            DLOGD(TAG, "호흡수: %.1f/분 (품질 %.2f; 기저선 %.1f/%.2f 진폭 %.1f/%.2f 간격 %.1f/%.2f)",
+                  resp.brpm, resp.quality,
+                  resp_ctx.signal[RESP_SIG_BASELINE].brpm, resp_ctx.signal[RESP_SIG_BASELINE].quality,
+                  resp_ctx.signal[RESP_SIG_AMPLITUDE].brpm, resp_ctx.signal[RESP_SIG_AMPLITUDE].quality,
+                  resp_ctx.signal[RESP_SIG_INTERVAL].brpm, resp_ctx.signal[RESP_SIG_INTERVAL].quality);
+        }
     }
     
-    // 버퍼 인덱스 업데이트
-    signal_buffer.head = (signal_buffer.head + 1) % BUFFER_SIZE;
-    if (signal_buffer.count < BUFFER_SIZE) {
-        signal_buffer.count++;
+    if (signal_state.sample_index < UINT32_MAX) {
+        signal_state.sample_index++;
     }
 }
 
-heart_rate_data_t calculate_heart_rate_and_spo2(uint32_t red, uint32_t ir) {
+heart_rate_data_t calculate_heart_rate_and_spo2(uint32_t red, uint32_t ir, int64_t t_us) {
     heart_rate_data_t result = {0};
     
-    hr_update_sample(red, ir);
+    hr_update_sample(red, ir, t_us);
     
     result.heart_rate = heart_data.hr_valid ? heart_data.last_hr_bpm : 0.0f;
-    result.spo2 = hr_get_latest_spo2();  // 항상 95 이상 반환
+    result.spo2 = hr_get_latest_spo2();  // 유효하지 않으면 0
     result.valid_data = heart_data.hr_valid || heart_data.spo2_valid;
     result.signal_quality = signal_quality.quality_good ? signal_quality.perfusion_index / 10.0f : 0.0f;
     result.perfusion_index = signal_quality.perfusion_index;
     result.r_ratio = heart_data.r_ratio;
     result.spo2_status = heart_data.spo2_valid ? determine_spo2_status(heart_data.last_spo2) : SPO2_STATUS_INVALID;
+#if CONFIG_HR_ENGINE_TIME
+    result.beat_time_us = heart_data.last_beat_time;
+    result.hr_confidence = 0.0f;
+#else
+    result.beat_time_us = heart_data.last_hr_time;
+    result.hr_confidence = heart_data.hr_confidence;
+#endif
+    result.spo2_time_us = heart_data.last_spo2_time;
+    result.motion_corrupted = motion_artifact_is_corrupted(&motion_ctx);
+    result.motion_weight = motion_artifact_weight(&motion_ctx);
+    result.resp_rate = heart_data.resp_rate;
+    result.resp_quality = heart_data.resp_quality;
+    result.resp_time_us = heart_data.last_resp_time;
     
     return result;
 }
 
+void hr_set_motion_reference(float ax_g, float ay_g, float az_g) {
+    motion_ref_g[0] = ax_g;
+    motion_ref_g[1] = ay_g;
+    motion_ref_g[2] = az_g;
+    motion_ref_valid = true;
+}
+
+bool hr_is_motion_corrupted(void) {
+    return motion_artifact_is_corrupted(&motion_ctx);
+}
+
 spo2_status_t hr_get_spo2_status(void) {
     if (!heart_data.spo2_valid) {
         return SPO2_STATUS_INVALID;
@@ -526,8 +721,34 @@ float hr_get_latest(void) {
 }
 
 int hr_get_latest_spo2(void) {
-    // 항상 95 이상의 값 반환 (0 반환 방지)
-    return (heart_data.last_spo2 >= 95) ? heart_data.last_spo2 : 95;
+    return heart_data.spo2_valid ? heart_data.last_spo2 : 0;
+}
+
+esp_err_t hr_set_spo2_calibration(const spo2_calibration_t *cal) {
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(SPO2_CAL_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "SpO2 교정 NVS 열기 실패: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = nvs_set_blob(nvs, SPO2_CAL_NVS_KEY, cal, sizeof(*cal));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "SpO2 교정 계수 저장 실패: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    spo2_cal = *cal;
+    spo2_cal_loaded = true;
+    ESP_LOGI(TAG, "SpO2 교정 계수 저장: %.2f %+.2fR %+.2fR²", cal->a, cal->b, cal->c);
+    return ESP_OK;
+}
+
+spo2_calibration_t hr_get_spo2_calibration(void) {
+    return spo2_cal;
 }
 
 bool hr_is_latest_valid(void) {
@@ -542,10 +763,37 @@ filtered_signal_t hr_get_filtered_signals(void) {
     return filtered_signals;
 }
 
+// 품질은 hr_update_sample()에서 이미 평가했으므로 인자는 쓰지 않는다 (기존 API 호환)
 bool hr_validate_signal_quality(uint32_t red, uint32_t ir) {
+    (void)red;
+    (void)ir;
     return signal_quality.quality_good;
 }
 
-bool hr_auto_adjust_led_current(uint32_t current_red_dc, uint32_t current_ir_dc) {
-    return false;  // 자동 조정 기능 제거
+bool hr_auto_adjust_led_current(uint8_t *ir_current, uint8_t *red_current) {
+    if (!agc_request_pending) {
+        return false;
+    }
+    agc_request_pending = false;
+    *ir_current = agc_request[LED_AGC_IR];
+    *red_current = agc_request[LED_AGC_RED];
+    return true;
+}
+
+void hr_led_current_applied(uint8_t ir_current, uint8_t red_current) {
+    const uint8_t current[LED_AGC_CHANNELS] = { [LED_AGC_IR] = ir_current, [LED_AGC_RED] = red_current };
+    float gain[LED_AGC_CHANNELS];
+    led_agc_applied(&agc_ctx, current, gain);
+    agc_request_pending = false;
+    
+    // DC는 전류에 비례하므로 EMA를 새 수준으로 옮겨 계단 응답이 AC로 새지 않게 한다
+    filtered_signals.ir_dc *= gain[LED_AGC_IR];
+    filtered_signals.red_dc *= gain[LED_AGC_RED];
+    memset(ir_clean_hist, 0, sizeof(ir_clean_hist));
+    heart_data.last_beat_time = 0;
+    resp_rate_reset(&resp_ctx);     // 기저선이 계단으로 움직였으므로 창을 새로 채운다
+    
+    ESP_LOGI(TAG, "LED 전류 반영: IR %.1fmA, RED %.1fmA (%lu번째 변경)",
+             ir_current * LED_AGC_MA_PER_LSB, red_current * LED_AGC_MA_PER_LSB,
+             (unsigned long)agc_ctx.changes);
 }
@@ -0,0 +1,249 @@
+// hr_spectral.c
+// 창 FFT 스펙트럼 피크 기반 심박 추정과 시간 영역 추정과의 선택 규칙
+
+#include "hr_spectral.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "dsps_fft2r.h"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FFT_N                   HR_SPECTRAL_FFT_SIZE
+#define SUBHARMONIC_RATIO       0.4f    // 절반 주파수 파워가 피크의 이 비율 이상이면 기본파로 본다
+#define HARMONIC_COUNT          3       // 신뢰도에 넣는 고조파 차수 (기본파 포함)
+
+// 선택 규칙
+#define FUSION_AGREE_BPM        8.0f    // 두 추정이 이 안이면 일치로 본다
+#define FUSION_SPEC_STRONG      0.65f   // 어긋날 때 스펙트럼을 믿는 신뢰도 (잡음만 있을 때 최대 0.63)
+#define FUSION_TIME_STRONG      0.5f    // 스펙트럼이 약할 때 박동 간격을 믿는 신뢰도
+#define FUSION_CONTINUITY_BPM   15.0f   // 둘 다 약할 때 직전 심박과 이만큼 가까워야 채택
+
+static float s_window[FFT_N];           // Hann 창
+#if defined(ESP_PLATFORM)
+static float s_fft_table[FFT_N];        // esp-dsp radix-2 계수 테이블
+#else
+static float s_twiddle[FFT_N];          // cos/-sin 교대, N/2개
+#endif
+static bool s_tables_ready = false;
+
+// 창/FFT 계수 테이블 (실패하면 false, 다음 init에서 다시 시도)
+static bool tables_init(void) {
+    if (s_tables_ready) {
+        return true;
+    }
+    for (int i = 0; i < FFT_N; i++) {
+        s_window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / FFT_N);
+    }
+#if defined(ESP_PLATFORM)
+    // 다른 모듈이 먼저 초기화했다면(ESP_ERR_DSP_REINITIALIZED) 그 테이블을 그대로 쓴다
+    esp_err_t ret = dsps_fft2r_init_fc32(s_fft_table, FFT_N);
+    if (ret != ESP_OK && ret != ESP_ERR_DSP_REINITIALIZED) {
+        return false;
+    }
+#else
+    for (int k = 0; k < FFT_N / 2; k++) {
+        s_twiddle[2 * k] = cosf(2.0f * (float)M_PI * k / FFT_N);
+        s_twiddle[2 * k + 1] = -sinf(2.0f * (float)M_PI * k / FFT_N);
+    }
+#endif
+    s_tables_ready = true;
+    return true;
+}
+
+// 복소 FFT (제자리, 결과는 자연 순서)
+static void fft_forward(float *x) {
+#if defined(ESP_PLATFORM)
+    dsps_fft2r_fc32(x, FFT_N);
+    dsps_bit_rev_fc32(x, FFT_N);
+#else
+    for (int i = 1, j = 0; i < FFT_N; i++) {
+        int bit = FFT_N >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float tr = x[2 * i], ti = x[2 * i + 1];
+            x[2 * i] = x[2 * j];
+            x[2 * i + 1] = x[2 * j + 1];
+            x[2 * j] = tr;
+            x[2 * j + 1] = ti;
+        }
+    }
+    for (int len = 2; len <= FFT_N; len <<= 1) {
+        int half = len / 2;
+        int step = FFT_N / len;
+        for (int i = 0; i < FFT_N; i += len) {
+            for (int k = 0; k < half; k++) {
+                float wr = s_twiddle[2 * k * step];
+                float wi = s_twiddle[2 * k * step + 1];
+                float *a = &x[2 * (i + k)];
+                float *b = &x[2 * (i + k + half)];
+                float tr = b[0] * wr - b[1] * wi;
+                float ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+#endif
+}
+
+bool hr_spectral_init(hr_spectral_ctx_t *ctx, float fs_hz, uint32_t update_ms) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->fft_ready = tables_init();
+    ctx->fs = fs_hz / HR_SPECTRAL_DECIM;
+    ctx->update_samples = (uint16_t)(fs_hz * update_ms / 1000.0f);
+    if (ctx->update_samples < 1) {
+        ctx->update_samples = 1;
+    }
+    ctx->bin_lo = (uint16_t)ceilf(HR_SPECTRAL_MIN_BPM / 60.0f * FFT_N / ctx->fs);
+    ctx->bin_hi = (uint16_t)floorf(HR_SPECTRAL_MAX_BPM / 60.0f * FFT_N / ctx->fs);
+    return ctx->fft_ready;
+}
+
+void hr_spectral_reset(hr_spectral_ctx_t *ctx) {
+    ctx->head = 0;
+    ctx->count = 0;
+    ctx->decim_sum = 0.0f;
+    ctx->decim_n = 0;
+    ctx->since_update = 0;
+}
+
+// 링 → 창 → FFT → 대역 피크
+static void estimate(hr_spectral_ctx_t *ctx, hr_estimate_t *out) {
+    float mean = 0.0f;
+    for (int i = 0; i < FFT_N; i++) {
+        mean += ctx->ring[i];
+    }
+    mean /= FFT_N;
+
+    float *x = ctx->work;
+    for (int i = 0; i < FFT_N; i++) {
+        x[2 * i] = (ctx->ring[(ctx->head + i) % FFT_N] - mean) * s_window[i];
+        x[2 * i + 1] = 0.0f;
+    }
+    fft_forward(x);
+
+    // 파워 스펙트럼을 같은 버퍼 앞쪽에 (p[k]는 x[2k], x[2k+1]을 읽은 뒤에 쓴다)
+    float *p = x;
+    const int lo = ctx->bin_lo, hi = ctx->bin_hi;
+    for (int k = 0; k <= hi + 1; k++) {
+        float re = x[2 * k], im = x[2 * k + 1];
+        p[k] = re * re + im * im;
+    }
+
+    int peak = lo;
+    float total = 0.0f;
+    for (int k = lo; k <= hi; k++) {
+        total += p[k];
+        if (p[k] > p[peak]) {
+            peak = k;
+        }
+    }
+
+    // 2차 고조파가 기본파보다 크게 잡힌 경우 (날카로운 수축기 피크)
+    int sub = (p[peak / 2] > p[(peak + 1) / 2]) ? peak / 2 : (peak + 1) / 2;
+    if (sub >= lo && p[sub] >= SUBHARMONIC_RATIO * p[peak] && p[sub] >= p[sub - 1] && p[sub] >= p[sub + 1]) {
+        peak = sub;
+    }
+
+    // 포물선 보간
+    float a = p[peak - 1], b = p[peak], c = p[peak + 1];
+    float denom = a - 2.0f * b + c;
+    float delta = (denom < 0.0f) ? 0.5f * (a - c) / denom : 0.0f;
+    if (delta > 0.5f) delta = 0.5f;
+    if (delta < -0.5f) delta = -0.5f;
+
+    out->bpm = (peak + delta) * ctx->fs / FFT_N * 60.0f;
+
+    // 신뢰도 = 기본파와 대역 안 고조파(2, 3차) 주변 파워 / 대역 전체 파워
+    // (느린 심박은 고조파가 대역 안에 더 많이 들어오므로 기본파만 세면 신뢰도가 낮게 나온다)
+    float harmonic = a + b + c;
+    for (int h = 2; h <= HARMONIC_COUNT; h++) {
+        int k = (int)lroundf(h * (peak + delta));
+        if (k + 1 > hi) {
+            break;
+        }
+        harmonic += p[k - 1] + p[k] + p[k + 1];
+    }
+    out->confidence = (total > 0.0f) ? harmonic / total : 0.0f;
+    if (out->confidence > 1.0f) {
+        out->confidence = 1.0f;
+    }
+    out->valid = out->confidence >= HR_SPECTRAL_MIN_CONF &&
+                 out->bpm >= HR_SPECTRAL_MIN_BPM && out->bpm <= HR_SPECTRAL_MAX_BPM;
+}
+
+bool hr_spectral_process(hr_spectral_ctx_t *ctx, float ir_ac, hr_estimate_t *out) {
+    ctx->decim_sum += ir_ac;
+    if (++ctx->decim_n >= HR_SPECTRAL_DECIM) {
+        ctx->ring[ctx->head] = ctx->decim_sum / HR_SPECTRAL_DECIM;
+        ctx->head = (ctx->head + 1) % FFT_N;
+        if (ctx->count < FFT_N) {
+            ctx->count++;
+        }
+        ctx->decim_sum = 0.0f;
+        ctx->decim_n = 0;
+    }
+
+    if (ctx->since_update < ctx->update_samples) {
+        ctx->since_update++;
+    }
+    if (ctx->since_update < ctx->update_samples || (ctx->fft_ready && ctx->count < FFT_N)) {
+        return false;
+    }
+    ctx->since_update = 0;
+    if (!ctx->fft_ready) {
+        // FFT를 쓸 수 없으면 추정 주기만 알리고 결과는 항상 무효
+        memset(out, 0, sizeof(*out));
+        return true;
+    }
+    estimate(ctx, out);
+    return true;
+}
+
+hr_source_t hr_fusion_select(const hr_estimate_t *time_est, const hr_estimate_t *spec_est, float prev_bpm,
+                             float *bpm) {
+    bool tv = time_est->valid;
+    bool sv = spec_est->valid;
+
+    if (tv && sv && fabsf(time_est->bpm - spec_est->bpm) <= FUSION_AGREE_BPM) {
+        float w = time_est->confidence + spec_est->confidence;
+        *bpm = (w > 0.0f) ? (time_est->bpm * time_est->confidence + spec_est->bpm * spec_est->confidence) / w
+                          : 0.5f * (time_est->bpm + spec_est->bpm);
+        return HR_SOURCE_BOTH;
+    }
+    if (sv && spec_est->confidence >= FUSION_SPEC_STRONG) {
+        *bpm = spec_est->bpm;
+        return HR_SOURCE_SPECTRAL;
+    }
+    if (tv && time_est->confidence >= FUSION_TIME_STRONG) {
+        *bpm = time_est->bpm;
+        return HR_SOURCE_TIME;
+    }
+
+    // 둘 다 약하면 직전 심박과의 연속성으로 고른다
+    if (prev_bpm <= 0.0f) {
+        return HR_SOURCE_NONE;
+    }
+    hr_source_t src = HR_SOURCE_NONE;
+    float best = FUSION_CONTINUITY_BPM;
+    if (sv && fabsf(spec_est->bpm - prev_bpm) <= best) {
+        best = fabsf(spec_est->bpm - prev_bpm);
+        *bpm = spec_est->bpm;
+        src = HR_SOURCE_SPECTRAL;
+    }
+    if (tv && fabsf(time_est->bpm - prev_bpm) < best) {
+        *bpm = time_est->bpm;
+        src = HR_SOURCE_TIME;
+    }
+    return src;
+}
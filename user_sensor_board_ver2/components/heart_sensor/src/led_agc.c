@@ -0,0 +1,119 @@
+// led_agc.c
+// 채널별 DC 대역 + 맥파 진폭 여유 기반 LED 전류 조정
+
+#include "led_agc.h"
+#include <math.h>
+#include <string.h>
+
+// DC 기준 (ADC 카운트)
+#define DC_HIGH             200000.0f   // 76% FS - 넘으면 DC_TARGET으로 내림 (맥파 + 움직임 여유)
+#define DC_TARGET           100000.0f
+#define DC_SATURATED        (0.97f * LED_AGC_FULL_SCALE)   // 포화면 DC를 믿을 수 없어 절반으로
+#define DC_LOW              20000.0f    // MIN_DC_VALUE의 4배 - 이보다 어두우면 올림
+#define DC_KEEP             25000.0f    // 조정 후 DC 하한 (DC_LOW와 사이를 둬 바로 다시 걸리지 않게)
+
+// 맥파 진폭(|x - DC| 평균, 정현파면 RMS의 0.9배) 기준. 조정할 때는 AC_KEEP을 겨냥하고,
+// 다시 움직이는 기준(AC_RAISE/AC_SAVE)은 그 양쪽으로 멀리 둬 내리고 올리기를 반복하지 않는다.
+#define AC_RAISE            100.0f      // 미만이면 올림 (MIN_AC_AMPLITUDE 50의 두 배)
+#define AC_KEEP             200.0f
+#define AC_SAVE             400.0f      // 이상이면 여유분만큼 내림
+
+#define AC_TAU_S            1.0f
+#define BLANK_S             0.5f        // 필터 과도 응답이 박동으로 잡히지 않게 쉬는 시간
+#define HOLD_S              2.0f        // DC/진폭 추정이 새 전류에 다시 모이는 시간
+#define PENDING_TIMEOUT_S   1.0f        // 획득 태스크가 반영하지 못했으면 다시 판정
+
+static uint8_t clamp_current(float v) {
+    if (v < LED_AGC_MIN_CURRENT) return LED_AGC_MIN_CURRENT;
+    if (v > LED_AGC_MAX_CURRENT) return LED_AGC_MAX_CURRENT;
+    return (uint8_t)(v + 0.5f);
+}
+
+void led_agc_init(led_agc_ctx_t *ctx, float fs_hz, uint8_t ir_current, uint8_t red_current) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->ac_a = 1.0f / (AC_TAU_S * fs_hz);
+    ctx->blank_samples = (uint16_t)(BLANK_S * fs_hz);
+    ctx->hold_samples = (uint16_t)(HOLD_S * fs_hz);
+    ctx->pending_timeout = (uint16_t)(PENDING_TIMEOUT_S * fs_hz);
+    ctx->current[LED_AGC_IR] = ir_current;
+    ctx->current[LED_AGC_RED] = red_current;
+    // 처음에도 DC/진폭 추정이 모일 때까지 판정하지 않는다
+    ctx->hold = ctx->hold_samples;
+}
+
+// 채널 하나의 새 전류 (바꿀 필요 없으면 cur 그대로)
+static uint8_t decide(uint8_t cur, float dc, float ac_abs) {
+    if (dc >= DC_SATURATED) {
+        return clamp_current(cur * 0.5f);
+    }
+    if (dc > DC_HIGH) {
+        uint8_t next = clamp_current(cur * DC_TARGET / dc);
+        return (next < cur) ? next : (cur > LED_AGC_MIN_CURRENT ? cur - 1 : cur);
+    }
+    if (dc < LED_AGC_CONTACT_PER_LSB * cur) {     // 피부가 없으면 올려도 소용없음
+        return cur;
+    }
+
+    // 신호는 전류에 비례하므로 DC 하한과 진폭 목표를 함께 만족하는 가장 작은 배율로 한 번에 옮긴다
+    float k = DC_KEEP / dc;
+    float k_ac = AC_KEEP / (ac_abs > 1.0f ? ac_abs : 1.0f);
+    if (k_ac > k) {
+        k = k_ac;
+    }
+    if (k * dc > DC_TARGET) {
+        k = DC_TARGET / dc;             // 진폭이 모자라도 포화 여유는 남긴다
+    }
+
+    if (dc < DC_LOW || ac_abs < AC_RAISE) {
+        uint8_t next = clamp_current(cur * k);
+        return (next > cur) ? next : cur;
+    }
+    if (ac_abs >= AC_SAVE) {
+        uint8_t next = clamp_current(cur * k);
+        return (next < cur) ? next : cur;
+    }
+    return cur;
+}
+
+bool led_agc_update(led_agc_ctx_t *ctx, const float raw[LED_AGC_CHANNELS], const float dc[LED_AGC_CHANNELS],
+                    uint8_t out[LED_AGC_CHANNELS]) {
+    for (int c = 0; c < LED_AGC_CHANNELS; c++) {
+        ctx->ac_abs[c] += ctx->ac_a * (fabsf(raw[c] - dc[c]) - ctx->ac_abs[c]);
+    }
+    if (ctx->blank > 0) {
+        ctx->blank--;
+    }
+    if (ctx->pending > 0 && --ctx->pending > 0) {
+        return false;
+    }
+    if (ctx->hold > 0) {
+        ctx->hold--;
+        return false;
+    }
+
+    bool change = false;
+    for (int c = 0; c < LED_AGC_CHANNELS; c++) {
+        out[c] = decide(ctx->current[c], dc[c], ctx->ac_abs[c]);
+        change |= out[c] != ctx->current[c];
+    }
+    if (change) {
+        ctx->pending = ctx->pending_timeout;
+    }
+    return change;
+}
+
+void led_agc_applied(led_agc_ctx_t *ctx, const uint8_t current[LED_AGC_CHANNELS], float gain[LED_AGC_CHANNELS]) {
+    for (int c = 0; c < LED_AGC_CHANNELS; c++) {
+        gain[c] = (ctx->current[c] > 0) ? (float)current[c] / ctx->current[c] : 1.0f;
+        ctx->ac_abs[c] *= gain[c];
+        ctx->current[c] = current[c];
+    }
+    ctx->pending = 0;
+    ctx->blank = ctx->blank_samples;
+    ctx->hold = ctx->hold_samples;
+    ctx->changes++;
+}
+
+bool led_agc_is_blanking(const led_agc_ctx_t *ctx) {
+    return ctx->blank > 0;
+}
@@ -8,18 +8,20 @@
 
 static const char *TAG = "MAX30102_DRV";
 
+static const uint16_t sample_rate_hz[] = { 50, 100, 200, 400, 800, 1000, 1600, 3200 };   // SPO2_SR 코드별
+
 static i2c_port_t current_port = I2C_NUM_0;
 static max30102_config_t current_config;
 
 // 기본 설정값 (데이터시트 권장값)
 static const max30102_config_t default_config = {
     .led_mode = MAX30102_MODE_SPO2,
-    .sample_rate = MAX30102_SAMPLERATE_100,    // 100Hz (SpO2 권장)
+    .sample_rate = MAX30102_SAMPLERATE_200,    // 200Hz, 4샘플 평균으로 FIFO 출력 50Hz
     .pulse_width = MAX30102_PULSEWIDTH_411,    // 16bit, 411μs (노이즈에 강함)
     .adc_range = MAX30102_ADCRANGE_4096,       // 4096 nA
-    .ir_current = 60,                          // 12mA (60 * 0.2mA)
-    .red_current = 60,                         // 12mA (60 * 0.2mA)
-    .sample_averaging = 4,                     // 4 샘플 평균
+    .ir_current = MAX30102_DEFAULT_LED_CURRENT,    // 12mA (60 * 0.2mA)
+    .red_current = MAX30102_DEFAULT_LED_CURRENT,   // 12mA (60 * 0.2mA)
+    .sample_averaging = MAX30102_SAMPLEAVG_4,  // 4 샘플 평균 (SMP_AVE 코드)
     .fifo_rollover = true                      // FIFO 롤오버 활성화
 };
 
@@ -66,7 +68,7 @@ esp_err_t max30102_init_advanced(i2c_port_t port, const max30102_config_t *confi
     
     // FIFO 설정
     uint8_t fifo_config = 0x00;
-    fifo_config |= (config->sample_averaging << 5);  // SMP_AVE[2:0]
+    fifo_config |= (config->sample_averaging & 0x07) << 5;  // SMP_AVE[2:0]
     if (config->fifo_rollover) {
         fifo_config |= 0x10;  // FIFO_ROLLOVER_EN
     }
@@ -102,29 +104,67 @@ esp_err_t max30102_init_advanced(i2c_port_t port, const max30102_config_t *confi
     ret = max30102_clear_fifo();
     if (ret != ESP_OK) return ret;
     
-    ESP_LOGI(TAG, "MAX30102 초기화 완료 - 모드: %d, 샘플레이트: %dHz, LED 전류: IR=%dmA, RED=%dmA", 
-             config->led_mode, 
-             (50 << config->sample_rate),
+    ESP_LOGI(TAG, "MAX30102 초기화 완료 - 모드: %d, 샘플레이트: %dHz / %d샘플 평균, LED 전류: IR=%dmA, RED=%dmA",
+             config->led_mode,
+             sample_rate_hz[config->sample_rate & 0x07], 1 << config->sample_averaging,
              config->ir_current * 200 / 1000,  // mA 변환
              config->red_current * 200 / 1000);
     
     return ESP_OK;
 }
 
+// 샘플 하나는 RED, IR 순서로 3바이트씩 (18비트 데이터, 상위 6비트는 무시)
+static uint32_t fifo_word(const uint8_t *p) {
+    return (((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2]) & 0x3FFFF;
+}
+
+esp_err_t max30102_read_fifo_samples(uint32_t *red, uint32_t *ir, uint8_t max_samples, uint8_t *count) {
+    *count = 0;
+    uint8_t ptr[3];     // WR_PTR, OVF_CNT, RD_PTR (연속 레지스터)
+    esp_err_t ret = read_register(MAX30102_REG_FIFO_WR_PTR, ptr, sizeof(ptr));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // 샘플이 유실됐다면(OVF_CNT != 0) FIFO가 가득 찬 상태라 WR_PTR == RD_PTR이어도 32개가 남아 있다
+    // (OVF_CNT는 샘플 하나를 꺼낼 때 0으로 돌아간다)
+    uint8_t available = (ptr[0] - ptr[2]) & (MAX30102_FIFO_DEPTH - 1);
+    if (ptr[1] != 0) {
+        ESP_LOGW(TAG, "FIFO 오버플로우: %d샘플 유실", ptr[1]);
+        if (available == 0) {
+            available = MAX30102_FIFO_DEPTH;
+        }
+    }
+    uint8_t n = (available > max_samples) ? max_samples : available;
+    if (n == 0) {
+        return ESP_OK;
+    }
+
+    // FIFO_DATA는 읽을 때마다 RD_PTR이 넘어가므로 n샘플을 한 번의 burst로 읽는다
+    uint8_t data[MAX30102_FIFO_DEPTH * 6];
+    ret = read_register(MAX30102_REG_FIFO_DATA, data, (size_t)n * 6);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        red[i] = fifo_word(&data[i * 6]);
+        ir[i] = fifo_word(&data[i * 6 + 3]);
+    }
+    *count = n;
+    return ESP_OK;
+}
+
 esp_err_t max30102_read_fifo(uint32_t *red, uint32_t *ir) {
-    uint8_t data[6];
-    esp_err_t ret = read_register(MAX30102_REG_FIFO_DATA, data, 6);
+    uint32_t reds[MAX30102_FIFO_DEPTH], irs[MAX30102_FIFO_DEPTH];
+    uint8_t n;
+    esp_err_t ret = max30102_read_fifo_samples(reds, irs, MAX30102_FIFO_DEPTH, &n);
     if (ret != ESP_OK) {
         return ret;
     }
-    
-    // 18비트 데이터 추출 (상위 6비트는 무시)
-    *red = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
-    *red &= 0x3FFFF;  // 18비트 마스크
-    
-    *ir = ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 8) | data[5];
-    *ir &= 0x3FFFF;   // 18비트 마스크
-    
+    if (n == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *red = reds[n - 1];
+    *ir = irs[n - 1];
     return ESP_OK;
 }
 
@@ -144,9 +184,8 @@ uint8_t max30102_read_fifo_multi(max30102_fifo_data_t *fifo_data, uint8_t max_sa
         }
     }
     
-    // 최신 샘플만 읽기 (가장 최근 1개)
-    if (samples_to_read > 0) {
-        max30102_read_fifo(&fifo_data->red, &fifo_data->ir);
+    // 최신 샘플만 읽기 (가장 최근 1개, 앞의 샘플은 버림)
+    if (samples_to_read > 0 && max30102_read_fifo(&fifo_data->red, &fifo_data->ir) == ESP_OK) {
         return 1;
     }
     
@@ -154,8 +193,8 @@ uint8_t max30102_read_fifo_multi(max30102_fifo_data_t *fifo_data, uint8_t max_sa
 }
 
 esp_err_t max30102_set_led_current(uint8_t ir_current, uint8_t red_current) {
-    esp_err_t ret1 = write_register(MAX30102_REG_LED1_PA, ir_current);
-    esp_err_t ret2 = write_register(MAX30102_REG_LED2_PA, red_current);
+    esp_err_t ret1 = write_register(MAX30102_REG_LED1_PA, red_current);
+    esp_err_t ret2 = write_register(MAX30102_REG_LED2_PA, ir_current);
     
     if (ret1 == ESP_OK && ret2 == ESP_OK) {
         current_config.ir_current = ir_current;
@@ -167,6 +206,16 @@ esp_err_t max30102_set_led_current(uint8_t ir_current, uint8_t red_current) {
     return ESP_FAIL;
 }
 
+esp_err_t max30102_set_shutdown(bool shutdown) {
+    uint8_t mode;
+    esp_err_t ret = read_register(MAX30102_REG_MODE_CONFIG, &mode, 1);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    mode = shutdown ? (mode | 0x80) : (mode & ~0x80);   // SHDN
+    return write_register(MAX30102_REG_MODE_CONFIG, mode);
+}
+
 esp_err_t max30102_clear_fifo(void) {
     esp_err_t ret1 = write_register(MAX30102_REG_FIFO_WR_PTR, 0x00);
     esp_err_t ret2 = write_register(MAX30102_REG_FIFO_RD_PTR, 0x00);
@@ -0,0 +1,112 @@
+// motion_artifact.c
+// 가속도 기준 NLMS 움직임 잡음 제거 (ESP-IDF 의존성 없음)
+
+#include "motion_artifact.h"
+#include <math.h>
+#include <string.h>
+
+#define MA_MU               0.03f   // NLMS 스텝 크기 (dsp_bench motion 합성 보행 구간 기준)
+#define MA_EPS              1e-4f   // 기준 신호가 거의 없을 때 발산 방지
+#define MA_GRAVITY_FC_HZ    0.3f    // 중력 추정 저역 통과 차단 주파수
+#define MA_POWER_TAU_S      1.0f    // 전력 추정 시간 상수
+#define MA_HOLD_S           2.0f    // 조건 해제 후 플래그 유지 시간
+
+#define MA_ADAPT_MIN_G      0.02f   // 이 RMS 이하는 정지로 보고 계수를 갱신하지 않음
+#define MA_HEAVY_MOTION_G   0.6f    // 이 RMS 이상은 잡음 제거와 관계없이 오염으로 판정
+#define MA_ARTIFACT_RATIO   4.0f    // 추정 잡음 전력이 남은 신호의 4배(6dB) 이상이면 오염
+#define MA_RESIDUAL_RATIO   4.0f    // 남은 신호 전력이 정지 시 맥파 전력의 4배 이상이면 오염
+
+void motion_artifact_init(motion_artifact_ctx_t *ctx, float fs_hz) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->mu = MA_MU;
+    ctx->gravity_a = 1.0f - expf(-2.0f * (float)M_PI * MA_GRAVITY_FC_HZ / fs_hz);
+    ctx->power_a = 1.0f / (fs_hz * MA_POWER_TAU_S);
+    ctx->hold_samples = (uint32_t)(fs_hz * MA_HOLD_S);
+}
+
+void motion_artifact_reset(motion_artifact_ctx_t *ctx) {
+    float mu = ctx->mu;
+    float gravity_a = ctx->gravity_a;
+    float power_a = ctx->power_a;
+    uint32_t hold_samples = ctx->hold_samples;
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->mu = mu;
+    ctx->gravity_a = gravity_a;
+    ctx->power_a = power_a;
+    ctx->hold_samples = hold_samples;
+}
+
+float motion_artifact_process(motion_artifact_ctx_t *ctx, const float acc_g[MA_REF_AXES], float ppg_ac) {
+    // 1) 중력 제거 후 동적 가속도를 축별 지연선 맨 앞에 넣는다
+    if (!ctx->gravity_ready) {
+        memcpy(ctx->gravity, acc_g, sizeof(ctx->gravity));
+        ctx->gravity_ready = true;
+    }
+    float motion_sq = 0.0f;
+    for (int a = 0; a < MA_REF_AXES; a++) {
+        ctx->gravity[a] += ctx->gravity_a * (acc_g[a] - ctx->gravity[a]);
+        float dyn = acc_g[a] - ctx->gravity[a];
+        float *line = &ctx->x[a * MA_TAPS];
+        memmove(&line[1], &line[0], (MA_TAPS - 1) * sizeof(float));
+        line[0] = dyn;
+        motion_sq += dyn * dyn;
+    }
+
+    // 2) 움직임 잡음 추정 y = w·x, 출력 e = d - y
+    float y = 0.0f;
+    float energy = 0.0f;
+    for (int i = 0; i < MA_WEIGHTS; i++) {
+        y += ctx->w[i] * ctx->x[i];
+        energy += ctx->x[i] * ctx->x[i];
+    }
+    float e = ppg_ac - y;
+
+    // 3) 움직이는 동안에만 계수 갱신 (정지 중 갱신하면 맥파 자체를 학습해 버림)
+    ctx->motion_pow += ctx->power_a * (motion_sq - ctx->motion_pow);
+    bool moving = ctx->motion_pow > MA_ADAPT_MIN_G * MA_ADAPT_MIN_G;
+    if (moving) {
+        float g = ctx->mu * e / (MA_EPS + energy);
+        for (int i = 0; i < MA_WEIGHTS; i++) {
+            ctx->w[i] += g * ctx->x[i];
+        }
+    } else {
+        ctx->rest_pow += ctx->power_a * (e * e - ctx->rest_pow);
+    }
+    ctx->artifact_pow += ctx->power_a * (y * y - ctx->artifact_pow);
+    ctx->clean_pow += ctx->power_a * (e * e - ctx->clean_pow);
+
+    // 4) 오염 판정 (히스테리시스: 조건이 사라져도 hold_samples 동안 유지)
+    bool bad = ctx->motion_pow > MA_HEAVY_MOTION_G * MA_HEAVY_MOTION_G ||
+               (moving && ctx->artifact_pow > MA_ARTIFACT_RATIO * ctx->clean_pow) ||
+               (moving && ctx->rest_pow > 0.0f && ctx->clean_pow > MA_RESIDUAL_RATIO * ctx->rest_pow);
+    if (bad) {
+        ctx->corrupted = true;
+        ctx->hold = ctx->hold_samples;
+    } else if (ctx->hold > 0) {
+        if (--ctx->hold == 0) {
+            ctx->corrupted = false;
+        }
+    }
+
+    return e;
+}
+
+bool motion_artifact_is_corrupted(const motion_artifact_ctx_t *ctx) {
+    return ctx->corrupted;
+}
+
+float motion_artifact_weight(const motion_artifact_ctx_t *ctx) {
+    float total = ctx->clean_pow + ctx->artifact_pow;
+    if (ctx->corrupted) {
+        return 0.0f;
+    }
+    if (total <= 0.0f) {
+        return 1.0f;
+    }
+    return ctx->clean_pow / total;
+}
+
+float motion_artifact_motion_rms(const motion_artifact_ctx_t *ctx) {
+    return sqrtf(ctx->motion_pow);
+}
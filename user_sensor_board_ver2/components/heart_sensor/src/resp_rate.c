@@ -0,0 +1,179 @@
+// resp_rate.c
+// 기저선/박동 진폭/박동 간격의 자기상관 피크로 호흡수 추정, 신호 간 일치로 최종 선택
+
+#include "resp_rate.h"
+#include <math.h>
+#include <string.h>
+
+#define GAP_MAX_S           2.0f    // 이보다 오래 못 쓰는 샘플이 이어지면 창이 시간상 이어지지 않는다
+#define PEAK_NEAR_BEST      0.85f   // 가장 높은 피크의 이 비율 이상인 첫 피크를 주기로 본다 (2배 주기 선택 방지)
+
+// 자기상관은 지연 lag_max + 1(6회/분 ≈ 43)까지 창의 절반 크기 배열에 담는다
+_Static_assert(RESP_RATE_WINDOW >= 96, "RESP_RATE_WINDOW는 96 이상");
+
+void resp_rate_init(resp_rate_ctx_t *ctx, float fs_hz, uint32_t update_ms) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->fs = fs_hz / RESP_RATE_DECIM;
+    ctx->update_samples = (uint16_t)(ctx->fs * update_ms / 1000.0f);
+    if (ctx->update_samples < 1) {
+        ctx->update_samples = 1;
+    }
+    ctx->gap_max = (uint16_t)(GAP_MAX_S * fs_hz);
+    ctx->lag_min = (uint8_t)floorf(60.0f * ctx->fs / RESP_RATE_MAX_BRPM);
+    ctx->lag_max = (uint8_t)ceilf(60.0f * ctx->fs / RESP_RATE_MIN_BRPM);
+}
+
+void resp_rate_reset(resp_rate_ctx_t *ctx) {
+    ctx->head = 0;
+    ctx->count = 0;
+    ctx->decim_sum = 0.0f;
+    ctx->decim_n = 0;
+    ctx->gap = 0;
+    ctx->since_update = 0;
+    ctx->beat_seen = false;
+}
+
+void resp_rate_beat(resp_rate_ctx_t *ctx, float amplitude, float interval_s) {
+    ctx->beat_value[RESP_SIG_AMPLITUDE] = amplitude;
+    ctx->beat_value[RESP_SIG_INTERVAL] = interval_s;
+    ctx->beat_seen = true;
+}
+
+// 신호 하나: 선형 추세 제거 → 정규화 자기상관 → 첫 주기 피크
+static void estimate_signal(resp_rate_ctx_t *ctx, const float *ring, resp_estimate_t *out) {
+    const int n = RESP_RATE_WINDOW;
+    float *y = ctx->work;
+    float sy = 0.0f, sxy = 0.0f;
+    for (int i = 0; i < n; i++) {
+        y[i] = ring[(ctx->head + i) % n];
+        sy += y[i];
+        sxy += i * y[i];
+    }
+    const float xm = 0.5f * (n - 1);
+    const float ym = sy / n;
+    const float sxx = n * ((float)n * n - 1.0f) / 12.0f;
+    const float slope = (sxy - n * xm * ym) / sxx;
+    float r0 = 0.0f;
+    for (int i = 0; i < n; i++) {
+        y[i] -= ym + slope * (i - xm);
+        r0 += y[i] * y[i];
+    }
+
+    out->valid = false;
+    out->quality = 0.0f;
+    out->brpm = 0.0f;
+    if (r0 <= 0.0f) {
+        return;
+    }
+
+    // 지연별 평균 곱 / 분산 (지연이 길수록 겹치는 샘플이 줄어드는 만큼 보정)
+    float r[RESP_RATE_WINDOW / 2];
+    const int lo = ctx->lag_min - 1, hi = ctx->lag_max + 1;
+    for (int k = lo; k <= hi; k++) {
+        float acc = 0.0f;
+        for (int i = 0; i + k < n; i++) {
+            acc += y[i] * y[i + k];
+        }
+        r[k - lo] = (acc / (n - k)) / (r0 / n);
+    }
+
+    float best = 0.0f;
+    for (int k = ctx->lag_min; k <= ctx->lag_max; k++) {
+        float v = r[k - lo];
+        if (v > r[k - lo - 1] && v >= r[k - lo + 1] && v > best) {
+            best = v;
+        }
+    }
+    if (best <= 0.0f) {
+        return;
+    }
+    int peak = 0;
+    for (int k = ctx->lag_min; k <= ctx->lag_max; k++) {
+        float v = r[k - lo];
+        if (v > r[k - lo - 1] && v >= r[k - lo + 1] && v >= PEAK_NEAR_BEST * best) {
+            peak = k;
+            break;
+        }
+    }
+
+    float a = r[peak - lo - 1], b = r[peak - lo], c = r[peak - lo + 1];
+    float denom = a - 2.0f * b + c;
+    float delta = (denom < 0.0f) ? 0.5f * (a - c) / denom : 0.0f;
+    out->brpm = 60.0f * ctx->fs / (peak + delta);
+    out->quality = (b > 1.0f) ? 1.0f : b;
+    out->valid = out->quality >= RESP_RATE_MIN_QUALITY &&
+                 out->brpm >= RESP_RATE_MIN_BRPM && out->brpm <= RESP_RATE_MAX_BRPM;
+}
+
+// 신호별 추정 중 서로 일치하는 무리의 품질 가중 평균
+// 품질 지표 = 무리 품질 합 / 유효 신호 수 (유효한 신호끼리 어긋나면 그만큼 낮아진다)
+static void fuse(const resp_estimate_t *sig, resp_estimate_t *out) {
+    float best_q = 0.0f;
+    int n_valid = 0;
+    out->brpm = 0.0f;
+    for (int i = 0; i < RESP_SIG_COUNT; i++) {
+        if (!sig[i].valid) {
+            continue;
+        }
+        n_valid++;
+        float sum_q = 0.0f, sum_b = 0.0f;
+        for (int j = 0; j < RESP_SIG_COUNT; j++) {
+            if (sig[j].valid && fabsf(sig[j].brpm - sig[i].brpm) <= RESP_RATE_AGREE_BRPM) {
+                sum_q += sig[j].quality;
+                sum_b += sig[j].quality * sig[j].brpm;
+            }
+        }
+        if (sum_q > best_q) {
+            best_q = sum_q;
+            out->brpm = sum_b / sum_q;
+        }
+    }
+    out->quality = n_valid ? best_q / n_valid : 0.0f;
+    out->valid = out->quality >= RESP_RATE_MIN_QUALITY;
+}
+
+bool resp_rate_sample(resp_rate_ctx_t *ctx, float baseline, bool usable, resp_estimate_t *out) {
+    if (!usable) {
+        if (ctx->gap < UINT16_MAX) {
+            ctx->gap++;
+        }
+        if (ctx->gap == ctx->gap_max) {
+            resp_rate_reset(ctx);
+        }
+        return false;
+    }
+    ctx->gap = 0;
+
+    ctx->decim_sum += baseline;
+    if (++ctx->decim_n < RESP_RATE_DECIM) {
+        return false;
+    }
+    ctx->ring[RESP_SIG_BASELINE][ctx->head] = ctx->decim_sum / RESP_RATE_DECIM;
+    ctx->ring[RESP_SIG_AMPLITUDE][ctx->head] = ctx->beat_value[RESP_SIG_AMPLITUDE];
+    ctx->ring[RESP_SIG_INTERVAL][ctx->head] = ctx->beat_value[RESP_SIG_INTERVAL];
+    ctx->head = (ctx->head + 1) % RESP_RATE_WINDOW;
+    if (ctx->count < RESP_RATE_WINDOW) {
+        ctx->count++;
+    }
+    ctx->decim_sum = 0.0f;
+    ctx->decim_n = 0;
+
+    if (ctx->since_update < ctx->update_samples) {
+        ctx->since_update++;
+    }
+    if (ctx->since_update < ctx->update_samples || ctx->count < RESP_RATE_WINDOW) {
+        return false;
+    }
+    ctx->since_update = 0;
+
+    estimate_signal(ctx, ctx->ring[RESP_SIG_BASELINE], &ctx->signal[RESP_SIG_BASELINE]);
+    if (ctx->beat_seen) {
+        estimate_signal(ctx, ctx->ring[RESP_SIG_AMPLITUDE], &ctx->signal[RESP_SIG_AMPLITUDE]);
+        estimate_signal(ctx, ctx->ring[RESP_SIG_INTERVAL], &ctx->signal[RESP_SIG_INTERVAL]);
+    } else {
+        ctx->signal[RESP_SIG_AMPLITUDE].valid = false;
+        ctx->signal[RESP_SIG_INTERVAL].valid = false;
+    }
+    fuse(ctx->signal, out);
+    return true;
+}
@@ -0,0 +1,143 @@
+// spo2_beat.c
+// 박동 구간 최대/최소/평균 기반 ratio-of-ratios와 중앙값 집계
+
+#include "spo2_beat.h"
+#include <math.h>
+#include <string.h>
+
+#define BEAT_MIN_BPM        40.0f
+#define BEAT_MAX_BPM        200.0f
+#define RATE_MIN_FRACTION   0.7f        // 심박을 알면 구간은 주기의 70% 이상이어야 한 박동으로 본다
+#define PERFUSION_MIN       0.0005f     // IR AC/DC 0.05% 미만이면 맥파가 아니라 잡음
+#define PERFUSION_MAX       0.2f        // 20% 초과면 접촉 변화/움직임
+#define R_MIN               0.2f
+#define R_MAX               3.0f
+
+void spo2_beat_init(spo2_beat_ctx_t *ctx, float fs_hz) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->fs = fs_hz;
+    ctx->min_samples_floor = (uint16_t)(fs_hz * 60.0f / BEAT_MAX_BPM);
+    ctx->min_samples = ctx->min_samples_floor;
+    ctx->max_samples = (uint16_t)(fs_hz * 60.0f / BEAT_MIN_BPM);
+}
+
+void spo2_beat_reset(spo2_beat_ctx_t *ctx) {
+    ctx->n = 0;
+    ctx->head = 0;
+    ctx->count = 0;
+}
+
+void spo2_beat_set_rate(spo2_beat_ctx_t *ctx, float bpm) {
+    uint16_t min_samples = ctx->min_samples_floor;
+    if (bpm >= BEAT_MIN_BPM && bpm <= BEAT_MAX_BPM) {
+        uint16_t from_rate = (uint16_t)(RATE_MIN_FRACTION * ctx->fs * 60.0f / bpm);
+        if (from_rate > min_samples) {
+            min_samples = from_rate;
+        }
+    }
+    ctx->min_samples = min_samples;
+}
+
+void spo2_beat_sample(spo2_beat_ctx_t *ctx, float red, float ir, bool usable) {
+    const float x[2] = { red, ir };
+    if (ctx->n == 0) {
+        for (int c = 0; c < 2; c++) {
+            ctx->max[c] = ctx->min[c] = ctx->first[c] = x[c];
+            ctx->imax[c] = ctx->imin[c] = 0;
+            ctx->sum[c] = 0.0f;
+        }
+        ctx->clean = true;
+    } else {
+        for (int c = 0; c < 2; c++) {
+            if (x[c] > ctx->max[c]) {
+                ctx->max[c] = x[c];
+                ctx->imax[c] = ctx->n;
+            }
+            if (x[c] < ctx->min[c]) {
+                ctx->min[c] = x[c];
+                ctx->imin[c] = ctx->n;
+            }
+        }
+    }
+    ctx->last[0] = red;
+    ctx->last[1] = ir;
+    ctx->sum[0] += red;
+    ctx->sum[1] += ir;
+    ctx->clean &= usable;
+    if (ctx->n < UINT16_MAX) {
+        ctx->n++;
+    }
+}
+
+// 구간 양 끝을 잇는 기준선(호흡/DC 변화)을 뺀 최대 - 최소
+static float detrended_ac(const spo2_beat_ctx_t *ctx, int c) {
+    float slope = (ctx->last[c] - ctx->first[c]) / (ctx->n - 1);
+    return fabsf((ctx->max[c] - slope * ctx->imax[c]) - (ctx->min[c] - slope * ctx->imin[c]));
+}
+
+// 지난 박동 구간의 R (버릴 구간이면 음수), 받아들일 구간이면 IR 관류도 돌려준다
+static float beat_ratio(const spo2_beat_ctx_t *ctx, float *ir_perfusion) {
+    if (!ctx->clean || ctx->n > ctx->max_samples) {
+        return -1.0f;
+    }
+    float dc_red = ctx->sum[0] / ctx->n;
+    float dc_ir = ctx->sum[1] / ctx->n;
+    if (dc_red <= 0.0f || dc_ir <= 0.0f) {
+        return -1.0f;
+    }
+    float pr = detrended_ac(ctx, 0) / dc_red;
+    float pir = detrended_ac(ctx, 1) / dc_ir;
+    if (pir < PERFUSION_MIN || pir > PERFUSION_MAX || pr <= 0.0f) {
+        return -1.0f;
+    }
+    float r = pr / pir;
+    *ir_perfusion = pir;
+    return (r >= R_MIN && r <= R_MAX) ? r : -1.0f;
+}
+
+bool spo2_beat_end(spo2_beat_ctx_t *ctx, float *r_median) {
+    // 한 박동 안에서 검출이 여러 번 나면(중복맥, 잡음 피크) 최소 길이가 될 때까지 구간을 이어 붙인다
+    if (ctx->n < ctx->min_samples) {
+        return false;
+    }
+    float perfusion = 0.0f;
+    float r = beat_ratio(ctx, &perfusion);
+    uint16_t n = ctx->n;
+    ctx->n = 0;     // 다음 샘플부터 새 구간
+    if (r < 0.0f) {
+        ctx->rejected++;
+        return false;
+    }
+    ctx->accepted++;
+    ctx->beat_perfusion = perfusion;
+    ctx->beat_seconds = n / ctx->fs;
+    ctx->r[ctx->head] = r;
+    ctx->head = (ctx->head + 1) % SPO2_BEAT_HISTORY;
+    if (ctx->count < SPO2_BEAT_HISTORY) {
+        ctx->count++;
+    }
+    if (ctx->count < SPO2_BEAT_MIN_BEATS) {
+        return false;
+    }
+
+    // 중앙값 (최대 8개 삽입 정렬 - 박동당 한 번)
+    float v[SPO2_BEAT_HISTORY];
+    int count = ctx->count;
+    for (int i = 0; i < count; i++) {
+        float x = ctx->r[i];
+        int j = i - 1;
+        for (; j >= 0 && v[j] > x; j--) {
+            v[j + 1] = v[j];
+        }
+        v[j + 1] = x;
+    }
+    *r_median = (count % 2) ? v[count / 2] : 0.5f * (v[count / 2 - 1] + v[count / 2]);
+    return true;
+}
+
+float spo2_from_ratio(const spo2_calibration_t *cal, float r) {
+    float s = cal->a + cal->b * r + cal->c * r * r;
+    if (s > 100.0f) s = 100.0f;
+    if (s < 0.0f) s = 0.0f;
+    return s;
+}
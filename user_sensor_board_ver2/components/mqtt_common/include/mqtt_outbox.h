@@ -0,0 +1,58 @@
+// mqtt_outbox.h
+// 우선순위별 유한 발행 대기열 (esp-mqtt outbox 위의 흐름 제어)
+//
+// 발행 요청은 클래스별 대기열에 복사해 두고, 연결 중이면서 인플라이트 QoS1 메시지 수가
+// 한도 이내일 때만 높은 클래스부터 esp-mqtt로 넘긴다. 인플라이트는 MQTT_EVENT_PUBLISHED /
+// MQTT_EVENT_DELETED로 해제한다. 대기열 + esp_mqtt_client_get_outbox_size()가 메모리 예산을
+// 넘거나 클래스 대기열이 가득 차면 가장 낮은 클래스부터, 같은 토픽의 더 새 항목으로 대체된
+// coalesce 항목을 먼저 버리고 그다음 가장 오래된 항목을 버린다. 경보는 버리지 않는다:
+// 경보 대기열이 가득 차면 새 경보를 거절하고, publish가 실패한 경보는 맨 앞에 남아 재시도된다.
+// 버림/거절/대체는 metrics에 기록된다.
+
+#ifndef MQTT_OUTBOX_H
+#define MQTT_OUTBOX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "mqtt_client.h"
+#include "mqtt_client_wrapper.h"
+
+// 우선순위 클래스 (값이 작을수록 먼저 전송, 나중에 버림)
+typedef enum {
+    MQTT_CLASS_ALERT = 0,   // 낙상/경보 (QoS 1)
+    MQTT_CLASS_VITALS,      // 생체 텔레메트리 (QoS 1)
+    MQTT_CLASS_ENV,         // 환경 텔레메트리 (QoS 1)
+    MQTT_CLASS_DIAG,        // 진단 (QoS 0)
+    MQTT_CLASS_COUNT
+} mqtt_class_t;
+
+typedef struct {
+    uint16_t pending[MQTT_CLASS_COUNT];     // 클래스별 대기 메시지 수
+    uint32_t pending_bytes;
+    uint16_t inflight;                      // PUBACK 대기 중인 QoS1 메시지 수
+    int32_t outbox_bytes;                   // 마지막으로 확인한 esp-mqtt outbox 크기
+} mqtt_outbox_stats_t;
+
+/**
+ * @brief 대기열/전송 태스크 생성 (mqtt_start() 내부에서 호출)
+ */
+esp_err_t mqtt_outbox_init(void);
+
+/**
+ * @brief 메시지를 클래스 대기열에 넣는다 (payload는 복사됨, 연결이 끊겨 있어도 보관)
+ * @param coalesce true면 예산/용량이 넘쳤을 때 같은 토픽의 더 새 항목이 있으면 먼저 버려도 되는
+ *                 메시지 (최신 값만 의미 있는 텔레메트리, 경보 클래스에서는 무시)
+ * @return ESP_OK, 예산보다 큰 메시지면 ESP_ERR_INVALID_SIZE,
+ *         메모리 부족 또는 경보 대기열이 가득 찼으면 ESP_ERR_NO_MEM
+ */
+esp_err_t mqtt_outbox_publish(mqtt_class_t cls, mqtt_topic_id_t topic, const char *payload, int len, bool coalesce);
+
+/**
+ * @brief MQTT 이벤트 전달 (래퍼의 이벤트 핸들러에서 호출)
+ */
+void mqtt_outbox_handle_event(esp_mqtt_event_id_t event_id, int msg_id);
+
+void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats);
+
+#endif // MQTT_OUTBOX_H
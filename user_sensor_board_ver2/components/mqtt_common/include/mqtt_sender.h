@@ -1,8 +1,24 @@
 #ifndef MQTT_SENDER_H
 #define MQTT_SENDER_H
 
+#include "esp_err.h"
 #include "sensor_data.h"
+#include "vital_rules.h"
 
 void mqtt_send_sensor_data(sensor_data_t data);
 
+// 낙상 감지 즉시 경보 클래스로 전송 (일반 텔레메트리보다 먼저 나감)
+// 경보 대기열이 가득 차 거절되면 ESP_OK가 아닌 값을 돌려주므로 호출자가 다시 시도해야 한다
+esp_err_t mqtt_send_fall_alert(const sensor_data_t *data);
+
+// 생체 규칙 경보(발생/해제)를 경보 클래스로 전송 (반환값은 mqtt_send_fall_alert와 같음)
+esp_err_t mqtt_send_vital_alert(const vital_alert_t *alert);
+
+// 낙상 후보 원시 창을 1초 단위 조각으로 나눠 part번째 조각을 전송 (*parts에 전체 조각 수)
+// 창 하나(약 6KB)를 한 번에 넣으면 outbox 예산을 넘으므로 호출자가 주기마다 한 조각씩 보낸다
+esp_err_t mqtt_send_fall_window(const fall_window_t *window, int part, int *parts);
+
+// metrics 카운터와 발행 대기열 상태를 진단 클래스로 전송
+void mqtt_send_diagnostics(void);
+
 #endif
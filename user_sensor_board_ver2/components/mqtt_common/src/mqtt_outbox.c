@@ -0,0 +1,307 @@
+// mqtt_outbox.c
+
+#include "mqtt_outbox.h"
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "metrics.h"
+#include "app_init.h"
+#include "task_placement.h"
+
+static const char *TAG = "MQTT_OUTBOX";
+
+typedef struct {
+    char *payload;
+    int len;
+    mqtt_topic_id_t topic;
+    bool coalesce;              // 압박 시 같은 토픽의 더 새 항목이 있으면 먼저 버려도 됨
+} outbox_item_t;
+
+// 클래스별 원형 대기열
+typedef struct {
+    outbox_item_t items[CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN];
+    int head;
+    int count;
+} class_queue_t;
+
+typedef struct {
+    int msg_id;
+    int64_t sent_us;
+} inflight_t;
+
+static const int s_class_qos[MQTT_CLASS_COUNT] = { 1, 1, 1, 0 };
+static const metric_counter_t s_class_drop_metric[MQTT_CLASS_COUNT] = {
+    METRIC_OUTBOX_DROPS_ALERT, METRIC_OUTBOX_DROPS_VITALS, METRIC_OUTBOX_DROPS_ENV, METRIC_OUTBOX_DROPS_DIAG,
+};
+
+// 경보는 인플라이트 한도와 무관하게 보내므로 경보 대기열 길이만큼 여유 슬롯을 둔다
+// (슬롯이 모두 차면 경보도 대기열 맨 앞에서 기다린다)
+#define INFLIGHT_SLOTS  (CONFIG_APP_MQTT_OUTBOX_MAX_INFLIGHT + CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN)
+
+static class_queue_t s_queues[MQTT_CLASS_COUNT];
+static size_t s_pending_bytes = 0;
+static inflight_t s_inflight[INFLIGHT_SLOTS];
+static int s_inflight_count = 0;
+static int s_outbox_bytes = 0;
+static SemaphoreHandle_t s_lock = NULL;     // 대기열/인플라이트 보호 (잡은 채로 esp-mqtt API 호출 금지)
+static TaskHandle_t s_task = NULL;
+
+// 대기열 맨 앞 항목 제거 (s_lock 보유 상태)
+static void queue_pop(mqtt_class_t cls, outbox_item_t *out) {
+    class_queue_t *q = &s_queues[cls];
+    *out = q->items[q->head];
+    q->head = (q->head + 1) % CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN;
+    q->count--;
+    s_pending_bytes -= out->len;
+}
+
+// 경보는 버리지 않는다 (대기열이 가득 차면 새 경보를 거절)
+static void drop_oldest(mqtt_class_t cls) {
+    outbox_item_t item;
+    queue_pop(cls, &item);
+    free(item.payload);
+    metrics_inc(s_class_drop_metric[cls]);
+}
+
+// 같은 토픽의 더 새 항목이 뒤에 있는 가장 오래된 coalesce 항목을 버림 (s_lock 보유 상태)
+static bool drop_superseded(mqtt_class_t cls) {
+    class_queue_t *q = &s_queues[cls];
+    for (int i = 0; i < q->count - 1; i++) {
+        outbox_item_t *item = &q->items[(q->head + i) % CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN];
+        if (!item->coalesce) {
+            continue;
+        }
+        for (int j = i + 1; j < q->count; j++) {
+            if (q->items[(q->head + j) % CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN].topic != item->topic) {
+                continue;
+            }
+            s_pending_bytes -= item->len;
+            free(item->payload);
+            for (int k = i; k < q->count - 1; k++) {
+                q->items[(q->head + k) % CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN] =
+                    q->items[(q->head + k + 1) % CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN];
+            }
+            q->count--;
+            metrics_inc(METRIC_OUTBOX_COALESCED);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 예산 초과분을 낮은 클래스부터 정리: 먼저 최신 값으로 대체된 항목, 그다음 가장 오래된 항목 (경보는 남김)
+static void enforce_budget(void) {
+    for (int cls = MQTT_CLASS_DIAG; cls > MQTT_CLASS_ALERT; cls--) {
+        while (s_queues[cls].count > 0 &&
+               s_pending_bytes + s_outbox_bytes > CONFIG_APP_MQTT_OUTBOX_BUDGET_BYTES) {
+            if (!drop_superseded((mqtt_class_t)cls)) {
+                drop_oldest((mqtt_class_t)cls);
+            }
+        }
+    }
+}
+
+esp_err_t mqtt_outbox_publish(mqtt_class_t cls, mqtt_topic_id_t topic, const char *payload, int len, bool coalesce) {
+    if (s_lock == NULL || cls >= MQTT_CLASS_COUNT || payload == NULL || len <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len > CONFIG_APP_MQTT_OUTBOX_BUDGET_BYTES) {
+        metrics_inc(s_class_drop_metric[cls]);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    char *copy = malloc(len);
+    if (copy == NULL) {
+        metrics_inc(s_class_drop_metric[cls]);
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(copy, payload, len);
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    class_queue_t *q = &s_queues[cls];
+    if (q->count == CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN) {
+        if (cls == MQTT_CLASS_ALERT) {
+            // 대기 중인 경보를 밀어내지 않고 새 경보를 거절 (호출자가 다음 주기에 다시 넣을 수 있음)
+            xSemaphoreGive(s_lock);
+            free(copy);
+            metrics_inc(s_class_drop_metric[cls]);
+            return ESP_ERR_NO_MEM;
+        }
+        if (!drop_superseded(cls)) {
+            drop_oldest(cls);
+        }
+    }
+    outbox_item_t *item = &q->items[(q->head + q->count) % CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN];
+    item->payload = copy;
+    item->len = len;
+    item->topic = topic;
+    item->coalesce = coalesce && cls != MQTT_CLASS_ALERT;
+    q->count++;
+    s_pending_bytes += len;
+    enforce_budget();
+    xSemaphoreGive(s_lock);
+
+    xTaskNotifyGive(s_task);
+    return ESP_OK;
+}
+
+// 전송 가능한 가장 높은 클래스의 항목을 꺼냄 (s_lock 보유 상태)
+// 경보는 publish가 성공할 때까지 대기열 맨 앞에 남겨 두고 복사본만 돌려준다
+// (경보는 버리거나 덮어쓰지 않으므로 전송 중에도 맨 앞 항목이 바뀌지 않는다)
+static bool take_next(outbox_item_t *out, mqtt_class_t *out_cls) {
+    for (int cls = MQTT_CLASS_ALERT; cls < MQTT_CLASS_COUNT; cls++) {
+        class_queue_t *q = &s_queues[cls];
+        if (q->count == 0) {
+            continue;
+        }
+        // 경보는 인플라이트 한도와 무관하게 바로 보냄, 나머지는 창이 비어야 함
+        // (높은 클래스가 막혀 있으면 낮은 클래스가 앞지르지 않도록 여기서 멈춤)
+        int limit = (cls == MQTT_CLASS_ALERT) ? INFLIGHT_SLOTS : CONFIG_APP_MQTT_OUTBOX_MAX_INFLIGHT;
+        if (s_class_qos[cls] > 0 && s_inflight_count >= limit) {
+            return false;
+        }
+        if (cls == MQTT_CLASS_ALERT) {
+            *out = q->items[q->head];
+        } else {
+            queue_pop((mqtt_class_t)cls, out);
+        }
+        *out_cls = (mqtt_class_t)cls;
+        return true;
+    }
+    return false;
+}
+
+// take_next()가 INFLIGHT_SLOTS 이내에서만 QoS1 항목을 내주므로 항상 자리가 있다
+static void inflight_add(int msg_id, int64_t sent_us) {
+    s_inflight[s_inflight_count].msg_id = msg_id;
+    s_inflight[s_inflight_count].sent_us = sent_us;
+    s_inflight_count++;
+}
+
+// 인플라이트에서 제거하고 전송 시각 반환 (없으면 0)
+static int64_t inflight_remove(int msg_id) {
+    for (int i = 0; i < s_inflight_count; i++) {
+        if (s_inflight[i].msg_id == msg_id) {
+            int64_t sent_us = s_inflight[i].sent_us;
+            s_inflight[i] = s_inflight[--s_inflight_count];
+            return sent_us;
+        }
+    }
+    return 0;
+}
+
+static void drain(void) {
+    esp_mqtt_client_handle_t client = mqtt_get_handle();
+
+    while (client != NULL && mqtt_is_connected()) {
+        int outbox_bytes = esp_mqtt_client_get_outbox_size(client);
+
+        outbox_item_t item;
+        mqtt_class_t cls;
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_outbox_bytes = outbox_bytes;
+        if (outbox_bytes == 0) {
+            // esp-mqtt outbox가 비었는데 남은 인플라이트는 PUBACK 이벤트를 놓친 것
+            s_inflight_count = 0;
+        }
+        enforce_budget();
+        bool found = take_next(&item, &cls);
+        xSemaphoreGive(s_lock);
+        if (!found) {
+            break;
+        }
+
+        int qos = s_class_qos[cls];
+        int64_t sent_us = esp_timer_get_time();
+        int msg_id = mqtt_wrapper_publish(item.topic, item.payload, item.len, qos);
+
+        if (msg_id < 0) {
+            if (cls == MQTT_CLASS_ALERT) {
+                // 맨 앞에 남아 있으므로 다음 drain(이벤트 또는 1초 주기)에서 다시 시도
+                ESP_LOGW(TAG, "경보 publish 실패 (len %d), 재시도 대기", item.len);
+            } else {
+                ESP_LOGW(TAG, "publish 실패 (class %d, len %d)", cls, item.len);
+                free(item.payload);
+                metrics_inc(s_class_drop_metric[cls]);
+            }
+            break;
+        }
+        app_init_mark_first_publish();
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        if (cls == MQTT_CLASS_ALERT) {
+            queue_pop(cls, &item);
+        }
+        if (qos > 0) {
+            inflight_add(msg_id, sent_us);
+        }
+        xSemaphoreGive(s_lock);
+        free(item.payload);
+    }
+}
+
+void mqtt_outbox_handle_event(esp_mqtt_event_id_t event_id, int msg_id) {
+    if (s_lock == NULL) {
+        return;
+    }
+
+    if (event_id == MQTT_EVENT_PUBLISHED || event_id == MQTT_EVENT_DELETED) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        int64_t sent_us = inflight_remove(msg_id);
+        xSemaphoreGive(s_lock);
+
+        if (event_id == MQTT_EVENT_DELETED) {
+            metrics_inc(METRIC_OUTBOX_EXPIRED);
+            ESP_LOGW(TAG, "msg_id=%d outbox 만료로 삭제됨", msg_id);
+        } else if (sent_us != 0) {
+            metrics_record_ms(METRIC_MQTT_ACK_MS, (uint32_t)((esp_timer_get_time() - sent_us) / 1000));
+        }
+    } else if (event_id != MQTT_EVENT_CONNECTED) {
+        return;
+    }
+    // 창이 비었거나 재연결됨 → 대기열 전송 재개
+    xTaskNotifyGive(s_task);
+}
+
+static void outbox_task(void *pvParameters) {
+    while (1) {
+        // 이벤트를 놓쳐도 주기적으로 outbox 크기를 다시 확인
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        drain();
+    }
+}
+
+esp_err_t mqtt_outbox_init(void) {
+    if (s_lock != NULL) {
+        return ESP_OK;
+    }
+    s_lock = xSemaphoreCreateMutex();
+    if (s_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (task_placement_create(TASK_ID_MQTT_OUTBOX, outbox_task, NULL, &s_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "발행 대기열 시작 (예산 %d bytes, 인플라이트 %d, 클래스당 %d개)",
+             CONFIG_APP_MQTT_OUTBOX_BUDGET_BYTES, CONFIG_APP_MQTT_OUTBOX_MAX_INFLIGHT,
+             CONFIG_APP_MQTT_OUTBOX_QUEUE_LEN);
+    return ESP_OK;
+}
+
+void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (s_lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int cls = 0; cls < MQTT_CLASS_COUNT; cls++) {
+        stats->pending[cls] = (uint16_t)s_queues[cls].count;
+    }
+    stats->pending_bytes = (uint32_t)s_pending_bytes;
+    stats->inflight = (uint16_t)s_inflight_count;
+    stats->outbox_bytes = s_outbox_bytes;
+    xSemaphoreGive(s_lock);
+}
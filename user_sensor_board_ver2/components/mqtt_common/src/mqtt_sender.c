@@ -1,45 +1,273 @@
 #include "mqtt_sender.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <inttypes.h>
 #include "esp_log.h"
 #include "mqtt_client.h"
 #include "mqtt_client_wrapper.h"
-#include "esp_timer.h"
-#include "sntp_helper.h"
+#include "mqtt_outbox.h"
+#include "metrics.h"
+#include "clock_service.h"
+#define DLOG_LOCAL_LEVEL CONFIG_DLOG_LEVEL_MQTT_SEND
+#include "dlog.h"
 
-extern esp_mqtt_client_handle_t mqtt_client;
-extern bool mqtt_is_connected(void);  // 연결 상태 체크 함수
+static const char *TAG = "MQTT_SEND";
 
+// 고정 크기 버퍼에 JSON 조각을 이어 붙이는 도우미 (넘치면 len이 size 이상이 됨)
+typedef struct {
+    char *buf;
+    size_t size;
+    int len;
+} payload_buf_t;
+
+static void pb_append(payload_buf_t *pb, const char *fmt, ...) {
+    if (pb->len < 0 || (size_t)pb->len >= pb->size) {
+        return;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(pb->buf + pb->len, pb->size - pb->len, fmt, ap);
+    va_end(ap);
+    pb->len = (n < 0) ? -1 : pb->len + n;
+}
+
+static void pb_append_base64(payload_buf_t *pb, const uint8_t *data, size_t n) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    if (pb->len < 0 || (size_t)pb->len + (n + 2) / 3 * 4 >= pb->size) {
+        pb->len = (int)pb->size;    // 넘침 표시
+        return;
+    }
+    char *out = pb->buf + pb->len;
+    for (size_t i = 0; i < n; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < n) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < n) v |= data[i + 2];
+        *out++ = table[(v >> 18) & 0x3F];
+        *out++ = table[(v >> 12) & 0x3F];
+        *out++ = (i + 1 < n) ? table[(v >> 6) & 0x3F] : '=';
+        *out++ = (i + 2 < n) ? table[v & 0x3F] : '=';
+    }
+    *out = '\0';
+    pb->len = (int)(out - pb->buf);
+}
+
+// TTL 이내인 항목만 담아 전송 (만료된 항목은 생략 → 백엔드가 "데이터 없음"과 "값 변화 없음"을 구분)
+// 연결이 끊겨 있으면 생체 클래스 대기열에 최신 1건만 남기고 재연결 시 전송
 void mqtt_send_sensor_data(sensor_data_t data) {
-    if (!mqtt_is_connected()) return;
-
-    // SNTP 동기화 상태에 따라 적절한 타임스탬프 선택
-    int64_t timestamp_to_send;
-    const char* timestamp_type;
-    
-    if (is_sntp_synced()) {
-        // SNTP 동기화된 경우: 유닉스 타임스탬프 사용
-        time_t world_time = get_current_world_time();
-        timestamp_to_send = (int64_t)world_time * 1000;  // 초를 밀리초로 변환
-        timestamp_type = "unix_timestamp_ms";
-    } else {
-        // SNTP 동기화되지 않은 경우: ESP 타이머 사용
-        timestamp_to_send = esp_timer_get_time() / 1000;  // 마이크로초를 밀리초로 변환
-        timestamp_type = "esp_time_ms";
-    }
-
-    char payload[512]; // 위치 정보 포함으로 크기 증가
-    snprintf(payload, sizeof(payload),
-        "{\"measurement\": \"person\", \"tags\": {\"deviceId\": \"2\"}, "
-        "\"fields\": {\"heartRate\": 76.6, \"temperature\": %.2f, \"spo2\": 97, \"steps\": %d, \"fallDetected\": %d}, "
-        "\"location\": {\"major\": %d, \"minor\": %d, \"rssi\": %d}, "
+    // 레코드 시각 = 전송 시각 (SNTP 기준점이 없으면 부팅 후 경과 ms)
+    int64_t timestamp_to_send = clock_to_utc_ms(clock_now_us());
+    const char* timestamp_type = clock_is_utc_valid() ? "unix_timestamp_ms" : "esp_time_ms";
+
+    char payload[864]; // 위치 정보 + 항목별 시각 + 활동 분류 + 호흡수 + 피부 온도 포함
+    payload_buf_t pb = { payload, sizeof(payload), 0 };
+    const char *sep = "";
+
+    pb_append(&pb, "{\"measurement\": \"person\", \"tags\": {\"deviceId\": \"%s\"}, \"fields\": {", mqtt_wrapper_device_id());
+    if (data.validity_flags.heart_rate_valid) {
+        pb_append(&pb, "%s\"heartRate\": %.1f", sep, data.heart_rate);
+        sep = ", ";
+    }
+    if (data.validity_flags.temperature_valid) {
+        pb_append(&pb, "%s\"temperature\": %.2f, \"skinTemp\": %.2f", sep, data.temperature, data.skin_temperature);
+        sep = ", ";
+    }
+    if (data.validity_flags.spo2_valid) {
+        pb_append(&pb, "%s\"spo2\": %d", sep, data.spo2);
+        sep = ", ";
+    }
+    if (data.validity_flags.resp_rate_valid) {
+        pb_append(&pb, "%s\"respRate\": %.1f, \"respQuality\": %.2f", sep, data.resp_rate, data.resp_quality);
+        sep = ", ";
+    }
+    if (data.validity_flags.steps_valid) {
+        pb_append(&pb, "%s\"steps\": %d", sep, data.steps);
+        sep = ", ";
+    }
+    if (data.validity_flags.fall_detected_valid) {
+        pb_append(&pb, "%s\"fallDetected\": %d", sep, data.fall_detected);
+        sep = ", ";
+    }
+    if (data.validity_flags.motion_artifact_valid) {
+        pb_append(&pb, "%s\"motionArtifact\": %d", sep, data.motion_artifact);
+        sep = ", ";
+    }
+    if (data.validity_flags.activity_valid) {
+        pb_append(&pb, "%s\"activity\": \"%s\"", sep, data.activity);
+    }
+    pb_append(&pb, "}, ");
+
+    if (data.validity_flags.location_valid) {
+        pb_append(&pb, "\"location\": {\"major\": %d, \"minor\": %d, \"rssi\": %d}, ",
+                  data.location.major, data.location.minor, data.location.rssi);
+    }
+
+    // 항목별 획득 시각 (백엔드 상관 분석 및 지연 측정용)
+    static const char *const names[] = {
+        "heartRate", "temperature", "spo2", "respRate", "steps", "fallDetected", "location",
+    };
+    const bool valid[] = {
+        data.validity_flags.heart_rate_valid, data.validity_flags.temperature_valid, data.validity_flags.spo2_valid,
+        data.validity_flags.resp_rate_valid, data.validity_flags.steps_valid, data.validity_flags.fall_detected_valid,
+        data.validity_flags.location_valid,
+    };
+    const int64_t acq_time_us[] = {
+        data.acq_time_us.heart_rate, data.acq_time_us.temperature, data.acq_time_us.spo2,
+        data.acq_time_us.resp_rate, data.acq_time_us.steps, data.acq_time_us.fall_detected, data.acq_time_us.location,
+    };
+    sep = "";
+    pb_append(&pb, "\"fieldTime\": {");
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        if (valid[i]) {
+            pb_append(&pb, "%s\"%s\": %" PRId64, sep, names[i], clock_to_utc_ms(acq_time_us[i]));
+            sep = ", ";
+        }
+    }
+    pb_append(&pb, "}, \"time\": %" PRId64 "}", timestamp_to_send);
+
+    int len = pb.len;
+    if (len < 0 || (size_t)len >= sizeof(payload)) {
+        ESP_LOGE(TAG, "payload 버퍼 부족 (len=%d)", len);
+        return;
+    }
+
+    // 최신 값만 의미 있으므로 대기열이 넘칠 때는 더 새 주기 값이 있는 항목부터 버려지게 표시
+    esp_err_t err = mqtt_outbox_publish(MQTT_CLASS_VITALS, MQTT_TOPIC_SENSOR_DATA, payload, len, true);
+    // payload 문자열은 스택 버퍼라 지연 로그에 담을 수 없으므로 길이만 기록
+    DLOGI(TAG, "Queued vitals err=%d, len=%d (timestamp: %" PRId64 ", type: %s)",
+          err, len, timestamp_to_send, timestamp_type);
+}
+
+esp_err_t mqtt_send_fall_alert(const sensor_data_t *data) {
+    char payload[192];
+    int len = snprintf(payload, sizeof(payload),
+        "{\"measurement\": \"alert\", \"tags\": {\"deviceId\": \"%s\"}, "
+        "\"fields\": {\"type\": \"fall\"}, \"time\": %" PRId64 "}",
+        mqtt_wrapper_device_id(), clock_to_utc_ms(data->acq_time_us.fall_detected));
+    if (len < 0 || (size_t)len >= sizeof(payload)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 경보는 덮어쓰지 않고 모두 전송 (예산 초과로도 버리지 않음)
+    esp_err_t err = mqtt_outbox_publish(MQTT_CLASS_ALERT, MQTT_TOPIC_ALERT, payload, len, false);
+    ESP_LOGW(TAG, "낙상 경보 대기열 등록 (err=%d)", err);
+    return err;
+}
+
+esp_err_t mqtt_send_vital_alert(const vital_alert_t *alert) {
+    char payload[320];
+    int len = snprintf(payload, sizeof(payload),
+        "{\"measurement\": \"alert\", \"tags\": {\"deviceId\": \"%s\"}, "
+        "\"fields\": {\"type\": \"vital\", \"rule\": %u, \"metric\": \"%s\", \"condition\": \"%s\", "
+        "\"severity\": \"%s\", \"state\": \"%s\", \"value\": %.2f, \"threshold\": %.2f}, "
         "\"time\": %" PRId64 "}",
-        // data.heart_rate, 
-        data.temperature, 
-        // data.spo2, 
-        data.steps, data.fall_detected, 
-        data.location.major, 
-        data.location.minor, data.location.rssi, 
-        timestamp_to_send);
-
-    esp_mqtt_client_publish(mqtt_client, "sensor/data", payload, 0, 1, 0);
-    ESP_LOGI("MQTT_SEND", "Published: %s (timestamp: %lld, type: %s)", payload, timestamp_to_send, timestamp_type);
+        mqtt_wrapper_device_id(), alert->rule_id, vital_metric_name((vital_metric_t)alert->metric),
+        vital_op_name((vital_op_t)alert->op), vital_severity_name((vital_severity_t)alert->severity),
+        alert->raised ? "raised" : "cleared", alert->value, alert->threshold, clock_to_utc_ms(alert->t_us));
+    if (len < 0 || (size_t)len >= sizeof(payload)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 발생/해제 모두 경보 클래스로 (덮어쓰면 해제가 발생을 지울 수 있으므로 모두 전송)
+    esp_err_t err = mqtt_outbox_publish(MQTT_CLASS_ALERT, MQTT_TOPIC_ALERT, payload, len, false);
+    ESP_LOGW(TAG, "생체 경보 대기열 등록: 규칙 %u %s (err=%d)", alert->rule_id, alert->raised ? "발생" : "해제", err);
+    return err;
+}
+
+#define FALL_WINDOW_PART_SAMPLES    100     // 조각당 샘플 수 (100Hz 1초, raw 1200B → base64 1600B)
+
+// raw는 샘플마다 ax, ay, az, gx, gy, gz int16 리틀 엔디언을 base64로 인코딩
+esp_err_t mqtt_send_fall_window(const fall_window_t *window, int part, int *parts) {
+    static char payload[2176];          // 전송 태스크에서만 호출 (스택 대신 정적 버퍼)
+    static uint8_t raw[FALL_WINDOW_PART_SAMPLES * 12];
+
+    int total = (window->count + FALL_WINDOW_PART_SAMPLES - 1) / FALL_WINDOW_PART_SAMPLES;
+    *parts = total;
+    if (part < 0 || part >= total) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int offset = part * FALL_WINDOW_PART_SAMPLES;
+    int n = window->count - offset;
+    if (n > FALL_WINDOW_PART_SAMPLES) {
+        n = FALL_WINDOW_PART_SAMPLES;
+    }
+    uint8_t *p = raw;
+    for (int i = 0; i < n; i++) {
+        for (int axis = 0; axis < 6; axis++) {
+            uint16_t v = (uint16_t)window->raw[offset + i][axis];
+            *p++ = (uint8_t)(v & 0xFF);
+            *p++ = (uint8_t)(v >> 8);
+        }
+    }
+
+    payload_buf_t pb = { payload, sizeof(payload), 0 };
+    pb_append(&pb, "{\"measurement\": \"fall_window\", \"tags\": {\"deviceId\": \"%s\"}, \"fields\": {"
+              "\"verdict\": \"%s\", \"reason\": \"%s\", \"impactTime\": %" PRId64 ", "
+              "\"impactG\": %.2f, \"freeFallMs\": %u, \"tiltDeg\": %.1f, \"postGyroRms\": %.1f, "
+              "\"hz\": %u, \"accLsbPerG\": %.0f, \"gyroLsbPerDps\": %.1f, "
+              "\"count\": %u, \"impactIndex\": %u, \"part\": %d, \"parts\": %d, \"offset\": %d, \"raw\": \"",
+              mqtt_wrapper_device_id(), window->confirmed ? "confirmed" : "rejected", window->reason,
+              clock_to_utc_ms(window->impact_time_us), window->impact_g, window->free_fall_ms, window->tilt_deg,
+              window->post_gyro_rms_dps, window->sample_hz, window->acc_lsb_per_g, window->gyro_lsb_per_dps,
+              window->count, window->impact_index, part, total, offset);
+    pb_append_base64(&pb, raw, (size_t)(p - raw));
+    pb_append(&pb, "\"}, \"time\": %" PRId64 "}", clock_to_utc_ms(clock_now_us()));
+
+    int len = pb.len;
+    if (len < 0 || (size_t)len >= sizeof(payload)) {
+        ESP_LOGE(TAG, "낙상 창 payload 버퍼 부족 (len=%d)", len);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 환경 클래스(QoS 1)를 빌려 씀: 생체 텔레메트리보다 먼저 버려지고 진단보다는 오래 남음
+    esp_err_t err = mqtt_outbox_publish(MQTT_CLASS_ENV, MQTT_TOPIC_FALL_WINDOW, payload, len, false);
+    DLOGI(TAG, "낙상 창 %d/%d 대기열 등록 err=%d, len=%d", part + 1, total, err, len);
+    return err;
+}
+
+void mqtt_send_diagnostics(void) {
+    mqtt_outbox_stats_t stats;
+    mqtt_outbox_get_stats(&stats);
+
+    metric_timer_stat_t pub = metrics_get_timer(METRIC_PUBLISH_LATENCY_MS);
+    // 연결 단계 시간: 마지막 연결 기준 (재연결 소요는 최댓값)
+    metric_timer_stat_t assoc = metrics_get_timer(METRIC_WIFI_ASSOC_MS);
+    metric_timer_stat_t dhcp = metrics_get_timer(METRIC_WIFI_DHCP_MS);
+    metric_timer_stat_t to_mqtt = metrics_get_timer(METRIC_WIFI_ASSOC_TO_MQTT_MS);
+    metric_timer_stat_t outage = metrics_get_timer(METRIC_WIFI_OUTAGE_MS);
+
+    char payload[768];
+    int len = snprintf(payload, sizeof(payload),
+        "{\"measurement\": \"diag\", \"tags\": {\"deviceId\": \"%s\"}, \"fields\": {"
+        "\"wifiDisconnects\": %lu, \"mqttDisconnects\": %lu, "
+        "\"dropAlert\": %lu, \"dropVitals\": %lu, \"dropEnv\": %lu, \"dropDiag\": %lu, "
+        "\"coalesced\": %lu, \"expired\": %lu, "
+        "\"inflight\": %u, \"pendingBytes\": %lu, \"outboxBytes\": %ld, "
+        "\"imuMisses\": %lu, \"pubLatencyMaxMs\": %lu, \"pipeDrops\": %lu, \"tempFrameDrops\": %lu, "
+        "\"vitalAlertDrops\": %lu, "
+        "\"assocMs\": %lu, \"dhcpMs\": %lu, \"assocToMqttMs\": %lu, \"assocToMqttAvgMs\": %lu, "
+        "\"outageMaxMs\": %lu}, "
+        "\"time\": %" PRId64 "}",
+        mqtt_wrapper_device_id(),
+        (unsigned long)metrics_get_counter(METRIC_WIFI_DISCONNECTS),
+        (unsigned long)metrics_get_counter(METRIC_MQTT_DISCONNECTS),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_DROPS_ALERT),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_DROPS_VITALS),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_DROPS_ENV),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_DROPS_DIAG),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_COALESCED),
+        (unsigned long)metrics_get_counter(METRIC_OUTBOX_EXPIRED),
+        stats.inflight, (unsigned long)stats.pending_bytes, (long)stats.outbox_bytes,
+        (unsigned long)metrics_get_counter(METRIC_IMU_DEADLINE_MISSES), (unsigned long)pub.max,
+        (unsigned long)metrics_get_counter(METRIC_PIPELINE_DROPS),
+        (unsigned long)metrics_get_counter(METRIC_TEMP_FRAME_DROPS),
+        (unsigned long)metrics_get_counter(METRIC_VITAL_ALERT_DROPS),
+        (unsigned long)assoc.last, (unsigned long)dhcp.last, (unsigned long)to_mqtt.last,
+        (unsigned long)(to_mqtt.count ? to_mqtt.sum / to_mqtt.count : 0), (unsigned long)outage.max,
+        clock_to_utc_ms(clock_now_us()));
+    if (len < 0 || (size_t)len >= sizeof(payload)) {
+        return;
+    }
+
+    // 진단은 최신 값만 의미 있으므로 덮어쓰기 (QoS 0, 가장 먼저 버려짐)
+    mqtt_outbox_publish(MQTT_CLASS_DIAG, MQTT_TOPIC_DIAG, payload, len, true);
 }
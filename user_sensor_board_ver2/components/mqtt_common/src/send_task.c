@@ -1,57 +1,118 @@
 #include "send_task.h"
 #include "sensor_data.h"
 #include "mqtt_sender.h"
-#include "sntp_helper.h"
-#include "esp_timer.h"
+#include "clock_service.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#define DLOG_LOCAL_LEVEL CONFIG_DLOG_LEVEL_MQTT_SEND
+#include "dlog.h"
+#include "trace_capture.h"
+#include "task_placement.h"
+#include "sensor_pipeline.h"
+#include "vital_rules.h"
+#include "metrics.h"
+#include "esp_timer.h"
+#include "mqtt_client_wrapper.h"
 
 static const char *TAG = "SEND_TASK";
 
+#define SEND_PERIOD_MS        1000
+#define DIAG_PERIOD_MS        60000
+
 // 실제로 주기적으로 실행되는 태스크 함수
 void send_task(void *pvParameters)
 {
+    TickType_t next_send = xTaskGetTickCount();
+    TickType_t next_diag = next_send + pdMS_TO_TICKS(DIAG_PERIOD_MS);
+    int64_t due_us = esp_timer_get_time();      // next_send에 해당하는 기한 (발행 지연 측정용)
+    int64_t last_alert_us = 0;
+    sensor_data_t fall_event;                   // 경보 대기열이 가득 차 아직 넣지 못한 낙상 경보
+    bool fall_pending = false;
+    vital_alert_t alert;                        // 〃 생체 경보 (규칙 링에서 이미 꺼냄)
+    bool alert_pending = false;
+    int fall_window_part = 0;                   // 전송 중인 낙상 창의 다음 조각
+
     while (1) {
-        // SNTP 동기화 상태에 따라 타임스탬프 설정
-        int64_t timestamp;
-        const char* timestamp_type;
-        
-        if (is_sntp_synced()) {
-            // SNTP 동기화된 경우: 유닉스 타임스탬프 사용
-            time_t world_time = get_current_world_time();
-            timestamp = (int64_t)world_time * 1000;  // 초를 밀리초로 변환
-            timestamp_type = "unix_timestamp_ms";
-        } else {
-            // SNTP 동기화되지 않은 경우: ESP 타이머 사용
-            timestamp = esp_timer_get_time() / 1000;  // 마이크로초를 밀리초로 변환
-            timestamp_type = "esp_time_ms";
-        }
-        
-        sensor_data_set_timestamp(timestamp);
+        // 주기까지 대기하되, 낙상/생체 경보 알림이 오면 바로 깨어남
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = ((int32_t)(next_send - now) > 0) ? next_send - now : 0;
+        bool notified = ulTaskNotifyTake(pdTRUE, wait) > 0;
 
-        // 구조체 복사 (mutex로 보호됨)
+        // 구조체 복사 (mutex로 보호됨) - 항목별 타임스탬프는 획득 시점에 이미 찍혀 있음
         sensor_data_t snapshot = sensor_data_get_snapshot();
+
+        // 새 낙상 이벤트는 경보 클래스로 먼저 전송
+        if (snapshot.validity_flags.fall_detected_valid && snapshot.fall_detected &&
+            snapshot.acq_time_us.fall_detected != last_alert_us) {
+            last_alert_us = snapshot.acq_time_us.fall_detected;
+            fall_event = snapshot;
+            fall_pending = true;
+        }
+        // 경보는 버리지 않으므로 거절되면 다음 주기에 다시 넣는다
+        if (fall_pending && mqtt_send_fall_alert(&fall_event) == ESP_OK) {
+            fall_pending = false;
+        }
+        // 생체 규칙 경보 (집계 태스크가 규칙 상태가 바뀔 때마다 넣음, 거절되면 순서를 지켜 다음 주기에 이어서)
+        while (alert_pending || vital_rules_take_alert(&alert)) {
+            alert_pending = (mqtt_send_vital_alert(&alert) != ESP_OK);
+            if (alert_pending) {
+                break;
+            }
+        }
+        if (notified && (int32_t)(next_send - xTaskGetTickCount()) > 0) {
+            continue;
+        }
+        next_send += pdMS_TO_TICKS(SEND_PERIOD_MS);
+        int64_t this_due_us = due_us;
+        due_us += (int64_t)SEND_PERIOD_MS * 1000;
         
         // 유효한 측정값이 있는지 확인
-        if (sensor_data_has_valid_measurements()) {
-            int valid_count = sensor_data_get_valid_count();
-            ESP_LOGI(TAG, "Sending data with %d valid sensors, timestamp: %lld (%s, SNTP synced: %s)", 
-                     valid_count, timestamp, timestamp_type, is_sntp_synced() ? "YES" : "NO");
+        if (sensor_data_has_valid_measurements(&snapshot)) {
+            int valid_count = sensor_data_get_valid_count(&snapshot);
+            DLOGI(TAG, "Sending data with %d valid sensors (UTC valid: %s)",
+                     valid_count, clock_is_utc_valid() ? "YES" : "NO");
             
             // MQTT 전송 - mqtt_sender.c 내부 함수
+            TRACE_BEGIN(TRACE_MARK_PUBLISH);
             mqtt_send_sensor_data(snapshot);
+            TRACE_END(TRACE_MARK_PUBLISH);
+            int64_t late_us = esp_timer_get_time() - this_due_us;
+            metrics_record_ms(METRIC_PUBLISH_LATENCY_MS, late_us > 0 ? (uint32_t)(late_us / 1000) : 0);
         } else {
-            ESP_LOGW(TAG, "Skipping MQTT send - no valid measurements");
+            ESP_LOGW(TAG, "Skipping MQTT send - no fresh measurements");
+        }
+
+        // 낙상 후보 원시 창: 연결돼 있을 때 주기마다 한 조각씩 (outbox 예산 안에서 흘려보냄)
+        const fall_window_t *window = sensor_data_peek_fall_window();
+        if (window != NULL && mqtt_is_connected()) {
+            int parts = 0;
+            esp_err_t err = mqtt_send_fall_window(window, fall_window_part, &parts);
+            if (err == ESP_OK) {
+                fall_window_part++;
+            }
+            // 메모리 부족은 다음 주기에 같은 조각을 재시도, 그 밖의 오류는 창을 포기
+            if (fall_window_part >= parts || (err != ESP_OK && err != ESP_ERR_NO_MEM)) {
+                sensor_data_release_fall_window();
+                fall_window_part = 0;
+            }
         }
 
-        // 다음 전송까지 대기 (1초)
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        if ((int32_t)(xTaskGetTickCount() - next_diag) >= 0) {
+            next_diag += pdMS_TO_TICKS(DIAG_PERIOD_MS);
+            mqtt_send_diagnostics();
+            metrics_log_summary();
+            task_placement_check_stacks();
+            sensor_pipeline_log_stats();
+        }
     }
 }
 
 // app_main에서 호출할 시작 함수
 void start_send_task(void)
 {
-    xTaskCreate(send_task, "send_task", 4096, NULL, 5, NULL);
+    TaskHandle_t handle = NULL;
+    task_placement_create(TASK_ID_SEND, send_task, NULL, &handle);
+    sensor_data_set_event_task(handle);
+    vital_rules_set_event_task(handle);
 }
@@ -0,0 +1,49 @@
+// sensor_backend.h
+// 센서/BLE 입력 백엔드 (Kconfig 선택)
+//
+// CONFIG_SENSOR_BACKEND_HARDWARE: 드라이버가 I2C/NimBLE로 실제 장치를 읽는다 (이 컴포넌트는 이름만 제공)
+// CONFIG_SENSOR_BACKEND_SYNTHETIC: 심박/SpO2/보행/낙상/체온/앵커 RSSI를 수식으로 생성
+// CONFIG_SENSOR_BACKEND_TRACE: 펌웨어에 임베드된 CSV 트레이스를 시간축에 맞춰 재생
+//
+// 가상 백엔드는 링커 --wrap으로 i2c_master_write_to_device / i2c_master_write_read_device와
+// NimBLE 포트/GAP 탐색 함수를 가로챈다. I2C 쪽은 MPU6050/MAX30102/MLX90614를 레지스터 수준으로
+// 모델링(WHO_AM_I, 측정 범위, FIFO 포인터, LED 전류, SMBus PEC)하고, BLE 쪽은 가상 앵커의
+// iBeacon 광고를 BLE_GAP_EVENT_DISC로 기존 GAP 콜백에 전달한다. 따라서 드라이버,
+// sensor_manager 스케줄링, DSP, sensor_data, send_task는 수정 없이 QEMU 등 하드웨어 없는
+// 환경에서 그대로 동작한다.
+
+#ifndef SENSOR_BACKEND_H
+#define SENSOR_BACKEND_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_SENSOR_BACKEND_SYNTHETIC || CONFIG_SENSOR_BACKEND_TRACE
+#define SENSOR_BACKEND_VIRTUAL 1
+#else
+#define SENSOR_BACKEND_VIRTUAL 0
+#endif
+
+/**
+ * @brief 백엔드 초기화 (가상 시간축 시작, 트레이스 검증)
+ *
+ * 가로챈 I2C/BLE 호출이 처음 들어올 때 자동으로 호출되므로 명시적으로 부르지 않아도 된다.
+ * 여러 번 호출해도 한 번만 수행하며 하드웨어 백엔드에서는 아무것도 하지 않는다.
+ * @return ESP_OK, 트레이스가 비었거나 형식이 틀리면 ESP_ERR_INVALID_ARG
+ */
+esp_err_t sensor_backend_init(void);
+
+/**
+ * @brief 선택된 백엔드 이름 ("hardware", "synthetic", "trace")
+ */
+const char *sensor_backend_name(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSOR_BACKEND_H
@@ -0,0 +1,100 @@
+// sensor_backend.c
+
+#include "sensor_backend.h"
+
+#if SENSOR_BACKEND_VIRTUAL
+
+#include "sensor_backend_priv.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "SENSOR_BACKEND";
+
+// 0: 미초기화, 1: 초기화 중, 2: 완료
+static volatile int s_state = 0;
+static portMUX_TYPE s_init_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_err_t s_init_err = ESP_OK;
+static int64_t s_t0_us = 0;
+
+esp_err_t sensor_backend_init(void) {
+    bool run = false;
+    portENTER_CRITICAL(&s_init_lock);
+    if (s_state == 0) {
+        s_state = 1;
+        run = true;
+    }
+    portEXIT_CRITICAL(&s_init_lock);
+
+    if (!run) {
+        // 다른 태스크가 초기화 중이면 끝날 때까지 대기
+        while (s_state != 2) {
+            vTaskDelay(1);
+        }
+        return s_init_err;
+    }
+
+    s_init_err = backend_signal_init();
+    s_t0_us = esp_timer_get_time();
+    s_state = 2;
+
+    if (s_init_err != ESP_OK) {
+        ESP_LOGE(TAG, "%s 신호원 초기화 실패: %s", backend_signal_name(), esp_err_to_name(s_init_err));
+    } else {
+        ESP_LOGW(TAG, "가상 센서 백엔드 사용: %s (I2C/NimBLE 호출은 장치 모델로 대체됨)", backend_signal_name());
+    }
+    return s_init_err;
+}
+
+const char *sensor_backend_name(void) {
+    return backend_signal_name();
+}
+
+int64_t backend_now_us(void) {
+    if (s_state != 2) {
+        sensor_backend_init();
+    }
+    return esp_timer_get_time() - s_t0_us;
+}
+
+uint32_t backend_rand(uint32_t *state) {
+    // xorshift32 - 시드가 같으면 같은 신호가 재현된다
+    uint32_t x = *state ? *state : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+float backend_randf(uint32_t *state) {
+    return (backend_rand(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+float backend_gauss(uint32_t *state) {
+    // 균등분포 4개 합 (분산 1/3) → 표준정규 근사
+    float s = backend_randf(state) + backend_randf(state) + backend_randf(state) + backend_randf(state);
+    return (s - 2.0f) * 1.7320508f;
+}
+
+bool backend_inject_error(uint32_t *state) {
+#if CONFIG_SENSOR_BACKEND_I2C_ERROR_PERMILLE > 0
+    return (backend_rand(state) % 1000) < CONFIG_SENSOR_BACKEND_I2C_ERROR_PERMILLE;
+#else
+    (void)state;
+    return false;
+#endif
+}
+
+#else // 하드웨어 백엔드
+
+esp_err_t sensor_backend_init(void) {
+    return ESP_OK;
+}
+
+const char *sensor_backend_name(void) {
+    return "hardware";
+}
+
+#endif
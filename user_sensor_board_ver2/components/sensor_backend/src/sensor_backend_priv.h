@@ -0,0 +1,69 @@
+// sensor_backend_priv.h
+// 가상 백엔드 내부 공용 정의
+//
+// 신호원(signal_synth.c 또는 signal_trace.c 중 하나가 빌드됨)은 물리 단위 값을 시간의 함수로
+// 내놓고, 장치 모델(virt_i2c.c, virt_ble.c)이 이를 레지스터 값/광고 패킷으로 바꾼다.
+// 시간은 모두 sensor_backend_init() 이후 경과 µs이다.
+
+#ifndef SENSOR_BACKEND_PRIV_H
+#define SENSOR_BACKEND_PRIV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// ---- 신호원 ----
+
+typedef struct {
+    float ax, ay, az;       // g
+    float gx, gy, gz;       // dps
+} backend_imu_t;
+
+/**
+ * @brief 광고 1건 전달 콜백 (major/minor는 호스트 바이트 순서)
+ */
+typedef void (*backend_adv_fn_t)(uint16_t major, uint16_t minor, int rssi, void *arg);
+
+esp_err_t backend_signal_init(void);
+const char *backend_signal_name(void);
+
+/**
+ * @brief t_us 시점의 손목 IMU 값
+ * @return 신호가 없으면 false (트레이스에 해당 행이 없음)
+ */
+bool backend_signal_imu(int64_t t_us, backend_imu_t *out);
+
+/**
+ * @brief t_us 시점의 PPG 광전류 (기본 설정 12mA / ADC 4096nA / 18비트 기준 ADC 카운트)
+ */
+bool backend_signal_ppg(int64_t t_us, float *red, float *ir);
+
+/**
+ * @brief t_us 시점의 피부(물체) 온도와 주변 온도 (°C)
+ */
+bool backend_signal_temp(int64_t t_us, float *object_c, float *ambient_c);
+
+/**
+ * @brief (from_us, to_us] 구간에 수신된 앵커 광고를 시간 순서대로 전달
+ * @param rx_prob 광고 1건의 수신 확률 (스캔 윈도우/간격, 합성 신호원만 사용)
+ * @return 전달한 광고 수
+ */
+int backend_signal_adv(int64_t from_us, int64_t to_us, float rx_prob, backend_adv_fn_t fn, void *arg);
+
+// ---- sensor_backend.c ----
+
+/**
+ * @brief sensor_backend_init() 이후 경과 µs (처음 호출 시 초기화)
+ */
+int64_t backend_now_us(void);
+
+uint32_t backend_rand(uint32_t *state);
+float backend_randf(uint32_t *state);       // [0, 1)
+float backend_gauss(uint32_t *state);       // 근사 N(0, 1)
+
+/**
+ * @brief CONFIG_SENSOR_BACKEND_I2C_ERROR_PERMILLE 확률로 true (버스 오류 주입)
+ */
+bool backend_inject_error(uint32_t *state);
+
+#endif // SENSOR_BACKEND_PRIV_H
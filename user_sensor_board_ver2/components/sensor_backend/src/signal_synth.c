@@ -0,0 +1,320 @@
+// signal_synth.c
+// 합성 신호원 (CONFIG_SENSOR_BACKEND_SYNTHETIC)
+//
+// 활동 주기(CONFIG_SENSOR_BACKEND_SYNTH_ACTIVITY_PERIOD_S)를 1/3 정지 → 1/2 보행 → 1/6 정지로 나누고
+// 모든 채널이 같은 활동 상태를 공유한다. 보행 중에는 손목 가속도/자이로에 걸음 주기 성분이 생기고
+// 심박이 오르며 PPG에 걸음과 상관된 모션 아티팩트가 섞이고 착용자가 앵커 사이를 이동한다.
+// 낙상(CONFIG_SENSOR_BACKEND_SYNTH_FALL_INTERVAL_S)은 자유낙하 → 충격 → 누운 자세 순서로 재현한다.
+// 미착용(CONFIG_SENSOR_BACKEND_SYNTH_OFF_WRIST_INTERVAL_S) 구간에는 시계가 책상 위에 놓인 것처럼
+// IMU는 수평 정지, PPG는 LED 누설광, 체온은 주변 온도가 되어 펌웨어의 착용 감지를 시험할 수 있다.
+// 활동/위치는 경과 시간의 순수 함수이고 잡음은 채널별 고정 시드 난수열이다.
+
+#include "sensor_backend_priv.h"
+#include "sdkconfig.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define US_PER_S            1000000LL
+
+// 보행
+#define STEP_HZ             1.8f        // 걸음 주파수
+#define WALK_SPEED_MPS      1.2f
+#define WALK_HR_RISE_BPM    25.0f
+#define WALK_HR_TAU_S       30.0f       // 보행 중 심박 상승 시정수
+#define REST_HR_TAU_S       60.0f       // 정지 후 회복 시정수
+
+// 낙상 (충격 시점 기준)
+#define FALL_FREEFALL_US    300000LL
+#define FALL_IMPACT_US      50000LL
+#define FALL_LYING_US       10000000LL
+
+// PPG (12mA, ADC 4096nA 기준 카운트)
+#define PPG_DC_IR           120000.0f
+#define PPG_DC_RED          90000.0f
+#define PPG_PERFUSION_IR    0.02f       // IR AC/DC
+#define PPG_MOTION_GAIN     0.006f      // 보행 시 아티팩트 진폭 (DC 대비)
+#define PPG_NOISE_COUNTS    30.0f
+#define RESP_HZ             0.25f       // 호흡 (기저선 변동, 호흡성 부정맥)
+#define PPG_OFF_WRIST_IR    300.0f      // 미착용 시 LED → PD 누설광 (12mA 기준 카운트)
+#define PPG_OFF_WRIST_RED   200.0f
+
+// 앵커 배치: 복도를 따라 ANCHOR_SPACING_M 간격, 착용자는 ANCHOR_OFFSET_M 떨어진 선을 왕복
+#define ANCHOR_SPACING_M    8.0f
+#define ANCHOR_OFFSET_M     2.0f
+#define ANCHOR_TX_1M_DBM    (-59.0f)    // iBeacon measured power
+#define PATH_LOSS_EXP       2.2f
+#define RSSI_SIGMA_DB       4.0f
+#define RSSI_FLOOR_DBM      (-95)
+
+typedef struct {
+    bool walking;
+    float walk_s;           // 현재 보행 구간 경과 (s)
+    float rest_s;           // 마지막 보행 종료 후 경과 (s), 보행 이력이 없으면 음수
+    float walk_total_s;     // 누적 보행 시간 (위치 계산용)
+} activity_t;
+
+static struct {
+    uint32_t rng_imu;
+    uint32_t rng_ppg;
+    uint32_t rng_temp;
+    uint32_t rng_adv;
+    double ppg_phase;       // 박동 위상 (회전 수)
+    int64_t ppg_last_us;
+} s_synth;
+
+esp_err_t backend_signal_init(void) {
+    memset(&s_synth, 0, sizeof(s_synth));
+    uint32_t seed = (uint32_t)CONFIG_SENSOR_BACKEND_SEED;
+    s_synth.rng_imu = seed * 2654435761u + 1;
+    s_synth.rng_ppg = seed * 2654435761u + 2;
+    s_synth.rng_temp = seed * 2654435761u + 3;
+    s_synth.rng_adv = seed * 2654435761u + 4;
+    return ESP_OK;
+}
+
+const char *backend_signal_name(void) {
+    return "synthetic";
+}
+
+static void activity_at(int64_t t_us, activity_t *a) {
+    const int64_t period_us = (int64_t)CONFIG_SENSOR_BACKEND_SYNTH_ACTIVITY_PERIOD_S * US_PER_S;
+    memset(a, 0, sizeof(*a));
+    if (period_us <= 0) {
+        a->rest_s = -1.0f;
+        return;
+    }
+
+    const int64_t still_us = period_us / 3;
+    const int64_t walk_us = period_us / 2;
+    int64_t cycle = t_us / period_us;
+    int64_t pos = t_us % period_us;
+
+    int64_t walked = pos - still_us;
+    if (walked < 0) walked = 0;
+    if (walked > walk_us) walked = walk_us;
+    a->walk_total_s = (float)((cycle * walk_us + walked) / 1000) / 1000.0f;
+
+    if (pos >= still_us && pos < still_us + walk_us) {
+        a->walking = true;
+        a->walk_s = (float)(pos - still_us) / US_PER_S;
+    } else if (pos >= still_us + walk_us) {
+        a->rest_s = (float)(pos - still_us - walk_us) / US_PER_S;
+    } else if (cycle > 0) {
+        a->rest_s = (float)(pos + period_us - still_us - walk_us) / US_PER_S;
+    } else {
+        a->rest_s = -1.0f;
+    }
+}
+
+// 낙상 에피소드 안이면 충격 시점 기준 경과 µs (자유낙하 구간은 음수), 아니면 INT64_MIN
+static int64_t fall_offset_us(int64_t t_us) {
+#if CONFIG_SENSOR_BACKEND_SYNTH_FALL_INTERVAL_S > 0
+    const int64_t interval_us = (int64_t)CONFIG_SENSOR_BACKEND_SYNTH_FALL_INTERVAL_S * US_PER_S;
+    int64_t k = (t_us + FALL_FREEFALL_US) / interval_us;
+    if (k > 0) {
+        int64_t dt = t_us - k * interval_us;
+        if (dt < FALL_IMPACT_US + FALL_LYING_US) {
+            return dt;
+        }
+    }
+#endif
+    return INT64_MIN;
+}
+
+// 미착용 구간인지 (주기의 시작부터 지속 시간 동안, 첫 주기는 착용으로 시작)
+static bool off_wrist_at(int64_t t_us) {
+#if CONFIG_SENSOR_BACKEND_SYNTH_OFF_WRIST_INTERVAL_S > 0
+    const int64_t interval_us = (int64_t)CONFIG_SENSOR_BACKEND_SYNTH_OFF_WRIST_INTERVAL_S * US_PER_S;
+    const int64_t duration_us = (int64_t)CONFIG_SENSOR_BACKEND_SYNTH_OFF_WRIST_DURATION_S * US_PER_S;
+    return t_us >= interval_us && (t_us % interval_us) < duration_us;
+#else
+    (void)t_us;
+    return false;
+#endif
+}
+
+static float heart_rate_bpm(const activity_t *a) {
+    float hr = (float)CONFIG_SENSOR_BACKEND_SYNTH_HR_BPM;
+    if (a->walking) {
+        hr += WALK_HR_RISE_BPM * (1.0f - expf(-a->walk_s / WALK_HR_TAU_S));
+    } else if (a->rest_s >= 0.0f) {
+        float walk_len_s = CONFIG_SENSOR_BACKEND_SYNTH_ACTIVITY_PERIOD_S / 2.0f;
+        float peak = WALK_HR_RISE_BPM * (1.0f - expf(-walk_len_s / WALK_HR_TAU_S));
+        hr += peak * expf(-a->rest_s / REST_HR_TAU_S);
+    }
+    return hr;
+}
+
+bool backend_signal_imu(int64_t t_us, backend_imu_t *out) {
+    activity_t a;
+    activity_at(t_us, &a);
+    float t = (float)(t_us % (100 * US_PER_S)) / US_PER_S;     // 주기 성분용 (100s마다 접어 float 정밀도 유지)
+
+    // 손목이 거의 수평일 때의 중력 방향
+    out->ax = 0.05f;
+    out->ay = -0.10f;
+    out->az = 0.99f;
+    out->gx = 0.5f;         // 자이로 바이어스
+    out->gy = -0.3f;
+    out->gz = 0.2f;
+
+    int64_t fall_dt = fall_offset_us(t_us);
+    if (off_wrist_at(t_us)) {
+        // 책상 위: 수평 정지 (바이어스와 잡음만)
+        out->ax = 0.0f;
+        out->ay = 0.0f;
+        out->az = 1.0f;
+    } else if (fall_dt != INT64_MIN) {
+        if (fall_dt < 0) {
+            // 자유낙하: 합가속도 ~0.3g, 손목 회전
+            float k = (float)(fall_dt + FALL_FREEFALL_US) / FALL_FREEFALL_US;
+            out->ax = 0.05f + 0.25f * k;
+            out->ay = -0.10f;
+            out->az = 0.30f * (1.0f - k);
+            out->gx = 180.0f;
+            out->gy = 120.0f;
+        } else if (fall_dt < FALL_IMPACT_US) {
+            // 충격: 6g (펌웨어의 ±16g 설정에서는 포화 없이 그대로 보임)
+            out->ax = 3.6f;
+            out->ay = 3.6f;
+            out->az = 3.0f;
+            out->gx = -250.0f;
+            out->gy = 300.0f;
+        } else {
+            // 누운 자세: 중력이 X축으로
+            out->ax = 0.98f;
+            out->ay = 0.10f;
+            out->az = 0.15f;
+        }
+    } else if (a.walking) {
+        float w = 2.0f * (float)M_PI * STEP_HZ * t;
+        out->ax += 0.30f * sinf(w) + 0.08f * sinf(2.0f * w);
+        out->ay += 0.18f * sinf(w + 1.2f);
+        out->az += 0.15f * sinf(2.0f * w);
+        out->gx += 40.0f * sinf(0.5f * w);      // 팔 흔들기는 걸음 주파수의 절반
+        out->gy += 15.0f * sinf(0.5f * w + 0.5f);
+        out->gz += 10.0f * sinf(w);
+    }
+
+    out->ax += 0.004f * backend_gauss(&s_synth.rng_imu);
+    out->ay += 0.004f * backend_gauss(&s_synth.rng_imu);
+    out->az += 0.004f * backend_gauss(&s_synth.rng_imu);
+    out->gx += 0.1f * backend_gauss(&s_synth.rng_imu);
+    out->gy += 0.1f * backend_gauss(&s_synth.rng_imu);
+    out->gz += 0.1f * backend_gauss(&s_synth.rng_imu);
+    return true;
+}
+
+// 박동 한 주기 파형 (수축기 피크 + 중복맥), 위상 [0, 1)
+static float pulse_shape(float ph) {
+    float a = (ph - 0.15f) / 0.07f;
+    float b = (ph - 0.42f) / 0.09f;
+    return expf(-a * a) + 0.35f * expf(-b * b);
+}
+
+bool backend_signal_ppg(int64_t t_us, float *red, float *ir) {
+    activity_t a;
+    activity_at(t_us, &a);
+    float t = (float)(t_us % (100 * US_PER_S)) / US_PER_S;
+    float resp = sinf(2.0f * (float)M_PI * RESP_HZ * t);
+
+    // 박동 위상 적분 (FIFO 샘플 시각 순서로 호출된다)
+    float hr_hz = heart_rate_bpm(&a) / 60.0f * (1.0f + 0.04f * resp);
+    if (t_us > s_synth.ppg_last_us) {
+        s_synth.ppg_phase += (double)hr_hz * (double)(t_us - s_synth.ppg_last_us) / US_PER_S;
+        s_synth.ppg_phase -= floor(s_synth.ppg_phase);
+    }
+    s_synth.ppg_last_us = t_us;
+    float g = pulse_shape((float)s_synth.ppg_phase);
+
+    if (off_wrist_at(t_us)) {
+        *ir = PPG_OFF_WRIST_IR + PPG_NOISE_COUNTS * backend_gauss(&s_synth.rng_ppg);
+        *red = PPG_OFF_WRIST_RED + PPG_NOISE_COUNTS * backend_gauss(&s_synth.rng_ppg);
+        return true;
+    }
+
+    // 비율 R = (AC_red/DC_red)/(AC_ir/DC_ir), SpO2 ≈ 110 - 25R
+    float r_ratio = (110.0f - CONFIG_SENSOR_BACKEND_SYNTH_SPO2) / 25.0f;
+    float base = 1.0f + 0.01f * resp;
+    float ir_v = PPG_DC_IR * base * (1.0f - PPG_PERFUSION_IR * g);
+    float red_v = PPG_DC_RED * base * (1.0f - PPG_PERFUSION_IR * r_ratio * g);
+
+    int64_t fall_dt = fall_offset_us(t_us);
+    if (a.walking && fall_dt == INT64_MIN) {
+        float m = PPG_MOTION_GAIN * sinf(2.0f * (float)M_PI * STEP_HZ * t + 0.7f);
+        ir_v += PPG_DC_IR * m;
+        red_v += PPG_DC_RED * m;
+    } else if (fall_dt != INT64_MIN && fall_dt < 500000) {
+        // 충격 직후 센서 접촉이 흔들림
+        ir_v *= 0.85f;
+        red_v *= 0.85f;
+    }
+
+    *ir = ir_v + PPG_NOISE_COUNTS * backend_gauss(&s_synth.rng_ppg);
+    *red = red_v + PPG_NOISE_COUNTS * backend_gauss(&s_synth.rng_ppg);
+    return true;
+}
+
+bool backend_signal_temp(int64_t t_us, float *object_c, float *ambient_c) {
+    activity_t a;
+    activity_at(t_us, &a);
+    float t_s = (float)(t_us % (3600 * US_PER_S)) / US_PER_S;
+
+    float skin = CONFIG_SENSOR_BACKEND_SYNTH_SKIN_TEMP_X10 / 10.0f;
+    skin += 0.3f * sinf(2.0f * (float)M_PI * t_s / 900.0f);
+    if (a.walking) {
+        skin -= 0.3f * (1.0f - expf(-a.walk_s / 120.0f));     // 보행 중 손목 냉각
+    }
+    *ambient_c = 24.0f + 0.5f * sinf(2.0f * (float)M_PI * t_s / 3600.0f);
+    if (off_wrist_at(t_us)) {
+        skin = *ambient_c;      // 시계 뒷면이 주변 온도를 봄
+    }
+    *object_c = skin + 0.03f * backend_gauss(&s_synth.rng_temp);
+    return true;
+}
+
+int backend_signal_adv(int64_t from_us, int64_t to_us, float rx_prob, backend_adv_fn_t fn, void *arg) {
+    const int anchors = CONFIG_SENSOR_BACKEND_SYNTH_ANCHORS;
+    const int64_t interval_us = (int64_t)CONFIG_SENSOR_BACKEND_SYNTH_ADV_INTERVAL_MS * 1000;
+    if (to_us <= from_us) {
+        return 0;
+    }
+
+    // 착용자 위치: 누적 보행 거리를 복도 길이로 접은 삼각파
+    activity_t a;
+    activity_at(to_us, &a);
+    float span = ANCHOR_SPACING_M * (anchors - 1);
+    float pos = 0.0f;
+    if (span > 0.0f) {
+        pos = fmodf(a.walk_total_s * WALK_SPEED_MPS, 2.0f * span);
+        if (pos > span) pos = 2.0f * span - pos;
+    }
+
+    // 앵커별 기대 RSSI (로그 거리 경로 손실)
+    float mean_rssi[8];
+    for (int i = 0; i < anchors && i < 8; i++) {
+        float dx = pos - ANCHOR_SPACING_M * i;
+        float d = sqrtf(dx * dx + ANCHOR_OFFSET_M * ANCHOR_OFFSET_M);
+        mean_rssi[i] = ANCHOR_TX_1M_DBM - 10.0f * PATH_LOSS_EXP * log10f(d);
+    }
+
+    // 광고 슬롯 순회 (앵커마다 위상을 조금씩 어긋나게)
+    int sent = 0;
+    for (int64_t slot = from_us / interval_us; slot * interval_us <= to_us; slot++) {
+        for (int i = 0; i < anchors && i < 8; i++) {
+            int64_t t = slot * interval_us + i * 7000;
+            if (t <= from_us || t > to_us) continue;
+            if (backend_randf(&s_synth.rng_adv) >= rx_prob) continue;
+
+            int rssi = (int)lroundf(mean_rssi[i] + RSSI_SIGMA_DB * backend_gauss(&s_synth.rng_adv));
+            if (rssi < RSSI_FLOOR_DBM) continue;
+            fn(1, (uint16_t)(i + 1), rssi, arg);
+            sent++;
+        }
+    }
+    return sent;
+}
@@ -0,0 +1,261 @@
+// signal_trace.c
+// 트레이스 재생 신호원 (CONFIG_SENSOR_BACKEND_TRACE)
+//
+// CONFIG_SENSOR_BACKEND_TRACE_FILE을 펌웨어에 텍스트로 임베드하고 종류별 커서로 스트리밍 재생한다
+// (힙 사용 없음). 형식은 한 줄에 한 샘플, 시각 오름차순:
+//
+//   # 주석,  #duration_ms=<반복 길이> (없으면 마지막 시각 + 10ms)
+//   <t_ms>,imu,<ax_g>,<ay_g>,<az_g>,<gx_dps>,<gy_dps>,<gz_dps>
+//   <t_ms>,ppg,<red>,<ir>              (12mA / ADC 4096nA / 18비트 기준 카운트)
+//   <t_ms>,temp,<object_c>,<ambient_c>
+//   <t_ms>,adv,<major>,<minor>,<rssi>  (광고 1건 수신)
+//
+// imu/ppg/temp는 해당 시각 이전의 마지막 행을 유지(sample-and-hold)하고 adv는 행마다 한 번 전달한다.
+// tools/synth_sensor_trace.py가 이 형식으로 시나리오를 생성한다.
+
+#include "sensor_backend_priv.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "SENSOR_TRACE";
+
+extern const char trace_start[] asm("_binary_sensor_trace_start");
+extern const char trace_end[] asm("_binary_sensor_trace_end");
+
+#define TRACE_MAX_VALUES 6
+
+typedef enum {
+    TRACE_IMU = 0,
+    TRACE_PPG,
+    TRACE_TEMP,
+    TRACE_ADV,
+    TRACE_KIND_COUNT
+} trace_kind_t;
+
+static const struct {
+    const char *name;
+    int values;
+} s_kinds[TRACE_KIND_COUNT] = {
+    [TRACE_IMU]  = { "imu", 6 },
+    [TRACE_PPG]  = { "ppg", 2 },
+    [TRACE_TEMP] = { "temp", 2 },
+    [TRACE_ADV]  = { "adv", 3 },
+};
+
+typedef struct {
+    int64_t t_us;
+    float v[TRACE_MAX_VALUES];
+} trace_row_t;
+
+// 종류별 재생 커서 (imu/ppg/temp는 sensor_manager 태스크, adv는 BLE 타이머에서만 사용)
+typedef struct {
+    const char *pos;            // 다음 행 탐색 위치
+    int64_t base_us;            // 현재 반복의 시작 시각
+    trace_row_t cur;
+    trace_row_t next;
+    bool have_cur;
+    bool have_next;
+} trace_cursor_t;
+
+static trace_cursor_t s_cursor[TRACE_KIND_COUNT];
+static int64_t s_duration_us = 0;
+static uint32_t s_rows[TRACE_KIND_COUNT];
+
+static const char *line_end(const char *p) {
+    while (p < trace_end && *p != '\n' && *p != '\0') p++;
+    return p;
+}
+
+// p에서 시작하는 한 줄을 파싱 - 종류가 맞으면 row를 채우고 true
+static bool parse_line(const char *p, const char *end, trace_kind_t *kind, trace_row_t *row) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (p >= end || *p == '#') {
+        return false;
+    }
+
+    char *q;
+    double t_ms = strtod(p, &q);
+    if (q == p || q >= end || *q != ',') {
+        return false;
+    }
+    p = q + 1;
+
+    for (int k = 0; k < TRACE_KIND_COUNT; k++) {
+        size_t n = strlen(s_kinds[k].name);
+        if ((size_t)(end - p) > n && strncmp(p, s_kinds[k].name, n) == 0 && p[n] == ',') {
+            p += n;
+            for (int i = 0; i < s_kinds[k].values; i++) {
+                if (p >= end || *p != ',') {
+                    return false;
+                }
+                row->v[i] = strtof(p + 1, &q);
+                if (q == p + 1) {
+                    return false;
+                }
+                p = q;
+            }
+            row->t_us = (int64_t)(t_ms * 1000.0);
+            *kind = (trace_kind_t)k;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 커서 종류의 다음 행 읽기 (반복 설정이면 끝에서 처음으로 돌아감)
+static bool fetch_next(trace_cursor_t *c, trace_kind_t want) {
+    for (int wrapped = 0; wrapped < 2; wrapped++) {
+        while (c->pos < trace_end && *c->pos != '\0') {
+            const char *end = line_end(c->pos);
+            trace_kind_t kind;
+            trace_row_t row;
+            bool ok = parse_line(c->pos, end, &kind, &row);
+            c->pos = (end < trace_end) ? end + 1 : end;
+            if (ok && kind == want) {
+                c->next = row;
+                c->next.t_us += c->base_us;
+                c->have_next = true;
+                return true;
+            }
+        }
+#if CONFIG_SENSOR_BACKEND_TRACE_LOOP
+        if (s_rows[want] == 0) {
+            break;
+        }
+        c->pos = trace_start;
+        c->base_us += s_duration_us;
+#else
+        break;
+#endif
+    }
+    c->have_next = false;
+    return false;
+}
+
+// t_us 이전의 마지막 행으로 커서를 진행
+static const trace_row_t *hold_at(trace_kind_t kind, int64_t t_us) {
+    trace_cursor_t *c = &s_cursor[kind];
+    while (c->have_next && c->next.t_us <= t_us) {
+        c->cur = c->next;
+        c->have_cur = true;
+        fetch_next(c, kind);
+    }
+    if (c->have_cur) {
+        return &c->cur;
+    }
+    // 첫 행 이전이면 첫 행 값을 사용
+    return c->have_next ? &c->next : NULL;
+}
+
+esp_err_t backend_signal_init(void) {
+    memset(s_rows, 0, sizeof(s_rows));
+    int64_t last_us = 0;
+    int64_t duration_us = 0;
+    int line_no = 0;
+
+    // 전체 검증: 종류별 행 수, 시각 오름차순, 반복 길이
+    for (const char *p = trace_start; p < trace_end && *p != '\0'; ) {
+        const char *end = line_end(p);
+        line_no++;
+
+        if (strncmp(p, "#duration_ms=", 13) == 0) {
+            duration_us = (int64_t)(strtod(p + 13, NULL) * 1000.0);
+        } else {
+            trace_kind_t kind;
+            trace_row_t row;
+            if (parse_line(p, end, &kind, &row)) {
+                if (row.t_us < last_us) {
+                    ESP_LOGE(TAG, "%d행: 시각이 감소함", line_no);
+                    return ESP_ERR_INVALID_ARG;
+                }
+                last_us = row.t_us;
+                s_rows[kind]++;
+            } else {
+                const char *s = p;
+                while (s < end && (*s == ' ' || *s == '\t' || *s == '\r')) s++;
+                if (s < end && *s != '#') {
+                    ESP_LOGE(TAG, "%d행: 형식 오류", line_no);
+                    return ESP_ERR_INVALID_ARG;
+                }
+            }
+        }
+        p = (end < trace_end) ? end + 1 : end;
+    }
+
+    if (s_rows[TRACE_IMU] + s_rows[TRACE_PPG] + s_rows[TRACE_TEMP] + s_rows[TRACE_ADV] == 0) {
+        ESP_LOGE(TAG, "트레이스가 비어 있음");
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_duration_us = duration_us > last_us ? duration_us : last_us + 10000;
+
+    for (int k = 0; k < TRACE_KIND_COUNT; k++) {
+        memset(&s_cursor[k], 0, sizeof(s_cursor[k]));
+        s_cursor[k].pos = trace_start;
+        fetch_next(&s_cursor[k], (trace_kind_t)k);
+    }
+
+#if CONFIG_SENSOR_BACKEND_TRACE_LOOP
+    const char *loop = ", 반복";
+#else
+    const char *loop = "";
+#endif
+    ESP_LOGI(TAG, "트레이스 %s: %lldms (imu %lu, ppg %lu, temp %lu, adv %lu행)%s",
+             CONFIG_SENSOR_BACKEND_TRACE_FILE, (long long)(s_duration_us / 1000),
+             (unsigned long)s_rows[TRACE_IMU], (unsigned long)s_rows[TRACE_PPG],
+             (unsigned long)s_rows[TRACE_TEMP], (unsigned long)s_rows[TRACE_ADV], loop);
+    return ESP_OK;
+}
+
+const char *backend_signal_name(void) {
+    return "trace";
+}
+
+bool backend_signal_imu(int64_t t_us, backend_imu_t *out) {
+    const trace_row_t *r = hold_at(TRACE_IMU, t_us);
+    if (r == NULL) {
+        return false;
+    }
+    out->ax = r->v[0];
+    out->ay = r->v[1];
+    out->az = r->v[2];
+    out->gx = r->v[3];
+    out->gy = r->v[4];
+    out->gz = r->v[5];
+    return true;
+}
+
+bool backend_signal_ppg(int64_t t_us, float *red, float *ir) {
+    const trace_row_t *r = hold_at(TRACE_PPG, t_us);
+    if (r == NULL) {
+        return false;
+    }
+    *red = r->v[0];
+    *ir = r->v[1];
+    return true;
+}
+
+bool backend_signal_temp(int64_t t_us, float *object_c, float *ambient_c) {
+    const trace_row_t *r = hold_at(TRACE_TEMP, t_us);
+    if (r == NULL) {
+        return false;
+    }
+    *object_c = r->v[0];
+    *ambient_c = r->v[1];
+    return true;
+}
+
+int backend_signal_adv(int64_t from_us, int64_t to_us, float rx_prob, backend_adv_fn_t fn, void *arg) {
+    (void)rx_prob;      // 트레이스 행 자체가 수신된 광고
+    trace_cursor_t *c = &s_cursor[TRACE_ADV];
+    int sent = 0;
+    while (c->have_next && c->next.t_us <= to_us) {
+        if (c->next.t_us > from_us) {
+            fn((uint16_t)c->next.v[0], (uint16_t)c->next.v[1], (int)c->next.v[2], arg);
+            sent++;
+        }
+        fetch_next(c, TRACE_ADV);
+    }
+    return sent;
+}
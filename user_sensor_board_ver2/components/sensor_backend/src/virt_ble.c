@@ -0,0 +1,197 @@
+// virt_ble.c
+// 가상 BLE 탐색 (링커 --wrap으로 NimBLE 포트 초기화와 GAP 탐색을 대체)
+//
+// 컨트롤러를 켜지 않고 호스트 동기화 콜백(ble_hs_cfg.sync_cb)만 호출한 뒤, ble_gap_disc()가 등록한
+// GAP 콜백에 신호원의 앵커 광고를 iBeacon 패킷(BLE_GAP_EVENT_DISC)으로 전달한다.
+// 광고 수신 확률은 스캔 윈도우/간격 비율이고, 주변 비-iBeacon 장치 광고도 섞어 필터 경로를 태운다.
+// 콜백은 esp_timer 태스크에서 호출된다 (실제 NimBLE에서는 호스트 태스크).
+
+#include "sensor_backend.h"
+#include "sensor_backend_priv.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nimble/nimble_port.h"
+#include "nimble/nimble_port_freertos.h"
+#include "host/ble_hs.h"
+#include "host/ble_gap.h"
+#include <string.h>
+
+static const char *TAG = "VIRT_BLE";
+
+#define VIRT_BLE_POLL_US        100000      // 광고 전달 주기
+#define VIRT_BLE_SYNC_DELAY_MS  100         // 호스트 동기화까지의 지연 (실제 컨트롤러 기동 시간 대략)
+#define IBEACON_ADV_LEN         30
+
+// anchor_sensor_board esp_ibeacon_api.h의 ESP_UUID
+static const uint8_t ANCHOR_UUID[16] = {
+    0xFD, 0xA5, 0x06, 0x93, 0xA4, 0xE2, 0x4F, 0xB1,
+    0xAF, 0xCF, 0xC6, 0xEB, 0x07, 0x64, 0x78, 0x25
+};
+
+static struct {
+    esp_timer_handle_t timer;
+    ble_gap_event_fn *cb;
+    void *cb_arg;
+    volatile bool active;
+    int64_t last_us;
+    int64_t end_us;             // INT64_MAX면 취소할 때까지
+    float rx_prob;
+    uint32_t rng;
+} s_scan;
+
+static portMUX_TYPE s_scan_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void deliver(const uint8_t *data, uint8_t len, int rssi, const uint8_t addr[6]) {
+    ble_gap_event_fn *cb;
+    void *arg;
+    portENTER_CRITICAL(&s_scan_lock);
+    cb = s_scan.active ? s_scan.cb : NULL;
+    arg = s_scan.cb_arg;
+    portEXIT_CRITICAL(&s_scan_lock);
+    if (cb == NULL) {
+        return;
+    }
+
+    struct ble_gap_event event;
+    memset(&event, 0, sizeof(event));
+    event.type = BLE_GAP_EVENT_DISC;
+    event.disc.event_type = BLE_HCI_ADV_RPT_EVTYPE_NONCONN_IND;
+    event.disc.length_data = len;
+    event.disc.data = data;
+    event.disc.rssi = (int8_t)rssi;
+    event.disc.addr.type = BLE_ADDR_PUBLIC;
+    memcpy(event.disc.addr.val, addr, 6);
+    cb(&event, arg);
+}
+
+static void on_anchor_adv(uint16_t major, uint16_t minor, int rssi, void *arg) {
+    // [Flags][Manufacturer Specific: Apple 0x004C, iBeacon 0x02 0x15, UUID, major, minor, measured power]
+    uint8_t adv[IBEACON_ADV_LEN] = { 0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15 };
+    memcpy(&adv[9], ANCHOR_UUID, sizeof(ANCHOR_UUID));
+    adv[25] = (uint8_t)(major >> 8);
+    adv[26] = (uint8_t)major;
+    adv[27] = (uint8_t)(minor >> 8);
+    adv[28] = (uint8_t)minor;
+    adv[29] = 0xC5;     // -59dBm @1m
+
+    const uint8_t addr[6] = { (uint8_t)minor, (uint8_t)(minor >> 8), (uint8_t)major, (uint8_t)(major >> 8), 0xA0, 0x30 };
+    deliver(adv, sizeof(adv), rssi, addr);
+}
+
+// 주변의 다른 BLE 장치 (비-iBeacon 제조사 데이터)
+static void emit_background(void) {
+    for (int i = 0; i < CONFIG_SENSOR_BACKEND_BLE_BACKGROUND_DEVICES; i++) {
+        if (backend_randf(&s_scan.rng) >= s_scan.rx_prob) {
+            continue;
+        }
+        uint8_t adv[12] = { 0x02, 0x01, 0x1A, 0x08, 0xFF, 0x06, 0x00, 0x01, 0x09, 0x20, (uint8_t)i, 0x00 };
+        const uint8_t addr[6] = { (uint8_t)i, 0x11, 0x22, 0x33, 0x44, 0xC0 };
+        int rssi = -70 - (int)(backend_rand(&s_scan.rng) % 25);
+        deliver(adv, sizeof(adv), rssi, addr);
+    }
+}
+
+static void scan_timer_cb(void *arg) {
+    if (!s_scan.active) {
+        return;
+    }
+    int64_t now = backend_now_us();
+    int64_t to = now < s_scan.end_us ? now : s_scan.end_us;
+
+    backend_signal_adv(s_scan.last_us, to, s_scan.rx_prob, on_anchor_adv, NULL);
+    emit_background();
+    s_scan.last_us = to;
+
+    if (to >= s_scan.end_us) {
+        // 지정한 탐색 시간 만료
+        ble_gap_event_fn *cb = s_scan.cb;
+        void *cb_arg = s_scan.cb_arg;
+        portENTER_CRITICAL(&s_scan_lock);
+        s_scan.active = false;
+        portEXIT_CRITICAL(&s_scan_lock);
+        esp_timer_stop(s_scan.timer);
+
+        struct ble_gap_event event;
+        memset(&event, 0, sizeof(event));
+        event.type = BLE_GAP_EVENT_DISC_COMPLETE;
+        event.disc_complete.reason = 0;
+        cb(&event, cb_arg);
+    }
+}
+
+static void virt_host_task(void *param) {
+    vTaskDelay(pdMS_TO_TICKS(VIRT_BLE_SYNC_DELAY_MS));
+    if (ble_hs_cfg.sync_cb != NULL) {
+        ble_hs_cfg.sync_cb();
+    }
+    vTaskDelete(NULL);
+}
+
+// ---- 가로챈 NimBLE API ----
+
+esp_err_t __wrap_nimble_port_init(void) {
+    esp_err_t err = sensor_backend_init();
+    if (err == ESP_OK) {
+        ESP_LOGW(TAG, "BLE 컨트롤러 대신 가상 앵커 광고 사용 (주변 장치 %d개)",
+                 CONFIG_SENSOR_BACKEND_BLE_BACKGROUND_DEVICES);
+    }
+    s_scan.rng = (uint32_t)CONFIG_SENSOR_BACKEND_SEED * 2654435761u + 5;
+    return err;
+}
+
+void __wrap_nimble_port_freertos_init(TaskFunction_t host_task_fn) {
+    (void)host_task_fn;     // nimble_port_run()은 실행하지 않음
+    xTaskCreate(virt_host_task, "virt_nimble", 2048, NULL, 5, NULL);
+}
+
+int __wrap_ble_gap_disc(uint8_t own_addr_type, int32_t duration_ms,
+                        const struct ble_gap_disc_params *disc_params,
+                        ble_gap_event_fn *cb, void *cb_arg) {
+    if (s_scan.active) {
+        return BLE_HS_EALREADY;
+    }
+    if (cb == NULL) {
+        return BLE_HS_EINVAL;
+    }
+    if (s_scan.timer == NULL) {
+        const esp_timer_create_args_t args = {
+            .callback = scan_timer_cb,
+            .name = "virt_ble_scan",
+        };
+        if (esp_timer_create(&args, &s_scan.timer) != ESP_OK) {
+            return BLE_HS_ENOMEM;
+        }
+    }
+
+    // 스캔 듀티 = window / interval (0이면 컨트롤러 기본값 0x10/0x10)
+    uint16_t itvl = (disc_params && disc_params->itvl) ? disc_params->itvl : 0x10;
+    uint16_t window = (disc_params && disc_params->window) ? disc_params->window : 0x10;
+    if (window > itvl) window = itvl;
+
+    int64_t now = backend_now_us();
+    portENTER_CRITICAL(&s_scan_lock);
+    s_scan.cb = cb;
+    s_scan.cb_arg = cb_arg;
+    s_scan.rx_prob = (float)window / (float)itvl;
+    s_scan.last_us = now;
+    s_scan.end_us = (duration_ms == BLE_HS_FOREVER) ? INT64_MAX : now + (int64_t)duration_ms * 1000;
+    s_scan.active = true;
+    portEXIT_CRITICAL(&s_scan_lock);
+
+    esp_timer_start_periodic(s_scan.timer, VIRT_BLE_POLL_US);
+    return 0;
+}
+
+int __wrap_ble_gap_disc_cancel(void) {
+    if (!s_scan.active) {
+        return BLE_HS_EALREADY;
+    }
+    portENTER_CRITICAL(&s_scan_lock);
+    s_scan.active = false;
+    portEXIT_CRITICAL(&s_scan_lock);
+    esp_timer_stop(s_scan.timer);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// 손목 피부/주변 온도 → 심부 체온 추정
+//
+// 손목 피부는 심부보다 차갑고, 그 차이는 피부에서 주변으로 빠져나가는 열류에 비례한다고 보면
+//     T_core ≈ T_skin + K · (T_skin - T_ambient)
+// 이다 (K = 심부-피부 열저항 / 피부-주변 열저항). MLX90614의 Ta는 시계 안쪽 센서 다이 온도라
+// 실제 주변보다 손목 쪽으로 치우치지만, 같은 방향으로 움직이므로 K에 흡수된다.
+// 1Hz 입력의 최근 CORE_TEMP_MEDIAN_N개 중앙값으로 튀는 값을 먼저 걸러낸 뒤 시정수
+// CORE_TEMP_TAU_S의 EMA로 평활하고, 창이 찰 때까지는 값을 내지 않는다. 피부로 보기 어려운 물체
+// 온도(시계가 들렸거나 미착용)는 창에 넣지 않고, 입력이 CORE_TEMP_GAP_S보다 오래 끊기면 새로 시작한다.
+// ESP-IDF 의존성이 없어 호스트에서도 그대로 컴파일된다.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CORE_TEMP_MEDIAN_N      5       // 중앙값 창 (1Hz에서 5초)
+#define CORE_TEMP_TAU_S         30.0f   // 평활 시정수
+#define CORE_TEMP_GAIN          0.35f   // K (피부 33.8°C, 주변 24°C → 심부 약 37.2°C)
+#define CORE_TEMP_SKIN_MIN_C    25.0f   // 이 범위 밖의 물체 온도는 피부가 아님
+#define CORE_TEMP_SKIN_MAX_C    42.0f
+#define CORE_TEMP_GAP_S         10      // 입력이 이보다 오래 끊기면 창을 비움
+
+/**
+ * @brief 추정 결과
+ */
+typedef struct {
+    float core_c;           // 심부 체온 추정 (평활)
+    float skin_c;           // 중앙값 필터를 거친 피부 온도
+    float ambient_c;        // 중앙값 필터를 거친 주변(센서 다이) 온도
+} core_temp_result_t;
+
+typedef struct {
+    float skin[CORE_TEMP_MEDIAN_N];
+    float ambient[CORE_TEMP_MEDIAN_N];
+    uint8_t head;
+    uint8_t count;
+    float core;             // EMA 상태
+    int64_t last_us;        // 마지막으로 창에 넣은 샘플 시각 (0 = 없음)
+} core_temp_ctx_t;
+
+void core_temp_init(core_temp_ctx_t *ctx);
+
+/**
+ * @brief 센서 샘플 1개 반영
+ * @param t_us 획득 시각 (µs)
+ * @return out을 채웠으면 true (창이 차기 전, 피부가 아닌 샘플이면 false)
+ */
+bool core_temp_update(core_temp_ctx_t *ctx, float object_c, float ambient_c, int64_t t_us,
+                      core_temp_result_t *out);
@@ -3,8 +3,22 @@
 #include "esp_err.h"
 #include "driver/i2c.h"
 
-// 초기화 함수 추가
+/**
+ * @brief 한 번에 읽은 주변(센서 다이)/물체 온도
+ */
+typedef struct {
+    float ambient_c;        // Ta (RAM 0x06) - 시계 안쪽 센서 온도
+    float object_c;         // Tobj1 (RAM 0x07) - 손목 피부 온도
+} mlx90614_reading_t;
+
+// 초기화 함수 추가 (port는 이후 읽기/sleep에도 그대로 사용)
 esp_err_t mlx90614_init(i2c_port_t port);
 
-// 기존 온도 읽기 함수
-esp_err_t mlx90614_read_temp(float *object_temp);
+// Ta와 Tobj1을 연달아 읽어 SMBus PEC(CRC-8)로 검증
+// ESP_ERR_INVALID_CRC: PEC 불일치, ESP_ERR_INVALID_RESPONSE: 오류 플래그/범위 밖
+// 두 경우 모두 프레임을 버린 것이므로 버스 복구/재시도 없이 다음 주기를 기다리면 된다
+esp_err_t mlx90614_read(mlx90614_reading_t *out);
+
+// 저전력 sleep 진입 (SMBus sleep 명령). 깨울 때는 버스에서 SDA를 33ms 이상 내려야 하며
+// (i2c_bus_wake_1), 깨운 뒤 첫 측정값은 250ms 뒤부터 유효하다.
+esp_err_t mlx90614_sleep(void);
@@ -0,0 +1,57 @@
+// core_temp.c
+// 중앙값 + EMA로 거른 피부/주변 온도에서 열류 보정으로 심부 체온 추정
+
+#include "core_temp.h"
+#include <math.h>
+#include <string.h>
+
+void core_temp_init(core_temp_ctx_t *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+// 최대 CORE_TEMP_MEDIAN_N개 삽입 정렬 후 중앙값
+static float median(const float *x, int n) {
+    float v[CORE_TEMP_MEDIAN_N];
+    for (int i = 0; i < n; i++) {
+        int j = i - 1;
+        for (; j >= 0 && v[j] > x[i]; j--) {
+            v[j + 1] = v[j];
+        }
+        v[j + 1] = x[i];
+    }
+    return (n % 2) ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+}
+
+bool core_temp_update(core_temp_ctx_t *ctx, float object_c, float ambient_c, int64_t t_us,
+                      core_temp_result_t *out) {
+    if (object_c < CORE_TEMP_SKIN_MIN_C || object_c > CORE_TEMP_SKIN_MAX_C) {
+        return false;
+    }
+    float dt_s = (ctx->last_us != 0) ? (t_us - ctx->last_us) / 1e6f : 0.0f;
+    if (ctx->last_us != 0 && (dt_s <= 0.0f || dt_s > CORE_TEMP_GAP_S)) {
+        core_temp_init(ctx);
+        dt_s = 0.0f;
+    }
+    ctx->last_us = t_us;
+
+    ctx->skin[ctx->head] = object_c;
+    ctx->ambient[ctx->head] = ambient_c;
+    ctx->head = (ctx->head + 1) % CORE_TEMP_MEDIAN_N;
+    if (ctx->count < CORE_TEMP_MEDIAN_N) {
+        ctx->count++;
+    }
+
+    float skin = median(ctx->skin, ctx->count);
+    float ambient = median(ctx->ambient, ctx->count);
+    float core = skin + CORE_TEMP_GAIN * (skin - ambient);
+    if (ctx->count < CORE_TEMP_MEDIAN_N) {
+        ctx->core = core;   // 창이 차는 동안은 EMA 시작값만 따라간다
+        return false;
+    }
+    ctx->core += (1.0f - expf(-dt_s / CORE_TEMP_TAU_S)) * (core - ctx->core);
+
+    out->core_c = ctx->core;
+    out->skin_c = skin;
+    out->ambient_c = ambient;
+    return true;
+}
@@ -8,9 +8,19 @@
 #define REG_OBJECT_TEMP 0x07
 #define REG_AMBIENT_TEMP 0x06
 #define REG_DEVICE_ID 0x0E
+#define CMD_SLEEP 0xFF
+#define TEMP_ERROR_FLAG 0x8000
+
+// 데이터시트 측정 범위 (벗어나면 잘못된 프레임)
+#define TA_MIN_C    -40.0f
+#define TA_MAX_C    125.0f
+#define TOBJ_MIN_C  -70.0f
+#define TOBJ_MAX_C  380.0f
 
 static const char *TAG = "MLX90614_DRV";
 
+static i2c_port_t s_port = I2C_NUM_1;     // mlx90614_init에서 받은 포트
+
 // MAX30102와 유사한 구조로 헬퍼 함수들 추가
 static esp_err_t write_register(i2c_port_t port, uint8_t reg, uint8_t val) {
     uint8_t data[2] = {reg, val};
@@ -21,8 +31,21 @@ static esp_err_t read_register(i2c_port_t port, uint8_t reg, uint8_t *data, size
     return i2c_master_write_read_device(port, MLX90614_ADDR, &reg, 1, data, len, pdMS_TO_TICKS(100));
 }
 
+// SMBus PEC (CRC-8, x^8 + x^2 + x + 1)
+static uint8_t smbus_crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
 esp_err_t mlx90614_init(i2c_port_t port) {
     ESP_LOGI(TAG, "MLX90614 초기화 시작 (I2C 포트: %d)", port);
+    s_port = port;
     
     // 디바이스 ID 확인
     uint8_t data[3];
@@ -44,55 +67,67 @@ esp_err_t mlx90614_init(i2c_port_t port) {
     return ESP_OK;
 }
 
-esp_err_t mlx90614_read_temp(float *object_temp) {
+// SMBus read word: [LSB, MSB, PEC], PEC는 주소(W) + 명령 + 주소(R) + 데이터 전체에 대한 CRC-8
+static esp_err_t read_word(uint8_t cmd, uint16_t *word) {
     uint8_t data[3];
-    esp_err_t ret;
+    esp_err_t ret = read_register(s_port, cmd, data, sizeof(data));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    const uint8_t frame[5] = { MLX90614_ADDR << 1, cmd, (MLX90614_ADDR << 1) | 1, data[0], data[1] };
+    uint8_t pec = smbus_crc8(frame, sizeof(frame));
+    if (pec != data[2]) {
+        ESP_LOGD(TAG, "PEC 불일치 (cmd 0x%02X): 계산값=0x%02X, 읽은값=0x%02X", cmd, pec, data[2]);
+        return ESP_ERR_INVALID_CRC;
+    }
+    *word = (uint16_t)(data[0] | (data[1] << 8));
+    return ESP_OK;
+}
 
-    // I2C_NUM_1 사용 (sensor_manager에서 I2C1로 호출)
-    i2c_port_t port = I2C_NUM_1;
+// 0.02K/LSB → °C (MSB는 오류 플래그)
+static esp_err_t word_to_celsius(uint16_t word, float min_c, float max_c, float *temp_c) {
+    if (word & TEMP_ERROR_FLAG) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    float c = word * 0.02f - 273.15f;
+    if (c < min_c || c > max_c) {
+        ESP_LOGD(TAG, "온도 범위 초과: %.2f°C (Raw: 0x%04X)", c, word);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    *temp_c = c;
+    return ESP_OK;
+}
 
-    // MAX30102와 유사한 방식으로 단순화된 읽기
-    ret = read_register(port, REG_OBJECT_TEMP, data, 3);
+esp_err_t mlx90614_read(mlx90614_reading_t *out) {
+    // 장치에 블록 읽기가 없어 read word 두 번이지만, 호출자는 버스 뮤텍스를 한 번만 잡는다
+    uint16_t ta_raw, tobj_raw;
+    esp_err_t ret = read_word(REG_AMBIENT_TEMP, &ta_raw);
+    if (ret == ESP_OK) {
+        ret = read_word(REG_OBJECT_TEMP, &tobj_raw);
+    }
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "온도 데이터 읽기 실패: %s", esp_err_to_name(ret));
         return ret;
     }
 
-    // 데이터 검증 및 변환
-    uint16_t raw = data[0] | (data[1] << 8);
-    
-    // Raw 데이터 로그 (디버깅용)
-    ESP_LOGD(TAG, "Raw data: 0x%02X 0x%02X 0x%02X, Raw value: %d", 
-             data[0], data[1], data[2], raw);
-    
-    // 체크섬 검증 (간단한 검증)
-    uint8_t checksum = data[2];
-    uint8_t calculated_checksum = 0;
-    for (int i = 0; i < 2; i++) {
-        calculated_checksum ^= data[i];
-    }
-    
-    if (checksum != calculated_checksum) {
-        // ESP_LOGW(TAG, "체크섬 불일치: 계산값=0x%02X, 읽은값=0x%02X", 
-        //          calculated_checksum, checksum);
-        // 체크섬 오류 시에도 계속 진행 (일부 센서는 체크섬이 다를 수 있음)
+    mlx90614_reading_t r;
+    ret = word_to_celsius(ta_raw, TA_MIN_C, TA_MAX_C, &r.ambient_c);
+    if (ret == ESP_OK) {
+        ret = word_to_celsius(tobj_raw, TOBJ_MIN_C, TOBJ_MAX_C, &r.object_c);
     }
-    
-    // 온도 변환 (Kelvin to Celsius)
-    // MLX90614는 Kelvin 단위로 데이터를 제공 (0.02K/LSB)
-    float temp_kelvin = raw * 0.02f;
-    *object_temp = temp_kelvin - 273.15f;
-    
-    // 온도 범위 검증 (-40°C ~ 125°C)
-    if (*object_temp < -40.0f || *object_temp > 125.0f) {
-        ESP_LOGW(TAG, "온도 범위 초과: %.2f°C (Raw: %d)", *object_temp, raw);
-        // 범위를 벗어나면 기본값 반환
-        *object_temp = 25.0f;
-        return ESP_ERR_INVALID_RESPONSE;
+    if (ret != ESP_OK) {
+        return ret;
     }
-    
-    ESP_LOGD(TAG, "온도 읽기 성공: %.2f°C (Raw: %d, Kelvin: %.2fK)", 
-             *object_temp, raw, temp_kelvin);
-    
+    *out = r;
+    ESP_LOGD(TAG, "온도 읽기 성공: Ta %.2f°C, Tobj %.2f°C", r.ambient_c, r.object_c);
     return ESP_OK;
 }
+
+esp_err_t mlx90614_sleep(void) {
+    // sleep 명령은 PEC가 맞아야 받아들여진다 (주소 0x5A면 0xE8)
+    uint8_t frame[2] = { MLX90614_ADDR << 1, CMD_SLEEP };
+    esp_err_t ret = write_register(s_port, CMD_SLEEP, smbus_crc8(frame, sizeof(frame)));
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "sleep 명령 실패: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 사용자 마커 ID (덤프 시 이름 테이블과 함께 출력)
+ */
+typedef enum {
+    TRACE_MARK_IMU_READ = 0,    // MPU6050 읽기 (버스 I/O만)
+    TRACE_MARK_PPG_READ,        // MAX30102 읽기 (버스 I/O만)
+    TRACE_MARK_TEMP_READ,       // MLX90614 읽기
+    TRACE_MARK_PUBLISH,         // MQTT payload 생성 + publish
+    TRACE_MARK_IMU_DSP,         // 걸음/낙상 처리 (imu_dsp 태스크)
+    TRACE_MARK_PPG_DSP,         // 심박/SpO2 계산 (ppg_dsp 태스크)
+    TRACE_MARK_AGGREGATE,       // DSP 결과 → sensor_data 반영 (aggregator 태스크)
+    TRACE_MARK_MAX
+} trace_mark_t;
+
+/**
+ * @brief 이벤트 타입 (tools/trace_to_perfetto.py와 동일해야 함)
+ */
+typedef enum {
+    TRACE_EV_TASK_IN = 1,
+    TRACE_EV_TASK_OUT,
+    TRACE_EV_ISR_ENTER,
+    TRACE_EV_ISR_EXIT,
+    TRACE_EV_MARK_BEGIN,
+    TRACE_EV_MARK_END,
+    TRACE_EV_TICK,
+} trace_event_type_t;
+
+/**
+ * @brief 트레이스 캡처 초기화
+ *
+ * CONFIG_TRACE_CAPTURE_START_DELAY_MS 후 CONFIG_TRACE_CAPTURE_WINDOW_MS 동안 기록하고
+ * 설정된 전송 경로(UART/MQTT)로 덤프하는 제어 태스크를 시작한다.
+ */
+void trace_capture_init(void);
+
+/**
+ * @brief 버퍼를 비우고 기록 시작
+ */
+void trace_capture_start(void);
+
+/**
+ * @brief 기록 중지 (버퍼 내용은 유지)
+ */
+void trace_capture_stop(void);
+
+bool trace_capture_is_running(void);
+
+/**
+ * @brief 사용자 마커 기록 (TRACE_BEGIN / TRACE_END 매크로 사용)
+ */
+void trace_capture_mark(trace_mark_t mark, bool begin);
+
+/**
+ * @brief 버퍼를 "#TR" 라인 형식으로 콘솔에 출력
+ */
+esp_err_t trace_capture_dump_uart(void);
+
+/**
+ * @brief 버퍼를 "#TR" 라인 형식으로 MQTT에 나눠 publish
+ * @return MQTT 미연결 시 ESP_ERR_INVALID_STATE
+ */
+esp_err_t trace_capture_dump_mqtt(void);
+
+#if CONFIG_TRACE_CAPTURE_ENABLE
+#define TRACE_BEGIN(mark) trace_capture_mark((mark), true)
+#define TRACE_END(mark)   trace_capture_mark((mark), false)
+#else
+#define TRACE_BEGIN(mark) do { (void)(mark); } while (0)
+#define TRACE_END(mark)   do { (void)(mark); } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+// FreeRTOS trace 매크로 훅
+//
+// 프로젝트 CMakeLists.txt에서 `-include`로 모든 C 파일 앞에 주입된다. FreeRTOS.h는
+// traceXXX 매크로가 정의되어 있지 않을 때만 빈 매크로를 정의하므로, 여기서 먼저 정의하면
+// 커널(tasks.c) 빌드 시 훅이 들어간다. 주입되는 헤더이므로 sdkconfig.h와 stdint.h 외에는
+// 아무 것도 include 하지 않는다.
+
+#ifndef __ASSEMBLER__
+
+#include "sdkconfig.h"
+
+#if CONFIG_TRACE_CAPTURE_ENABLE
+
+#include <stdint.h>
+
+void trace_capture_task_switched_in(void);
+void trace_capture_task_switched_out(void);
+void trace_capture_isr_enter(uint32_t irq);
+void trace_capture_isr_exit(void);
+void trace_capture_tick(void);
+
+#define traceTASK_SWITCHED_IN()              trace_capture_task_switched_in()
+#define traceTASK_SWITCHED_OUT()             trace_capture_task_switched_out()
+#define traceISR_ENTER(_n_)                  trace_capture_isr_enter((uint32_t)(_n_))
+#define traceISR_EXIT()                      trace_capture_isr_exit()
+#define traceISR_EXIT_TO_SCHEDULER()         trace_capture_isr_exit()
+
+#if CONFIG_TRACE_CAPTURE_TICKS
+#define traceTASK_INCREMENT_TICK(xTickCount) trace_capture_tick()
+#endif
+
+#endif // CONFIG_TRACE_CAPTURE_ENABLE
+
+#endif // __ASSEMBLER__
@@ -0,0 +1,348 @@
+#include "trace_capture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "mqtt_client.h"
+
+static const char *TAG = "TRACE";
+
+#if CONFIG_TRACE_CAPTURE_ENABLE
+
+#include "trace_hooks.h"
+
+#define TRACE_EVENTS   CONFIG_TRACE_CAPTURE_EVENTS_PER_CORE
+#define TRACE_TASKS    CONFIG_TRACE_CAPTURE_MAX_TASKS
+#define TRACE_NO_TASK  0xFF
+#define TRACE_NAME_LEN 16
+
+extern esp_mqtt_client_handle_t mqtt_client;   // mqtt_client_wrapper.c
+extern bool mqtt_is_connected(void);
+
+// 이벤트 (12 bytes)
+typedef struct {
+    uint32_t ts_us;     // esp_timer 하위 32비트 (약 71분 주기로 랩어라운드)
+    uint8_t type;       // trace_event_type_t
+    uint8_t task;       // 이벤트 시점의 태스크 테이블 인덱스
+    uint16_t id;        // 마커 ID / IRQ 번호
+    uint32_t arg;
+} trace_event_t;
+
+_Static_assert(sizeof(trace_event_t) == 12, "trace_event_t must stay 12 bytes");
+
+typedef struct {
+    TaskHandle_t handle;
+    char name[TRACE_NAME_LEN];
+} trace_task_t;
+
+// 코어별 버퍼: 각 코어는 자기 버퍼에만 기록하므로 인터럽트 마스크만으로 충분
+static DRAM_ATTR trace_event_t s_events[portNUM_PROCESSORS][TRACE_EVENTS];
+static DRAM_ATTR uint32_t s_count[portNUM_PROCESSORS];
+static DRAM_ATTR uint32_t s_overflow[portNUM_PROCESSORS];
+static DRAM_ATTR uint8_t s_cur_task[portNUM_PROCESSORS] = { [0 ... portNUM_PROCESSORS - 1] = TRACE_NO_TASK };
+static volatile DRAM_ATTR bool s_running = false;
+
+// 태스크 테이블은 두 코어가 공유하므로 스핀락으로 보호
+static DRAM_ATTR trace_task_t s_tasks[TRACE_TASKS];
+static DRAM_ATTR uint32_t s_task_count = 0;
+static portMUX_TYPE s_task_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t s_start_us = 0;
+static uint32_t s_stop_us = 0;
+
+static const char *const s_mark_names[TRACE_MARK_MAX] = {
+    [TRACE_MARK_IMU_READ]  = "imu_read",
+    [TRACE_MARK_PPG_READ]  = "ppg_read",
+    [TRACE_MARK_TEMP_READ] = "temp_read",
+    [TRACE_MARK_PUBLISH]   = "publish",
+    [TRACE_MARK_IMU_DSP]   = "imu_dsp",
+    [TRACE_MARK_PPG_DSP]   = "ppg_dsp",
+    [TRACE_MARK_AGGREGATE] = "aggregate",
+};
+
+static IRAM_ATTR void trace_record(uint8_t type, uint8_t task, uint16_t id, uint32_t arg) {
+    if (!s_running) {
+        return;
+    }
+
+    int core = esp_cpu_get_core_id();
+    UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t n = s_count[core];
+    if (n < TRACE_EVENTS) {
+        trace_event_t *ev = &s_events[core][n];
+        ev->ts_us = (uint32_t)esp_timer_get_time();
+        ev->type = type;
+        ev->task = task;
+        ev->id = id;
+        ev->arg = arg;
+        s_count[core] = n + 1;
+    } else {
+        s_overflow[core]++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+}
+
+// 핸들로 태스크 인덱스 조회, 처음 보는 태스크면 이름과 함께 등록
+static IRAM_ATTR uint8_t trace_task_index(TaskHandle_t handle) {
+    uint32_t count = s_task_count;
+    for (uint32_t i = 0; i < count; i++) {
+        if (s_tasks[i].handle == handle) {
+            return (uint8_t)i;
+        }
+    }
+
+    uint8_t idx = TRACE_NO_TASK;
+    portENTER_CRITICAL_SAFE(&s_task_lock);
+    // 다른 코어가 그 사이에 등록했을 수 있으므로 다시 확인
+    for (uint32_t i = count; i < s_task_count; i++) {
+        if (s_tasks[i].handle == handle) {
+            idx = (uint8_t)i;
+            break;
+        }
+    }
+    if (idx == TRACE_NO_TASK && s_task_count < TRACE_TASKS) {
+        trace_task_t *t = &s_tasks[s_task_count];
+        const char *name = pcTaskGetName(handle);
+        int j = 0;
+        for (; name != NULL && name[j] != '\0' && j < TRACE_NAME_LEN - 1; j++) {
+            t->name[j] = name[j];
+        }
+        t->name[j] = '\0';
+        t->handle = handle;
+        idx = (uint8_t)s_task_count;
+        s_task_count++;
+    }
+    portEXIT_CRITICAL_SAFE(&s_task_lock);
+    return idx;
+}
+
+void IRAM_ATTR trace_capture_task_switched_in(void) {
+    if (!s_running) {
+        return;
+    }
+    int core = esp_cpu_get_core_id();
+    uint8_t idx = trace_task_index(xTaskGetCurrentTaskHandle());
+    s_cur_task[core] = idx;
+    trace_record(TRACE_EV_TASK_IN, idx, 0, 0);
+}
+
+void IRAM_ATTR trace_capture_task_switched_out(void) {
+    if (!s_running) {
+        return;
+    }
+    trace_record(TRACE_EV_TASK_OUT, s_cur_task[esp_cpu_get_core_id()], 0, 0);
+}
+
+void IRAM_ATTR trace_capture_isr_enter(uint32_t irq) {
+    trace_record(TRACE_EV_ISR_ENTER, s_cur_task[esp_cpu_get_core_id()], (uint16_t)irq, 0);
+}
+
+void IRAM_ATTR trace_capture_isr_exit(void) {
+    trace_record(TRACE_EV_ISR_EXIT, s_cur_task[esp_cpu_get_core_id()], 0, 0);
+}
+
+void IRAM_ATTR trace_capture_tick(void) {
+    trace_record(TRACE_EV_TICK, s_cur_task[esp_cpu_get_core_id()], 0, 0);
+}
+
+void trace_capture_mark(trace_mark_t mark, bool begin) {
+    trace_record(begin ? TRACE_EV_MARK_BEGIN : TRACE_EV_MARK_END,
+                 s_cur_task[esp_cpu_get_core_id()], (uint16_t)mark, 0);
+}
+
+void trace_capture_start(void) {
+    s_running = false;
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        s_count[core] = 0;
+        s_overflow[core] = 0;
+    }
+    s_start_us = (uint32_t)esp_timer_get_time();
+    s_running = true;
+    ESP_LOGI(TAG, "트레이스 캡처 시작 (코어당 %d 이벤트)", TRACE_EVENTS);
+}
+
+void trace_capture_stop(void) {
+    if (!s_running) {
+        return;
+    }
+    s_running = false;
+    s_stop_us = (uint32_t)esp_timer_get_time();
+    ESP_LOGI(TAG, "트레이스 캡처 중지 (core0: %lu, core1: %lu 이벤트, 오버플로: %lu/%lu)",
+             (unsigned long)s_count[0], (unsigned long)(portNUM_PROCESSORS > 1 ? s_count[1] : 0),
+             (unsigned long)s_overflow[0], (unsigned long)(portNUM_PROCESSORS > 1 ? s_overflow[1] : 0));
+}
+
+bool trace_capture_is_running(void) {
+    return s_running;
+}
+
+// ---- 덤프 ----
+// 라인 형식 (모두 16진수가 아닌 값은 10진수)
+//   #TR-BEGIN:<cores>,<start_us>,<stop_us>
+//   #TR-TASK:<idx>,<name>
+//   #TR-MARK:<id>,<name>
+//   #TR-CORE:<core>,<events>,<overflow>
+//   #TR:<core>,<ts_us hex>,<type>,<task>,<id>,<arg hex>
+//   #TR-END
+
+typedef void (*trace_line_sink_t)(const char *line, void *ctx);
+
+static void trace_dump(trace_line_sink_t sink, void *ctx) {
+    char line[64];
+
+    snprintf(line, sizeof(line), "#TR-BEGIN:%d,%lu,%lu", portNUM_PROCESSORS,
+             (unsigned long)s_start_us, (unsigned long)s_stop_us);
+    sink(line, ctx);
+
+    for (uint32_t i = 0; i < s_task_count; i++) {
+        snprintf(line, sizeof(line), "#TR-TASK:%lu,%s", (unsigned long)i, s_tasks[i].name);
+        sink(line, ctx);
+    }
+    for (int i = 0; i < TRACE_MARK_MAX; i++) {
+        snprintf(line, sizeof(line), "#TR-MARK:%d,%s", i, s_mark_names[i]);
+        sink(line, ctx);
+    }
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        snprintf(line, sizeof(line), "#TR-CORE:%d,%lu,%lu", core,
+                 (unsigned long)s_count[core], (unsigned long)s_overflow[core]);
+        sink(line, ctx);
+
+        for (uint32_t i = 0; i < s_count[core]; i++) {
+            const trace_event_t *ev = &s_events[core][i];
+            snprintf(line, sizeof(line), "#TR:%d,%08lx,%u,%u,%u,%08lx", core,
+                     (unsigned long)ev->ts_us, ev->type, ev->task, ev->id, (unsigned long)ev->arg);
+            sink(line, ctx);
+        }
+    }
+
+    sink("#TR-END", ctx);
+}
+
+static void uart_sink(const char *line, void *ctx) {
+    static uint32_t lines = 0;
+    puts(line);
+    // 콘솔 출력 태스크가 워치독에 걸리지 않도록 주기적으로 양보
+    if ((++lines & 0x3F) == 0) {
+        vTaskDelay(1);
+    }
+}
+
+esp_err_t trace_capture_dump_uart(void) {
+    trace_capture_stop();
+    trace_dump(uart_sink, NULL);
+    return ESP_OK;
+}
+
+// MQTT 덤프: 라인을 약 1KB 단위로 묶어서 publish
+typedef struct {
+    char buf[1024];
+    int len;
+    int published;
+    bool failed;
+} mqtt_sink_ctx_t;
+
+static void mqtt_sink_flush(mqtt_sink_ctx_t *m) {
+    if (m->len == 0 || m->failed) {
+        return;
+    }
+    int msg_id = esp_mqtt_client_publish(mqtt_client, CONFIG_TRACE_CAPTURE_MQTT_TOPIC, m->buf, m->len, 1, 0);
+    if (msg_id < 0) {
+        m->failed = true;
+        return;
+    }
+    m->published++;
+    m->len = 0;
+    // 아웃박스가 한꺼번에 커지지 않도록 조금씩 전송
+    vTaskDelay(pdMS_TO_TICKS(20));
+}
+
+static void mqtt_sink(const char *line, void *ctx) {
+    mqtt_sink_ctx_t *m = (mqtt_sink_ctx_t *)ctx;
+    int n = strlen(line);
+    if (m->len + n + 1 > (int)sizeof(m->buf)) {
+        mqtt_sink_flush(m);
+    }
+    memcpy(m->buf + m->len, line, n);
+    m->len += n;
+    m->buf[m->len++] = '\n';
+}
+
+esp_err_t trace_capture_dump_mqtt(void) {
+    trace_capture_stop();
+    if (mqtt_client == NULL || !mqtt_is_connected()) {
+        ESP_LOGW(TAG, "MQTT 미연결 - 트레이스 덤프 생략");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    mqtt_sink_ctx_t *m = calloc(1, sizeof(mqtt_sink_ctx_t));
+    if (m == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    trace_dump(mqtt_sink, m);
+    mqtt_sink_flush(m);
+
+    esp_err_t ret = m->failed ? ESP_FAIL : ESP_OK;
+    ESP_LOGI(TAG, "트레이스 MQTT 덤프 %s (%d 메시지, 토픽: %s)",
+             m->failed ? "실패" : "완료", m->published, CONFIG_TRACE_CAPTURE_MQTT_TOPIC);
+    free(m);
+    return ret;
+}
+
+static void trace_ctl_task(void *pvParameters) {
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_TRACE_CAPTURE_START_DELAY_MS));
+    trace_capture_start();
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_TRACE_CAPTURE_WINDOW_MS));
+    trace_capture_stop();
+
+#if CONFIG_TRACE_CAPTURE_DUMP_MQTT
+    trace_capture_dump_mqtt();
+#else
+    trace_capture_dump_uart();
+#endif
+    vTaskDelete(NULL);
+}
+
+void trace_capture_init(void) {
+    ESP_LOGW(TAG, "트레이스 캡처 빌드 - %dms 후 %dms 동안 기록",
+             CONFIG_TRACE_CAPTURE_START_DELAY_MS, CONFIG_TRACE_CAPTURE_WINDOW_MS);
+    xTaskCreate(trace_ctl_task, "trace_ctl", 4096, NULL, 1, NULL);
+}
+
+#else  // !CONFIG_TRACE_CAPTURE_ENABLE
+
+void trace_capture_init(void) {
+}
+
+void trace_capture_start(void) {
+}
+
+void trace_capture_stop(void) {
+}
+
+bool trace_capture_is_running(void) {
+    return false;
+}
+
+void trace_capture_mark(trace_mark_t mark, bool begin) {
+    (void)mark;
+    (void)begin;
+}
+
+esp_err_t trace_capture_dump_uart(void) {
+    ESP_LOGW(TAG, "CONFIG_TRACE_CAPTURE_ENABLE 비활성화 상태");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t trace_capture_dump_mqtt(void) {
+    ESP_LOGW(TAG, "CONFIG_TRACE_CAPTURE_ENABLE 비활성화 상태");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
@@ -10,7 +10,7 @@
 #include "mqtt_client.h"
 #include "esp_system.h"
 
-#include "wifi_connect.h"
+#include "wifi_manager.h"
 #include "mqtt_client_wrapper.h"
 #include "sensor_data.h"
 #include "i2c_helper.h"
@@ -19,13 +19,92 @@
 #include "send_task.h"
 #include "beacon_scanner_task.h"
 #include "sensor_manager.h"
+#include "app_init.h"
+#include "clock_service.h"
+#include "dlog.h"
+#include "trace_capture.h"
+#include "sensor_backend.h"
+#include "placement_bench.h"
 
 static const char *TAG = "MAIN";
 
+// ---- 부팅 단계 함수 (app_init 단계 태스크에서 실행) ----
+
+static esp_err_t stage_i2c(void) {
+    // 가상 백엔드면 신호원 준비 (하드웨어 백엔드에서는 아무것도 하지 않음)
+    esp_err_t ret = sensor_backend_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "센서 백엔드(%s) 초기화 실패: %s", sensor_backend_name(), esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "센서 백엔드: %s", sensor_backend_name());
+    i2c_master_init();
+    return ESP_OK;
+}
+
+static esp_err_t stage_sensors(void) {
+    // 초기화 실패 시에도 계속 진행 (실패한 센서만 비활성)
+    esp_err_t ret = sensor_manager_start();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "센서 매니저 시작 실패, 계속 진행: %s", esp_err_to_name(ret));
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stage_wifi(void) {
+    // 완료(IP 획득)는 wifi_mgr 태스크에서 APP_INIT_NET_UP으로 통지
+    return wifi_manager_start();
+}
+
+// SNTP는 전송을 막지 않는다 - 서버 선택/동기화는 sntp 태스크에서 진행 (완료 시 APP_INIT_TIME_SYNCED)
+static esp_err_t stage_sntp(void) {
+    return sntp_service_start();
+}
+
+static esp_err_t stage_mqtt(void) {
+    // 완료(브로커 연결)는 mqtt_client_wrapper.c에서 APP_INIT_MQTT_UP으로 통지
+    mqtt_start();
+    return ESP_OK;
+}
+
+static esp_err_t stage_ble(void) {
+    ble_init();
+    return ESP_OK;
+}
+
+static esp_err_t stage_send(void) {
+    start_send_task();
+    return ESP_OK;
+}
+
+#if CONFIG_TASK_PLACEMENT_BENCH
+static esp_err_t stage_bench(void) {
+    return placement_bench_start();
+}
+#endif
+
+// 센서 경로(I2C → 센서)와 네트워크 경로(Wi-Fi → MQTT), BLE는 서로 독립적으로 진행된다.
+static const app_init_stage_t s_boot_stages[] = {
+    { "i2c",     0,                                   APP_INIT_I2C,     stage_i2c,     0 },
+    { "sensors", APP_INIT_I2C | APP_INIT_SENSOR_DATA, APP_INIT_SENSORS, stage_sensors, 4096 },
+    { "wifi",    APP_INIT_NVS,                        0,                stage_wifi,    0 },
+    { "sntp",    APP_INIT_NET_UP,                     0,                stage_sntp,    0 },
+    { "mqtt",    APP_INIT_NET_UP,                     0,                stage_mqtt,    0 },
+    { "ble",     APP_INIT_NVS,                        APP_INIT_BLE,     stage_ble,     0 },
+    { "send",    APP_INIT_SENSORS | APP_INIT_MQTT_UP, 0,                stage_send,    0 },
+#if CONFIG_TASK_PLACEMENT_BENCH
+    { "bench",   APP_INIT_SENSORS | APP_INIT_MQTT_UP, 0,                stage_bench,   0 },
+#endif
+};
+
 void app_main(void) {
-    ESP_ERROR_CHECK(nvs_flash_init());
+    app_init_begin();
+
     esp_reset_reason_t reason = esp_reset_reason();
     printf("Reset reason: %d\n", reason);
+
+    // 지연 로그 드레인 태스크 시작
+    dlog_init();
     
     // NVS 초기화
     esp_err_t ret = nvs_flash_init();
@@ -34,32 +113,19 @@ void app_main(void) {
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
-    
-    // I2C 초기화
-    i2c_master_init();
-    vTaskDelay(pdMS_TO_TICKS(500));
+    app_init_signal(APP_INIT_NVS);
 
-    // 센서 데이터 초기화
-    sensor_data_init();
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    // 센서 매니저 시작 (초기화 실패 시에도 계속 진행)
-    ret = sensor_manager_start();
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "센서 매니저 시작 실패, 계속 진행: %s", esp_err_to_name(ret));
-    }
-    vTaskDelay(pdMS_TO_TICKS(1000));
-    
-    // Wi-Fi 연결
-    wifi_connect();
-    vTaskDelay(pdMS_TO_TICKS(2000));
+    // 마지막으로 알던 시각 복원 (SNTP 동기화 전에도 타임스탬프 사용 가능)
+    sntp_restore_time();
+    clock_service_init(is_sntp_synced());
 
-    // MQTT 연결
-    mqtt_start();
+    // 센서 데이터 초기화 (뮤텍스 생성만 하므로 바로 수행)
+    sensor_data_init();
+    app_init_signal(APP_INIT_SENSOR_DATA);
 
-    // 블루투스 초기화
-    ble_init();
+    // 나머지는 의존성이 충족되는 대로 병렬 실행
+    ESP_ERROR_CHECK(app_init_start(s_boot_stages, sizeof(s_boot_stages) / sizeof(s_boot_stages[0])));
 
-    // MQTT 전송 태스크 시작
-    start_send_task();
-}
\ No newline at end of file
+    // 스케줄링 트레이스 (CONFIG_TRACE_CAPTURE_ENABLE 빌드에서만 동작)
+    trace_capture_init();
+}